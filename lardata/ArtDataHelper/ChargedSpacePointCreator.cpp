@@ -17,10 +17,69 @@
 
 // C/C++ standard libraries
 #include <utility> // std::move()
-#include <iterator> // std::back_inserter()
+#include <iterator> // std::make_move_iterator()
 #include <cassert>
 
 
+//------------------------------------------------------------------------------
+namespace {
+
+  /// Throws an exception if the two collections have different size.
+  void checkConsistentSizes(
+    std::vector<recob::SpacePoint> const& spacePoints,
+    std::vector<recob::PointCharge> const& charges
+    )
+  {
+    if (spacePoints.size() == charges.size()) return;
+    throw cet::exception("ChargedSpacePointCollectionCreator")
+      << "Input collections of inconsistent size:"
+      << " " << spacePoints.size() << " (space points)"
+      << "and " << charges.size() << " (charges)"
+      << "\n";
+  } // checkConsistentSizes()
+
+
+  /// Moves all the elements of `src` at the end of `dest`, leaving `src` empty.
+  template <typename T>
+  void moveAppend(std::vector<T>& dest, std::vector<T>&& src) {
+    // steal the whole storage, unless `dest` has more memory reserved already
+    if (dest.empty() && (dest.capacity() <= src.capacity()))
+      dest = std::move(src);
+    else {
+      dest.insert(dest.end(),
+        std::make_move_iterator(src.begin()), std::make_move_iterator(src.end())
+        );
+    }
+    src.clear();
+  } // moveAppend()
+
+} // local namespace
+
+
+//------------------------------------------------------------------------------
+void recob::ChargedSpacePointCollectionCreator::Buffer::addAll(
+  std::vector<recob::SpacePoint>&& spacePoints,
+  std::vector<recob::PointCharge>&& charges
+  )
+{
+  checkConsistentSizes(spacePoints, charges);
+  moveAppend(fSpacePoints, std::move(spacePoints));
+  moveAppend(fCharges, std::move(charges));
+} // recob::ChargedSpacePointCollectionCreator::Buffer::addAll()
+
+
+//------------------------------------------------------------------------------
+void recob::ChargedSpacePointCollectionCreator::Buffer::addAll(
+  std::vector<recob::SpacePoint> const& spacePoints,
+  std::vector<recob::PointCharge> const& charges
+  )
+{
+  checkConsistentSizes(spacePoints, charges);
+  fSpacePoints.insert(fSpacePoints.end(), spacePoints.begin(), spacePoints.end());
+  fCharges.insert(fCharges.end(), charges.begin(), charges.end());
+} // recob::ChargedSpacePointCollectionCreator::Buffer::addAll()
+
+
 //------------------------------------------------------------------------------
 recob::ChargedSpacePointCollectionCreator::ChargedSpacePointCollectionCreator
   (art::Event& event, std::string const& instanceName /* = {} */)
@@ -88,26 +147,9 @@ void recob::ChargedSpacePointCollectionCreator::addAll(
   assert(fSpacePoints);
   assert(fCharges);
 
-  if (spacePoints.size() != charges.size()) {
-    throw cet::exception("ChargedSpacePointCollectionCreator")
-      << "Input collections of inconsistent size:"
-      << " " << spacePoints.size() << " (space points)"
-      << "and " << charges.size() << " (charges)"
-      << "\n";
-  }
-  if (empty()) {
-    *fSpacePoints = std::move(spacePoints);
-    *fCharges = std::move(charges);
-  }
-  else {
-    fSpacePoints->reserve(fSpacePoints->size() + spacePoints.size());
-    for (auto&& obj: spacePoints) fSpacePoints->push_back(std::move(obj));
-    spacePoints.clear();
-
-    fCharges->reserve(fCharges->size() + charges.size());
-    for (auto&& obj: charges) fCharges->push_back(std::move(obj));
-    charges.clear();
-  }
+  checkConsistentSizes(spacePoints, charges);
+  moveAppend(*fSpacePoints, std::move(spacePoints));
+  moveAppend(*fCharges, std::move(charges));
 
   assert(fSpacePoints->size() == fCharges->size());
 
@@ -124,20 +166,10 @@ void recob::ChargedSpacePointCollectionCreator::addAll(
   assert(fSpacePoints);
   assert(fCharges);
 
-
-  if (spacePoints.size() != charges.size()) {
-    throw cet::exception("ChargedSpacePointCollectionCreator")
-      << "Input collections of inconsistent size:"
-      << " " << spacePoints.size() << " (space points)"
-      << "and " << charges.size() << " (charges)"
-      << "\n";
-  }
-  fSpacePoints->reserve(fSpacePoints->size() + spacePoints.size());
-  std::copy
-    (spacePoints.begin(), spacePoints.end(), std::back_inserter(*fSpacePoints));
-
-  fCharges->reserve(fCharges->size() + charges.size());
-  std::copy(charges.begin(), charges.end(), std::back_inserter(*fCharges));
+  checkConsistentSizes(spacePoints, charges);
+  fSpacePoints->insert
+    (fSpacePoints->end(), spacePoints.begin(), spacePoints.end());
+  fCharges->insert(fCharges->end(), charges.begin(), charges.end());
 
   assert(fSpacePoints->size() == fCharges->size());
 
@@ -145,9 +177,55 @@ void recob::ChargedSpacePointCollectionCreator::addAll(
 
 
 //------------------------------------------------------------------------------
-    /// Puts all data products into the event, leaving the creator `empty()`.
+void recob::ChargedSpacePointCollectionCreator::reserve(std::size_t n) {
+
+  // if these assertion fail, reserve() is being called after put()
+  assert(fSpacePoints);
+  assert(fCharges);
+
+  fSpacePoints->reserve(n);
+  fCharges->reserve(n);
+
+} // recob::ChargedSpacePointCollectionCreator::reserve()
+
+
+//------------------------------------------------------------------------------
+void recob::ChargedSpacePointCollectionCreator::makeBuffers(std::size_t n) {
+
+  fBuffers.clear();
+  fBuffers.resize(n);
+
+} // recob::ChargedSpacePointCollectionCreator::makeBuffers()
+
+
+//------------------------------------------------------------------------------
+void recob::ChargedSpacePointCollectionCreator::mergeBuffers() {
+
+  // if these assertion fail, mergeBuffers() is being called after put()
+  assert(fSpacePoints);
+  assert(fCharges);
+
+  std::size_t n = size();
+  for (Buffer const& buffer: fBuffers) n += buffer.size();
+  reserve(n);
+
+  for (Buffer& buffer: fBuffers) {
+    assert(buffer.fSpacePoints.size() == buffer.fCharges.size());
+    moveAppend(*fSpacePoints, std::move(buffer.fSpacePoints));
+    moveAppend(*fCharges, std::move(buffer.fCharges));
+  } // for
+
+  assert(fSpacePoints->size() == n);
+  assert(fCharges->size() == n);
+
+} // recob::ChargedSpacePointCollectionCreator::mergeBuffers()
+
+
+//------------------------------------------------------------------------------
 void recob::ChargedSpacePointCollectionCreator::put() {
 
+  mergeBuffers();
+
   fEvent.put(std::move(fSpacePoints), fInstanceName);
   fEvent.put(std::move(fCharges), fInstanceName);
 
@@ -161,6 +239,10 @@ void recob::ChargedSpacePointCollectionCreator::clear() {
 
   if (fSpacePoints) fSpacePoints->clear();
   if (fCharges) fCharges->clear();
+  for (Buffer& buffer: fBuffers) {
+    buffer.fSpacePoints.clear();
+    buffer.fCharges.clear();
+  } // for
 
   assert(empty());
 
@@ -24,6 +24,7 @@
 // C/C++ standard libraries
 #include <vector>
 #include <memory> // std::unique_ptr<>
+#include <utility> // std::move()
 #include <type_traits> // std::enable_if_t, ...
 #include <cstdlib> // std::size_t
 
@@ -176,6 +177,35 @@ namespace recob {
    *
    *
    *
+   * Filling from many threads
+   * --------------------------
+   *
+   * Space points produced concurrently can be collected in independent
+   * buffers, created with `makeBuffers()`: each buffer is filled by a single
+   * thread at a time with its own `add()` and `addAll()`, without locking.
+   * The buffers are appended to the collection, in buffer order and after the
+   * data added directly to the creator, by `mergeBuffers()` or at the latest
+   * by `put()`; the result does not depend on the timing of the threads.
+   * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~{.cpp}
+   * void MyProducer::produce(art::Event& event) {
+   *
+   *   recob::ChargedSpacePointCollectionCreator spacePoints(event);
+   *   spacePoints.makeBuffers(nThreads);
+   *
+   *   // in thread iThread:
+   *   auto& buffer = spacePoints.buffer(iThread);
+   *   buffer.reserve(expectedPointsPerThread);
+   *   for (...) buffer.add(std::move(spacePoint), std::move(charge));
+   *
+   *   // after all threads are done:
+   *   spacePoints.put();
+   *
+   * } // MyProducer::produce()
+   * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+   * The _art_ pointers to the space points in a buffer can be created only
+   * after they have been merged.
+   *
+   *
    * Operations on the collection
    * -----------------------------
    *
@@ -184,7 +214,8 @@ namespace recob {
    *
    * * query: the current number of space points (`size()`), whether there are
    *          any (`empty()`), and whether `put()` has been already called
-   *          (`spent()`; see below)
+   *          (`spent()`; see below); space points still in the buffers are
+   *          not counted until they are merged
    * * deletion: it is possible to remove *all* the data so far collected;
    *             this may be useful in case of error, where the data product
    *             should be set in as default-constructed (which unfortunately
@@ -226,6 +257,57 @@ namespace recob {
 
   public:
 
+    /// A partition of the collection, to be filled by a single thread.
+    class Buffer {
+    public:
+
+      //@{
+      /// Inserts the specified space point and charge into the buffer.
+      void add
+        (recob::SpacePoint const& spacePoint, recob::PointCharge const& charge)
+        { fSpacePoints.push_back(spacePoint); fCharges.push_back(charge); }
+      void add(recob::SpacePoint&& spacePoint, recob::PointCharge&& charge)
+        {
+          fSpacePoints.push_back(std::move(spacePoint));
+          fCharges.push_back(std::move(charge));
+        }
+      //@}
+
+      //@{
+      /**
+       * @brief Inserts all the space points and charges into the buffer.
+       * @throw cet::exception (category `ChargedSpacePointCollectionCreator`)
+       *                       if the input collections are inconsistent
+       */
+      void addAll(
+        std::vector<recob::SpacePoint>&& spacePoints,
+        std::vector<recob::PointCharge>&& charges
+        );
+      void addAll(
+        std::vector<recob::SpacePoint> const& spacePoints,
+        std::vector<recob::PointCharge> const& charges
+        );
+      //@}
+
+      /// Prepares the buffer to host at least `n` space points.
+      void reserve(std::size_t n)
+        { fSpacePoints.reserve(n); fCharges.reserve(n); }
+
+      /// Returns the number of space points in this buffer.
+      std::size_t size() const { return fSpacePoints.size(); }
+
+      /// Returns whether there are no space points in this buffer.
+      bool empty() const { return fSpacePoints.empty(); }
+
+    private:
+      friend class ChargedSpacePointCollectionCreator;
+
+      std::vector<recob::SpacePoint> fSpacePoints; ///< Buffered space points.
+      std::vector<recob::PointCharge> fCharges; ///< Buffered charges.
+
+    }; // class Buffer
+
+
     //--- BEGIN Constructors ---------------------------------------------------
     /// @{
     /// @name Constructors
@@ -292,7 +374,7 @@ namespace recob {
      * The data is pushed as the new last element of the collection.
      *
      * Data is copied or moved depending on which variant of this method is
-     * used.
+     * used. Either way, each vector is appended in a single operation.
      *
      * No exception safety is offered here.
      */
@@ -306,11 +388,20 @@ namespace recob {
       );
     //@}
 
+    /**
+     * @brief Prepares the collection to host at least `n` space points.
+     *
+     * A good estimation of the final number of space points avoids
+     * reallocations of the collections.
+     */
+    void reserve(std::size_t n);
+
     /**
      * @brief Puts all data products into the event, leaving the creator
      *        `empty()`.
      *
-     * The accumulated data is moved into the event.
+     * The buffers are merged first (see `mergeBuffers()`), then the
+     * accumulated data is moved into the event.
      *
      * This is the last valid action of the object.
      * After this, only `empty()`, `spent()` and the _art_ pointer makers
@@ -323,17 +414,56 @@ namespace recob {
     //--- END Insertion and finish operations --------------------------------
 
 
+    //--- BEGIN Buffer management ----------------------------------------------
+    /// @{
+    /// @name Buffer management
+
+    /**
+     * @brief Creates `n` empty buffers, replacing the existing ones.
+     * @param n number of buffers
+     *
+     * Data in the existing buffers which was not merged yet is lost.
+     * This call is not thread-safe, and it invalidates all references to the
+     * existing buffers.
+     */
+    void makeBuffers(std::size_t n);
+
+    /// Returns the number of buffers.
+    std::size_t nBuffers() const { return fBuffers.size(); }
+
+    /// Returns the buffer with index `i` (no check is performed).
+    Buffer& buffer(std::size_t i) { return fBuffers[i]; }
+
+    /// Returns the buffer with index `i` (no check is performed).
+    Buffer const& buffer(std::size_t i) const { return fBuffers[i]; }
+
+    /**
+     * @brief Appends the content of all buffers to the collection.
+     *
+     * The buffers are appended in order, and left empty: more data can be
+     * added to them and it will be appended on the next merge.
+     * This function is not thread-safe.
+     */
+    void mergeBuffers();
+
+    /// @}
+    //--- END Buffer management ------------------------------------------------
+
+
     //--- BEGIN Queries and operations -----------------------------------------
     /// @{
     /// @name Queries and operations
 
-    /// Returns whether there are currently no space points in the collection.
+    /// Returns whether there are currently no space points in the collection
+    /// (data still in the buffers is not included, as in `size()`).
     bool empty() const { return spent() || fSpacePoints->empty(); }
 
-    /// Returns the number of space points currently in the collection.
+    /// Returns the number of space points currently in the collection
+    /// (data still in the buffers is not included).
     std::size_t size() const { return spent()? 0U: fSpacePoints->size(); }
 
-    /// Removes all data from the collection, making it `empty()`.
+    /// Removes all data from the collection and the buffers, making it
+    /// `empty()`.
     void clear();
 
     /// Returns whether `put()` has already been called.
@@ -429,6 +559,8 @@ namespace recob {
     std::unique_ptr<std::vector<recob::PointCharge>> fCharges;
     /// Charge pointer maker.
     std::unique_ptr<art::PtrMaker<recob::PointCharge>> fChargePtrMaker;
+    /// Buffers waiting to be merged.
+    std::vector<Buffer> fBuffers;
 
     /// Returns the index of the last element (undefined if empty).
     std::size_t lastIndex() const { return size() - 1U; }
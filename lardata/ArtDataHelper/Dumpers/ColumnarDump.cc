@@ -0,0 +1,258 @@
+/**
+ * @file   lardata/ArtDataHelper/Dumpers/ColumnarDump.cc
+ * @brief  Binary column files for fast dumps of event data - implementation
+ * @date   October 18, 2026
+ * @see    ColumnarDump.h
+ */
+
+// library header
+#include "lardata/ArtDataHelper/Dumpers/ColumnarDump.h"
+
+// framework libraries
+#include "cetlib_except/exception.h"
+
+// C/C++ standard libraries
+#include <algorithm> // std::any_of(), std::find_if()
+
+
+namespace {
+
+  /// Signature at the beginning of each file.
+  constexpr char FileSignature[8]
+    = { 'L', 'A', 'R', 'C', 'O', 'L', '0', '1' };
+
+  /// Signature at the beginning of each table.
+  constexpr char TableSignature[4] = { 'T', 'A', 'B', 'L' };
+
+} // local namespace
+
+
+//------------------------------------------------------------------------------
+std::size_t recob::dumper::columnTypeSize(ColumnType_t type) {
+  switch (type) {
+    case ColumnType_t::Int16:  return sizeof(std::int16_t);
+    case ColumnType_t::UInt16: return sizeof(std::uint16_t);
+    case ColumnType_t::Int32:  return sizeof(std::int32_t);
+    case ColumnType_t::UInt32: return sizeof(std::uint32_t);
+    case ColumnType_t::Int64:  return sizeof(std::int64_t);
+    case ColumnType_t::UInt64: return sizeof(std::uint64_t);
+    case ColumnType_t::Float:  return sizeof(float);
+    case ColumnType_t::Double: return sizeof(double);
+  } // switch
+  throw cet::exception("ColumnarDump")
+    << "Unknown column type code " << static_cast<int>(type) << "\n";
+} // recob::dumper::columnTypeSize()
+
+
+//------------------------------------------------------------------------------
+std::string recob::dumper::columnTypeName(ColumnType_t type) {
+  switch (type) {
+    case ColumnType_t::Int16:  return "int16";
+    case ColumnType_t::UInt16: return "uint16";
+    case ColumnType_t::Int32:  return "int32";
+    case ColumnType_t::UInt32: return "uint32";
+    case ColumnType_t::Int64:  return "int64";
+    case ColumnType_t::UInt64: return "uint64";
+    case ColumnType_t::Float:  return "float";
+    case ColumnType_t::Double: return "double";
+  } // switch
+  return "<unknown (#" + std::to_string(static_cast<int>(type)) + ")>";
+} // recob::dumper::columnTypeName()
+
+
+//------------------------------------------------------------------------------
+//--- recob::dumper::ColumnarDumpWriter
+//------------------------------------------------------------------------------
+recob::dumper::ColumnarDumpWriter::ColumnarDumpWriter
+  (std::string const& path, std::size_t bufferSize /* = DefaultBufferSize */)
+  : fPath(path)
+  , fBuffer(bufferSize)
+{
+  // the buffer must be set before the file is opened
+  if (!fBuffer.empty())
+    fOut.rdbuf()->pubsetbuf(fBuffer.data(), fBuffer.size());
+  fOut.open(fPath, std::ios::binary | std::ios::trunc);
+  if (!fOut) {
+    throw cet::exception("ColumnarDump")
+      << "Can't open '" << fPath << "' for writing.\n";
+  }
+  writeRaw(FileSignature, sizeof(FileSignature));
+} // recob::dumper::ColumnarDumpWriter::ColumnarDumpWriter()
+
+
+//------------------------------------------------------------------------------
+recob::dumper::ColumnarDumpWriter::~ColumnarDumpWriter() {
+  // no exceptions from a destructor: an incomplete table will be detected
+  // by the reader as a truncated file
+  fOut.flush();
+} // recob::dumper::ColumnarDumpWriter::~ColumnarDumpWriter()
+
+
+//------------------------------------------------------------------------------
+void recob::dumper::ColumnarDumpWriter::beginTable(
+  std::string const& name,
+  std::uint32_t run, std::uint32_t subRun, std::uint32_t event,
+  std::uint64_t nRows, std::uint32_t nColumns
+) {
+  if (fMissingColumns > 0U) {
+    throw cet::exception("ColumnarDump")
+      << "New table '" << name << "' started while the previous one in '"
+      << fPath << "' still misses " << fMissingColumns << " columns.\n";
+  }
+
+  writeRaw(TableSignature, sizeof(TableSignature));
+  writeString(name);
+  writeValue(run);
+  writeValue(subRun);
+  writeValue(event);
+  writeValue(nRows);
+  writeValue(nColumns);
+  fMissingColumns = nColumns;
+
+} // recob::dumper::ColumnarDumpWriter::beginTable()
+
+
+//------------------------------------------------------------------------------
+void recob::dumper::ColumnarDumpWriter::flush() {
+  if (!fOut.flush()) {
+    throw cet::exception("ColumnarDump")
+      << "Error while writing into '" << fPath << "'.\n";
+  }
+} // recob::dumper::ColumnarDumpWriter::flush()
+
+
+//------------------------------------------------------------------------------
+void recob::dumper::ColumnarDumpWriter::writeColumnHeader
+  (std::string const& name, ColumnType_t type, std::uint64_t n)
+{
+  if (fMissingColumns == 0U) {
+    throw cet::exception("ColumnarDump")
+      << "Column '" << name << "' written to '" << fPath
+      << "' beyond the number declared for its table.\n";
+  }
+  --fMissingColumns;
+
+  writeString(name);
+  writeValue(static_cast<std::uint8_t>(type));
+  writeValue(n);
+
+} // recob::dumper::ColumnarDumpWriter::writeColumnHeader()
+
+
+//------------------------------------------------------------------------------
+void recob::dumper::ColumnarDumpWriter::writeString(std::string const& s) {
+  writeValue(static_cast<std::uint32_t>(s.length()));
+  writeRaw(s.data(), s.length());
+} // recob::dumper::ColumnarDumpWriter::writeString()
+
+
+//------------------------------------------------------------------------------
+void recob::dumper::ColumnarDumpWriter::writeRaw
+  (void const* data, std::size_t size)
+{
+  if (fOut.write(static_cast<char const*>(data), size)) return;
+  throw cet::exception("ColumnarDump")
+    << "Error while writing into '" << fPath << "'.\n";
+} // recob::dumper::ColumnarDumpWriter::writeRaw()
+
+
+//------------------------------------------------------------------------------
+//--- recob::dumper::ColumnarDumpReader
+//------------------------------------------------------------------------------
+bool recob::dumper::ColumnarDumpReader::Table::hasColumn
+  (std::string const& columnName) const
+{
+  return std::any_of(columns.begin(), columns.end(),
+    [&columnName](Column const& c){ return c.name == columnName; });
+} // recob::dumper::ColumnarDumpReader::Table::hasColumn()
+
+
+//------------------------------------------------------------------------------
+auto recob::dumper::ColumnarDumpReader::Table::column
+  (std::string const& columnName) const -> Column const&
+{
+  auto const iColumn = std::find_if(columns.begin(), columns.end(),
+    [&columnName](Column const& c){ return c.name == columnName; });
+  if (iColumn != columns.end()) return *iColumn;
+  throw cet::exception("ColumnarDump")
+    << "Table '" << name << "' has no column '" << columnName << "'.\n";
+} // recob::dumper::ColumnarDumpReader::Table::column()
+
+
+//------------------------------------------------------------------------------
+recob::dumper::ColumnarDumpReader::ColumnarDumpReader(std::string const& path)
+  : fPath(path)
+  , fIn(path, std::ios::binary)
+{
+  if (!fIn) {
+    throw cet::exception("ColumnarDump")
+      << "Can't open '" << fPath << "' for reading.\n";
+  }
+  char signature[sizeof(FileSignature)];
+  readRaw(signature, sizeof(signature));
+  if (!std::equal(signature, signature + sizeof(signature), FileSignature)) {
+    throw cet::exception("ColumnarDump")
+      << "'" << fPath << "' is not a column dump file.\n";
+  }
+} // recob::dumper::ColumnarDumpReader::ColumnarDumpReader()
+
+
+//------------------------------------------------------------------------------
+bool recob::dumper::ColumnarDumpReader::next(Table& table) {
+
+  char signature[sizeof(TableSignature)];
+  // a clean end of file is allowed only before a new table
+  if (fIn.peek() == std::ifstream::traits_type::eof()) return false;
+  readRaw(signature, sizeof(signature));
+  if (!std::equal(signature, signature + sizeof(signature), TableSignature)) {
+    throw cet::exception("ColumnarDump")
+      << "Corrupted table found in '" << fPath << "'.\n";
+  }
+
+  table.name = readString();
+  table.run = readValue<std::uint32_t>();
+  table.subRun = readValue<std::uint32_t>();
+  table.event = readValue<std::uint32_t>();
+  table.nRows = readValue<std::uint64_t>();
+  auto const nColumns = readValue<std::uint32_t>();
+
+  table.columns.resize(nColumns);
+  for (Column& column: table.columns) {
+    column.name = readString();
+    column.type = static_cast<ColumnType_t>(readValue<std::uint8_t>());
+    auto const n = readValue<std::uint64_t>();
+    column.data.resize(n * columnTypeSize(column.type));
+    readRaw(column.data.data(), column.data.size());
+  } // for columns
+
+  return true;
+} // recob::dumper::ColumnarDumpReader::next()
+
+
+//------------------------------------------------------------------------------
+std::string recob::dumper::ColumnarDumpReader::readString() {
+  std::string s(readValue<std::uint32_t>(), '\0');
+  readRaw(s.data(), s.length());
+  return s;
+} // recob::dumper::ColumnarDumpReader::readString()
+
+
+//------------------------------------------------------------------------------
+void recob::dumper::ColumnarDumpReader::readRaw(void* data, std::size_t size) {
+  if (fIn.read(static_cast<char*>(data), size)) return;
+  throw cet::exception("ColumnarDump")
+    << "File '" << fPath << "' is truncated.\n";
+} // recob::dumper::ColumnarDumpReader::readRaw()
+
+
+//------------------------------------------------------------------------------
+void recob::dumper::ColumnarDumpReader::throwTypeMismatch
+  (Column const& column, ColumnType_t requested)
+{
+  throw cet::exception("ColumnarDump")
+    << "Column '" << column.name << "' holds " << columnTypeName(column.type)
+    << " values, not " << columnTypeName(requested) << ".\n";
+} // recob::dumper::ColumnarDumpReader::throwTypeMismatch()
+
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,333 @@
+/**
+ * @file   lardata/ArtDataHelper/Dumpers/ColumnarDump.h
+ * @brief  Binary column files for fast dumps of event data
+ * @date   October 18, 2026
+ * @see    ColumnarDump.cc
+ *
+ * The text dumps of the dumper modules are meant for humans. For validation
+ * of large events (comparing the output of two releases, or of two
+ * configurations) they are slow to write and to compare. The dumper modules
+ * supporting it can instead write their data into a _column file_, where
+ * each data product of each event is stored as a table, and each field of
+ * the objects as a contiguous array of values (a column). Two files can then
+ * be compared one column at a time with `ColumnarDumpReader`.
+ *
+ * File layout (native byte order):
+ * * file signature: the 8 characters `LARCOL01`
+ * * any number of tables, each made of:
+ *     * table signature: the 4 characters `TABL`
+ *     * table name: 32-bit unsigned length, followed by the characters
+ *     * run, subrun and event number: 32-bit unsigned integers
+ *     * number of rows (64-bit unsigned) and of columns (32-bit unsigned)
+ *     * each column: name (like the table name), type code (8-bit, see
+ *       `ColumnType_t`), number of values (64-bit unsigned) and the values
+ *
+ * Columns in the same table may have different lengths: data with a variable
+ * number of values per object (e.g. the samples of a waveform) is stored as
+ * a single column with all the values, plus a column with the number of
+ * values of each object.
+ */
+
+#ifndef LARDATA_ARTDATAHELPER_DUMPERS_COLUMNARDUMP_H
+#define LARDATA_ARTDATAHELPER_DUMPERS_COLUMNARDUMP_H 1
+
+// C/C++ standard libraries
+#include <fstream>
+#include <string>
+#include <vector>
+#include <type_traits> // std::decay_t
+#include <cstring> // std::memcpy()
+#include <cstdint> // std::uint8_t, ...
+#include <cstddef> // std::size_t
+
+
+namespace recob {
+  namespace dumper {
+
+    /// Type of the values in a column.
+    enum class ColumnType_t: std::uint8_t {
+      Int16, UInt16, Int32, UInt32, Int64, UInt64, Float, Double
+    }; // ColumnType_t
+
+    /// Trait: `ColumnTypeOf<T>::value` is the column type code of `T`.
+    template <typename T> struct ColumnTypeOf;
+    template <> struct ColumnTypeOf<std::int16_t>
+      { static constexpr ColumnType_t value = ColumnType_t::Int16; };
+    template <> struct ColumnTypeOf<std::uint16_t>
+      { static constexpr ColumnType_t value = ColumnType_t::UInt16; };
+    template <> struct ColumnTypeOf<std::int32_t>
+      { static constexpr ColumnType_t value = ColumnType_t::Int32; };
+    template <> struct ColumnTypeOf<std::uint32_t>
+      { static constexpr ColumnType_t value = ColumnType_t::UInt32; };
+    template <> struct ColumnTypeOf<std::int64_t>
+      { static constexpr ColumnType_t value = ColumnType_t::Int64; };
+    template <> struct ColumnTypeOf<std::uint64_t>
+      { static constexpr ColumnType_t value = ColumnType_t::UInt64; };
+    template <> struct ColumnTypeOf<float>
+      { static constexpr ColumnType_t value = ColumnType_t::Float; };
+    template <> struct ColumnTypeOf<double>
+      { static constexpr ColumnType_t value = ColumnType_t::Double; };
+
+    /// Returns the size in bytes of a value of the specified type.
+    std::size_t columnTypeSize(ColumnType_t type);
+
+    /// Returns the name of the specified type (`"float"`, `"int32"`, ...).
+    std::string columnTypeName(ColumnType_t type);
+
+
+    //--------------------------------------------------------------------------
+    /**
+     * @brief Writes tables of columns into a binary file.
+     *
+     * Each table is written with a `beginTable()` call, which declares how
+     * many columns will follow, and that many `writeColumn()` calls.
+     * Each column is written with a single call to the output stream, which
+     * is buffered with a large buffer.
+     *
+     * Example:
+     * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~{.cpp}
+     * recob::dumper::ColumnarDumpWriter out("hits.lcol");
+     *
+     * out.beginTable("gaushit", run, subRun, event, hits.size(), 2U);
+     * out.writeColumn("channel", channels); // std::vector<std::uint32_t>
+     * out.writeColumn("peakTime", peakTimes); // std::vector<float>
+     * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+     *
+     * Errors are reported by throwing `cet::exception` (category
+     * `"ColumnarDump"`).
+     */
+    class ColumnarDumpWriter {
+        public:
+
+      /// Default size of the output buffer [bytes]
+      static constexpr std::size_t DefaultBufferSize = 4U << 20;
+
+      /// Creates (or overwrites) the file at `path` and writes its signature.
+      explicit ColumnarDumpWriter
+        (std::string const& path, std::size_t bufferSize = DefaultBufferSize);
+
+      /// Flushes the file (an incomplete table is left truncated).
+      ~ColumnarDumpWriter();
+
+      /**
+       * @brief Starts a new table.
+       * @param name name of the table (e.g. the tag of the data product)
+       * @param run run number of the event the table belongs to
+       * @param subRun subrun number of the event the table belongs to
+       * @param event number of the event the table belongs to
+       * @param nRows number of objects in the table
+       * @param nColumns number of columns that will follow
+       * @throw cet::exception if the previous table is not complete yet
+       */
+      void beginTable(
+        std::string const& name,
+        std::uint32_t run, std::uint32_t subRun, std::uint32_t event,
+        std::uint64_t nRows, std::uint32_t nColumns
+        );
+
+      //@{
+      /**
+       * @brief Writes a column of the current table.
+       * @tparam T type of the values (one supported by `ColumnTypeOf`)
+       * @param name name of the column
+       * @param values pointer to the first value
+       * @param n number of values
+       * @throw cet::exception if all the declared columns were already written
+       */
+      template <typename T>
+      void writeColumn(std::string const& name, T const* values, std::size_t n)
+        {
+          writeColumnHeader(name, ColumnTypeOf<T>::value, n);
+          writeRaw(values, n * sizeof(T));
+        }
+
+      template <typename T>
+      void writeColumn(std::string const& name, std::vector<T> const& values)
+        { writeColumn(name, values.data(), values.size()); }
+      //@}
+
+      /**
+       * @brief Writes a column with a value from each of the `objects`.
+       * @tparam Coll type of collection of objects
+       * @tparam Getter type of callable returning the value from an object
+       * @param name name of the column
+       * @param objects the objects to extract the values from
+       * @param getter callable returning the value for one object
+       *
+       * The type of the column is the one returned by `getter`, which must be
+       * supported by `ColumnTypeOf` (enumerators should be converted).
+       */
+      template <typename Coll, typename Getter>
+      void writeColumnOf
+        (std::string const& name, Coll const& objects, Getter getter);
+
+      /// Writes all the buffered data into the file.
+      void flush();
+
+        private:
+      std::string fPath; ///< Path of the output file.
+      std::vector<char> fBuffer; ///< Buffer of the output stream.
+      std::ofstream fOut; ///< Output stream.
+
+      std::uint32_t fMissingColumns = 0U; ///< Columns to go in current table.
+
+      /// Writes the header of a column, checking the table is not complete.
+      void writeColumnHeader
+        (std::string const& name, ColumnType_t type, std::uint64_t n);
+
+      /// Writes a string (length and characters).
+      void writeString(std::string const& s);
+
+      /// Writes `size` bytes from `data`, throwing on failure.
+      void writeRaw(void const* data, std::size_t size);
+
+      /// Writes the binary content of `value`.
+      template <typename T>
+      void writeValue(T value) { writeRaw(&value, sizeof(value)); }
+
+    }; // class ColumnarDumpWriter
+
+
+    //--------------------------------------------------------------------------
+    /**
+     * @brief Reads the tables from a file written by `ColumnarDumpWriter`.
+     *
+     * Tables are read one at a time, in order:
+     * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~{.cpp}
+     * recob::dumper::ColumnarDumpReader in("hits.lcol");
+     * recob::dumper::ColumnarDumpReader::Table table;
+     * while (in.next(table)) {
+     *   std::vector<float> const peakTimes
+     *     = table.column("peakTime").values<float>();
+     *   // ...
+     * }
+     * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+     * Tables and columns can be compared with `==`, which compares the stored
+     * values bit by bit.
+     *
+     * Errors are reported by throwing `cet::exception` (category
+     * `"ColumnarDump"`).
+     */
+    class ColumnarDumpReader {
+        public:
+
+      /// A column: its name, the type and the raw content.
+      struct Column {
+        std::string name; ///< Name of the column.
+        ColumnType_t type = ColumnType_t::Int32; ///< Type of the values.
+        std::vector<char> data; ///< Values, as raw bytes.
+
+        /// Returns the number of values in the column.
+        std::size_t size() const { return data.size() / columnTypeSize(type); }
+
+        /// Returns a copy of the values; throws if `T` is not the right type.
+        template <typename T>
+        std::vector<T> values() const;
+
+        bool operator== (Column const& other) const
+          {
+            return (name == other.name) && (type == other.type)
+              && (data == other.data);
+          }
+        bool operator!= (Column const& other) const
+          { return !(*this == other); }
+
+      }; // struct Column
+
+      /// A table: its name and event information, and all its columns.
+      struct Table {
+        std::string name; ///< Name of the table.
+        std::uint32_t run = 0U; ///< Run number of the event.
+        std::uint32_t subRun = 0U; ///< Subrun number of the event.
+        std::uint32_t event = 0U; ///< Event number.
+        std::uint64_t nRows = 0U; ///< Number of objects in the table.
+        std::vector<Column> columns; ///< All the columns.
+
+        /// Returns whether the table has a column with the specified name.
+        bool hasColumn(std::string const& columnName) const;
+
+        /// Returns the column with the specified name; throws if not present.
+        Column const& column(std::string const& columnName) const;
+
+        bool operator== (Table const& other) const
+          {
+            return (name == other.name) && (run == other.run)
+              && (subRun == other.subRun) && (event == other.event)
+              && (nRows == other.nRows) && (columns == other.columns);
+          }
+        bool operator!= (Table const& other) const
+          { return !(*this == other); }
+
+      }; // struct Table
+
+
+      /// Opens the file at `path` and checks its signature.
+      explicit ColumnarDumpReader(std::string const& path);
+
+      /**
+       * @brief Reads the next table from the file.
+       * @param table the object to be filled with the new table
+       * @return whether a table was read (`false` at the end of the file)
+       * @throw cet::exception if the file is corrupted or truncated
+       */
+      bool next(Table& table);
+
+        private:
+      std::string fPath; ///< Path of the input file.
+      std::ifstream fIn; ///< Input stream.
+
+      /// Reads a string (length and characters).
+      std::string readString();
+
+      /// Reads `size` bytes into `data`, throwing on failure.
+      void readRaw(void* data, std::size_t size);
+
+      /// Reads the binary content of a value of type `T`.
+      template <typename T>
+      T readValue() { T value; readRaw(&value, sizeof(value)); return value; }
+
+      /// Throws an exception about a type mismatch.
+      [[noreturn]] static void throwTypeMismatch
+        (Column const& column, ColumnType_t requested);
+
+    }; // class ColumnarDumpReader
+
+
+  } // namespace dumper
+} // namespace recob
+
+
+//==============================================================================
+//=== template implementation
+//===
+template <typename Coll, typename Getter>
+void recob::dumper::ColumnarDumpWriter::writeColumnOf
+  (std::string const& name, Coll const& objects, Getter getter)
+{
+  using Value_t = std::decay_t<decltype(getter(*(objects.begin())))>;
+
+  std::vector<Value_t> values;
+  values.reserve(objects.size());
+  for (auto const& obj: objects) values.push_back(getter(obj));
+  writeColumn(name, values);
+
+} // recob::dumper::ColumnarDumpWriter::writeColumnOf()
+
+
+//------------------------------------------------------------------------------
+template <typename T>
+std::vector<T> recob::dumper::ColumnarDumpReader::Column::values() const {
+
+  constexpr ColumnType_t requested = ColumnTypeOf<T>::value;
+  if (type != requested) throwTypeMismatch(*this, requested);
+
+  std::vector<T> v(size());
+  if (!data.empty()) std::memcpy(v.data(), data.data(), data.size());
+  return v;
+
+} // recob::dumper::ColumnarDumpReader::Column::values()
+
+
+//------------------------------------------------------------------------------
+
+#endif // LARDATA_ARTDATAHELPER_DUMPERS_COLUMNARDUMP_H
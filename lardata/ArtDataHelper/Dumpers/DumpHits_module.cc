@@ -7,6 +7,7 @@
 
 // C//C++ standard libraries
 #include <string>
+#include <memory> // std::unique_ptr<>
 
 // support libraries
 #include "fhiclcpp/types/Atom.h"
@@ -20,6 +21,10 @@
 #include "canvas/Persistency/Common/FindOne.h"
 #include "canvas/Utilities/InputTag.h"
 
+// LArSoft libraries
+#include "lardata/ArtDataHelper/Dumpers/ColumnarDump.h"
+#include "lardataobj/RecoBase/Hit.h"
+
 // ... plus see below ...
 
 namespace hit {
@@ -41,6 +46,10 @@ namespace hit {
    *   that the associated wire are on the same channel as the hit
    * - *CheckRawDigitAssociation* (string, default: false): if set, verifies
    *   that the associated raw digits are on the same channel as the hit
+   * - *ColumnarOutput* (string, default: empty): if set, the hits are written
+   *   into a binary column file with this path (see
+   *   `recob::dumper::ColumnarDumpWriter`), one table per event, instead of
+   *   being printed
    *
    */
   class DumpHits: public art::EDAnalyzer {
@@ -73,6 +82,12 @@ namespace hit {
         false
         }; // CheckWireAssociation
 
+      fhicl::Atom<std::string> ColumnarOutput{
+        Name("ColumnarOutput"),
+        Comment("write hits into this binary column file instead of printing them"),
+        ""
+        };
+
     }; // Config
 
     using Parameters = art::EDAnalyzer::Table<Config>;
@@ -91,6 +106,13 @@ namespace hit {
     bool bCheckRawDigits;           ///< check associations with raw digits
     bool bCheckWires;               ///< check associations with wires
 
+    /// Column file output (if enabled).
+    std::unique_ptr<recob::dumper::ColumnarDumpWriter> fColumnarOutput;
+
+    /// Writes all the hits as a table into the column file.
+    void WriteColumns
+      (art::Event const& evt, std::vector<recob::Hit> const& hits);
+
   }; // class DumpHits
 
 } // namespace hit
@@ -100,7 +122,7 @@ namespace hit {
 //---  module implementation
 //---
 // C//C++ standard libraries
-#include <memory> // std::unique_ptr<>
+#include <cstdint> // std::int32_t
 
 // support libraries
 #include "messagefacility/MessageLogger/MessageLogger.h"
@@ -110,7 +132,6 @@ namespace hit {
 
 // LArSoft includes
 #include "larcoreobj/SimpleTypesAndConstants/RawTypes.h" // raw::ChannelID_t
-#include "lardataobj/RecoBase/Hit.h"
 #include "lardataobj/RecoBase/Wire.h"
 #include "lardataobj/RawData/RawDigit.h"
 
@@ -124,7 +145,12 @@ namespace hit {
     , fOutputCategory    (config().OutputCategory())
     , bCheckRawDigits    (config().CheckRawDigitAssociation())
     , bCheckWires        (config().CheckWireAssociation())
-    {}
+    {
+      if (!config().ColumnarOutput().empty()) {
+        fColumnarOutput = std::make_unique<recob::dumper::ColumnarDumpWriter>
+          (config().ColumnarOutput());
+      }
+    }
 
 
   //-------------------------------------------------
@@ -158,12 +184,16 @@ namespace hit {
       }
     } // if check wires
 
+    if (fColumnarOutput) WriteColumns(evt, *Hits);
+
     unsigned int iHit = 0;
     for (const recob::Hit& hit: *Hits) {
 
       // print a header for the cluster
-      mf::LogVerbatim(fOutputCategory)
-        << "Hit #" << iHit << ": " << hit;
+      if (!fColumnarOutput) {
+        mf::LogVerbatim(fOutputCategory)
+          << "Hit #" << iHit << ": " << hit;
+      }
 
       if (HitToRawDigit) {
         raw::ChannelID_t assChannelID = HitToRawDigit->at(iHit).ref().Channel();
@@ -190,6 +220,59 @@ namespace hit {
 
   } // DumpHits::analyze()
 
+
+  //-------------------------------------------------
+  void DumpHits::WriteColumns
+    (art::Event const& evt, std::vector<recob::Hit> const& hits)
+  {
+    using recob::Hit;
+    auto& out = *fColumnarOutput;
+
+    out.beginTable(fHitsModuleLabel.encode(),
+      evt.run(), evt.subRun(), evt.event(), hits.size(), 20U);
+    out.writeColumnOf("channel", hits,
+      [](Hit const& hit){ return hit.Channel(); });
+    out.writeColumnOf("cryostat", hits,
+      [](Hit const& hit){ return hit.WireID().Cryostat; });
+    out.writeColumnOf("tpc", hits,
+      [](Hit const& hit){ return hit.WireID().TPC; });
+    out.writeColumnOf("plane", hits,
+      [](Hit const& hit){ return hit.WireID().Plane; });
+    out.writeColumnOf("wire", hits,
+      [](Hit const& hit){ return hit.WireID().Wire; });
+    out.writeColumnOf("view", hits,
+      [](Hit const& hit){ return static_cast<std::int32_t>(hit.View()); });
+    out.writeColumnOf("signalType", hits,
+      [](Hit const& hit){ return static_cast<std::int32_t>(hit.SignalType()); });
+    out.writeColumnOf("startTick", hits,
+      [](Hit const& hit){ return hit.StartTick(); });
+    out.writeColumnOf("endTick", hits,
+      [](Hit const& hit){ return hit.EndTick(); });
+    out.writeColumnOf("peakTime", hits,
+      [](Hit const& hit){ return hit.PeakTime(); });
+    out.writeColumnOf("sigmaPeakTime", hits,
+      [](Hit const& hit){ return hit.SigmaPeakTime(); });
+    out.writeColumnOf("RMS", hits,
+      [](Hit const& hit){ return hit.RMS(); });
+    out.writeColumnOf("peakAmplitude", hits,
+      [](Hit const& hit){ return hit.PeakAmplitude(); });
+    out.writeColumnOf("sigmaPeakAmplitude", hits,
+      [](Hit const& hit){ return hit.SigmaPeakAmplitude(); });
+    out.writeColumnOf("summedADC", hits,
+      [](Hit const& hit){ return hit.SummedADC(); });
+    out.writeColumnOf("integral", hits,
+      [](Hit const& hit){ return hit.Integral(); });
+    out.writeColumnOf("sigmaIntegral", hits,
+      [](Hit const& hit){ return hit.SigmaIntegral(); });
+    out.writeColumnOf("multiplicity", hits,
+      [](Hit const& hit){ return hit.Multiplicity(); });
+    out.writeColumnOf("localIndex", hits,
+      [](Hit const& hit){ return hit.LocalIndex(); });
+    out.writeColumnOf("goodnessOfFit", hits,
+      [](Hit const& hit){ return hit.GoodnessOfFit(); });
+
+  } // DumpHits::WriteColumns()
+
   DEFINE_ART_MODULE(DumpHits)
 
 } // namespace hit
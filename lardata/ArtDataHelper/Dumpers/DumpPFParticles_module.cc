@@ -51,6 +51,10 @@ namespace recob {
    *   `ProcessName_ModuleLabel_InstanceName_Run#_Subrun#_Event#_particles.dot`,
    *   where the the input label elements refer to the data product being
    *   plotted.
+   * - *NThreads* (unsigned int, default: `1`): number of threads formatting the
+   *   particles; the output is still printed in the same order as with a
+   *   single thread (`0` uses one thread per core; `1` formats everything in
+   *   the art thread)
    *
    *
    * Particle connection graphs
@@ -163,6 +167,12 @@ namespace recob {
         false
       };
 
+      fhicl::Atom<unsigned int> NThreads {
+        Name("NThreads"),
+        Comment("number of threads formatting the output (0: one per core)"),
+        1U
+      };
+
     }; // struct Config
 
     using Parameters = art::EDAnalyzer::Table<Config>;
@@ -180,6 +190,7 @@ namespace recob {
     bool fPrintHexFloats; ///< whether to print floats in base 16
     unsigned int fMaxDepth; ///< maximum generation to print (0: only primaries)
     bool fMakeEventGraphs; ///< whether to create one DOT file per event
+    unsigned int fNThreads; ///< number of threads formatting the output
 
 
     static std::string DotFileName
@@ -215,9 +226,11 @@ namespace recob {
 
 // support libraries
 #include "messagefacility/MessageLogger/MessageLogger.h"
+#include "lardata/ArtDataHelper/Dumpers/OrderedParallelDump.h"
 
 // C//C++ standard libraries
 #include <fstream>
+#include <ostream>
 #include <utility> // std::swap()
 #include <algorithm> // std::count(), std::find()
 #include <limits> // std::numeric_limits<>
@@ -332,6 +345,14 @@ namespace {
   } // hasDaughter()
 
 
+  //----------------------------------------------------------------------------
+  /// Output stream discarding all the output.
+  struct NullStream {
+    template <typename T>
+    NullStream& operator<< (T const&) { return *this; }
+  }; // NullStream
+
+
   //----------------------------------------------------------------------------
   class ParticleDumper {
       public:
@@ -406,14 +427,24 @@ namespace {
       ) const;
 
 
-    /// Dumps all primary particles
-    void DumpAllPrimaries(std::string indentstr = "") const;
-
-
     /// Dumps all particles in the input list
     void DumpAllParticles(std::string indentstr = "") const;
 
 
+    /**
+     * @brief Dumps all particles in the input list, formatting on many threads
+     * @param indentstr indentation string
+     * @param nThreads number of formatting threads (0: one per core)
+     *
+     * The output is the same as `DumpAllParticles(indentstr)`.
+     * The particle tree is first explored without printing anything, to learn
+     * which particles are printed from which primary one; then each message
+     * (usually a primary particle with all its descendents) is formatted
+     * independently, and they are all printed in the original order.
+     */
+    void DumpAllParticles(std::string indentstr, unsigned int nThreads) const;
+
+
     template <typename Stream>
     static void DumpPDGID(Stream&& out, int ID);
 
@@ -447,6 +478,130 @@ namespace {
     int_map<size_t> const particle_map; ///< fast lookup index by particle ID
 
 
+    /**
+     * @brief Provides the number of dumps of each particle
+     *
+     * The counter normally updates the count in `visited`, optionally
+     * recording each value it returns in a log; alternatively, it returns
+     * the values from such a log, in the same order they were recorded.
+     */
+    class VisitCounter {
+        public:
+      /// Counts in `visits`, and records the counts in `log` (if not null)
+      VisitCounter
+        (std::vector<unsigned int>& visits, std::vector<unsigned int>* log)
+        : fVisits(&visits), fLog(log)
+        {}
+
+      /// Replays the counts starting at `replay`
+      VisitCounter(unsigned int const* replay): fReplay(replay) {}
+
+      /// Counts a new dump of the particle and returns its number of dumps
+      unsigned int visit(size_t iPart)
+        { return fReplay? *(fReplay++): record(++((*fVisits)[iPart])); }
+
+      /// Returns the current number of dumps of the particle
+      unsigned int count(size_t iPart)
+        { return fReplay? *(fReplay++): record((*fVisits)[iPart]); }
+
+        private:
+      std::vector<unsigned int>* fVisits = nullptr; ///< counts
+      std::vector<unsigned int>* fLog = nullptr; ///< record of counts
+      unsigned int const* fReplay = nullptr; ///< next count to replay
+
+      unsigned int record(unsigned int n)
+        { if (fLog) fLog->push_back(n); return n; }
+
+    }; // VisitCounter
+
+
+    /// A message of the dump: either a particle tree, or a text
+    struct DumpItem_t {
+      size_t iPart = 0; ///< index of the particle to be dumped
+      std::string indentstr; ///< indentation string (for particles)
+      std::string message; ///< text of the message, if not a particle
+      size_t firstVisit = 0; ///< first visit count in the log (for particles)
+      bool isParticle = true; ///< whether this is a particle
+    }; // DumpItem_t
+
+
+    /// Receives the output of `DumpAllParticlesTo()` and prints it
+    class LogSink {
+        public:
+      LogSink(ParticleDumper const& dumper): fDumper(dumper) {}
+
+      void particle(size_t iPart, std::string const& indentstr)
+        {
+          fDumper.DumpParticle(
+            mf::LogVerbatim(fDumper.options.streamName),
+            iPart, indentstr, fDumper.options.maxDepth
+            );
+        }
+
+      void message(std::string const& text)
+        { mf::LogVerbatim(fDumper.options.streamName) << text; }
+
+        private:
+      ParticleDumper const& fDumper;
+    }; // LogSink
+
+
+    /// Receives the output of `DumpAllParticlesTo()` and just records it
+    class PlanSink {
+        public:
+      std::vector<DumpItem_t> items; ///< all the messages, in order
+      std::vector<unsigned int> visits; ///< log of all the visit counts
+
+      PlanSink(ParticleDumper const& dumper): fDumper(dumper) {}
+
+      void particle(size_t iPart, std::string const& indentstr)
+        {
+          DumpItem_t item;
+          item.iPart = iPart;
+          item.indentstr = indentstr;
+          item.firstVisit = visits.size();
+          VisitCounter counter(fDumper.visited, &visits);
+          fDumper.DumpParticle
+            (NullStream(), iPart, indentstr, fDumper.options.maxDepth, counter);
+          items.push_back(std::move(item));
+        }
+
+      void message(std::string const& text)
+        {
+          DumpItem_t item;
+          item.message = text;
+          item.isParticle = false;
+          items.push_back(std::move(item));
+        }
+
+        private:
+      ParticleDumper const& fDumper;
+    }; // PlanSink
+
+
+    /// Dump a particle, taking the number of dumps from the counter
+    template <typename Stream>
+    void DumpParticle(
+      Stream&& out, size_t iPart, std::string indentstr,
+      unsigned int gen, VisitCounter& counter
+      ) const;
+
+    /// Dump a particle specified by its ID, with the specified dump counter
+    template <typename Stream>
+    void DumpParticleWithID(
+      Stream&& out, size_t pID, std::string indentstr,
+      unsigned int gen, VisitCounter& counter
+      ) const;
+
+    /// Sends all primary particles to the sink
+    template <typename Sink>
+    void DumpAllPrimariesTo(Sink& sink, std::string indentstr) const;
+
+    /// Sends all particles in the input list to the sink
+    template <typename Sink>
+    void DumpAllParticlesTo(Sink& sink, std::string indentstr) const;
+
+
     template <typename Stream>
     void DumpPFParticleInfo(
       Stream&& out,
@@ -556,13 +711,24 @@ namespace {
     Stream&& out, size_t iPart, std::string indentstr /* = "" */,
     unsigned int gen /* = 0 */
     ) const
+  {
+    VisitCounter counter(visited, nullptr);
+    DumpParticle(std::forward<Stream>(out), iPart, indentstr, gen, counter);
+  } // ParticleDumper::DumpParticle()
+
+
+  //----------------------------------------------------------------------------
+  template <typename Stream>
+  void ParticleDumper::DumpParticle(
+    Stream&& out, size_t iPart, std::string indentstr,
+    unsigned int gen, VisitCounter& counter
+    ) const
   {
     lar::OptionalHexFloat hexfloat(options.hexFloats);
 
     recob::PFParticle const& part = particles.at(iPart);
-    ++visited[iPart];
 
-    if (visited[iPart] > 1) {
+    if (counter.visit(iPart) > 1) {
       out << indentstr << "particle " << part.Self()
         << " already printed!!!";
       return;
@@ -636,7 +802,8 @@ namespace {
           }
           else {
             out << '\n';
-            DumpParticleWithID(out, DaughterID, indentstr + "  ", gen - 1);
+            DumpParticleWithID
+              (out, DaughterID, indentstr + "  ", gen - 1, counter);
           }
         }
       } // if descending
@@ -648,7 +815,7 @@ namespace {
     //
     // warnings
     //
-    if (visited[iPart] == 2) {
+    if (counter.count(iPart) == 2) {
       out << "\n" << indentstr << "  WARNING: particle ID=" << PartID
         << " connected more than once!";
     }
@@ -665,10 +832,21 @@ namespace {
   void ParticleDumper::DumpParticleWithID(
     Stream&& out, size_t pID, std::string indentstr /* = "" */,
     unsigned int gen /* = 0 */
+  ) const {
+    VisitCounter counter(visited, nullptr);
+    DumpParticleWithID(std::forward<Stream>(out), pID, indentstr, gen, counter);
+  } // ParticleDumper::DumpParticleWithID()
+
+
+  //----------------------------------------------------------------------------
+  template <typename Stream>
+  void ParticleDumper::DumpParticleWithID(
+    Stream&& out, size_t pID, std::string indentstr,
+    unsigned int gen, VisitCounter& counter
   ) const {
     size_t const pos = particle_map[pID];
     if (particle_map.is_valid_value(pos)) {
-      DumpParticle(out, pos, indentstr, gen);
+      DumpParticle(out, pos, indentstr, gen, counter);
     }
     else {
       out /* << "\n" */ << indentstr << "<ID=" << pID << " not found>";
@@ -677,50 +855,88 @@ namespace {
 
 
   //----------------------------------------------------------------------------
-  void ParticleDumper::DumpAllPrimaries(std::string indentstr /* = "" */) const
+  void ParticleDumper::DumpAllParticles(std::string indentstr /* = "" */) const
+  {
+    LogSink sink(*this);
+    DumpAllParticlesTo(sink, indentstr);
+  } // ParticleDumper::DumpAllParticles()
+
+
+  //----------------------------------------------------------------------------
+  void ParticleDumper::DumpAllParticles
+    (std::string indentstr, unsigned int nThreads) const
+  {
+    if (nThreads == 1) {
+      DumpAllParticles(indentstr);
+      return;
+    }
+
+    // explore the particle tree, recording the messages and the dump counts
+    PlanSink plan(*this);
+    DumpAllParticlesTo(plan, indentstr);
+
+    // format the messages concurrently, replaying the recorded counts
+    recob::dumper::dumpInOrder(plan.items.size(), nThreads,
+      [this, &plan](std::ostream& out, size_t iItem)
+        {
+          DumpItem_t const& item = plan.items[iItem];
+          if (!item.isParticle) {
+            out << item.message;
+            return;
+          }
+          VisitCounter counter(plan.visits.data() + item.firstVisit);
+          DumpParticle
+            (out, item.iPart, item.indentstr, options.maxDepth, counter);
+        },
+      [this](std::string const& text)
+        { mf::LogVerbatim(options.streamName) << text; }
+      );
+
+  } // ParticleDumper::DumpAllParticles(unsigned int)
+
+
+  //----------------------------------------------------------------------------
+  template <typename Sink>
+  void ParticleDumper::DumpAllPrimariesTo
+    (Sink& sink, std::string indentstr) const
   {
     indentstr += "  ";
     size_t const nParticles = particles.size();
     unsigned int nPrimaries = 0;
     for (size_t iPart = 0; iPart < nParticles; ++iPart) {
       if (!particles[iPart].IsPrimary()) continue;
-      DumpParticle(
-        mf::LogVerbatim(options.streamName),
-        iPart, indentstr, options.maxDepth
-        );
+      sink.particle(iPart, indentstr);
     } // for
     if (nPrimaries == 0) {
-      mf::LogVerbatim(options.streamName)
-        << indentstr << "No primary particle found";
+      sink.message(indentstr + "No primary particle found");
     }
-  } // ParticleDumper::DumpAllPrimaries()
+  } // ParticleDumper::DumpAllPrimariesTo()
 
 
   //----------------------------------------------------------------------------
-  void ParticleDumper::DumpAllParticles(std::string indentstr /* = "" */) const
+  template <typename Sink>
+  void ParticleDumper::DumpAllParticlesTo
+    (Sink& sink, std::string indentstr) const
   {
     // first print all the primary particles
-    DumpAllPrimaries(indentstr);
+    DumpAllPrimariesTo(sink, indentstr);
     // then find out if there are any that are "disconnected"
     unsigned int const nDisconnected
       = std::count(visited.begin(), visited.end(), 0U);
     if (nDisconnected) {
-      mf::LogVerbatim(options.streamName) << indentstr
-        << nDisconnected << " particles not coming from primary ones:";
+      sink.message(indentstr + std::to_string(nDisconnected)
+        + " particles not coming from primary ones:");
       size_t const nParticles = visited.size();
       for (size_t iPart = 0; iPart < nParticles; ++iPart) {
         if (visited[iPart] > 0) continue;
-        DumpParticle(
-          mf::LogVerbatim(options.streamName), iPart, indentstr + "  ",
-          options.maxDepth
-          );
+        sink.particle(iPart, indentstr + "  ");
       } // for unvisited particles
-      mf::LogVerbatim(options.streamName) << indentstr
-        << "(end of " << nDisconnected << " particles not from primaries)";
+      sink.message(indentstr + "(end of " + std::to_string(nDisconnected)
+        + " particles not from primaries)");
     } // if there are disconnected particles
     // TODO finally, note if there are multiply-connected particles
 
-  } // ParticleDumper::DumpAllParticles()
+  } // ParticleDumper::DumpAllParticlesTo()
 
 
   //----------------------------------------------------------------------------
@@ -1122,6 +1338,7 @@ namespace recob {
     , fPrintHexFloats(config().PrintHexFloats())
     , fMaxDepth(std::numeric_limits<unsigned int>::max())
     , fMakeEventGraphs(config().MakeParticleGraphs())
+    , fNThreads(config().NThreads())
     {
       // here we are handling the optional configuration key as it had just a
       // default value
@@ -1227,7 +1444,7 @@ namespace recob {
       mf::LogPrint("DumpPFParticles")
         << "WARNING: principal component axis not available";
     }
-    dumper.DumpAllParticles("  ");
+    dumper.DumpAllParticles("  ", fNThreads);
 
     mf::LogVerbatim(fOutputCategory) << "\n"; // two empty lines
 
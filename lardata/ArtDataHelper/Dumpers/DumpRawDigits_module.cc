@@ -6,6 +6,8 @@
  */
 
 // LArSoft includes
+#include "lardata/ArtDataHelper/Dumpers/ColumnarDump.h"
+#include "lardata/ArtDataHelper/Dumpers/OrderedParallelDump.h"
 #include "lardataalg/Utilities/StatCollector.h" // lar::util::MinMaxCollector<>
 #include "lardataobj/RawData/RawDigit.h"
 #include "lardataobj/RawData/raw.h" // raw::Uncompress()
@@ -26,6 +28,11 @@
 
 // C//C++ standard libraries
 #include <string>
+#include <vector>
+#include <memory> // std::unique_ptr<>
+#include <ostream>
+#include <cstdint> // std::int32_t, std::uint64_t
+#include <cstddef> // std::size_t
 #include <algorithm> // std::min(), std::copy_n()
 #include <iomanip> // std::setprecision(), std::setw()
 
@@ -49,6 +56,15 @@ namespace detsim {
    *   will put this many of them for each line
    * - *Pedestal* (integer, default: `0`): digit values are written relative
    *   to this number
+   * - *ColumnarOutput* (string, default: empty): if set, the raw digits are
+   *   written into a binary column file with this path (see
+   *   `recob::dumper::ColumnarDumpWriter`), one table per event, instead of
+   *   being printed; the uncompressed samples of all the channels are stored
+   *   in a single column, without pedestal subtraction
+   * - *NThreads* (integer, default: `1`): number of threads uncompressing and
+   *   formatting the digits; the output is still printed in the original
+   *   order (`0` uses one thread per core; `1` does everything in the art
+   *   thread)
    *
    */
   class DumpRawDigits: public art::EDAnalyzer {
@@ -89,6 +105,18 @@ namespace detsim {
         0 /* default */
         };
 
+      fhicl::Atom<std::string> ColumnarOutput{
+        Name("ColumnarOutput"),
+        Comment("write digits into this binary column file instead of printing them"),
+        "" /* default */
+        };
+
+      fhicl::Atom<unsigned int> NThreads{
+        Name("NThreads"),
+        Comment("number of threads formatting the output (0: one per core)"),
+        1U /* default */
+        };
+
     }; // Config
 
     using Parameters = art::EDAnalyzer::Table<Config>;
@@ -109,11 +137,24 @@ namespace detsim {
     std::string fOutputCategory; ///< Category for `LogVerbatim` output.
     unsigned int fDigitsPerLine; ///< Ticks/digits per line in the output.
     Pedestal_t fPedestal; ///< ADC pedestal, will be subtracted from digits.
+    unsigned int fNThreads; ///< Number of threads formatting the output.
+
+    /// Column file output (if enabled).
+    std::unique_ptr<recob::dumper::ColumnarDumpWriter> fColumnarOutput;
+
+    /// Buffer for uncompressed digits, reused for all the channels.
+    raw::RawDigit::ADCvector_t fADCBuffer;
+
+    /// Writes all the raw digits as a table into the column file.
+    void WriteColumns
+      (art::Event const& evt, std::vector<raw::RawDigit> const& digits);
 
-    /// Dumps a single `recob:Wire` to the specified output stream.
+    /// Dumps a single `recob:Wire` to the specified output stream,
+    /// uncompressing the digits into the buffer `ADCs`.
     template <typename Stream>
     void PrintRawDigit(
       Stream&& out, raw::RawDigit const& digits,
+      raw::RawDigit::ADCvector_t& ADCs,
       std::string indent = "  ", std::string firstIndent = "  "
       ) const;
 
@@ -131,7 +172,13 @@ detsim::DumpRawDigits::DumpRawDigits(Parameters const& config)
   , fOutputCategory   (config().OutputCategory())
   , fDigitsPerLine    (config().DigitsPerLine())
   , fPedestal         (config().Pedestal())
-  {}
+  , fNThreads         (config().NThreads())
+{
+  if (!config().ColumnarOutput().empty()) {
+    fColumnarOutput = std::make_unique<recob::dumper::ColumnarDumpWriter>
+      (config().ColumnarOutput());
+  }
+}
 
 
 //------------------------------------------------------------------------------
@@ -154,26 +201,91 @@ void detsim::DumpRawDigits::analyze(art::Event const& evt) {
   mf::LogVerbatim(fOutputCategory) << "Event " << evt.id()
     << " contains " << RawDigits.size() << " '" << fDetSimModuleLabel.encode()
     << "' waveforms";
+
+  if (fColumnarOutput) {
+    WriteColumns(evt, RawDigits);
+    return;
+  }
+
+  if (fNThreads != 1U) {
+    // digits are formatted concurrently, and printed in their original order
+    recob::dumper::dumpInOrder(RawDigits.size(), fNThreads,
+      [this, &RawDigits](std::ostream& out, std::size_t iDigits)
+        {
+          // each formatting thread uses its own buffer
+          static thread_local raw::RawDigit::ADCvector_t ADCs;
+          PrintRawDigit(out, RawDigits[iDigits], ADCs);
+        },
+      [this](std::string const& text)
+        { mf::LogVerbatim(fOutputCategory) << text; }
+      );
+    return;
+  }
+
   for (raw::RawDigit const& digits: RawDigits) {
 
-    PrintRawDigit(mf::LogVerbatim(fOutputCategory), digits);
+    PrintRawDigit(mf::LogVerbatim(fOutputCategory), digits, fADCBuffer);
 
   } // for digits
 
-} // caldata::DumpWires::analyze()
+} // detsim::DumpRawDigits::analyze()
+
+
+//------------------------------------------------------------------------------
+void detsim::DumpRawDigits::WriteColumns
+  (art::Event const& evt, std::vector<raw::RawDigit> const& digits)
+{
+  using raw::RawDigit;
+  auto& out = *fColumnarOutput;
+
+  // uncompressed samples of all channels, in a single column
+  std::size_t nSamples = 0U;
+  for (RawDigit const& digit: digits) nSamples += digit.Samples();
+  std::vector<Digit_t> samples;
+  samples.reserve(nSamples);
+  for (RawDigit const& digit: digits) {
+    if (digit.Compression() == raw::kNone) {
+      samples.insert(samples.end(), digit.ADCs().begin(), digit.ADCs().end());
+      continue;
+    }
+    fADCBuffer.resize(digit.Samples());
+    raw::Uncompress(digit.ADCs(), fADCBuffer, digit.Compression());
+    samples.insert(samples.end(), fADCBuffer.begin(), fADCBuffer.end());
+  } // for
+
+  out.beginTable(fDetSimModuleLabel.encode(),
+    evt.run(), evt.subRun(), evt.event(), digits.size(), 7U);
+  out.writeColumnOf("channel", digits,
+    [](RawDigit const& digit){ return digit.Channel(); });
+  out.writeColumnOf("nTicks", digits,
+    [](RawDigit const& digit){ return std::uint64_t(digit.Samples()); });
+  out.writeColumnOf("nADC", digits,
+    [](RawDigit const& digit){ return std::uint64_t(digit.NADC()); });
+  out.writeColumnOf("compression", digits,
+    [](RawDigit const& digit)
+      { return static_cast<std::int32_t>(digit.Compression()); }
+    );
+  out.writeColumnOf("pedestal", digits,
+    [](RawDigit const& digit){ return digit.GetPedestal(); });
+  out.writeColumnOf("sigma", digits,
+    [](RawDigit const& digit){ return digit.GetSigma(); });
+  out.writeColumn("samples", samples);
+
+} // detsim::DumpRawDigits::WriteColumns()
 
 
 //------------------------------------------------------------------------------
 template <typename Stream>
 void detsim::DumpRawDigits::PrintRawDigit(
   Stream&& out, raw::RawDigit const& digits,
+  raw::RawDigit::ADCvector_t& ADCs,
   std::string indent /* = "  " */, std::string firstIndent /* = "  " */
 ) const {
 
   //
   // uncompress the digits
   //
-  raw::RawDigit::ADCvector_t ADCs(digits.Samples());
+  ADCs.assign(digits.Samples(), 0); // reuses the buffer memory
   raw::Uncompress(digits.ADCs(), ADCs, digits.Compression());
 
   //
@@ -6,6 +6,7 @@
  */
 
 // LArSoft includes
+#include "lardata/ArtDataHelper/Dumpers/ColumnarDump.h"
 #include "lardataobj/RecoBase/Track.h"
 #include "lardataobj/RecoBase/Hit.h"
 #include "lardataobj/RecoBase/SpacePoint.h"
@@ -34,6 +35,7 @@
 #include <iterator> // std::back_inserter()
 #include <functional> // std::mem_fn()
 #include <memory> // std::unique_ptr()
+#include <cstdint> // std::int32_t, std::uint64_t
 
 
 namespace {
@@ -223,6 +225,11 @@ namespace recob {
    *   associated with the tracks
    * - *ParticleAssociations* (boolean, default: `true`): prints the number
    *   of particle-flow particles associated with the tracks
+   * - *ColumnarOutput* (string, default: empty): if set, the tracks are
+   *   written into a binary column file with this path (see
+   *   `recob::dumper::ColumnarDumpWriter`), one table per event, instead of
+   *   being printed; the trajectory points of all tracks are stored in
+   *   single columns, and associations are not written
    *
    */
   class DumpTracks : public art::EDAnalyzer {
@@ -272,6 +279,11 @@ namespace recob {
         Comment("prints the number of PF particles associated to the track"),
         true
         };
+      fhicl::Atom<std::string> ColumnarOutput{
+        Name("ColumnarOutput"),
+        Comment("write tracks into this binary column file instead of printing them"),
+        ""
+        };
 
     }; // Config
 
@@ -296,6 +308,13 @@ namespace recob {
     bool fPrintSpacePoints; ///< prints the index of associated space points
     bool fPrintParticles; ///< prints the index of associated PFParticles
 
+    /// Column file output (if enabled).
+    std::unique_ptr<recob::dumper::ColumnarDumpWriter> fColumnarOutput;
+
+    /// Writes all the tracks as a table into the column file.
+    void WriteColumns
+      (art::Event const& evt, std::vector<recob::Track> const& tracks);
+
     /// Dumps information about the specified track
     void DumpTrack(unsigned int iTrack, recob::Track const& track) const;
 
@@ -320,7 +339,12 @@ namespace recob {
     , fPrintHits        (config().PrintHits())
     , fPrintSpacePoints (config().PrintSpacePoints())
     , fPrintParticles   (config().ParticleAssociations())
-    {}
+    {
+      if (!config().ColumnarOutput().empty()) {
+        fColumnarOutput = std::make_unique<recob::dumper::ColumnarDumpWriter>
+          (config().ColumnarOutput());
+      }
+    }
 
   //-------------------------------------------------
   void DumpTracks::analyze(const art::Event& evt) {
@@ -333,6 +357,11 @@ namespace recob {
       << "The event contains " << Tracks->size() << " '"
       << fTrackModuleLabel.encode() << "'tracks";
 
+    if (fColumnarOutput) {
+      WriteColumns(evt, *Tracks);
+      return;
+    }
+
     std::unique_ptr<art::FindManyP<recob::Hit>> pHits(
       fPrintNHits?
       new art::FindManyP<recob::Hit>(Tracks, evt, fTrackModuleLabel):
@@ -407,6 +436,60 @@ namespace recob {
   } // DumpTracks::analyze()
 
 
+  //---------------------------------------------------------------------------
+  void DumpTracks::WriteColumns
+    (art::Event const& evt, std::vector<recob::Track> const& tracks)
+  {
+    auto& out = *fColumnarOutput;
+
+    // trajectory points of all tracks, flattened into columns of their own
+    std::size_t nPoints = 0U;
+    for (recob::Track const& track: tracks)
+      nPoints += track.NumberTrajectoryPoints();
+    std::vector<double> pointX, pointY, pointZ;
+    pointX.reserve(nPoints);
+    pointY.reserve(nPoints);
+    pointZ.reserve(nPoints);
+    for (recob::Track const& track: tracks) {
+      for (std::size_t i = 0; i < track.NumberTrajectoryPoints(); ++i) {
+        auto const& point = track.LocationAtPoint(i);
+        pointX.push_back(point.X());
+        pointY.push_back(point.Y());
+        pointZ.push_back(point.Z());
+      } // for points
+    } // for tracks
+
+    out.beginTable(fTrackModuleLabel.encode(),
+      evt.run(), evt.subRun(), evt.event(), tracks.size(), 14U);
+    out.writeColumnOf("ID", tracks,
+      [](recob::Track const& track){ return std::int32_t(track.ID()); });
+    out.writeColumnOf("nPoints", tracks, [](recob::Track const& track)
+      { return std::uint64_t(track.NumberTrajectoryPoints()); });
+    out.writeColumnOf("length", tracks,
+      [](recob::Track const& track){ return double(track.Length()); });
+    out.writeColumnOf("theta", tracks,
+      [](recob::Track const& track){ return double(track.Theta()); });
+    out.writeColumnOf("phi", tracks,
+      [](recob::Track const& track){ return double(track.Phi()); });
+    out.writeColumnOf("startX", tracks,
+      [](recob::Track const& track){ return double(track.Vertex().X()); });
+    out.writeColumnOf("startY", tracks,
+      [](recob::Track const& track){ return double(track.Vertex().Y()); });
+    out.writeColumnOf("startZ", tracks,
+      [](recob::Track const& track){ return double(track.Vertex().Z()); });
+    out.writeColumnOf("endX", tracks,
+      [](recob::Track const& track){ return double(track.End().X()); });
+    out.writeColumnOf("endY", tracks,
+      [](recob::Track const& track){ return double(track.End().Y()); });
+    out.writeColumnOf("endZ", tracks,
+      [](recob::Track const& track){ return double(track.End().Z()); });
+    out.writeColumn("pointX", pointX);
+    out.writeColumn("pointY", pointY);
+    out.writeColumn("pointZ", pointZ);
+
+  } // DumpTracks::WriteColumns()
+
+
   //---------------------------------------------------------------------------
   void DumpTracks::DumpTrack
     (unsigned int iTrack, recob::Track const& track) const
@@ -6,6 +6,8 @@
  */
 
 // LArSoft includes
+#include "lardata/ArtDataHelper/Dumpers/ColumnarDump.h"
+#include "lardata/ArtDataHelper/Dumpers/OrderedParallelDump.h"
 #include "lardataalg/Utilities/StatCollector.h" // lar::util::MinMaxCollector<>
 #include "lardataobj/RecoBase/Wire.h"
 #include "larcoreobj/SimpleTypesAndConstants/geo_types.h"
@@ -25,6 +27,10 @@
 
 // C//C++ standard libraries
 #include <string>
+#include <memory> // std::unique_ptr<>
+#include <ostream>
+#include <cstdint> // std::int32_t
+#include <cstddef> // std::size_t
 #include <ios> // std::fixed
 #include <iomanip> // std::setprecision(), std::setw()
 
@@ -67,6 +73,14 @@ namespace caldata {
    *   for the output (useful for filtering)
    * - *DigitsPerLine* (integer, default: `20`): the dump of digits and ticks
    *   will put this many of them for each line; `0` suppresses digit printout
+   * - *ColumnarOutput* (string, default: empty): if set, the wires are
+   *   written into a binary column file with this path (see
+   *   `recob::dumper::ColumnarDumpWriter`), one table per event, instead of
+   *   being printed; the samples of all the regions of interest are stored
+   *   in a single column
+   * - *NThreads* (integer, default: `1`): number of threads formatting the
+   *   wires; the output is still printed in the original order of the wires
+   *   (`0` uses one thread per core; `1` formats them in the art thread)
    */
   class DumpWires : public art::EDAnalyzer {
       public:
@@ -93,6 +107,18 @@ namespace caldata {
         20 /* default */
         };
 
+      fhicl::Atom<std::string> ColumnarOutput{
+        Name("ColumnarOutput"),
+        Comment("write wires into this binary column file instead of printing them"),
+        "" /* default */
+        };
+
+      fhicl::Atom<unsigned int> NThreads{
+        Name("NThreads"),
+        Comment("number of threads formatting the output (0: one per core)"),
+        1U /* default */
+        };
+
     }; // Config
 
     using Parameters = art::EDAnalyzer::Table<Config>;
@@ -109,6 +135,14 @@ namespace caldata {
     art::InputTag fCalWireModuleLabel; ///< Input tag for wires.
     std::string fOutputCategory; ///< Category for `LogVerbatim` output.
     unsigned int fDigitsPerLine; ///< Ticks/digits per line in the output.
+    unsigned int fNThreads; ///< Number of threads formatting the output.
+
+    /// Column file output (if enabled).
+    std::unique_ptr<recob::dumper::ColumnarDumpWriter> fColumnarOutput;
+
+    /// Writes all the wires as a table into the column file.
+    void WriteColumns
+      (art::Event const& evt, std::vector<recob::Wire> const& wires);
 
     /// Dumps a single `recob:Wire` to the specified output stream.
     template <typename Stream>
@@ -130,7 +164,13 @@ caldata::DumpWires::DumpWires(Parameters const& config)
   , fCalWireModuleLabel(config().CalWireModuleLabel())
   , fOutputCategory    (config().OutputCategory())
   , fDigitsPerLine     (config().DigitsPerLine())
-  {}
+  , fNThreads          (config().NThreads())
+{
+  if (!config().ColumnarOutput().empty()) {
+    fColumnarOutput = std::make_unique<recob::dumper::ColumnarDumpWriter>
+      (config().ColumnarOutput());
+  }
+}
 
 
 //------------------------------------------------------------------------------
@@ -143,6 +183,22 @@ void caldata::DumpWires::analyze(art::Event const& evt) {
     << " contains " << Wires.size() << " '" << fCalWireModuleLabel.encode()
     << "' wires";
 
+  if (fColumnarOutput) {
+    WriteColumns(evt, Wires);
+    return;
+  }
+
+  if (fNThreads != 1U) {
+    // wires are formatted concurrently, and printed in their original order
+    recob::dumper::dumpInOrder(Wires.size(), fNThreads,
+      [this, &Wires](std::ostream& out, std::size_t iWire)
+        { PrintWire(out, Wires[iWire]); },
+      [this](std::string const& text)
+        { mf::LogVerbatim(fOutputCategory) << text; }
+      );
+    return;
+  }
+
   for (recob::Wire const& wire: Wires) {
 
     PrintWire(mf::LogVerbatim(fOutputCategory), wire);
@@ -152,6 +208,49 @@ void caldata::DumpWires::analyze(art::Event const& evt) {
 } // caldata::DumpWires::analyze()
 
 
+//------------------------------------------------------------------------------
+void caldata::DumpWires::WriteColumns
+  (art::Event const& evt, std::vector<recob::Wire> const& wires)
+{
+  using recob::Wire;
+  auto& out = *fColumnarOutput;
+
+  // regions of interest are flattened into columns of their own
+  std::vector<std::uint64_t> RoIBegin, RoISize;
+  std::vector<Wire::RegionsOfInterest_t::value_type> samples;
+  std::size_t nSamples = 0U, nRoIs = 0U;
+  for (Wire const& wire: wires) {
+    nRoIs += wire.SignalROI().n_ranges();
+    for (auto const& RoI: wire.SignalROI().get_ranges()) nSamples += RoI.size();
+  } // for
+  RoIBegin.reserve(nRoIs);
+  RoISize.reserve(nRoIs);
+  samples.reserve(nSamples);
+  for (Wire const& wire: wires) {
+    for (auto const& RoI: wire.SignalROI().get_ranges()) {
+      RoIBegin.push_back(RoI.begin_index());
+      RoISize.push_back(RoI.size());
+      samples.insert(samples.end(), RoI.begin(), RoI.end());
+    } // for RoIs
+  } // for wires
+
+  out.beginTable(fCalWireModuleLabel.encode(),
+    evt.run(), evt.subRun(), evt.event(), wires.size(), 7U);
+  out.writeColumnOf("channel", wires,
+    [](Wire const& wire){ return wire.Channel(); });
+  out.writeColumnOf("view", wires,
+    [](Wire const& wire){ return static_cast<std::int32_t>(wire.View()); });
+  out.writeColumnOf("nTicks", wires,
+    [](Wire const& wire){ return std::uint64_t(wire.NSignal()); });
+  out.writeColumnOf("nRoIs", wires,
+    [](Wire const& wire){ return std::uint64_t(wire.SignalROI().n_ranges()); });
+  out.writeColumn("RoIBegin", RoIBegin);
+  out.writeColumn("RoISize", RoISize);
+  out.writeColumn("samples", samples);
+
+} // caldata::DumpWires::WriteColumns()
+
+
 //------------------------------------------------------------------------------
 template <typename Stream>
 void caldata::DumpWires::PrintWire(
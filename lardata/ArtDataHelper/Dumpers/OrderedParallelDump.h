@@ -0,0 +1,248 @@
+/**
+ * @file   OrderedParallelDump.h
+ * @brief  Formats the dump of many objects on multiple threads.
+ * @date   October 18, 2026
+ *
+ * This is a header-only library.
+ */
+
+#ifndef LARDATA_ARTDATAHELPER_DUMPERS_ORDEREDPARALLELDUMP_H
+#define LARDATA_ARTDATAHELPER_DUMPERS_ORDEREDPARALLELDUMP_H 1
+
+// C/C++ standard libraries
+#include <sstream>
+#include <ios> // std::ios
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception> // std::exception_ptr
+#include <algorithm> // std::min()
+#include <utility> // std::swap()
+#include <cstddef> // std::size_t
+
+
+namespace recob {
+  namespace dumper {
+
+    /// Default number of objects formatted together by a single thread.
+    constexpr std::size_t DefaultDumpChunkSize = 64U;
+
+    /**
+     * @brief Formats objects on multiple threads and emits them in order.
+     * @tparam Format type of callable formatting a single object
+     * @tparam Emit type of callable receiving the formatted text of an object
+     * @param nItems number of objects to be dumped
+     * @param nThreads number of formatting threads (`0`: one per core)
+     * @param format callable as `format(std::ostream&, std::size_t i)`
+     * @param emit callable as `emit(std::string const& text)`
+     * @param chunkSize number of objects formatted together by one thread
+     *
+     * The objects are split in chunks of consecutive objects, and each chunk
+     * is formatted by one of the `nThreads` worker threads into its own buffer.
+     * The formatted text of each object is passed to `emit()` from the calling
+     * thread, in the original order of the objects (`0` to `nItems - 1`), so
+     * that the output is the same as the one of a serial loop. Each object is
+     * formatted into a stream with default format flags, like a new
+     * `mf::LogVerbatim` message would have.
+     *
+     * At most a few chunks per thread are kept in memory waiting to be
+     * emitted, so that dumping a very large collection does not need memory
+     * for all its output at once.
+     *
+     * `format` is called concurrently from different threads and it must not
+     * change any shared state; `emit` is always called from the caller thread.
+     * An exception thrown by any of the two stops the dump and it is rethrown
+     * to the caller after all the threads have stopped.
+     *
+     * If `nThreads` is `1` or there is only one chunk, everything happens in
+     * the calling thread.
+     *
+     * Example:
+     * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~{.cpp}
+     * recob::dumper::dumpInOrder(wires.size(), 4U,
+     *   [&wires](std::ostream& out, std::size_t i){ out << wires[i].Channel(); },
+     *   [](std::string const& text){ mf::LogVerbatim("DumpWires") << text; }
+     *   );
+     * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+     */
+    template <typename Format, typename Emit>
+    void dumpInOrder(
+      std::size_t nItems, unsigned int nThreads, Format format, Emit emit,
+      std::size_t chunkSize = DefaultDumpChunkSize
+      );
+
+
+  } // namespace dumper
+} // namespace recob
+
+
+//==============================================================================
+//=== template implementation
+//===
+namespace recob {
+  namespace dumper {
+    namespace details {
+
+      /// Formatted text of a chunk of consecutive objects.
+      struct DumpChunk_t {
+        std::string text; ///< Text of all the objects, one after the other.
+        std::vector<std::size_t> ends; ///< End of each object in `text`.
+        bool ready = false; ///< Whether the chunk is complete.
+      }; // DumpChunk_t
+
+
+      /// Formats the objects from `begin` to `end` into `chunk`.
+      template <typename Format>
+      void formatDumpChunk(
+        std::ostringstream& sstr, std::ios const& defaultFormat,
+        Format& format, std::size_t begin, std::size_t end, DumpChunk_t& chunk
+      ) {
+        sstr.str("");
+        chunk.ends.clear();
+        for (std::size_t i = begin; i < end; ++i) {
+          sstr.copyfmt(defaultFormat); // each object starts with fresh flags
+          format(static_cast<std::ostream&>(sstr), i);
+          chunk.ends.push_back(static_cast<std::size_t>(sstr.tellp()));
+        } // for
+        chunk.text = sstr.str();
+      } // formatDumpChunk()
+
+
+      /// Passes to `emit` the text of each object in `chunk`.
+      template <typename Emit>
+      void emitDumpChunk(Emit& emit, DumpChunk_t const& chunk) {
+        std::size_t begin = 0U;
+        for (std::size_t end: chunk.ends) {
+          emit(chunk.text.substr(begin, end - begin));
+          begin = end;
+        } // for
+      } // emitDumpChunk()
+
+    } // namespace details
+  } // namespace dumper
+} // namespace recob
+
+
+//------------------------------------------------------------------------------
+template <typename Format, typename Emit>
+void recob::dumper::dumpInOrder(
+  std::size_t nItems, unsigned int nThreads, Format format, Emit emit,
+  std::size_t chunkSize /* = DefaultDumpChunkSize */
+) {
+  using details::DumpChunk_t;
+
+  if (chunkSize == 0U) chunkSize = 1U;
+  std::size_t const nChunks = (nItems + chunkSize - 1U) / chunkSize;
+
+  if (nThreads == 0U) nThreads = std::thread::hardware_concurrency();
+  if (nThreads > nChunks) nThreads = static_cast<unsigned int>(nChunks);
+
+  std::ios const defaultFormat(nullptr); // format flags of a new stream
+
+  //
+  // serial processing
+  //
+  if (nThreads <= 1U) {
+    std::ostringstream sstr;
+    DumpChunk_t chunk;
+    for (std::size_t begin = 0U; begin < nItems; begin += chunkSize) {
+      std::size_t const end = std::min(begin + chunkSize, nItems);
+      details::formatDumpChunk(sstr, defaultFormat, format, begin, end, chunk);
+      details::emitDumpChunk(emit, chunk);
+    } // for
+    return;
+  } // if serial
+
+  //
+  // parallel processing: workers fill a ring of chunks, the caller empties it
+  //
+  std::size_t const nSlots = 4U * nThreads;
+  std::vector<DumpChunk_t> slots(nSlots);
+
+  std::mutex lock;
+  std::condition_variable changed;
+  std::size_t nextChunk = 0U; // next chunk to be formatted
+  std::size_t nEmitted = 0U; // number of chunks already emitted
+  bool stop = false; // set on error
+  std::exception_ptr error;
+
+  auto const worker = [&](){
+    std::ostringstream workerStream;
+    DumpChunk_t workerChunk;
+    while (true) {
+      std::size_t iChunk;
+      {
+        std::unique_lock<std::mutex> guard(lock);
+        changed.wait(guard,
+          [&](){ return stop || (nextChunk < nEmitted + nSlots); }
+          );
+        if (stop || (nextChunk >= nChunks)) return;
+        iChunk = nextChunk++;
+      }
+
+      try {
+        std::size_t const begin = iChunk * chunkSize;
+        std::size_t const end = std::min(begin + chunkSize, nItems);
+        details::formatDumpChunk
+          (workerStream, defaultFormat, format, begin, end, workerChunk);
+      }
+      catch (...) {
+        std::lock_guard<std::mutex> guard(lock);
+        if (!error) error = std::current_exception();
+        stop = true;
+        changed.notify_all();
+        return;
+      }
+
+      {
+        std::lock_guard<std::mutex> guard(lock);
+        DumpChunk_t& slot = slots[iChunk % nSlots];
+        std::swap(slot, workerChunk);
+        slot.ready = true;
+      }
+      changed.notify_all();
+    } // while
+  }; // worker
+
+  std::vector<std::thread> workers;
+  workers.reserve(nThreads);
+  for (unsigned int iThread = 0; iThread < nThreads; ++iThread)
+    workers.emplace_back(worker);
+
+  DumpChunk_t chunk;
+  for (std::size_t iChunk = 0U; iChunk < nChunks; ++iChunk) {
+    {
+      std::unique_lock<std::mutex> guard(lock);
+      DumpChunk_t& slot = slots[iChunk % nSlots];
+      changed.wait(guard, [&](){ return stop || slot.ready; });
+      if (stop) break;
+      std::swap(slot, chunk);
+      slot.ready = false;
+      ++nEmitted;
+    }
+    changed.notify_all();
+
+    try {
+      details::emitDumpChunk(emit, chunk);
+    }
+    catch (...) {
+      std::lock_guard<std::mutex> guard(lock);
+      if (!error) error = std::current_exception();
+      stop = true;
+      changed.notify_all();
+      break;
+    }
+  } // for chunks
+
+  for (std::thread& thread: workers) thread.join();
+
+  if (error) std::rethrow_exception(error);
+
+} // recob::dumper::dumpInOrder()
+
+
+//------------------------------------------------------------------------------
+
+#endif // LARDATA_ARTDATAHELPER_DUMPERS_ORDEREDPARALLELDUMP_H
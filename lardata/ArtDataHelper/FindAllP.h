@@ -12,11 +12,11 @@
 #define FINDALLP_H 1
 
 // C/C++ standard libraries
-#include <climits> // CHAR_BIT
-#include <stdexcept> // std::out_of_range
 #include <vector>
-#include <unordered_map>
-#include <functional> // std::hash<>
+#include <atomic>
+#include <algorithm> // std::max()
+#include <cstddef> // std::size_t
+#include <utility> // std::move()
 
 
 // framework libraries
@@ -37,19 +37,6 @@ namespace lar {
     /// LArSoft utility implementation details
     namespace details {
 
-      /// Hash functions for art and larsoft objects
-      template <typename T>
-      struct hash {
-        using result_type = size_t;
-        using argument_type = T;
-
-        result_type operator() (argument_type const& v) const;
-
-      }; // class hash<>
-
-
-
-
       /** **********************************************************************
        * @brief A class holding many associations between objects
        * @tparam Source type of the object we use as query key (indexing object)
@@ -60,6 +47,11 @@ namespace lar {
        * which Dest object is associated to this specific Src object?
        * The cache is structured so that only one Dest object is known for each
        * Src.
+       *
+       * There are typically very few source products in an event, so the
+       * cache of each product is kept in a small list that is searched
+       * linearly, starting from the product found in the last query.
+       * Within a product, the destination is found by direct indexing.
        */
       template <typename Source, typename Dest>
       class UniqueAssociationCache {
@@ -73,32 +65,60 @@ namespace lar {
         /// type for a cache of dest products for a given source product ID
         using InProductCache_t = std::vector<DestPtr_t>;
 
-        /// type of hash functor for the cache
-        using Hash_t = details::hash<art::ProductID>;
+        /// type for the cache of a single source product
+        struct ProductCache_t {
+          art::ProductID id; ///< ID of the source product
+          InProductCache_t dests; ///< destination pointer, by source key
+        }; // struct ProductCache_t
 
-        /// type for the complete cache, keyed by source product ID
-        using Cache_t
-          = std::unordered_map<art::ProductID, InProductCache_t, Hash_t>;
+        /// type for the complete cache, one entry per source product ID
+        using Cache_t = std::vector<ProductCache_t>;
 
-        Cache_t AssnCache; ///< association cache, keyed by product ID and index
+        Cache_t AssnCache; ///< association cache, by product ID and index
 
 
         /// Constructor: an empty cache
         UniqueAssociationCache() = default;
 
+        // the last hit is not worth preserving in copies
+        UniqueAssociationCache(UniqueAssociationCache const& from)
+          : AssnCache(from.AssnCache) {}
+        UniqueAssociationCache(UniqueAssociationCache&& from)
+          : AssnCache(std::move(from.AssnCache)) {}
+        UniqueAssociationCache& operator= (UniqueAssociationCache const& from)
+          { AssnCache = from.AssnCache; LastHit = 0U; return *this; }
+        UniqueAssociationCache& operator= (UniqueAssociationCache&& from)
+          { AssnCache = std::move(from.AssnCache); LastHit = 0U; return *this; }
+
         /**
          * @brief Returns the specified element of the cache
          * @param src art pointer to the object we want the association of
          * @return the requested element, or a null pointer if not found
          */
-        DestPtr_t operator[] (SourcePtr_t const& src) const
-          { return AssnCache[src.id()][src.key()]; }
+        DestPtr_t const& operator[] (SourcePtr_t const& src) const
+          {
+            InProductCache_t const* dests = find(src.id());
+            return (dests && (src.key() < dests->size()))
+              ? (*dests)[src.key()]: NullDest;
+          }
+
+        /// Returns the cache for the specified product, nullptr if none
+        InProductCache_t const* find(art::ProductID const& id) const;
+
+        /// Returns the cache for the specified product, creating it if needed
+        InProductCache_t& findOrCreate(art::ProductID const& id);
 
         /// Empties the cache
-        void clear() { AssnCache.clear(); }
+        void clear() { AssnCache.clear(); LastHit = 0U; }
 
         size_t NProductIDs() const { return AssnCache.size(); }
 
+          private:
+        static inline DestPtr_t const NullDest{}; ///< returned when not found
+
+        /// index of the product found in the last query
+        mutable std::atomic<std::size_t> LastHit { 0U };
+
       }; // class UniqueAssociationCache<>
 
 
@@ -135,7 +155,8 @@ namespace lar {
          * @param src a art pointer to the source object
          * @return a pointer to the associated object, or a null pointer if none
          */
-        art::Ptr<Dest_t> const& operator[] (art::Ptr<Dest_t> const& src) const;
+        art::Ptr<Dest_t> const& operator[] (art::Ptr<Source_t> const& src) const
+          { return cache[src]; }
 
 
         /// Returns whether there are associations from objects in product id
@@ -191,22 +212,17 @@ namespace lar {
 
         /// Adds all associations in the specified handle; returns their number
         unsigned int Merge(art::Handle<Assns_t>& handle);
-      }; // class FindAllP<>
 
-
-
-
-      /** **********************************************************************
-       * @brief Resizes a vector to a size power of 2, with a minimum size
-       * @param v the vector to be resized
-       * @param min_size the minimal size of the vector
-       *
-       * The vector v is resized, any new element is default-initialized.
-       * The target size is the smallest power of 2 not smaller than min_size,
-       * or 0 if min_size is 0.
-       */
-      template <typename T>
-      void ResizeToPower2(std::vector<T>& v, size_t min_size);
+        /**
+         * @brief Adds all the associations in the specified handles
+         * @param handles list of the associations to be added
+         * @return the number of associations added
+         *
+         * The keys of all associations are scanned first, so that the cache of
+         * each source product is allocated only once, with the exact size.
+         */
+        unsigned int MergeAll(std::vector<art::Handle<Assns_t>> const& handles);
+      }; // class FindAllP<>
 
 
     } // namespace details
@@ -223,26 +239,43 @@ namespace lar {
   namespace util {
     namespace details {
       //------------------------------------------------------------------------
-      //---  FindAllP
+      //---  UniqueAssociationCache
 
       template <typename Source, typename Dest>
-      auto FindAllP<Source, Dest>::operator[]
-        (art::Ptr<Dest_t> const& src) const -> art::Ptr<Dest_t> const&
+      auto UniqueAssociationCache<Source, Dest>::find
+        (art::ProductID const& id) const -> InProductCache_t const*
       {
-        // we expect a missing match to be exceptional
-        try {
-          return cache.AssnCache.at(src.id()).at(src.key());
-        }
-        catch (std::out_of_range) {
-          return {};
-        }
-      } // FindAllP<>::operator[]
+        std::size_t const nProducts = AssnCache.size();
+        std::size_t const last = LastHit.load(std::memory_order_relaxed);
+        if ((last < nProducts) && (AssnCache[last].id == id))
+          return &(AssnCache[last].dests);
+        for (std::size_t iProduct = 0; iProduct < nProducts; ++iProduct) {
+          if (AssnCache[iProduct].id != id) continue;
+          LastHit.store(iProduct, std::memory_order_relaxed);
+          return &(AssnCache[iProduct].dests);
+        } // for
+        return nullptr;
+      } // UniqueAssociationCache<>::find()
 
 
+      template <typename Source, typename Dest>
+      auto UniqueAssociationCache<Source, Dest>::findOrCreate
+        (art::ProductID const& id) -> InProductCache_t&
+      {
+        InProductCache_t const* dests = find(id);
+        if (dests) return const_cast<InProductCache_t&>(*dests);
+        AssnCache.push_back({ id, {} });
+        return AssnCache.back().dests;
+      } // UniqueAssociationCache<>::findOrCreate()
+
+
+      //------------------------------------------------------------------------
+      //---  FindAllP
+
       template <typename Source, typename Dest>
       inline bool FindAllP<Source, Dest>::hasProduct
         (art::ProductID const& id) const
-        { return cache.AssnCache.count(id) > 0; }
+        { return cache.find(id) != nullptr; }
 
 
       template <typename Source, typename Dest>
@@ -263,10 +296,8 @@ namespace lar {
         MF_LOG_DEBUG("FindAllP") << "Read(): read " << assns_list.size()
           << " association sets";
 
-        unsigned int count = 0;
         // parse all the associations, and translate them into a local cache
-        for (art::Handle<Assns_t> handle: assns_list)
-          count += Merge(handle);
+        unsigned int const count = MergeAll(assns_list);
 
         MF_LOG_DEBUG("FindAllP") << "Read " << count << " associations for "
           << cache.NProductIDs() << " product IDs";
@@ -298,7 +329,7 @@ namespace lar {
             << "no association found with input tag '" << assnTag << "'";
         }
 
-        return Merge(handle);
+        return MergeAll({ handle });
       } // FindAllP::Add(Event, InputTag)
 
 
@@ -306,100 +337,104 @@ namespace lar {
       unsigned int FindAllP<Source, Dest>::Merge
         (art::Handle<Assns_t>& handle)
       {
-        // product ID of the last source object; initialized invalid
-        art::ProductID LastProductID = art::Ptr<Source_t>().id();
-        typename Cache_t::InProductCache_t const* AssnsList = nullptr;
-
-        unsigned int count = 0;
-
-        MF_LOG_DEBUG("FindAllP") << "Merge(): importing " << handle->size()
-          << " associations from " << handle.provenance();
+        return MergeAll({ handle });
+      } // FindAllP::Merge()
 
-        for (auto const& assn: *handle) {
-          // assn is a std::pair<art::Ptr<Source_t>, art::Ptr<Dest_t>>
-          art::Ptr<Source_t> const& src = assn.first;
 
-          if (src.isNull()) {
-            MF_LOG_ERROR("FindAllP") << "Empty pointer found in association "
-              << handle.provenance();
-            continue; // this should not happen
-          }
+      template <typename Source, typename Dest>
+      unsigned int FindAllP<Source, Dest>::MergeAll
+        (std::vector<art::Handle<Assns_t>> const& handles)
+      {
+        //
+        // first pass: find the size needed for each source product
+        //
+        struct ProductSize_t {
+          art::ProductID id;
+          std::size_t size;
+        };
+        std::vector<ProductSize_t> sizes;
+        for (art::Handle<Assns_t> const& handle: handles) {
+          ProductSize_t* last = nullptr;
+          for (auto const& assn: *handle) {
+            art::Ptr<Source_t> const& src = assn.first;
+            if (src.isNull()) continue;
+            if (!last || (last->id != src.id())) {
+              // if we have changed product (that should be fairly rare),
+              // look for its entry
+              last = nullptr;
+              for (ProductSize_t& size: sizes) {
+                if (size.id != src.id()) continue;
+                last = &size;
+                break;
+              }
+              if (!last) {
+                sizes.push_back({ src.id(), 0U });
+                last = &sizes.back();
+              }
+            } // if different product ID
+            last->size = std::max<std::size_t>(last->size, src.key() + 1);
+          } // for associations
+        } // for handles
+
+        // allocate the exact space, preserving what is already in the cache
+        for (ProductSize_t const& size: sizes) {
+          auto& AssnsList = cache.findOrCreate(size.id);
+          if (AssnsList.size() < size.size) AssnsList.resize(size.size);
+        }
 
-          art::Ptr<Dest_t> const& dest = assn.second;
-
-          // if we have changed product (that should be fairly rare),
-          // update the running pointers
-          if (src.id() != LastProductID) {
-            LastProductID = src.id();
-            AssnsList = &(cache.AssnCache[LastProductID]);
-
-            // if the list is empty, it means we have just created it!
-            if (AssnsList->empty()) {
-              // allocate enough space to accomodate all the associations,
-              // (provided that source IDs are sequencial);
-              // in fact typically all the associations in the same handle
-              // have the same product ID
-              ResizeToPower2(*AssnsList, handle->size());
-            }
-          } // if different product ID
-
-          // make sure there is enough room in the vector
-          typename art::Ptr<Source_t>::key_type key = src.key();
-          if (key >= AssnsList->size()) ResizeToPower2(*AssnsList, key + 1);
-
-          // store the association to dest
-          art::Ptr<Dest_t>& dest_cell = (*AssnsList)[key];
-          if (dest_cell.isNonnull() && (dest_cell != dest)) {
-            throw art::Exception(art::errors::InvalidNumber)
-              << "Object Ptr" << src
-              << " is associated with at least two objects: "
-              << dest << " and " << dest_cell;
-          }
-          dest_cell = dest;
-          ++count;
-        } // for all associations in a list
+        //
+        // second pass: fill
+        //
+        unsigned int count = 0;
 
-        MF_LOG_DEBUG("FindAllP")
-          << "Merged " << count << " associations from " << handle.provenance();
-        return count;
-      } // FindAllP::Merge()
+        for (art::Handle<Assns_t> const& handle: handles) {
 
+          MF_LOG_DEBUG("FindAllP") << "Merge(): importing " << handle->size()
+            << " associations from " << handle.provenance();
 
+          // product ID of the last source object; initialized invalid
+          art::ProductID LastProductID = art::Ptr<Source_t>().id();
+          typename Cache_t::InProductCache_t* AssnsList = nullptr;
 
-      //------------------------------------------------------------------------
-      template <>
-      auto hash<art::ProductID>::operator()
-        (argument_type const& id) const -> result_type
-      {
-        // make sure we have enough bits in result_type;
-        // if not, we need a more clever algorithm
-        //static_assert(
-        //  sizeof(id.processIndex()) + sizeof(id.productIndex())
-        //    <= sizeof(result_type),
-        //  "hash return type not large enough for hashing art::ProductID"
-          //);
-        // stack the process and product IDs in one integer
-        //return result_type(
-          //(id.processIndex() << sizeof(id.productIndex() * CHAR_BIT))
-          //+ id.productIndex()
-          //);
-	  return result_type( id.value() );
-      } // hash<art::ProductID>::operator()
+          unsigned int handleCount = 0;
+          for (auto const& assn: *handle) {
+            // assn is a std::pair<art::Ptr<Source_t>, art::Ptr<Dest_t>>
+            art::Ptr<Source_t> const& src = assn.first;
 
+            if (src.isNull()) {
+              MF_LOG_ERROR("FindAllP") << "Empty pointer found in association "
+                << handle.provenance();
+              continue; // this should not happen
+            }
 
+            art::Ptr<Dest_t> const& dest = assn.second;
+
+            // if we have changed product (that should be fairly rare),
+            // update the running pointers
+            if (src.id() != LastProductID) {
+              LastProductID = src.id();
+              AssnsList = &(cache.findOrCreate(LastProductID));
+            } // if different product ID
+
+            // store the association to dest (the cache is already large enough)
+            art::Ptr<Dest_t>& dest_cell = (*AssnsList)[src.key()];
+            if (dest_cell.isNonnull() && (dest_cell != dest)) {
+              throw art::Exception(art::errors::InvalidNumber)
+                << "Object Ptr" << src
+                << " is associated with at least two objects: "
+                << dest << " and " << dest_cell;
+            }
+            dest_cell = dest;
+            ++handleCount;
+          } // for all associations in a list
 
-      //------------------------------------------------------------------------
-      template <typename T>
-      void ResizeToPower2(std::vector<T>& v, size_t min_size) {
-          if (min_size == 0) {
-          v.clear();
-          return;
-        }
-        size_t new_size = 1;
-        while (new_size < min_size) new_size *= 2;
+          MF_LOG_DEBUG("FindAllP") << "Merged " << handleCount
+            << " associations from " << handle.provenance();
+          count += handleCount;
+        } // for handles
 
-        v.resize(new_size);
-      } // ResizeToPower2()
+        return count;
+      } // FindAllP::MergeAll()
 
     } // namespace details
   } // namespace util
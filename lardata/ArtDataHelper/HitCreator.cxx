@@ -13,20 +13,19 @@
 // C/C++ standard library
 #include <utility> // std::move()
 #include <algorithm> // std::accumulate(), std::max()
-#include <limits> // std::numeric_limits<>
 #include <cassert>
 
 // art libraries
 #include "canvas/Utilities/Exception.h"
-#include "canvas/Persistency/Common/FindOneP.h"
 #include "art/Framework/Principal/Event.h"
+#include "art/Framework/Principal/Handle.h"
 #include "art/Framework/Services/Registry/ServiceHandle.h"
 
 // LArSoft libraries
 #include "larcore/Geometry/Geometry.h"
 #include "lardataobj/RecoBase/Wire.h"
 #include "lardataobj/RecoBase/Hit.h"
-#include "lardata/Utilities/MakeIndex.h"
+#include "larcoreobj/SimpleTypesAndConstants/RawTypes.h" // raw::ChannelID_t
 
 
 namespace {
@@ -38,6 +37,129 @@ namespace {
     assns.swap(empty);
   } // ClearAssociations()
 
+
+  /**
+   * @brief Returns a table of pointers to the elements of a collection.
+   * @tparam T type of the elements in the collection (need `Channel()`)
+   * @param handle handle to the collection
+   * @return pointer to the element on each channel (null if none)
+   *
+   * The table is indexed by channel ID. Elements with an invalid channel are
+   * skipped; if more elements are on the same channel, the last one is kept.
+   */
+  template <typename T>
+  std::vector<art::Ptr<T>> PtrsByChannel
+    (art::ValidHandle<std::vector<T>> const& handle)
+  {
+    std::vector<T> const& coll = *handle;
+
+    size_t nChannels = 0;
+    for (T const& obj: coll) {
+      raw::ChannelID_t const channel = obj.Channel();
+      if (channel == raw::InvalidChannelID) continue;
+      nChannels = std::max(nChannels, size_t(channel) + 1);
+    } // for
+
+    std::vector<art::Ptr<T>> byChannel(nChannels);
+    for (size_t i = 0; i < coll.size(); ++i) {
+      raw::ChannelID_t const channel = coll[i].Channel();
+      if (channel == raw::InvalidChannelID) continue;
+      byChannel[channel] = art::Ptr<T>(handle, i);
+    } // for
+    return byChannel;
+  } // PtrsByChannel()
+
+
+  /**
+   * @brief Returns the left pointer associated to each right element.
+   * @tparam Left type of the left element of the association
+   * @tparam Right type of the right element of the association
+   * @param assns the association
+   * @param rightID ID of the data product of the right elements
+   * @param nRight number of elements in the right data product
+   * @return pointer to the left object of each right element (null if none)
+   *
+   * This is the equivalent of `art::FindOneP<Left>` on the right data product:
+   * only the pairs whose right element belongs to the product with ID
+   * `rightID` are considered, and the table is indexed by the key of the right
+   * element.
+   */
+  template <typename Left, typename Right>
+  std::vector<art::Ptr<Left>> LeftPtrsByRightKey(
+    art::Assns<Left, Right> const& assns,
+    art::ProductID const& rightID, size_t nRight
+  ) {
+    std::vector<art::Ptr<Left>> byKey(nRight);
+    for (auto const& assn: assns) {
+      if (assn.second.id() != rightID) continue;
+      if (assn.second.key() >= nRight) continue;
+      byKey[assn.second.key()] = assn.first;
+    } // for
+    return byKey;
+  } // LeftPtrsByRightKey()
+
+
+  /**
+   * @brief Returns a table of the pointers in a list, by channel.
+   * @tparam T type of the pointed elements (need `Channel()`)
+   * @param ptrs list of pointers
+   * @return pointer to the element on each channel (null if none)
+   *
+   * The table is indexed by channel ID. Null pointers and elements with an
+   * invalid channel are skipped; if more elements are on the same channel, the
+   * last one in the list is kept.
+   */
+  template <typename T>
+  std::vector<art::Ptr<T>> PtrsByChannel
+    (std::vector<art::Ptr<T>> const& ptrs)
+  {
+    std::vector<art::Ptr<T>> byChannel;
+    for (art::Ptr<T> const& ptr: ptrs) {
+      if (ptr.isNull()) continue;
+      raw::ChannelID_t const channel = ptr->Channel();
+      if (channel == raw::InvalidChannelID) continue;
+      if (size_t(channel) >= byChannel.size()) byChannel.resize(channel + 1);
+      byChannel[channel] = ptr;
+    } // for
+    return byChannel;
+  } // PtrsByChannel()
+
+
+  /**
+   * @brief Associates each hit to the object on its channel.
+   * @tparam T type of object to associate to
+   * @tparam MakeHitPtr type of functor returning the pointer to a hit
+   * @param assns the association to be filled
+   * @param hits the hits to be associated
+   * @param byChannel table of the pointer to associate to, by channel ID
+   * @param makeHitPtr functor returning the pointer to the hit with an index
+   * @param requiredWhat if not null, hits must have an object to associate to
+   * @throw art::Exception (`art::errors::LogicError`) if an object is
+   *        `requiredWhat` and a hit has none
+   *
+   * Hits with no object in the table are not associated, unless
+   * `requiredWhat` is specified (in which case it's the description of the
+   * missing object in the exception message).
+   */
+  template <typename T, typename MakeHitPtr>
+  void AssociateHitsByChannel(
+    art::Assns<T, recob::Hit>& assns, std::vector<recob::Hit> const& hits,
+    std::vector<art::Ptr<T>> const& byChannel, MakeHitPtr makeHitPtr,
+    char const* requiredWhat = nullptr
+  ) {
+    for (size_t iHit = 0; iHit < hits.size(); ++iHit) {
+      size_t const iChannel = size_t(hits[iHit].Channel());
+      if ((iChannel < byChannel.size()) && byChannel[iChannel].isNonnull()) {
+        assns.addSingle(byChannel[iChannel], makeHitPtr(iHit));
+        continue;
+      }
+      if (!requiredWhat) continue;
+      throw art::Exception(art::errors::LogicError)
+        << "No " << requiredWhat << " associated to channel #" << iChannel
+        << " whence hit #" << iHit << " comes!\n";
+    } // for hit
+  } // AssociateHitsByChannel()
+
 } // local namespace
 
 
@@ -344,6 +466,126 @@ namespace recob {
   } // HitCollectionCreator::CreateAssociationsToLastHit()
 
 
+  //****************************************************************************
+  //***  ConcurrentHitCollectionCreator
+  //----------------------------------------------------------------------
+  void ConcurrentHitCollectionCreator::Buffer::emplace_back(
+    recob::Hit&& hit,
+    art::Ptr<recob::Wire> const& wire, art::Ptr<raw::RawDigit> const& digits
+  ) {
+    hits.emplace_back(std::move(hit));
+    if (doWireAssns) wires.push_back(wire);
+    if (doRawDigitAssns) this->digits.push_back(digits);
+  } // ConcurrentHitCollectionCreator::Buffer::emplace_back()
+
+
+  //----------------------------------------------------------------------
+  void ConcurrentHitCollectionCreator::Buffer::reserve(size_t new_size) {
+    hits.reserve(new_size);
+    if (doWireAssns) wires.reserve(new_size);
+    if (doRawDigitAssns) digits.reserve(new_size);
+  } // ConcurrentHitCollectionCreator::Buffer::reserve()
+
+
+  //----------------------------------------------------------------------
+  ConcurrentHitCollectionCreator::ConcurrentHitCollectionCreator(
+    art::Event& event,
+    std::string instance_name /* = "" */,
+    bool doWireAssns /* = true */, bool doRawDigitAssns /* = true */
+    )
+    : HitAndAssociationsWriterBase
+      (event, instance_name, doWireAssns, doRawDigitAssns)
+  {
+    hits.reset(new std::vector<recob::Hit>);
+    makeBuffers(1U);
+  } // ConcurrentHitCollectionCreator::ConcurrentHitCollectionCreator()
+
+
+  //----------------------------------------------------------------------
+  void ConcurrentHitCollectionCreator::makeBuffers(size_t n) {
+    buffers.clear();
+    buffers.resize(n);
+    for (Buffer& buffer: buffers) {
+      buffer.doWireAssns = bool(WireAssns);
+      buffer.doRawDigitAssns = bool(RawDigitAssns);
+    }
+  } // ConcurrentHitCollectionCreator::makeBuffers()
+
+
+  //----------------------------------------------------------------------
+  size_t ConcurrentHitCollectionCreator::size() const {
+    size_t n = hits? hits->size(): 0;
+    for (Buffer const& buffer: buffers) n += buffer.size();
+    return n;
+  } // ConcurrentHitCollectionCreator::size()
+
+
+  //----------------------------------------------------------------------
+  void ConcurrentHitCollectionCreator::merge() {
+    if (!hits) {
+      throw art::Exception(art::errors::LogicError)
+        << "ConcurrentHitCollectionCreator is trying to merge hits into"
+        " a hit collection that was never created!\n";
+    }
+
+    // location of a hit in the buffers
+    struct HitSource_t {
+      Buffer* buffer;
+      size_t index;
+    };
+
+    std::vector<HitSource_t> sources;
+    for (Buffer& buffer: buffers) {
+      for (size_t iHit = 0; iHit < buffer.size(); ++iHit)
+        sources.push_back({ &buffer, iHit });
+    } // for
+    if (sources.empty()) return;
+
+    // sort by channel only if the concatenation of the buffers is not sorted
+    auto const byChannel = [](HitSource_t const& a, HitSource_t const& b)
+      {
+        return a.buffer->hits[a.index].Channel()
+          < b.buffer->hits[b.index].Channel();
+      };
+    if (!std::is_sorted(sources.begin(), sources.end(), byChannel))
+      std::stable_sort(sources.begin(), sources.end(), byChannel);
+
+    // move the hits and create their associations, all in one pass
+    size_t const firstHit = hits->size();
+    hits->reserve(firstHit + sources.size());
+    for (HitSource_t const& source: sources) {
+      Buffer& buffer = *(source.buffer);
+      hits->push_back(std::move(buffer.hits[source.index]));
+
+      if (!WireAssns && !RawDigitAssns) continue;
+      HitPtr_t const hit_ptr = CreatePtr(hits->size() - 1);
+      if (WireAssns) {
+        art::Ptr<recob::Wire> const& wire = buffer.wires[source.index];
+        if (wire.isNonnull()) WireAssns->addSingle(wire, hit_ptr);
+      }
+      if (RawDigitAssns) {
+        art::Ptr<raw::RawDigit> const& digits = buffer.digits[source.index];
+        if (digits.isNonnull()) RawDigitAssns->addSingle(digits, hit_ptr);
+      }
+    } // for
+
+    // empty the buffers (releasing their memory)
+    for (Buffer& buffer: buffers) {
+      buffer.hits = {};
+      buffer.wires = {};
+      buffer.digits = {};
+    }
+
+  } // ConcurrentHitCollectionCreator::merge()
+
+
+  //----------------------------------------------------------------------
+  void ConcurrentHitCollectionCreator::put_into() {
+    merge(); // throws if there is no collection
+    HitAndAssociationsWriterBase::put_into();
+  } // ConcurrentHitCollectionCreator::put_into()
+
+
   //****************************************************************************
   //***  HitCollectionAssociator
   //----------------------------------------------------------------------
@@ -415,94 +657,58 @@ namespace recob {
     // but we don't know where digits are; in that case, we try to use wires
     const bool bUseWiresForDigits = RawDigitAssns && (digits_label == "");
 
-    if (WireAssns || bUseWiresForDigits) {
-      // do we use wires for digit associations too?
+    auto const makeHitPtr = [this](size_t iHit){ return CreatePtr(iHit); };
 
-      // get the wire collection
+    if (WireAssns || bUseWiresForDigits) {
+      // get the wire collection and a table of wires by channel,
+      // built once for both the wire and the digit associations
       art::ValidHandle<std::vector<recob::Wire>> hWires
         = event->getValidHandle<std::vector<recob::Wire>>(wires_label);
+      std::vector<art::Ptr<recob::Wire>> const WireMap
+        = PtrsByChannel(hWires);
 
-      // fill a map of wire index vs. channel number
-      std::vector<size_t> WireMap
-        = util::MakeIndex(*hWires, std::mem_fn(&recob::Wire::Channel));
+      if (WireAssns) {
+        AssociateHitsByChannel
+          (*WireAssns, srchits, WireMap, makeHitPtr, "wire");
+      } // if wire associations
 
-      // use raw rigit - wire association, assuming they have been produced
-      // by the same producer as the wire and with the same instance name;
-      // we don't check whether the data product is found, but the following
-      // code will have FindOneP throw if that was not the case
-      // (that's what we would do here anyway, maybe with a better message...)
-      std::unique_ptr<art::FindOneP<raw::RawDigit>> WireToDigit;
       if (bUseWiresForDigits) {
-        WireToDigit.reset
-          (new art::FindOneP<raw::RawDigit>(hWires, *event, wires_label));
-      }
-
-      // add associations, hit by hit:
-      for (size_t iHit = 0; iHit < srchits.size(); ++iHit) {
-
-        // find the channel
-        size_t iChannel = size_t(srchits[iHit].Channel()); // forcibly converted
-
-        // find the wire associated to that channel
-        size_t iWire = std::numeric_limits<size_t>::max();
-        if (iChannel < WireMap.size()) iWire = WireMap[iChannel];
-        if (iWire == std::numeric_limits<size_t>::max()) {
-          throw art::Exception(art::errors::LogicError)
-            << "No wire associated to channel #" << iChannel << " whence hit #"
-            << iHit << " comes!\n";
-        } // if no channel
-
-        // make the association with wires
-        if (WireAssns) {
-          art::Ptr<recob::Wire> wire(hWires, iWire);
-          WireAssns->addSingle(wire, CreatePtr(iHit));
-        }
-
-        if (bUseWiresForDigits) {
-          // find the digit associated to that channel
-          art::Ptr<raw::RawDigit> const& digit = WireToDigit->at(iWire);
-          if (digit.isNull()) {
+        // use raw digit - wire association, assuming they have been produced
+        // by the same producer as the wire and with the same instance name;
+        // the digit of each channel is the one associated to its wire
+        std::vector<art::Ptr<raw::RawDigit>> const DigitOfWire
+          = LeftPtrsByRightKey(
+            *(event->getValidHandle<art::Assns<raw::RawDigit, recob::Wire>>
+              (wires_label)),
+            hWires.id(), hWires->size()
+            );
+
+        // every hit needs a wire first
+        std::vector<art::Ptr<raw::RawDigit>> DigitMap(WireMap.size());
+        for (size_t iHit = 0; iHit < srchits.size(); ++iHit) {
+          size_t const iChannel = size_t(srchits[iHit].Channel());
+          if ((iChannel >= WireMap.size()) || WireMap[iChannel].isNull()) {
             throw art::Exception(art::errors::LogicError)
-              << "No raw digit associated to channel #" << iChannel
+              << "No wire associated to channel #" << iChannel
               << " whence hit #" << iHit << " comes!\n";
-          } // if no channel
+          }
+          DigitMap[iChannel] = DigitOfWire[WireMap[iChannel].key()];
+        } // for hits
 
-          // make the association
-          RawDigitAssns->addSingle(digit, CreatePtr(iHit));
-        } // if create digit associations through wires
-      } // for hit
-
-    } // if wire associations
+        AssociateHitsByChannel
+          (*RawDigitAssns, srchits, DigitMap, makeHitPtr, "raw digit");
+      } // if create digit associations through wires
+    } // if wire table needed
 
     if (RawDigitAssns && !bUseWiresForDigits) {
-      // get the digit collection
+      // get the digit collection and a table of digits by channel
       art::ValidHandle<std::vector<raw::RawDigit>> hDigits
         = event->getValidHandle<std::vector<raw::RawDigit>>(digits_label);
+      std::vector<art::Ptr<raw::RawDigit>> const DigitMap
+        = PtrsByChannel(hDigits);
 
-      // fill a map of wire index vs. channel number
-      std::vector<size_t> DigitMap
-        = util::MakeIndex(*hDigits, std::mem_fn(&raw::RawDigit::Channel));
-
-      // add associations, hit by hit:
-      for (size_t iHit = 0; iHit < srchits.size(); ++iHit) {
-
-        // find the channel
-        size_t iChannel = size_t(srchits[iHit].Channel()); // forcibly converted
-
-        // find the digit associated to that channel
-        size_t iDigit = std::numeric_limits<size_t>::max();
-        if (iChannel < DigitMap.size()) iDigit = DigitMap[iChannel];
-        if (iDigit == std::numeric_limits<size_t>::max()) {
-          throw art::Exception(art::errors::LogicError)
-            << "No raw digit associated to channel #" << iChannel
-            << " whence hit #" << iHit << " comes!\n";
-        } // if no channel
-
-        // make the association
-        art::Ptr<raw::RawDigit> digit(hDigits, iDigit);
-        RawDigitAssns->addSingle(digit, CreatePtr(iHit));
-
-      } // for hit
+      AssociateHitsByChannel
+        (*RawDigitAssns, srchits, DigitMap, makeHitPtr, "raw digit");
     } // if we have rawdigit label
 
   } // HitCollectionAssociator::put_into()
@@ -545,86 +751,51 @@ namespace recob {
     if (!RawDigitAssns && !WireAssns) return; // no associations needed
     assert(event);
 
-    // we make the associations anew
-    if (RawDigitAssns) ClearAssociations(*RawDigitAssns);
-
-    // read the hits; this is going to hurt performances...
-    // no solution to that until there is a way to have a lazy read
+    // only the associations of the original hit collection are considered,
+    // as `art::FindOneP` would do
     art::ValidHandle<std::vector<recob::Hit>> hHits
       = event->getValidHandle<std::vector<recob::Hit>>(hits_label);
 
-    // now get the associations
+    auto const makeHitPtr = [this](size_t iHit){ return CreatePtr(iHit); };
+
     if (WireAssns) {
       // we make the associations anew
       ClearAssociations(*WireAssns);
 
       // find the associations between the hits and the wires
-      art::FindOneP<recob::Wire> HitToWire(hHits, *event, hits_label);
-      if (!HitToWire.isValid()) {
+      art::Handle<art::Assns<recob::Wire, recob::Hit>> hHitToWire;
+      if (!event->getByLabel(hits_label, hHitToWire)) {
         throw art::Exception(art::errors::ProductNotFound)
           << "Can't find the associations between hits and wires produced by '"
           << hits_label << "'!\n";
       } // if no association
 
       // fill a map of wire vs. channel number
-      std::vector<art::Ptr<recob::Wire>> WireMap;
-      for (size_t iAssn = 0; iAssn < HitToWire.size(); ++iAssn) {
-        art::Ptr<recob::Wire> wire = HitToWire.at(iAssn);
-        if (wire.isNull()) continue;
-        size_t channelID = (size_t) wire->Channel();
-        if (WireMap.size() <= channelID) // expand the map of necessary
-          WireMap.resize(std::max(channelID + 1, 2 * WireMap.size()), {});
-        WireMap[channelID] = std::move(wire);
-      } // for
-
-      // now go through all the hits...
-      for (size_t iHit = 0; iHit < srchits.size(); ++iHit) {
-        recob::Hit const& hit = srchits[iHit];
-        size_t channelID = (size_t) hit.Channel();
-
-        // no association if there is no wire to associate with
-        if ((channelID >= WireMap.size()) || !WireMap[channelID]) continue;
-
-        // create an association using the same wire pointer
-        WireAssns->addSingle(WireMap[channelID], CreatePtr(iHit));
-      } // for hits
+      std::vector<art::Ptr<recob::Wire>> const WireMap = PtrsByChannel
+        (LeftPtrsByRightKey(*hHitToWire, hHits.id(), hHits->size()));
+
+      // no association if there is no wire to associate with
+      AssociateHitsByChannel(*WireAssns, srchits, WireMap, makeHitPtr);
     } // if wire associations
 
-    // now get the associations
     if (RawDigitAssns) {
       // we make the associations anew
       ClearAssociations(*RawDigitAssns);
 
       // find the associations between the hits and the raw digits
-      art::FindOneP<raw::RawDigit> HitToDigits(hHits, *event, hits_label);
-      if (!HitToDigits.isValid()) {
+      art::Handle<art::Assns<raw::RawDigit, recob::Hit>> hHitToDigits;
+      if (!event->getByLabel(hits_label, hHitToDigits)) {
         throw art::Exception(art::errors::ProductNotFound)
           << "Can't find the associations between hits and raw digits"
           << " produced by '" << hits_label << "'!\n";
       } // if no association
 
       // fill a map of digits vs. channel number
-      std::vector<art::Ptr<raw::RawDigit>> DigitMap;
-      for (size_t iAssn = 0; iAssn < HitToDigits.size(); ++iAssn) {
-        art::Ptr<raw::RawDigit> digits = HitToDigits.at(iAssn);
-        if (digits.isNull()) continue;
-        size_t channelID = (size_t) digits->Channel();
-        if (DigitMap.size() <= channelID) // expand the map of necessary
-          DigitMap.resize(std::max(channelID + 1, 2 * DigitMap.size()), {});
-        DigitMap[channelID] = std::move(digits);
-      } // for
-
-      // now go through all the hits...
-      for (size_t iHit = 0; iHit < srchits.size(); ++iHit) {
-        recob::Hit const& hit = srchits[iHit];
-        size_t channelID = (size_t) hit.Channel();
-
-        // no association if there is no digits to associate with
-        if ((channelID >= DigitMap.size()) || !DigitMap[channelID]) continue;
-
-        // create an association using the same digits pointer
-        RawDigitAssns->addSingle(DigitMap[channelID], CreatePtr(iHit));
-      } // for hits
+      std::vector<art::Ptr<raw::RawDigit>> const DigitMap = PtrsByChannel
+        (LeftPtrsByRightKey(*hHitToDigits, hHits.id(), hHits->size()));
+
+      // no association if there is no digits to associate with
+      AssociateHitsByChannel(*RawDigitAssns, srchits, DigitMap, makeHitPtr);
     } // if digit associations
 
   } // HitRefinerAssociator::put_into()
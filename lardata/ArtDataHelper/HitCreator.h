@@ -681,6 +681,202 @@ namespace recob {
 
 
 
+  /** **************************************************************************
+   * @brief A class handling a collection of hits filled by many threads.
+   *
+   * This class serves the same purpose as `HitCollectionCreator`, but hits
+   * are not added directly to it. Instead, the caller creates with
+   * `makeBuffers()` as many independent buffers as the partitions of its
+   * work (e.g. one per thread or one per channel range), and fills each
+   * buffer with `buffer(i).emplace_back(...)`. Different buffers can be filled
+   * concurrently without locking, as long as each buffer is used by a single
+   * thread at a time.
+   *
+   * When all buffers are complete, `put_into()` (or an explicit `merge()`)
+   * collects all their hits in a single collection, sorted by channel.
+   * Hits on the same channel keep the order of their buffers, and within a
+   * buffer they keep their insertion order: the result does not depend on the
+   * timing of the threads. If buffers are assigned to increasing channel
+   * ranges, the merge is a plain concatenation and no sorting is performed.
+   * The associations to wires and raw digits are created in a single pass
+   * after the merge.
+   *
+   * Example:
+   * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~{.cpp}
+   * recob::ConcurrentHitCollectionCreator hcol(event);
+   * hcol.makeBuffers(nThreads);
+   *
+   * // in thread iThread:
+   * auto& buffer = hcol.buffer(iThread);
+   * for (...) buffer.emplace_back(std::move(hit), wirePtr, digitPtr);
+   *
+   * // after all threads are done:
+   * hcol.put_into();
+   * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+   */
+  class ConcurrentHitCollectionCreator: public HitAndAssociationsWriterBase {
+  public:
+
+    /// A partition of the hit collection, to be filled by a single thread.
+    class Buffer {
+    public:
+
+      /**
+       * @brief Adds the specified hit to the buffer.
+       * @param hit the hit that will be moved into the buffer
+       * @param wire art pointer to the wire to be associated to this hit
+       * @param digits art pointer to the raw digits to be associated to the hit
+       *
+       * If a art pointer is not valid, that association will not be stored.
+       */
+      void emplace_back(
+        recob::Hit&& hit,
+        art::Ptr<recob::Wire> const& wire = art::Ptr<recob::Wire>(),
+        art::Ptr<raw::RawDigit> const& digits = art::Ptr<raw::RawDigit>()
+        );
+
+      /// Adds a copy of the specified hit to the buffer.
+      void emplace_back(
+        recob::Hit const& hit,
+        art::Ptr<recob::Wire> const& wire = art::Ptr<recob::Wire>(),
+        art::Ptr<raw::RawDigit> const& digits = art::Ptr<raw::RawDigit>()
+        )
+        { emplace_back(recob::Hit(hit), wire, digits); }
+
+      /// Adds the hit in the specified creator to the buffer.
+      void emplace_back(
+        HitCreator&& hit,
+        art::Ptr<recob::Wire> const& wire = art::Ptr<recob::Wire>(),
+        art::Ptr<raw::RawDigit> const& digits = art::Ptr<raw::RawDigit>()
+        )
+        { emplace_back(hit.move(), wire, digits); }
+
+      /// Adds the specified hit, associated only to raw digits.
+      void emplace_back(recob::Hit&& hit, art::Ptr<raw::RawDigit> const& digits)
+        { emplace_back(std::move(hit), art::Ptr<recob::Wire>(), digits); }
+
+      /// Adds the hit in the specified creator, associated only to raw digits.
+      void emplace_back(HitCreator&& hit, art::Ptr<raw::RawDigit> const& digits)
+        { emplace_back(hit.move(), art::Ptr<recob::Wire>(), digits); }
+
+      /// Returns the number of hits in this buffer.
+      size_t size() const { return hits.size(); }
+
+      /// Prepares the buffer to host at least `new_size` hits.
+      void reserve(size_t new_size);
+
+      /// Returns a read-only reference to the hits in this buffer.
+      std::vector<recob::Hit> const& peek() const { return hits; }
+
+    private:
+      friend class ConcurrentHitCollectionCreator;
+
+      std::vector<recob::Hit> hits; ///< Hits in this buffer.
+
+      /// Wire associated to each hit (empty if wire associations are off).
+      std::vector<art::Ptr<recob::Wire>> wires;
+
+      /// Digits associated to each hit (empty if digit associations are off).
+      std::vector<art::Ptr<raw::RawDigit>> digits;
+
+      bool doWireAssns = false; ///< Whether to record wire pointers.
+      bool doRawDigitAssns = false; ///< Whether to record digit pointers.
+
+    }; // class Buffer
+
+
+    /// @name Constructors
+    /// @{
+    /**
+     * @brief Constructor: sets instance name and whether to build associations.
+     * @param event the event the products are going to be put into
+     * @param instance_name name of the instance for all data products
+     * @param doWireAssns whether to enable associations to wires
+     * @param doRawDigitAssns whether to enable associations to raw digits
+     *
+     * All the data products (hit collection and associations) will have the
+     * specified product instance name.
+     * A single buffer is created.
+     */
+    ConcurrentHitCollectionCreator(
+      art::Event& event,
+      std::string instance_name = "",
+      bool doWireAssns = true, bool doRawDigitAssns = true
+      );
+
+    /**
+     * @brief Constructor: no product instance name.
+     * @param event the event the products are going to be put into
+     * @param doWireAssns whether to enable associations to wires
+     * @param doRawDigitAssns whether to enable associations to raw digits
+     */
+    ConcurrentHitCollectionCreator(
+      art::Event& event,
+      bool doWireAssns, bool doRawDigitAssns
+      ):
+      ConcurrentHitCollectionCreator(event, "", doWireAssns, doRawDigitAssns)
+      {}
+
+    /// @}
+
+
+    /// @name Buffer management
+    /// @{
+    /**
+     * @brief Creates `n` empty buffers, replacing the existing ones.
+     * @param n number of buffers
+     *
+     * This call is not thread-safe, and it invalidates all references to the
+     * existing buffers.
+     */
+    void makeBuffers(size_t n);
+
+    /// Returns the number of buffers.
+    size_t nBuffers() const { return buffers.size(); }
+
+    /// Returns the buffer with index `i` (no check is performed).
+    Buffer& buffer(size_t i) { return buffers[i]; }
+
+    /// Returns the buffer with index `i` (no check is performed).
+    Buffer const& buffer(size_t i) const { return buffers[i]; }
+    /// @}
+
+
+    /// Returns the number of hits currently in the buffers and collection.
+    size_t size() const;
+
+    /**
+     * @brief Moves all the buffers into the final hit collection.
+     *
+     * Hits are sorted by channel as explained in the class description, and
+     * their associations are created. All buffers are left empty, and more
+     * hits can be added to them: they will be merged on the next call,
+     * after the hits already in the collection.
+     * This function is not thread-safe.
+     */
+    void merge();
+
+    /**
+     * @brief Merges the buffers and moves the data into the event.
+     *
+     * The calling module must have already declared the production of these
+     * products with the proper instance name.
+     * After the move, the collections in this object are empty.
+     */
+    void put_into();
+
+    /// Returns the merged hits (buffers not merged yet are not included).
+    std::vector<recob::Hit> const& peek() const { return *hits; }
+
+
+  protected:
+
+    std::vector<Buffer> buffers; ///< Hits waiting to be merged.
+
+  }; // class ConcurrentHitCollectionCreator
+
+
+
 
   /** **************************************************************************
    * @brief A class handling a collection of hits and its associations.
@@ -1052,6 +1248,10 @@ namespace recob {
   /// A manager for `recob::HitCollectionCreator` writer class.
   using HitCollectionCreatorManager = HitAndAssociationsWriterManager<HitCollectionCreator>;
 
+  /// A manager for `recob::ConcurrentHitCollectionCreator` writer class.
+  using ConcurrentHitCollectionCreatorManager
+    = HitAndAssociationsWriterManager<ConcurrentHitCollectionCreator>;
+
 } // namespace recob
 
 
@@ -46,9 +46,16 @@ public:
     /// Access the vector of the feature vectors.
     std::vector< FeatureVector<N> > const & vectors() const { return *fVectors; }
 
-    /// Access feature vector data at index "key".
-    /// *** WOULD LIKE TO CHANGE TYPE OF FVEC DATA MEMBER TO std::array AND THEN ENABLE THIS FUNCTION ***
-    //const std::array<float, N> & getVector(size_t key) const { return (*fVectors)[key].data(); }
+    /// Access all the feature vectors as a flat block of size() x N values, stored
+    /// vector after vector (no copy).
+    util::span<float const*> vectorsBlock() const { return featureBlock(*fVectors); }
+
+    /// Access feature vector data at index "key" (no copy).
+    util::span<float const*> getVectorSpan(size_t key) const { return featureSpan((*fVectors)[key]); }
+
+    /// Access feature vector data idicated with art::Ptr::key() (no copy).
+    util::span<float const*> getVectorSpan(art::Ptr<T> const & item) const
+    { return getVectorSpan(item.key()); }
 
     /// Get copy of the feature vector at index "key".
     std::array<float, N> getVector(size_t key) const
@@ -125,6 +132,13 @@ public:
     /// Access the vector of the feature vectors.
     std::vector< FeatureVector<N> > const & outputs() const { return FVectorReader<T, N>::vectors(); }
 
+    /// Access all the MVA outputs as a flat block of size() x N values (no copy).
+    util::span<float const*> outputsBlock() const { return FVectorReader<T, N>::vectorsBlock(); }
+
+    /// Access the MVA output values at index "key" (no copy).
+    util::span<float const*> getOutputSpan(size_t key) const
+    { return FVectorReader<T, N>::getVectorSpan(key); }
+
     /// Get copy of the MVA output vector at index "key".
     std::array<float, N> getOutput(size_t key) const
     { return FVectorReader<T, N>::getVector(key); }
@@ -151,6 +165,35 @@ public:
         std::function<float (T const &)> fweight) const
     { return pAccumulate(items, fweight, FVectorReader<T, N>::vectors()); }
 
+    /// Get MVA results accumulated over each of many groups of items at once (eg. over
+    /// the hits of each of the clusters in the event). The items of group g are the
+    /// ones with key in keys[offsets[g]] ... keys[offsets[g + 1] - 1] (compressed
+    /// sparse row layout). The result of each group is the same as from getOutput().
+    std::vector< std::array<float, N> > getOutputs(
+        std::vector<size_t> const & offsets, std::vector<size_t> const & keys) const
+    { return pAccumulateGroups<N>(offsets, keys, outputsBlock().begin()); }
+
+    /// Get MVA results accumulated over groups of items, weighted with weights[k] for
+    /// the item keys[k] (see getOutputs() without weights for the group layout).
+    std::vector< std::array<float, N> > getOutputs(
+        std::vector<size_t> const & offsets, std::vector<size_t> const & keys,
+        std::vector<float> const & weights) const
+    { return pAccumulateGroups<N>(offsets, keys, outputsBlock().begin(), [&weights](size_t k){ return weights[k]; }); }
+
+    /// Get MVA results accumulated over groups of items, weighted with the result
+    /// of weight(k) for the item keys[k]; weight can be any callable object (eg. a
+    /// lambda), which is inlined.
+    template <typename Weight>
+    std::vector< std::array<float, N> > getOutputs(
+        std::vector<size_t> const & offsets, std::vector<size_t> const & keys,
+        Weight weight) const
+    { return pAccumulateGroups<N>(offsets, keys, outputsBlock().begin(), weight); }
+
+    /// Get MVA results accumulated over each of the groups of items (eg. the result
+    /// of art::FindManyP for all the clusters in the event).
+    std::vector< std::array<float, N> > getOutputs(
+        std::vector< std::vector< art::Ptr<T> > > const & groups) const;
+
     /// Meaning/name of the index'th column in the collection of MVA output vectors.
     const std::string & outputName(size_t index) const { return FVectorReader<T, N>::columnName(index); }
 
@@ -175,7 +218,7 @@ anab::FVectorReader<T, N>::FVectorReader(const art::Event & evt, const art::Inpu
     auto descriptionHandle = evt.getValidHandle< std::vector< anab::FVecDescription<N> > >(tag);
 
     // search for FVecDescription<N> produced for the type T, with the instance name from the tag
-    std::string outputInstanceName = tag.instance() + getProductName(typeid(T));
+    std::string outputInstanceName = tag.instance() + getProductName<T>();
     for (auto const & dscr : *descriptionHandle)
     {
         if (dscr.outputInstance() == outputInstanceName)
@@ -211,7 +254,7 @@ anab::FVectorReader<T, N>::FVectorReader(const art::Event & evt, const art::Inpu
     if (!evt.getByLabel( tag, descriptionHandle )) { return; }
 
     // search for FVecDescription<N> produced for the type T, with the instance name from the tag
-    std::string outputInstanceName = tag.instance() + getProductName(typeid(T));
+    std::string outputInstanceName = tag.instance() + getProductName<T>();
     for (auto const & dscr : *descriptionHandle)
     {
         if (dscr.outputInstance() == outputInstanceName)
@@ -236,6 +279,23 @@ anab::FVectorReader<T, N>::FVectorReader(const art::Event & evt, const art::Inpu
     success = true; // ok, all data found in the event
 }
 //----------------------------------------------------------------------------
+// MVAReader functions.
+//
+template <class T, size_t N>
+std::vector< std::array<float, N> > anab::MVAReader<T, N>::getOutputs(
+    std::vector< std::vector< art::Ptr<T> > > const & groups) const
+{
+    std::vector<size_t> offsets, keys;
+    offsets.reserve(groups.size() + 1);
+    offsets.push_back(0);
+    for (auto const & items : groups)
+    {
+        for (auto const & ptr : items) { keys.push_back(ptr.key()); }
+        offsets.push_back(keys.size());
+    }
+    return getOutputs(offsets, keys);
+}
+//----------------------------------------------------------------------------
 
 #endif //ANAB_MVAREADER
 
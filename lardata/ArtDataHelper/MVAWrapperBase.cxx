@@ -11,10 +11,11 @@
 
 #include <cxxabi.h>
 #include <algorithm>
+#include <atomic>
 
 namespace anab {
 
-std::string FVectorWrapperBase::getProductName(std::type_info const & ti) const
+std::string FVectorWrapperBase::getProductName(std::type_info const & ti)
 {
     char* realname;
     int status;
@@ -29,4 +30,10 @@ std::string FVectorWrapperBase::getProductName(std::type_info const & ti) const
     return pname;
 }
 
+size_t FVectorWrapperBase::nextTypeIndex()
+{
+    static std::atomic<size_t> nTypes(0);
+    return nTypes++;
+}
+
 } // namespace anab
@@ -11,13 +11,16 @@
 
 #include "canvas/Persistency/Common/Ptr.h"
 
+#include "larcorealg/CoreUtils/span.h"
 #include "lardataobj/AnalysisBase/MVAOutput.h"
 
 #include <typeinfo>
+#include <type_traits>
 #include <functional>
 #include <string>
 #include <unordered_map>
 #include <cmath>
+#include <algorithm>
 
 namespace anab {
 
@@ -27,9 +30,64 @@ public:
 
 protected:
 
-    std::string getProductName(std::type_info const & ti) const;
-    size_t getProductHash(std::type_info const & ti) const { return ti.hash_code(); }
+    static std::string getProductName(std::type_info const & ti);
 
+    /// Name of the data product type T, demangled only at the first call for each type.
+    template <class T>
+    static std::string const & getProductName()
+    {
+        static std::string const name = getProductName(typeid(T));
+        return name;
+    }
+
+    /// Small integer unique to the type T in the process, assigned at the first call
+    /// for each type: per-type lookup tables can be plain vectors indexed by it.
+    template <class T>
+    static size_t getTypeIndex()
+    {
+        static size_t const index = nextTypeIndex();
+        return index;
+    }
+
+    /// Flat view of all the values in the collection of feature vectors: vector k
+    /// occupies the values from k*N to (k+1)*N, so that a whole [nItems x N] block
+    /// can be written or read without copying vector by vector.
+    template <size_t N>
+    static util::span<float*> featureBlock(std::vector< FeatureVector<N> > & vectors)
+    {
+        static_assert(hasFlatLayout<N>(), "FeatureVector<N> is not a plain array of N floats");
+        float* data = reinterpret_cast<float*>(vectors.data());
+        return util::make_span(data, data + vectors.size() * N);
+    }
+
+    template <size_t N>
+    static util::span<float const*> featureBlock(std::vector< FeatureVector<N> > const & vectors)
+    {
+        static_assert(hasFlatLayout<N>(), "FeatureVector<N> is not a plain array of N floats");
+        float const* data = reinterpret_cast<float const*>(vectors.data());
+        return util::make_span(data, data + vectors.size() * N);
+    }
+
+    /// View of the values of a single feature vector (no copy).
+    template <size_t N>
+    static util::span<float const*> featureSpan(FeatureVector<N> const & vec)
+    {
+        static_assert(hasFlatLayout<N>(), "FeatureVector<N> is not a plain array of N floats");
+        float const* data = reinterpret_cast<float const*>(&vec);
+        return util::make_span(data, data + N);
+    }
+
+    // the flat views rely on FeatureVector<N> being a plain array of N floats
+    template <size_t N>
+    static constexpr bool hasFlatLayout()
+    {
+        return std::is_standard_layout_v< FeatureVector<N> >
+            && std::is_trivially_copyable_v< FeatureVector<N> >
+            && (sizeof(FeatureVector<N>) == N * sizeof(float));
+    }
+
+private:
+    static size_t nextTypeIndex();
 };
 
 /// Helper functions for MVAReader and MVAWriter wrappers.
@@ -69,6 +127,23 @@ protected:
         std::vector< art::Ptr<T> > const & items,
         std::vector< FeatureVector<N> > const & outs,
         std::array<char, N> const & mask) const;
+
+    // batch version, accumulating outputs for many groups of items at once
+    // (eg. for all the clusters in the event), with the same result as above:
+    // - group g is made of the items with keys[offsets[g]] ... keys[offsets[g + 1] - 1]
+    // - outs is the contiguous block of N outputs per item (item k from outs[k*N])
+    // - weight(k) is called with the index k in keys, and should return a float
+
+    template <size_t N, typename Weight>
+    std::vector< std::array<float, N> > pAccumulateGroups(
+        std::vector<size_t> const & offsets, std::vector<size_t> const & keys,
+        float const * outs, Weight weight) const;
+
+    template <size_t N>
+    std::vector< std::array<float, N> > pAccumulateGroups(
+        std::vector<size_t> const & offsets, std::vector<size_t> const & keys,
+        float const * outs) const
+    { return pAccumulateGroups<N>(offsets, keys, outs, [](size_t){ return 1.0F; }); }
 };
 
 } // namespace anab
@@ -285,6 +360,58 @@ std::array<float, N> anab::MVAWrapperBase::pAccumulate(
 }
 //----------------------------------------------------------------------------
 
+template <size_t N, typename Weight>
+std::vector< std::array<float, N> > anab::MVAWrapperBase::pAccumulateGroups(
+    std::vector<size_t> const & offsets, std::vector<size_t> const & keys,
+    float const * outs, Weight weight) const
+{
+    float const pmin = 1.0e-6, pmax = 1.0 - pmin;
+
+    size_t const nGroups = offsets.empty() ? 0 : offsets.size() - 1;
+    std::vector< std::array<float, N> > results(nGroups);
+
+    std::array<double, N> acc;
+    std::array<float, N> logs;
+    for (size_t g = 0; g < nGroups; ++g)
+    {
+        acc.fill(0);
+        double totw = 0.0;
+
+        for (size_t k = offsets[g]; k < offsets[g + 1]; ++k)
+        {
+            float const w = weight(k);
+            if (w == 0) continue;
+
+            // clamp, log and accumulate in separate branchless loops: the clamp
+            // and the accumulation can be vectorized, while std::log stays a
+            // scalar call unless fast math and a vector math library are used;
+            // NaN outputs go through as in pAccumulate()
+            float const * vout = outs + keys[k] * N;
+            for (size_t i = 0; i < N; ++i) logs[i] = std::min(std::max(vout[i], pmin), pmax);
+            for (size_t i = 0; i < N; ++i) logs[i] = std::log(logs[i]);
+            for (size_t i = 0; i < N; ++i) acc[i] += w * logs[i];
+
+            totw += w;
+        }
+
+        if (offsets[g + 1] > offsets[g])
+        {
+            double totp = 0.0;
+            for (size_t i = 0; i < N; ++i)
+            {
+                acc[i] = std::exp(acc[i] / totw);
+                totp += acc[i];
+            }
+            for (size_t i = 0; i < N; ++i) { acc[i] /= totp; }
+        }
+        else acc.fill(1.0 / N);
+
+        for (size_t i = 0; i < N; ++i) results[g][i] = acc[i];
+    }
+    return results;
+}
+//----------------------------------------------------------------------------
+
 //----------------------------------------------------------------------------
 // functions with the mask tagging groups og labels
 //----------------------------------------------------------------------------
@@ -15,6 +15,9 @@
 
 #include "lardata/ArtDataHelper/MVAWrapperBase.h"
 
+#include <algorithm>
+#include <limits>
+
 namespace anab {
 
 /// Index to the MVA output / FeatureVector collection, used when result vectors are added or set.
@@ -80,6 +83,19 @@ public:
     void addVector(FVector_ID id, std::vector<float> const & values) { fVectors[id]->emplace_back(values); }
     void addVector(FVector_ID id, std::vector<double> const & values) { fVectors[id]->emplace_back(values); }
 
+    /// Copy nItems feature vectors from a block of nItems x N values, stored vector after
+    /// vector (eg. the output of a batched CNN inference), to the vectors starting at index
+    /// "first"; the collection is extended if it is shorter than first + nItems.
+    void setVectors(FVector_ID id, size_t first, float const * block, size_t nItems);
+
+    /// Append nItems feature vectors from a block of nItems x N values.
+    void addVectors(FVector_ID id, float const * block, size_t nItems) { setVectors(id, size(id), block, nItems); }
+
+    /// Writable flat view of all the values, size(id) x N, stored vector after vector.
+    /// The inference output can be written directly there, with no intermediate buffer,
+    /// after initializing the collection with initOutputs() to the required size.
+    util::span<float*> vectorsBlock(FVector_ID id) { return featureBlock(*(fVectors[id])); }
+
     /// Set tag of associated data products in case it was not ready at the initialization time.
     void setDataTag(FVector_ID id, art::InputTag const & dataTag) { (*fDescriptions)[id].setDataTag(dataTag.encode()); }
 
@@ -112,6 +128,11 @@ public:
         return vout;
     }
 
+    /// Access the values of the feature vector for the type T, at index "key" (no copy).
+    template <class T>
+    util::span<float const*> getVectorSpan(size_t key) const
+    { return featureSpan( ( *(fVectors[getProductID<T>()]) )[key] ); }
+
     friend std::ostream& operator<< (std::ostream &o, FVectorWriter const& a)
     {
         o << "FVectorWriter for " << a.fInstanceName << ", " << N << " outputs";
@@ -138,12 +159,14 @@ private:
     std::vector< std::string > fRegisteredDataTypes;
     bool fIsDescriptionRegistered;
 
-    std::unordered_map< size_t, FVector_ID > fTypeHashToID;
+    /// ID of the collection of each type, indexed by getTypeIndex<T>() (NoID if none).
+    std::vector< FVector_ID > fTypeToID;
+    static constexpr FVector_ID NoID = std::numeric_limits<FVector_ID>::max();
 
     std::unique_ptr< std::vector< anab::FVecDescription<N> > > fDescriptions;
     void clearEventData()
     {
-        fTypeHashToID.clear(); fVectors.clear();
+        std::fill(fTypeToID.begin(), fTypeToID.end(), NoID); fVectors.clear();
         fDescriptions.reset(nullptr);
     }
 
@@ -182,6 +205,12 @@ public:
     void addOutput(FVector_ID id, std::vector<float> const & values) { FVectorWriter<N>::addVector(id, values); }
     void addOutput(FVector_ID id, std::vector<double> const & values) { FVectorWriter<N>::addVector(id, values); }
 
+    void setOutputs(FVector_ID id, size_t first, float const * block, size_t nItems) { FVectorWriter<N>::setVectors(id, first, block, nItems); }
+    void addOutputs(FVector_ID id, float const * block, size_t nItems) { FVectorWriter<N>::addVectors(id, block, nItems); }
+
+    /// Writable flat view of all the MVA outputs for the collection "id" (see vectorsBlock()).
+    util::span<float*> outputsBlock(FVector_ID id) { return FVectorWriter<N>::vectorsBlock(id); }
+
 
     /// Get MVA results accumulated over the vector of items (eg. over hits associated to a cluster).
     /// NOTE: MVA outputs for these items has to be added to the MVAWriter first!
@@ -231,12 +260,11 @@ template <size_t N>
 template <class T>
 anab::FVector_ID anab::FVectorWriter<N>::getProductID() const
 {
-    auto const & ti = typeid(T);
-    auto search = fTypeHashToID.find(getProductHash(ti));
-    if (search != fTypeHashToID.end()) { return search->second; }
+    size_t const index = getTypeIndex<T>();
+    if ((index < fTypeToID.size()) && (fTypeToID[index] != NoID)) { return fTypeToID[index]; }
     else
     {
-        throw cet::exception("FVectorWriter") << "Feature vectors not initialized for product " << getProductName(ti) << std::endl;
+        throw cet::exception("FVectorWriter") << "Feature vectors not initialized for product " << getProductName<T>() << std::endl;
     }
 }
 //----------------------------------------------------------------------------
@@ -256,7 +284,7 @@ template <size_t N>
 template <class T>
 void anab::FVectorWriter<N>::produces_using()
 {
-    std::string dataName = getProductName(typeid(T));
+    std::string const & dataName = getProductName<T>();
     if (dataTypeRegistered(dataName))
     {
         throw cet::exception("FVectorWriter") << "Type " << dataName << "was already registered." << std::endl;
@@ -293,8 +321,8 @@ anab::FVector_ID anab::FVectorWriter<N>::initOutputs(
     std::string const & dataTag, size_t dataSize,
     std::vector< std::string > const & names)
 {
-    size_t dataHash = getProductHash(typeid(T));
-    std::string dataName = getProductName(typeid(T));
+    size_t const typeIndex = getTypeIndex<T>();
+    std::string const & dataName = getProductName<T>();
 
     if (!dataTypeRegistered(dataName))
     {
@@ -313,7 +341,8 @@ anab::FVector_ID anab::FVectorWriter<N>::initOutputs(
 
     fVectors.push_back( std::make_unique< std::vector< anab::FeatureVector<N> > >() );
     anab::FVector_ID id = fVectors.size() - 1;
-    fTypeHashToID[dataHash] = id;
+    if (typeIndex >= fTypeToID.size()) { fTypeToID.resize(typeIndex + 1, NoID); }
+    fTypeToID[typeIndex] = id;
 
     if (dataSize) { fVectors[id]->resize(dataSize, anab::FeatureVector<N>(0.0F)); }
 
@@ -321,6 +350,17 @@ anab::FVector_ID anab::FVectorWriter<N>::initOutputs(
 }
 //----------------------------------------------------------------------------
 
+template <size_t N>
+void anab::FVectorWriter<N>::setVectors(FVector_ID id, size_t first, float const * block, size_t nItems)
+{
+    auto & vectors = *(fVectors[id]);
+    if (vectors.size() < first + nItems) { vectors.resize(first + nItems, anab::FeatureVector<N>(0.0F)); }
+
+    auto dest = featureBlock(vectors);
+    std::copy(block, block + nItems * N, dest.begin() + first * N);
+}
+//----------------------------------------------------------------------------
+
 template <size_t N>
 void anab::FVectorWriter<N>::saveOutputs(art::Event & evt)
 {
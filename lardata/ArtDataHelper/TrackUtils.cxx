@@ -26,9 +26,69 @@
 // ROOT libraries
 
 // C/C++ standard libraries
+#include <algorithm> // std::find()
+#include <limits> // std::numeric_limits<>
 #include <cmath>
 
 
+namespace {
+
+   /// Returns the angle from vertical of the wires of the first plane on `view`
+   /// (`0` if there is no such plane).
+   double AngleToVertical(geo::GeometryCore const& geom, geo::View_t view) {
+      for(unsigned int i = 0; i < geom.Nplanes(); ++i){
+         if(geom.Plane(i).View() == view)
+            return geom.Plane(i).Wire(0).ThetaZ(false) - 0.5*::util::pi<>();
+      }
+      return 0.;
+   } // AngleToVertical()
+
+
+   /// Adds to each of the `nViews` `lengths` the length of the track projected
+   /// on the view with the specified angle of the wires from the vertical.
+   void AddProjectedLengths(
+      recob::Track const& track, std::size_t nViews,
+      double const* sinAngleToVert, double const* cosAngleToVert,
+      double* lengths
+   ) {
+      // loop over all points in the trajectory and add the contribution
+      // to each view
+      for(size_t p = 1; p < track.NumberTrajectoryPoints(); ++p){
+         const auto& pos_cur = track.LocationAtPoint(p);
+         const auto& pos_prev = track.LocationAtPoint(p - 1);
+         double dist = std::sqrt( std::pow(pos_cur.x() - pos_prev.x(), 2) +
+            std::pow(pos_cur.y() - pos_prev.y(), 2) +
+            std::pow(pos_cur.z() - pos_prev.z(), 2) );
+
+         // (sin(angleToVert),cos(angleToVert)) is the direction perpendicular to wire
+         // fDir[p-1] is the direction between the two relevant points
+         const auto& dir_prev = track.DirectionAtPoint(p - 1);
+         double const dirY = dir_prev.Y(), dirZ = dir_prev.Z();
+         for(std::size_t v = 0; v < nViews; ++v){
+            double cosgamma
+               = std::abs(sinAngleToVert[v]*dirY + cosAngleToVert[v]*dirZ);
+
+            /// @todo is this right, or should it be dist*cosgamma???
+            lengths[v] += dist/cosgamma;
+         } // for views
+      } // end loop over distances between trajectory points
+   } // AddProjectedLengths()
+
+
+   /// Throws if `trajectory_point` is not a valid point of `track`.
+   void CheckTrajectoryPoint
+      (recob::Track const& track, size_t trajectory_point)
+   {
+      if(trajectory_point >= track.NumberTrajectoryPoints()) {
+         throw cet::exception("TrackPitchInView") << "ERROR: Asking for trajectory point #"
+            << trajectory_point << " when trajectory vector size is of size "
+            << track.NumberTrajectoryPoints() << ".\n";
+      }
+   } // CheckTrajectoryPoint()
+
+} // local namespace
+
+
 
 //------------------------------------------------------------------------------
 double lar::util::TrackProjectedLength(recob::Track const& track, geo::View_t view) {
@@ -40,33 +100,11 @@ double lar::util::TrackProjectedLength(recob::Track const& track, geo::View_t vi
    double length = 0.;
 
    auto const* geom = lar::providerFrom<geo::Geometry>();
-   double angleToVert = 0.;
-   for(unsigned int i = 0; i < geom->Nplanes(); ++i){
-      if(geom->Plane(i).View() == view){
-         angleToVert = geom->Plane(i).Wire(0).ThetaZ(false) - 0.5*::util::pi<>();
-         break;
-      }
-   }
-
-   // now loop over all points in the trajectory and add the contribution to the
-   // to the desired view
+   double const angleToVert = AngleToVertical(*geom, view);
+   double const sinAngleToVert = std::sin(angleToVert);
+   double const cosAngleToVert = std::cos(angleToVert);
 
-   for(size_t p = 1; p < track.NumberTrajectoryPoints(); ++p){
-      const auto& pos_cur = track.LocationAtPoint(p);
-      const auto& pos_prev = track.LocationAtPoint(p - 1);
-      double dist = std::sqrt( std::pow(pos_cur.x() - pos_prev.x(), 2) +
-         std::pow(pos_cur.y() - pos_prev.y(), 2) +
-         std::pow(pos_cur.z() - pos_prev.z(), 2) );
-
-      // (sin(angleToVert),cos(angleToVert)) is the direction perpendicular to wire
-      // fDir[p-1] is the direction between the two relevant points
-      const auto& dir_prev = track.DirectionAtPoint(p - 1);
-      double cosgamma = std::abs(std::sin(angleToVert)*dir_prev.Y() +
-         std::cos(angleToVert)*dir_prev.Z() );
-
-      /// @todo is this right, or should it be dist*cosgamma???
-      length += dist/cosgamma;
-   } // end loop over distances between trajectory points
+   AddProjectedLengths(track, 1U, &sinAngleToVert, &cosAngleToVert, &length);
 
    return length;
 } // lar::util::TrackProjectedLength()
@@ -86,11 +124,7 @@ double lar::util::TrackPitchInView
     */
 
 
-   if(trajectory_point >= track.NumberTrajectoryPoints()) {
-      cet::exception("TrackPitchInView") << "ERROR: Asking for trajectory point #"
-         << trajectory_point << " when trajectory vector size is of size "
-         << track.NumberTrajectoryPoints() << ".\n";
-   }
+   CheckTrajectoryPoint(track, trajectory_point);
    recob::Track::TrajectoryPoint_t const& point
      = track.TrajectoryPoint(trajectory_point);
 
@@ -146,3 +180,117 @@ double lar::util::TrackPitchInView
 } // lar::util::TrackPitchInView()
 
 //------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------
+//--- lar::util::TrackViewTable
+//---
+std::vector<double> const& lar::util::TrackViewTable::forView
+  (geo::View_t view) const
+{
+   auto const iView = std::find(views.begin(), views.end(), view);
+   if (iView == views.end()) {
+      throw cet::exception("TrackViewTable")
+        << "no values for view " << geo::PlaneGeo::ViewName(view) << ".\n";
+   }
+   return values[iView - views.begin()];
+} // lar::util::TrackViewTable::forView()
+
+
+//------------------------------------------------------------------------------
+//--- lar::util::TrackViewProjector
+//---
+lar::util::TrackViewProjector::TrackViewProjector
+  (geo::GeometryCore const& geom)
+  : fGeom(&geom)
+{
+   // views are taken from the first TPC, like in TrackProjectedLength()
+   for(unsigned int i = 0; i < geom.Nplanes(); ++i){
+      geo::View_t const view = geom.Plane(i).View();
+      if (std::find(fViews.begin(), fViews.end(), view) != fViews.end())
+         continue;
+      double const angleToVert = AngleToVertical(geom, view);
+      fViews.push_back(view);
+      fSinAngleToVert.push_back(std::sin(angleToVert));
+      fCosAngleToVert.push_back(std::cos(angleToVert));
+   } // for planes
+} // lar::util::TrackViewProjector::TrackViewProjector()
+
+
+//------------------------------------------------------------------------------
+double lar::util::TrackViewProjector::ProjectedLength
+  (recob::Track const& track, geo::View_t view) const
+{
+   if(view == geo::kUnknown) {
+      throw cet::exception("TrackProjectedLength") << "cannot provide projected length for "
+        << "unknown view\n";
+   }
+   std::size_t const iView = std::find(fViews.begin(), fViews.end(), view)
+     - fViews.begin();
+   double length = 0.;
+   if (iView < fViews.size()) {
+      AddProjectedLengths(track, 1U,
+        &fSinAngleToVert[iView], &fCosAngleToVert[iView], &length);
+   }
+   else { // like TrackProjectedLength(), when no plane has this view
+      double const sinAngleToVert = 0.0, cosAngleToVert = 1.0;
+      AddProjectedLengths
+        (track, 1U, &sinAngleToVert, &cosAngleToVert, &length);
+   }
+   return length;
+} // lar::util::TrackViewProjector::ProjectedLength()
+
+
+//------------------------------------------------------------------------------
+void lar::util::TrackViewProjector::ProjectedLengths
+  (recob::Track const& track, double* lengths) const
+{
+   std::fill(lengths, lengths + NViews(), 0.0);
+   AddProjectedLengths(track, NViews(),
+     fSinAngleToVert.data(), fCosAngleToVert.data(), lengths);
+} // lar::util::TrackViewProjector::ProjectedLengths()
+
+
+//------------------------------------------------------------------------------
+void lar::util::TrackViewProjector::PitchesInViews(
+   recob::Track const& track, double* pitches,
+   size_t trajectory_point /* = 0U */
+) const {
+
+   CheckTrajectoryPoint(track, trajectory_point);
+   recob::Track::TrajectoryPoint_t const& point
+     = track.TrajectoryPoint(trajectory_point);
+
+   // this throws if the position is not in any TPC;
+   // the TPC is looked up only once for all the views
+   geo::TPCGeo const& tpc = fGeom->PositionToTPC(point.position);
+   auto const dir = point.direction();
+
+   lar::util::RealComparisons const check(1e-4);
+   for (std::size_t iView = 0; iView < NViews(); ++iView) {
+      // this throws if there is no plane with this view in the TPC
+      geo::PlaneGeo const& plane = tpc.Plane(fViews[iView]);
+
+      // same as in TrackPitchInView()
+      auto const& proj = plane.Projection(dir);
+      pitches[iView] = check.zero(proj.Y())
+        ? std::numeric_limits<double>::infinity()
+        : proj.R() / std::abs(proj.Y()) * plane.WirePitch()
+        ;
+   } // for views
+
+} // lar::util::TrackViewProjector::PitchesInViews()
+
+
+//------------------------------------------------------------------------------
+lar::util::TrackViewTable lar::util::TrackViewProjector::MakeTable
+  (std::size_t nTracks) const
+{
+   TrackViewTable table;
+   table.views = fViews;
+   table.values.assign(NViews(), std::vector<double>(nTracks, 0.0));
+   return table;
+} // lar::util::TrackViewProjector::MakeTable()
+
+
+//------------------------------------------------------------------------------
@@ -9,6 +9,9 @@
  * `lar::util::TrackProjectedLength()` and `lar::util::TrackPitchInView()` have
  * been factored out from `recob::Track`, from `recob::Track::ProjectedLength()`
  * and `recob::Track::PitchInView()` respectively.
+ *
+ * `lar::util::TrackViewProjector` computes the same quantities for many tracks
+ * and all the views at once.
  */
 
 #ifndef LARDATA_ARTDATAHELPER_TRACKUTILS_H
@@ -17,7 +20,13 @@
 // LArSoft libraries
 #include "larcoreobj/SimpleTypesAndConstants/geo_types.h" // geo::View_t
 
+// C/C++ standard libraries
+#include <vector>
+#include <iterator> // std::size()
+#include <cstddef> // std::size_t
+
 namespace recob { class Track; }
+namespace geo { class GeometryCore; }
 
 namespace lar::util {
 
@@ -65,7 +74,173 @@ namespace lar::util {
     (recob::Track const& track, geo::View_t view, size_t trajectory_point = 0U);
 
 
+  /// Values of a quantity for a list of tracks, in each view (one array each).
+  struct TrackViewTable {
+    std::vector<geo::View_t> views; ///< The views, in order.
+    std::vector<std::vector<double>> values; ///< `values[iView][iTrack]`
+
+    /// Returns the values of all the tracks in `view`.
+    /// @throw cet::exception (category `"TrackViewTable"`) if view not present
+    std::vector<double> const& forView(geo::View_t view) const;
+
+  }; // struct TrackViewTable
+
+
+  /**
+   * @brief Computes track projections on all the views at once.
+   *
+   * The results are the same as the ones of `TrackProjectedLength()` and
+   * `TrackPitchInView()`, but the geometry information needed is looked up
+   * only once:
+   * * the orientation of the wires of each view is cached at construction
+   *   (it is taken from the first TPC, like `TrackProjectedLength()` does);
+   * * the TPC containing a trajectory point is found once per track, rather
+   *   than once per view.
+   *
+   * The trajectory of each track is also traversed only once, computing the
+   * contribution of each step to all the views together.
+   *
+   * The batch functions accept any collection of tracks, or of objects
+   * dereferencing to tracks (like `art::Ptr<recob::Track>` and track proxies),
+   * and return one array per view, with one entry per track in the same order
+   * as in the input.
+   *
+   * Example:
+   * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~{.cpp}
+   * lar::util::TrackViewProjector const projector
+   *   { *(lar::providerFrom<geo::Geometry>()) };
+   *
+   * auto const& tracks
+   *   = *(event.getValidHandle<std::vector<recob::Track>>(trackTag));
+   * lar::util::TrackViewTable const lengths
+   *   = projector.ProjectedLengths(tracks);
+   * std::vector<double> const& lengthsOnZ = lengths.forView(geo::kZ);
+   * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+   *
+   * The projector must be recreated if the geometry changes.
+   */
+  class TrackViewProjector {
+      public:
+
+    /// Caches the information of all the views in `geom`.
+    explicit TrackViewProjector(geo::GeometryCore const& geom);
+
+    /// Returns the list of the views the results are computed for.
+    std::vector<geo::View_t> const& Views() const { return fViews; }
+
+    /// Returns the number of views the results are computed for.
+    std::size_t NViews() const { return fViews.size(); }
+
+
+    /// Returns the same as `TrackProjectedLength(track, view)`.
+    double ProjectedLength(recob::Track const& track, geo::View_t view) const;
+
+    /**
+     * @brief Computes the projected length of `track` on all the views.
+     * @param track the track to be projected
+     * @param lengths array of `NViews()` values to be filled [cm]
+     */
+    void ProjectedLengths(recob::Track const& track, double* lengths) const;
+
+    /// Returns the projected length of each of the `tracks` in each view.
+    template <typename Tracks>
+    TrackViewTable ProjectedLengths(Tracks const& tracks) const;
+
+
+    /**
+     * @brief Computes the pitch of `track` on all the views.
+     * @param track the track to be projected
+     * @param pitches array of `NViews()` values to be filled [cm]
+     * @param trajectory_point the point of the track to get the pitch at
+     * @throw cet::exception like `TrackPitchInView()`
+     *
+     * Unlike `TrackPitchInView()`, when the track is almost parallel to the
+     * wires of a view no exception is thrown, and the pitch on that view is
+     * set to infinity instead, so that the other views are still computed.
+     */
+    void PitchesInViews
+      (recob::Track const& track, double* pitches, size_t trajectory_point = 0U)
+      const;
+
+    /// Returns the pitch of each of the `tracks` in each view
+    /// (see `PitchesInViews(recob::Track const&, double*, size_t)`).
+    template <typename Tracks>
+    TrackViewTable PitchesInViews
+      (Tracks const& tracks, size_t trajectory_point = 0U) const;
+
+
+      private:
+    geo::GeometryCore const* fGeom; ///< Geometry used for the TPC lookups.
+
+    std::vector<geo::View_t> fViews; ///< The views, in order.
+
+    /// For each view, sine of the angle of the wires from the vertical.
+    std::vector<double> fSinAngleToVert;
+
+    /// For each view, cosine of the angle of the wires from the vertical.
+    std::vector<double> fCosAngleToVert;
+
+    /// Returns an empty table with room for `nTracks` values per view.
+    TrackViewTable MakeTable(std::size_t nTracks) const;
+
+    /// Returns the track from a track or from an object pointing to one.
+    static recob::Track const& TrackOf(recob::Track const& track)
+      { return track; }
+    template <typename TrackRef>
+    static recob::Track const& TrackOf(TrackRef const& track)
+      { return *track; }
+
+  }; // class TrackViewProjector
+
+
 } // namespace lar::util
 
 
+//------------------------------------------------------------------------------
+//--- template implementation
+//---
+template <typename Tracks>
+lar::util::TrackViewTable lar::util::TrackViewProjector::ProjectedLengths
+  (Tracks const& tracks) const
+{
+  std::size_t const nTracks = std::size(tracks);
+  TrackViewTable table = MakeTable(nTracks);
+
+  std::vector<double> lengths(NViews());
+  std::size_t iTrack = 0;
+  for (auto const& track: tracks) {
+    ProjectedLengths(TrackOf(track), lengths.data());
+    for (std::size_t iView = 0; iView < lengths.size(); ++iView)
+      table.values[iView][iTrack] = lengths[iView];
+    ++iTrack;
+  } // for
+
+  return table;
+} // lar::util::TrackViewProjector::ProjectedLengths()
+
+
+//------------------------------------------------------------------------------
+template <typename Tracks>
+lar::util::TrackViewTable lar::util::TrackViewProjector::PitchesInViews
+  (Tracks const& tracks, size_t trajectory_point /* = 0U */) const
+{
+  std::size_t const nTracks = std::size(tracks);
+  TrackViewTable table = MakeTable(nTracks);
+
+  std::vector<double> pitches(NViews());
+  std::size_t iTrack = 0;
+  for (auto const& track: tracks) {
+    PitchesInViews(TrackOf(track), pitches.data(), trajectory_point);
+    for (std::size_t iView = 0; iView < pitches.size(); ++iView)
+      table.values[iView][iTrack] = pitches[iView];
+    ++iTrack;
+  } // for
+
+  return table;
+} // lar::util::TrackViewProjector::PitchesInViews()
+
+
+//------------------------------------------------------------------------------
+
+
 #endif // LARDATA_ARTDATAHELPER_TRACKUTILS_H
@@ -25,6 +25,60 @@
 /// Reconstruction base classes
 namespace recob {
 
+  //****************************************************************************
+  //***  WireROIBuilder
+  //----------------------------------------------------------------------
+  WireROIBuilder::WireROIBuilder(
+    std::size_t nTicks, Sample_t threshold,
+    std::size_t padBefore /* = 0U */, std::size_t padAfter /* = 0U */,
+    std::size_t regionCapacity /* = 0U */
+    )
+    : fNTicks(nTicks)
+    , fThreshold(threshold)
+    , fPadAfter(padAfter)
+    , fHistory(padBefore)
+  {
+    fBuffer.reserve(regionCapacity);
+  } // WireROIBuilder::WireROIBuilder()
+
+
+  //----------------------------------------------------------------------
+  void WireROIBuilder::openROI() {
+    fInROI = true;
+    fBufferStart = fTick - fHistorySize;
+    if (fHistorySize == 0U) return;
+
+    std::size_t iHistory
+      = (fHistoryNext + fHistory.size() - fHistorySize) % fHistory.size();
+    for (std::size_t i = 0; i < fHistorySize; ++i) {
+      fBuffer.push_back(fHistory[iHistory]);
+      if (++iHistory == fHistory.size()) iHistory = 0U;
+    } // for
+    fHistorySize = 0U;
+  } // WireROIBuilder::openROI()
+
+
+  //----------------------------------------------------------------------
+  WireROIBuilder::RegionsOfInterest_t WireROIBuilder::finish() {
+    closeROI();
+    fROIs.resize(fNTicks);
+    return std::move(fROIs);
+  } // WireROIBuilder::finish()
+
+
+  //----------------------------------------------------------------------
+  void WireROIBuilder::closeROI() {
+    if (!fInROI) return;
+    fROIs.add_range(fBufferStart, fBuffer.begin(), fBuffer.end());
+    fBuffer.clear(); // capacity is kept for the next region
+    fInROI = false;
+    fBelow = 0U;
+  } // WireROIBuilder::closeROI()
+
+
+  //****************************************************************************
+  //***  WireCreator
+
   //----------------------------------------------------------------------
   WireCreator::WireCreator
     (const RegionsOfInterest_t& sigROIlist, const raw::RawDigit& rawdigit):
@@ -71,4 +125,13 @@ namespace recob {
     wire(std::move(sigROIlist), channel, view)
     {}
 
+  //----------------------------------------------------------------------
+  WireCreator::WireCreator(
+    WireROIBuilder&& builder,
+    raw::ChannelID_t channel,
+    geo::View_t view
+    ):
+    wire(builder.finish(), channel, view)
+    {}
+
 } // namespace recob
@@ -12,6 +12,10 @@
 
 // C/C++ standard library
 #include <utility> // std::move()
+#include <vector>
+#include <algorithm> // std::max()
+#include <cmath> // std::abs()
+#include <cstddef> // std::size_t
 
 // LArSoft libraries
 #include "larcoreobj/SimpleTypesAndConstants/RawTypes.h" // raw::ChannelID_t
@@ -23,6 +27,144 @@ namespace raw { class RawDigit; }
 /// Reconstruction base classes
 namespace recob {
 
+  /**
+   * @brief Builds the regions of interest of a wire from a stream of samples.
+   *
+   * Instead of filling a buffer with the full waveform of the channel and then
+   * extracting the regions of interest from it, the samples can be fed to
+   * this object one tick at a time with `addSample()` (or in blocks with
+   * `addSamples()`). A region of interest is opened when a sample exceeds the
+   * threshold (in absolute value) and closed when `padAfter` samples in a row
+   * have not. `padBefore` samples before the first one above threshold and
+   * `padAfter` samples after the last one are included in the region.
+   * Regions that would overlap are merged.
+   *
+   * Only the samples of the region currently being built are stored in a
+   * buffer, which is reused for all regions; the samples are copied into the
+   * sparse vector as each region is closed. Regions with known content can
+   * also be added directly with `addROI()`.
+   *
+   * Example:
+   *
+   *     recob::WireROIBuilder builder(nTicks, threshold, 5, 10);
+   *     for (std::size_t tick = 0; tick < nTicks; ++tick)
+   *       builder.addSample(deconvolutedSample(tick));
+   *     recob::WireCreator wire(std::move(builder), channel, view);
+   *
+   */
+  class WireROIBuilder {
+    public:
+      /// Alias for the type of regions of interest
+      using RegionsOfInterest_t = Wire::RegionsOfInterest_t;
+
+      /// Type of signal sample.
+      using Sample_t = RegionsOfInterest_t::value_type;
+
+      /**
+       * @brief Constructor: sets the size of the waveform and the scan.
+       * @param nTicks total number of ticks of the waveform
+       * @param threshold samples above this (absolute) value open a region
+       * @param padBefore samples to include before a region
+       * @param padAfter samples to include after a region
+       * @param regionCapacity expected number of samples in a region
+       */
+      WireROIBuilder(
+        std::size_t nTicks, Sample_t threshold,
+        std::size_t padBefore = 0U, std::size_t padAfter = 0U,
+        std::size_t regionCapacity = 0U
+        );
+
+
+      /// Adds the sample for the next tick to the threshold scan.
+      void addSample(Sample_t value)
+        {
+          if (aboveThreshold(value)) {
+            if (!fInROI) openROI();
+            fBuffer.push_back(value);
+            fBelow = 0U;
+          }
+          else if (fInROI && (fBelow < fPadAfter)) { // tail of the region
+            fBuffer.push_back(value);
+            ++fBelow;
+          }
+          else {
+            if (fInROI) closeROI();
+            addToHistory(value);
+          }
+          ++fTick;
+        }
+
+      /// Adds to the threshold scan the samples for the next ticks.
+      template <typename Iter>
+      void addSamples(Iter begin, Iter end)
+        { while (begin != end) addSample(*begin++); }
+
+      /**
+       * @brief Adds a region with the specified content.
+       * @param tick the first tick of the region
+       * @param begin iterator to the first sample of the region
+       * @param end iterator past the last sample of the region
+       *
+       * The region being scanned, if any, is closed first. The threshold scan
+       * then continues from the tick after the new region.
+       */
+      template <typename Iter>
+      void addROI(std::size_t tick, Iter begin, Iter end);
+
+      /// Returns the tick the next sample of the scan is assigned to.
+      std::size_t currentTick() const { return fTick; }
+
+      /// Returns the number of regions completed so far.
+      std::size_t nROIs() const { return fROIs.n_ranges(); }
+
+      /**
+       * @brief Completes and returns the regions of interest.
+       * @return the regions of interest, sized to the full waveform
+       *
+       * This object is left empty and should not be used any more.
+       */
+      RegionsOfInterest_t finish();
+
+    private:
+      RegionsOfInterest_t fROIs; ///< Completed regions of interest.
+      std::size_t fNTicks; ///< Total number of ticks.
+      Sample_t fThreshold; ///< Threshold to open a region.
+      std::size_t fPadAfter; ///< Samples to include after a region.
+
+      std::size_t fTick = 0U; ///< The tick of the next sample.
+
+      std::vector<Sample_t> fBuffer; ///< Samples of the current region.
+      std::size_t fBufferStart = 0U; ///< Tick of the first sample in buffer.
+      bool fInROI = false; ///< Whether a region is being built.
+      std::size_t fBelow = 0U; ///< Samples below threshold since last above.
+
+      /// Last samples not in a region (circular buffer of `padBefore` size).
+      std::vector<Sample_t> fHistory;
+      std::size_t fHistoryNext = 0U; ///< Where the next sample is written.
+      std::size_t fHistorySize = 0U; ///< Number of valid history samples.
+
+      /// Opens a new region, starting with the samples in the history.
+      void openROI();
+
+      /// Moves the buffer content into a new region, if a region is open.
+      void closeROI();
+
+      /// Records a sample not in a region, for use in the next region.
+      void addToHistory(Sample_t value)
+        {
+          if (fHistory.empty()) return;
+          fHistory[fHistoryNext] = value;
+          if (++fHistoryNext == fHistory.size()) fHistoryNext = 0U;
+          if (fHistorySize < fHistory.size()) ++fHistorySize;
+        }
+
+      /// Returns whether `value` opens or extends a region.
+      bool aboveThreshold(Sample_t value) const
+        { return std::abs(value) > fThreshold; }
+
+  }; // class WireROIBuilder
+
+
   /**
    * @brief Class managing the creation of a new recob::Wire object
    *
@@ -116,6 +258,21 @@ namespace recob {
         geo::View_t view
         );
 
+      /**
+       * @brief Constructor: uses the regions of interest from a builder
+       * @param builder the completed builder of the regions of interest
+       * @param channel the ID of the channel
+       * @param view the view the channel belongs to
+       *
+       * The regions are moved from the builder, which should not be used any
+       * more.
+       */
+      WireCreator(
+        WireROIBuilder&& builder,
+        raw::ChannelID_t channel,
+        geo::View_t view
+        );
+
       /**
        * @brief Prepares the constructed wire to be moved away
        * @return a right-value reference to the constructed wire
@@ -157,4 +314,19 @@ namespace recob {
 
 } // namespace recob
 
+
+//------------------------------------------------------------------------------
+//--- template implementation
+//------------------------------------------------------------------------------
+template <typename Iter>
+void recob::WireROIBuilder::addROI(std::size_t tick, Iter begin, Iter end) {
+  closeROI();
+  fTick = std::max(fTick, fROIs.add_range(tick, begin, end).end_index());
+  fHistorySize = 0U;
+  fHistoryNext = 0U;
+} // recob::WireROIBuilder::addROI()
+
+
+//------------------------------------------------------------------------------
+
 #endif // WIRECREATOR_H
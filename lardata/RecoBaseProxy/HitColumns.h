@@ -0,0 +1,273 @@
+/**
+ * @file   lardata/RecoBaseProxy/HitColumns.h
+ * @brief  Offers `proxy::HitColumns`, a column view of `recob::Hit` fields.
+ * @date   October 18, 2026
+ *
+ * This library is header-only.
+ *
+ * Hits are stored in `recob::Hit` objects, and the fields of each hit are
+ * laid out next to each other. Algorithms looping on many hits and reading
+ * only few of their fields (e.g. peak time and integral) waste memory
+ * bandwidth and can't be vectorized by the compiler.
+ * `proxy::HitColumns` collects references to the hits, optionally grouped
+ * (e.g. by track), and on demand copies a single field of all of them into a
+ * contiguous vector ("column").
+ *
+ * Example: total charge of each track
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~{.cpp}
+ * auto tracks = proxy::getCollection<proxy::Tracks>(event, tracksTag);
+ * auto const hits = proxy::makeTrackHitColumns(tracks);
+ *
+ * std::vector<float> const& integrals = hits.integrals();
+ * for (std::size_t iTrack = 0; iTrack < hits.nGroups(); ++iTrack) {
+ *   float charge = 0.0;
+ *   for (float q: hits.groupOf(integrals, iTrack)) charge += q;
+ *   // ...
+ * }
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+
+#ifndef LARDATA_RECOBASEPROXY_HITCOLUMNS_H
+#define LARDATA_RECOBASEPROXY_HITCOLUMNS_H
+
+// LArSoft libraries
+#include "larcorealg/CoreUtils/span.h" // util::span, util::make_span
+#include "lardataobj/RecoBase/Hit.h"
+#include "larcoreobj/SimpleTypesAndConstants/RawTypes.h" // raw::ChannelID_t
+
+// C/C++ standard libraries
+#include <vector>
+#include <type_traits> // std::is_same_v, std::decay_t
+#include <cstddef> // std::size_t
+
+
+namespace proxy {
+
+  namespace details {
+
+    /// Returns a pointer to the hit `elem` is or points to.
+    template <typename Elem>
+    recob::Hit const* hitAddress(Elem const& elem)
+      {
+        if constexpr (std::is_same_v<std::decay_t<Elem>, recob::Hit>)
+          return &elem;
+        else return &*elem;
+      }
+
+  } // namespace details
+
+
+  //----------------------------------------------------------------------------
+  /**
+   * @brief Structure-of-arrays view of a (grouped) list of hits.
+   *
+   * The object holds pointers to the hits, which must stay valid for its
+   * whole lifetime (for hits from the event, that is always the case).
+   * Hits are added one group at a time with `addGroup()`; each group gets
+   * a contiguous range of hit indices, and `groupBegin()`/`groupEnd()`
+   * describe that range in the same way as a compressed sparse row offset
+   * table.
+   *
+   * The field columns (`channels()`, `peakTimes()`, ...) are filled on their
+   * first request, and after that they are just returned. A column that is
+   * never requested costs nothing. Adding a group invalidates the columns
+   * already filled (they are refilled at the next request).
+   *
+   * @note Since columns are filled on first access, concurrent access to a
+   *       column that was not filled yet is not thread-safe, even if the
+   *       object is constant. Call `fillAll()` before sharing the object
+   *       among threads.
+   */
+  class HitColumns {
+
+      public:
+    using Channel_t = raw::ChannelID_t; ///< Type of channel ID.
+
+    /// Constructor: no hits, no groups.
+    HitColumns() = default;
+
+    /// Constructor: all the hits in `hits` as a single group.
+    template <typename Hits>
+    explicit HitColumns(Hits const& hits) { addGroup(hits); }
+
+
+    // --- BEGIN Hit groups ----------------------------------------------------
+    /// @name Hit groups
+    /// @{
+
+    /**
+     * @brief Adds all the hits in `hits` as a new group.
+     * @tparam Hits type of range of hits
+     * @param hits the hits to be added
+     * @return the index of the new group
+     *
+     * The elements of `hits` may be `recob::Hit` objects, or anything that
+     * can be dereferenced into one (C pointers, `art::Ptr`, the elements of
+     * an associated hit range of a proxy...).
+     */
+    template <typename Hits>
+    std::size_t addGroup(Hits const& hits);
+
+    /// Returns the number of hits in all groups.
+    std::size_t size() const { return fHits.size(); }
+
+    /// Returns whether there are no hits at all.
+    bool empty() const { return fHits.empty(); }
+
+    /// Returns the number of groups.
+    std::size_t nGroups() const { return fGroupOffsets.size() - 1U; }
+
+    /// Returns the index of the first hit in the specified group.
+    std::size_t groupBegin(std::size_t iGroup) const
+      { return fGroupOffsets[iGroup]; }
+
+    /// Returns the index after the last hit in the specified group.
+    std::size_t groupEnd(std::size_t iGroup) const
+      { return fGroupOffsets[iGroup + 1U]; }
+
+    /// Returns the number of hits in the specified group.
+    std::size_t groupSize(std::size_t iGroup) const
+      { return groupEnd(iGroup) - groupBegin(iGroup); }
+
+    /// Returns the offset table (`nGroups() + 1` entries).
+    std::vector<std::size_t> const& groupOffsets() const
+      { return fGroupOffsets; }
+
+    /// Returns the part of the `column` pertaining the specified group.
+    template <typename T>
+    util::span<T const*> groupOf
+      (std::vector<T> const& column, std::size_t iGroup) const
+      {
+        T const* data = column.data();
+        return
+          util::make_span(data + groupBegin(iGroup), data + groupEnd(iGroup));
+      }
+
+    /// Returns the hit with the specified index.
+    recob::Hit const& hit(std::size_t iHit) const { return *(fHits[iHit]); }
+
+    /// @}
+    // --- END Hit groups ------------------------------------------------------
+
+
+    // --- BEGIN Columns -------------------------------------------------------
+    /// @name Columns
+    /// @{
+
+    /// Returns the channel of all hits (`recob::Hit::Channel()`).
+    std::vector<Channel_t> const& channels() const
+      { return column(fChannels, &recob::Hit::Channel); }
+
+    /// Returns the peak time of all hits (`recob::Hit::PeakTime()`).
+    std::vector<float> const& peakTimes() const
+      { return column(fPeakTimes, &recob::Hit::PeakTime); }
+
+    /// Returns the RMS of all hits (`recob::Hit::RMS()`).
+    std::vector<float> const& RMSs() const
+      { return column(fRMSs, &recob::Hit::RMS); }
+
+    /// Returns the peak amplitude of all hits (`recob::Hit::PeakAmplitude()`).
+    std::vector<float> const& peakAmplitudes() const
+      { return column(fPeakAmplitudes, &recob::Hit::PeakAmplitude); }
+
+    /// Returns the integral of all hits (`recob::Hit::Integral()`).
+    std::vector<float> const& integrals() const
+      { return column(fIntegrals, &recob::Hit::Integral); }
+
+    /// Returns the summed ADC of all hits (`recob::Hit::SummedADC()`).
+    std::vector<float> const& summedADCs() const
+      { return column(fSummedADCs, &recob::Hit::SummedADC); }
+
+    /// Fills all the columns (see the thread safety note in the class).
+    void fillAll() const
+      {
+        channels();
+        peakTimes();
+        RMSs();
+        peakAmplitudes();
+        integrals();
+        summedADCs();
+      }
+
+    /// @}
+    // --- END Columns ---------------------------------------------------------
+
+
+      private:
+    std::vector<recob::Hit const*> fHits; ///< Pointers to all hits.
+    std::vector<std::size_t> fGroupOffsets { 0U }; ///< Start of each group.
+
+    // columns: a column is filled when its size matches the number of hits
+    mutable std::vector<Channel_t> fChannels;
+    mutable std::vector<float> fPeakTimes;
+    mutable std::vector<float> fRMSs;
+    mutable std::vector<float> fPeakAmplitudes;
+    mutable std::vector<float> fIntegrals;
+    mutable std::vector<float> fSummedADCs;
+
+    /// Fills `cache` with the result of `getter` on all hits, if needed.
+    template <typename T, typename Getter>
+    std::vector<T> const& column(std::vector<T>& cache, Getter getter) const;
+
+  }; // class HitColumns
+
+
+  //----------------------------------------------------------------------------
+  /**
+   * @brief Returns a `HitColumns` with one group of hits per track.
+   * @tparam Tracks type of the track collection proxy
+   * @param tracks collection proxy of tracks (e.g. `proxy::Tracks`)
+   * @return a `HitColumns` object with hits from each track, in order
+   *
+   * Group _i_ holds the hits associated to the _i_-th track in `tracks`, in
+   * the same order as `track.hits()`.
+   */
+  template <typename Tracks>
+  HitColumns makeTrackHitColumns(Tracks const& tracks);
+
+
+} // namespace proxy
+
+
+//------------------------------------------------------------------------------
+//--- template implementation
+//------------------------------------------------------------------------------
+template <typename Hits>
+std::size_t proxy::HitColumns::addGroup(Hits const& hits) {
+
+  for (auto const& elem: hits) fHits.push_back(details::hitAddress(elem));
+  fGroupOffsets.push_back(fHits.size());
+  return nGroups() - 1U;
+
+} // proxy::HitColumns::addGroup()
+
+
+//------------------------------------------------------------------------------
+template <typename T, typename Getter>
+std::vector<T> const& proxy::HitColumns::column
+  (std::vector<T>& cache, Getter getter) const
+{
+  if (cache.size() == fHits.size()) return cache;
+
+  cache.resize(fHits.size());
+  T* dest = cache.data();
+  for (recob::Hit const* hit: fHits) *(dest++) = (hit->*getter)();
+  return cache;
+
+} // proxy::HitColumns::column()
+
+
+//------------------------------------------------------------------------------
+template <typename Tracks>
+proxy::HitColumns proxy::makeTrackHitColumns(Tracks const& tracks) {
+
+  HitColumns hits;
+  for (auto const& track: tracks) hits.addGroup(track.hits());
+  return hits;
+
+} // proxy::makeTrackHitColumns()
+
+
+//------------------------------------------------------------------------------
+
+#endif // LARDATA_RECOBASEPROXY_HITCOLUMNS_H
@@ -0,0 +1,385 @@
+/**
+ * @file   lardata/Utilities/AssnsCSRIndex.h
+ * @brief  Compressed sparse row index of associations.
+ * @date   October 18, 2026
+ *
+ * This library is header-only and does not depend on the framework: any
+ * collection of pairs of pointer-like objects (exposing `key()` and `id()`)
+ * can be indexed, which includes `art::Assns`.
+ */
+
+#ifndef LARDATA_UTILITIES_ASSNSCSRINDEX_H
+#define LARDATA_UTILITIES_ASSNSCSRINDEX_H
+
+// LArSoft libraries
+#include "larcorealg/CoreUtils/span.h" // util::span, util::make_span()
+
+// C/C++ standard libraries
+#include <vector>
+#include <cstddef> // std::size_t
+#include <type_traits> // std::conditional_t, std::is_void_v
+#include <utility> // std::move()
+
+
+namespace util {
+
+  /**
+   * @brief Values grouped by element, in compressed sparse row format.
+   * @tparam Value type of the grouped values
+   *
+   * The values of all the elements are stored contiguously in `values`, sorted
+   * by element; the values of the element #`i` are in the range from
+   * `values[offsets[i]]` to `values[offsets[i + 1]]` (excluded).
+   * The `offsets` list has therefore one more entry than the elements.
+   * Compared to a vector of vectors, there are only two memory allocations
+   * in total and all the data is contiguous.
+   *
+   * Tables are usually filled with `util::fillCSR()`.
+   */
+  template <typename Value>
+  struct AssociatedCSR {
+
+    using value_type = Value;
+    using values_t = std::vector<Value>;
+    using range_t = util::span<typename values_t::const_iterator>;
+
+    std::vector<std::size_t> offsets; ///< Start of the values of each element.
+    values_t values; ///< All values, sorted by element.
+
+    /// Returns the number of elements (not of values).
+    std::size_t size() const
+      { return offsets.empty()? 0U: offsets.size() - 1U; }
+
+    /// Returns whether there are no elements.
+    bool empty() const { return size() == 0U; }
+
+    /// Returns the range of values of the element `i`.
+    range_t operator[] (std::size_t i) const
+      {
+        return util::make_span(
+          values.cbegin() + offsets[i], values.cbegin() + offsets[i + 1]
+          );
+      }
+
+    /// Returns the number of values of the element `i`.
+    std::size_t count(std::size_t i) const
+      { return offsets[i + 1] - offsets[i]; }
+
+    /// Returns the total number of values.
+    std::size_t nValues() const { return values.size(); }
+
+  }; // struct AssociatedCSR
+
+
+  /**
+   * @brief Groups the items of a collection in a CSR table.
+   * @tparam Value type of the values to be stored in the table
+   * @param items the collection of the items to be grouped
+   * @param nRows number of elements in the table
+   * @param rowOf function returning the element (row) of an item
+   * @param valueOf function returning the value of an item
+   * @return a table with the value of each item under its row
+   *
+   * The collection is iterated twice (once to count, once to fill); items
+   * whose row is not smaller than `nRows` are skipped. The relative order of
+   * the items within each row is preserved.
+   */
+  template <typename Value, typename Coll, typename RowOf, typename ValueOf>
+  AssociatedCSR<Value> fillCSR
+    (Coll const& items, std::size_t nRows, RowOf rowOf, ValueOf valueOf);
+
+
+  /**
+   * @brief Index of associations in compressed sparse row format.
+   * @tparam Meta type of metadata of the association (`void` if none)
+   *
+   * The index connects each element of the left side of an association to the
+   * keys of all the elements it is associated to (forward view), and
+   * optionally each element of the right side to the keys of the left elements
+   * associated to it (reverse view). Only keys (indices in the data product)
+   * are stored, which is what is needed when all associated objects come from
+   * a single data product, as it is the case for the vast majority of
+   * associations.
+   *
+   * If the association carries metadata and `Meta` is not `void`, a copy of
+   * the metadata is also stored, aligned with the keys of each view.
+   *
+   * Example:
+   * @code{.cpp}
+   * auto const& hits = *(event.getValidHandle<std::vector<recob::Hit>>(tag));
+   * auto const& trackHits
+   *   = *(event.getValidHandle<art::Assns<recob::Track, recob::Hit>>(tag));
+   * auto const index = util::makeAssnsCSRIndex
+   *   (trackHits, nTracks).buildReverse(hits.size());
+   *
+   * for (std::size_t iHit: index.forward()[iTrack]) { ... }
+   * for (std::size_t iTrack: index.reverse()[iHit]) { ... }
+   * @endcode
+   * Construction takes O(N) time for N associations (no sorting is performed).
+   */
+  template <typename Meta = void>
+  class AssnsCSRIndex {
+
+    /// Placeholder for the metadata column when there is no metadata.
+    struct NoMetadata_t {};
+
+      public:
+    using Key_t = std::size_t; ///< Type of key of associated elements.
+    using Table_t = AssociatedCSR<Key_t>; ///< Type of a view.
+    using Metadata_t = Meta; ///< Type of metadata.
+
+    /// Whether this index stores metadata.
+    static constexpr bool hasMetadata = !std::is_void_v<Meta>;
+
+    /// Type of the metadata column.
+    using MetadataColumn_t = std::conditional_t
+      <hasMetadata, std::vector<Meta>, NoMetadata_t>;
+
+    /// Default constructor: an empty index.
+    AssnsCSRIndex() = default;
+
+    /**
+     * @brief Constructor: indexes the specified association.
+     * @tparam Assns type of association
+     * @tparam Pred type of association selection predicate
+     * @param assns the association collection
+     * @param nLeft number of elements on the left side of the association
+     * @param keep predicate: only the pairs for which `keep(pair)` is `true`
+     *             are indexed
+     *
+     * Only the forward view is built; see `buildReverse()`.
+     * The association collection must support `size()` and `operator[]`
+     * returning the pair of pointers; if metadata is requested, it must also
+     * support `data(i)`.
+     * Pairs with a left key not smaller than `nLeft` are ignored.
+     */
+    template <typename Assns, typename Pred>
+    AssnsCSRIndex(Assns const& assns, std::size_t nLeft, Pred keep);
+
+    /// Constructor: indexes all the pairs of the specified association.
+    template <typename Assns>
+    AssnsCSRIndex(Assns const& assns, std::size_t nLeft)
+      : AssnsCSRIndex(assns, nLeft, [](auto const&){ return true; })
+      {}
+
+    /**
+     * @brief Builds the reverse view of the index.
+     * @param nRight number of elements on the right side of the association
+     * @return this index
+     *
+     * The reverse view is obtained in O(N) time by transposing the forward
+     * one; the left keys associated to each right element are sorted.
+     * Right keys not smaller than `nRight` are ignored.
+     */
+    AssnsCSRIndex& buildReverse(std::size_t nRight);
+
+
+    /// Returns the number of left elements.
+    std::size_t size() const { return fForward.size(); }
+
+    /// Returns the number of indexed associations.
+    std::size_t nAssociations() const { return fForward.nValues(); }
+
+    /// Returns whether the reverse view has been built.
+    bool hasReverse() const { return !fReverse.offsets.empty(); }
+
+    /// Returns the forward view (keys of right elements for each left one).
+    Table_t const& forward() const { return fForward; }
+
+    /// Returns the reverse view (keys of left elements for each right one).
+    Table_t const& reverse() const { return fReverse; }
+
+    /// Returns the keys of the right elements associated to left one `i`.
+    typename Table_t::range_t operator[] (std::size_t i) const
+      { return fForward[i]; }
+
+    /// Returns the metadata of the associations of the left element `i`.
+    auto forwardMetadata(std::size_t i) const
+      { return metadataRange(fForwardMeta, fForward, i); }
+
+    /// Returns the metadata of the associations of the right element `i`.
+    auto reverseMetadata(std::size_t i) const
+      { return metadataRange(fReverseMeta, fReverse, i); }
+
+
+      private:
+    Table_t fForward; ///< Keys of right elements, by left element.
+    Table_t fReverse; ///< Keys of left elements, by right element.
+
+    MetadataColumn_t fForwardMeta; ///< Metadata aligned with `fForward`.
+    MetadataColumn_t fReverseMeta; ///< Metadata aligned with `fReverse`.
+
+    /// Returns the metadata range of element `i` of the `table`.
+    static auto metadataRange
+      (MetadataColumn_t const& meta, Table_t const& table, std::size_t i)
+      {
+        static_assert(hasMetadata, "This index does not store metadata.");
+        return util::make_span(
+          meta.cbegin() + table.offsets[i], meta.cbegin() + table.offsets[i + 1]
+          );
+      }
+
+  }; // class AssnsCSRIndex<>
+
+
+  /**
+   * @brief Returns an index of the keys of an association (no metadata).
+   * @param assns the association collection
+   * @param nLeft number of elements on the left side of the association
+   *
+   * Only the forward view is built.
+   */
+  template <typename Assns>
+  AssnsCSRIndex<> makeAssnsCSRIndex(Assns const& assns, std::size_t nLeft)
+    { return { assns, nLeft }; }
+
+  /**
+   * @brief Returns an index of the keys of an association with left side on
+   *        the specified product.
+   * @param assns the association collection
+   * @param nLeft number of elements on the left side of the association
+   * @param leftID only pairs with left pointer with this product ID are kept
+   *
+   * Only the forward view is built.
+   */
+  template <typename Assns, typename ProductID>
+  AssnsCSRIndex<> makeAssnsCSRIndex
+    (Assns const& assns, std::size_t nLeft, ProductID const& leftID)
+    {
+      return {
+        assns, nLeft,
+        [&leftID](auto const& pair){ return pair.first.id() == leftID; }
+        };
+    }
+
+  /**
+   * @brief Returns an index of an association, including its metadata.
+   * @param assns the association collection
+   * @param nLeft number of elements on the left side of the association
+   *
+   * Only the forward view is built.
+   */
+  template <typename Assns>
+  AssnsCSRIndex<typename Assns::data_t> makeAssnsCSRIndexWithMetadata
+    (Assns const& assns, std::size_t nLeft)
+    { return { assns, nLeft }; }
+
+
+} // namespace util
+
+
+//------------------------------------------------------------------------------
+//--- template implementation
+//------------------------------------------------------------------------------
+template <typename Value, typename Coll, typename RowOf, typename ValueOf>
+util::AssociatedCSR<Value> util::fillCSR
+  (Coll const& items, std::size_t nRows, RowOf rowOf, ValueOf valueOf)
+{
+  AssociatedCSR<Value> table;
+
+  // first pass: count the values of each row, then turn the counts into
+  // offsets (where each row starts)
+  table.offsets.resize(nRows + 1U, 0U);
+  for (auto const& item: items) {
+    std::size_t const row = rowOf(item);
+    if (row < nRows) ++table.offsets[row + 1U];
+  } // for
+  for (std::size_t i = 0; i < nRows; ++i)
+    table.offsets[i + 1U] += table.offsets[i];
+
+  // second pass: place each value at the next free slot of its row
+  table.values.resize(table.offsets.back());
+  std::vector<std::size_t> next(table.offsets.begin(), table.offsets.end() - 1);
+  for (auto const& item: items) {
+    std::size_t const row = rowOf(item);
+    if (row < nRows) table.values[next[row]++] = valueOf(item);
+  } // for
+
+  return table;
+} // util::fillCSR()
+
+
+//------------------------------------------------------------------------------
+template <typename Meta>
+template <typename Assns, typename Pred>
+util::AssnsCSRIndex<Meta>::AssnsCSRIndex
+  (Assns const& assns, std::size_t nLeft, Pred keep)
+{
+  //
+  // we group the positions of the pairs in the association, which we then use
+  // to extract the right keys and, if needed, the metadata
+  //
+  std::size_t const nAssns = assns.size();
+
+  // first pass: count
+  fForward.offsets.resize(nLeft + 1U, 0U);
+  for (std::size_t iAssn = 0; iAssn < nAssns; ++iAssn) {
+    auto const& pair = assns[iAssn];
+    if (!keep(pair)) continue;
+    std::size_t const row = pair.first.key();
+    if (row < nLeft) ++fForward.offsets[row + 1U];
+  } // for
+  for (std::size_t i = 0; i < nLeft; ++i)
+    fForward.offsets[i + 1U] += fForward.offsets[i];
+
+  // second pass: fill
+  fForward.values.resize(fForward.offsets.back());
+  if constexpr (hasMetadata) fForwardMeta.resize(fForward.offsets.back());
+  std::vector<std::size_t> next
+    (fForward.offsets.begin(), fForward.offsets.end() - 1);
+  for (std::size_t iAssn = 0; iAssn < nAssns; ++iAssn) {
+    auto const& pair = assns[iAssn];
+    if (!keep(pair)) continue;
+    std::size_t const row = pair.first.key();
+    if (row >= nLeft) continue;
+    std::size_t const pos = next[row]++;
+    fForward.values[pos] = pair.second.key();
+    if constexpr (hasMetadata) fForwardMeta[pos] = assns.data(iAssn);
+  } // for
+
+} // util::AssnsCSRIndex<>::AssnsCSRIndex()
+
+
+//------------------------------------------------------------------------------
+template <typename Meta>
+auto util::AssnsCSRIndex<Meta>::buildReverse(std::size_t nRight)
+  -> AssnsCSRIndex&
+{
+  Table_t reverse;
+
+  // count the left elements of each right element
+  reverse.offsets.resize(nRight + 1U, 0U);
+  for (Key_t const right: fForward.values)
+    if (right < nRight) ++reverse.offsets[right + 1U];
+  for (std::size_t i = 0; i < nRight; ++i)
+    reverse.offsets[i + 1U] += reverse.offsets[i];
+
+  // transpose; since we proceed by increasing left key, the left keys of each
+  // right element end up sorted
+  reverse.values.resize(reverse.offsets.back());
+  MetadataColumn_t reverseMeta;
+  if constexpr (hasMetadata) reverseMeta.resize(reverse.offsets.back());
+  std::vector<std::size_t> next
+    (reverse.offsets.begin(), reverse.offsets.end() - 1);
+  std::size_t const nLeft = fForward.size();
+  for (std::size_t left = 0; left < nLeft; ++left) {
+    for (std::size_t iF = fForward.offsets[left];
+      iF < fForward.offsets[left + 1]; ++iF
+    ) {
+      Key_t const right = fForward.values[iF];
+      if (right >= nRight) continue;
+      std::size_t const pos = next[right]++;
+      reverse.values[pos] = left;
+      if constexpr (hasMetadata) reverseMeta[pos] = fForwardMeta[iF];
+    } // for associated
+  } // for left
+
+  fReverse = std::move(reverse);
+  fReverseMeta = std::move(reverseMeta);
+  return *this;
+} // util::AssnsCSRIndex<>::buildReverse()
+
+
+//------------------------------------------------------------------------------
+
+#endif // LARDATA_UTILITIES_ASSNSCSRINDEX_H
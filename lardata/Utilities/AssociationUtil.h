@@ -73,6 +73,8 @@
 #define ASSOCIATIONUTIL_H
 
 // C/C++ standard libraries
+#include <algorithm> // std::count()
+#include <cstddef> // std::size_t
 #include <string>
 #include <utility> // std::move()
 #include <vector>
@@ -89,6 +91,9 @@
 #include "canvas/Persistency/Common/PtrVector.h"
 #include "messagefacility/MessageLogger/MessageLogger.h"
 
+// LArSoft libraries
+#include "lardata/Utilities/AssnsCSRIndex.h" // util::AssociatedCSR, ...
+
 namespace util {
 
   // see https://cdcvs.fnal.gov/redmine/projects/art/wiki/Inter-Product_References
@@ -520,10 +525,12 @@ namespace util {
   // this method assumes there is a one to many relationship between T and U
   // for example if you want to get all recob::Hits
   // that are not associated to recob::Clusters
-  // std::vector<const recob::Hit*> hits = FindUNotAssociatedToU<recob::Cluster>(art::Handle<recob::Hit>, ...);
+  // std::vector<const recob::Hit*> hits = FindUNotAssociatedToT<recob::Cluster>(art::Handle<std::vector<recob::Hit>>, ...);
+  // The association is read directly and scanned only once, flagging the
+  // associated objects; no art::FindOne query is performed.
   template<class T, class U>
   std::vector<const U*>
-  FindUNotAssociatedToT(art::Handle<U>     b,
+  FindUNotAssociatedToT(art::Handle<std::vector<U>> b,
                         art::Event  const& evt,
                         std::string const& label);
 
@@ -533,10 +540,10 @@ namespace util {
   // this method assumes there is a one to many relationship between T and U
   // for example if you want to get all recob::Hits
   // that are not associated to recob::Clusters
-  // std::vector< art::Ptr<recob::Hit> > hits = FindUNotAssociatedToTP<recob::Cluster>(art::Handle<recob::Hit>, ...);
+  // std::vector< art::Ptr<recob::Hit> > hits = FindUNotAssociatedToTP<recob::Cluster>(art::Handle<std::vector<recob::Hit>>, ...);
   template<class T, class U>
   std::vector< art::Ptr<U> >
-  FindUNotAssociatedToTP(art::Handle<U>     b,
+  FindUNotAssociatedToTP(art::Handle<std::vector<U>> b,
                          art::Event  const& evt,
                          std::string const& label);
 
@@ -553,6 +560,14 @@ namespace util {
   // --- GetAssociatedVectorManyP takes in a handle to an association, and a handle to a product on the event.
   //     The ouput is a vector of with the same number of entries as the handle to the product, containing a vector
   //     of pointers to all associated products.
+  // --- GetAssociatedCSRManyI and GetAssociatedCSRManyP return the same
+  //     information as GetAssociatedVectorManyI and GetAssociatedVectorManyP,
+  //     in a single compressed sparse row table (see util::AssociatedCSR);
+  //     for an index of keys in both directions, see util::AssnsCSRIndex,
+  //     which GetAssociatedVectorManyI uses.
+  //
+  // Only the pairs whose left side points to the product in index_p are
+  // considered; pairs from other products are skipped.
 
   template<class T,class U>
   std::vector<size_t>
@@ -573,6 +588,32 @@ namespace util {
                            art::Handle< std::vector<T> > index_p);
 
 
+  template<class T,class U>
+  AssociatedCSR<size_t>
+  GetAssociatedCSRManyI(art::Handle< art::Assns<T,U> > h,
+                        art::Handle< std::vector<T> > index_p);
+  template<class T,class U>
+  AssociatedCSR<const U*>
+  GetAssociatedCSRManyP(art::Handle< art::Assns<T,U> > h,
+                        art::Handle< std::vector<T> > index_p);
+
+  namespace details {
+
+    /// Returns for each of the `n` elements whether it appears as left side
+    /// in `assns` with the specified product ID.
+    template <typename Assns>
+    std::vector<bool> flagAssociatedLeft
+      (Assns const& assns, art::ProductID const& id, std::size_t n);
+
+    /// Returns the number of pairs in `assns` for each left key, considering
+    /// only the pairs with the specified left product ID.
+    template <typename Assns>
+    std::vector<std::size_t> countAssociatedLeft
+      (Assns const& assns, art::ProductID const& id, std::size_t n);
+
+  } // namespace details
+
+
 }// end namespace
 
 //----------------------------------------------------------------------
@@ -853,27 +894,56 @@ bool util::CreateAssnD(
   return true;
 } // util::CreateAssnD() [01b]
 
+//----------------------------------------------------------------------
+template <typename Assns>
+std::vector<bool> util::details::flagAssociatedLeft
+  (Assns const& assns, art::ProductID const& id, std::size_t n)
+{
+  std::vector<bool> associated(n, false);
+  for(auto const& pair: assns) {
+    if (pair.first.id() != id) continue;
+    associated[pair.first.key()] = true;
+  }
+  return associated;
+} // util::details::flagAssociatedLeft()
+
+
+//----------------------------------------------------------------------
+template <typename Assns>
+std::vector<std::size_t> util::details::countAssociatedLeft
+  (Assns const& assns, art::ProductID const& id, std::size_t n)
+{
+  std::vector<std::size_t> counts(n, 0U);
+  for(auto const& pair: assns) {
+    if (pair.first.id() != id) continue;
+    ++counts[pair.first.key()];
+  }
+  return counts;
+} // util::details::countAssociatedLeft()
+
+
 //----------------------------------------------------------------------
 template<class T, class U>
 inline std::vector<const U*>
-util::FindUNotAssociatedToT(art::Handle<U>     b,
+util::FindUNotAssociatedToT(art::Handle<std::vector<U>> b,
                             art::Event  const& evt,
                             std::string const& label)
 {
-  // Do a FindOne for type T for each object of type U
-  // If the FindOne returns an invalid maybe ref, add the pointer
-  // of object type U to the return vector
+  // Read the association between U and T, flag all the objects of type U
+  // from b appearing in it, and add the pointers to the objects not flagged
+  // to the return vector
 
-  std::vector<const U*> notAssociated;
+  auto const& assns = *(evt.getValidHandle<art::Assns<U, T>>(label));
 
-  art::FindOne<T> const fa(b, evt, label);
+  std::vector<bool> const associated
+    = details::flagAssociatedLeft(assns, b.id(), b->size());
 
-  for(size_t u = 0; u < b->size(); ++u){
-    cet::maybe_ref<T const> t(fa.at(u));
-    if( !t.isValid() ){
-      art::Ptr<U> ptr(b, u);
-      notAssociated.push_back(ptr.get());
-    }
+  std::vector<const U*> notAssociated;
+  notAssociated.reserve
+    (associated.size() - std::count(associated.begin(), associated.end(), true));
+
+  for(size_t u = 0; u < associated.size(); ++u){
+    if(!associated[u]) notAssociated.push_back(&((*b)[u]));
   }
 
   return notAssociated;
@@ -882,23 +952,25 @@ util::FindUNotAssociatedToT(art::Handle<U>     b,
 //----------------------------------------------------------------------
 template<class T, class U>
 inline std::vector< art::Ptr<U> >
-util::FindUNotAssociatedToTP(art::Handle<U>     b,
+util::FindUNotAssociatedToTP(art::Handle<std::vector<U>> b,
                              art::Event  const& evt,
                              std::string const& label)
 {
-  // Do a FindOneP for type T for each object of type U
-  // If the FindOne returns an invalid maybe ref, add the pointer
-  // of object type U to the return vector
+  // Read the association between U and T, flag all the objects of type U
+  // from b appearing in it, and create a pointer for each of the objects
+  // not flagged
 
-  std::vector< art::Ptr<U> > notAssociated;
+  auto const& assns = *(evt.getValidHandle<art::Assns<U, T>>(label));
 
-  art::FindOneP<T> const fa(b, evt, label);
+  std::vector<bool> const associated
+    = details::flagAssociatedLeft(assns, b.id(), b->size());
 
-  for(size_t u = 0; u < b->size(); ++u){
-    cet::maybe_ref<T const> t(fa.at(u));
-    if( !t.isValid() ){
-      notAssociated.emplace_back(b, u);
-    }
+  std::vector< art::Ptr<U> > notAssociated;
+  notAssociated.reserve
+    (associated.size() - std::count(associated.begin(), associated.end(), true));
+
+  for(size_t u = 0; u < associated.size(); ++u){
+    if(!associated[u]) notAssociated.emplace_back(b, u);
   }
 
   return notAssociated;
@@ -912,8 +984,10 @@ util::GetAssociatedVectorOneI(art::Handle< art::Assns<T,U> > h,
                               art::Handle< std::vector<T> > index_p)
 {
   std::vector<size_t> associated_index(index_p->size());
-  for(auto const& pair : *h)
-    associated_index.at(pair.first.key()) = pair.second.key();
+  for(auto const& pair : *h) {
+    if (pair.first.id() != index_p.id()) continue;
+    associated_index[pair.first.key()] = pair.second.key();
+  }
   return associated_index;
 }
 
@@ -923,8 +997,10 @@ util::GetAssociatedVectorOneP(art::Handle< art::Assns<T,U> > h,
                               art::Handle< std::vector<T> > index_p)
 {
   std::vector<const U*> associated_pointer(index_p->size());
-  for(auto const& pair : *h)
-    associated_pointer.at(pair.first.key()) = &(*(pair.second));
+  for(auto const& pair : *h) {
+    if (pair.first.id() != index_p.id()) continue;
+    associated_pointer[pair.first.key()] = &(*(pair.second));
+  }
   return associated_pointer;
 }
 
@@ -933,9 +1009,14 @@ inline std::vector< std::vector<size_t> >
 util::GetAssociatedVectorManyI(art::Handle< art::Assns<T,U> > h,
                                art::Handle< std::vector<T> > index_p)
 {
-  std::vector< std::vector<size_t> > associated_indices(index_p->size());
-  for(auto const& pair : *h)
-    associated_indices.at(pair.first.key()).push_back(pair.second.key());
+  // the keys are grouped by the CSR index, then each vector is allocated once
+  auto const index
+    = util::makeAssnsCSRIndex(*h, index_p->size(), index_p.id());
+  std::vector< std::vector<size_t> > associated_indices(index.size());
+  for(std::size_t i = 0; i < index.size(); ++i) {
+    auto const keys = index[i];
+    associated_indices[i].assign(keys.begin(), keys.end());
+  }
   return associated_indices;
 }
 
@@ -944,12 +1025,45 @@ inline std::vector< std::vector<const U*> >
 util::GetAssociatedVectorManyP(art::Handle< art::Assns<T,U> > h,
                                art::Handle< std::vector<T> > index_p)
 {
-  std::vector< std::vector<const U*> > associated_pointers(index_p->size());
-  for(auto const& pair : *h)
-    associated_pointers.at(pair.first.key()).push_back( &(*(pair.second)) );
+  // count first, so that each vector is allocated only once
+  std::vector<std::size_t> const counts
+    = details::countAssociatedLeft(*h, index_p.id(), index_p->size());
+  std::vector< std::vector<const U*> > associated_pointers(counts.size());
+  for(std::size_t i = 0; i < counts.size(); ++i)
+    associated_pointers[i].reserve(counts[i]);
+  for(auto const& pair : *h) {
+    if (pair.first.id() != index_p.id()) continue;
+    associated_pointers[pair.first.key()].push_back( &(*(pair.second)) );
+  }
   return associated_pointers;
 }
 
+template<class T,class U>
+inline util::AssociatedCSR<size_t>
+util::GetAssociatedCSRManyI(art::Handle< art::Assns<T,U> > h,
+                            art::Handle< std::vector<T> > index_p)
+{
+  // pairs from other products get an invalid row, and are skipped
+  std::size_t const n = index_p->size();
+  art::ProductID const id = index_p.id();
+  return util::fillCSR<size_t>(*h, n,
+    [n, id](auto const& pair){ return (pair.first.id() == id)? pair.first.key(): n; },
+    [](auto const& pair){ return pair.second.key(); });
+}
+
+template<class T,class U>
+inline util::AssociatedCSR<const U*>
+util::GetAssociatedCSRManyP(art::Handle< art::Assns<T,U> > h,
+                            art::Handle< std::vector<T> > index_p)
+{
+  // pairs from other products get an invalid row, and are skipped
+  std::size_t const n = index_p->size();
+  art::ProductID const id = index_p.id();
+  return util::fillCSR<const U*>(*h, n,
+    [n, id](auto const& pair){ return (pair.first.id() == id)? pair.first.key(): n; },
+    [](auto const& pair){ return &(*(pair.second)); });
+}
+
 //--------------------------------------------------------------------
 // Functions to support unnecessary leading producer argument
 //
@@ -3,25 +3,32 @@
  * @brief  Memory allocator for large amount of (small) objects
  * @author Gianluca Petrillo (petrillo@fnal.gov)
  * @date   August 17th, 2014
+ *
+ * This header provides:
+ *
+ * * `lar::BulkAllocator`: STL allocator drawing from a memory pool per type
+ * * `lar::BulkMemoryResource`: the same memory pool, as a
+ *   `std::pmr::memory_resource` (only where the C++17 library provides it)
+ *
+ * This is a pure header that contains only template classes and inline code.
  */
 
 
-//--- BEGIN issue #19494 -------------------------------------------------------
-/// @bug BulkAllocator.h is currently broken; see issue #19494.
-// We are leaving it here because, being a header, it will not bother unless
-// explicitly invoked. Note that there is a unit test for it too.
-#error ("BulkAllocator.h is currently broken; see issue #19494.")
-//--- END issue #19494 ---------------------------------------------------------
-
-
 #ifndef BULKALLOCATOR_H
 #define BULKALLOCATOR_H
 
 // interface include
 #include <memory> // std::allocator<>, std::unique_ptr<>
-#include <stdexcept> // std::logic_error
+#include <new> // std::bad_alloc
+#include <array>
+#include <cstddef> // std::size_t, std::ptrdiff_t, std::max_align_t
 #include <cstdlib> // std::free
 
+#if __has_include(<memory_resource>)
+# include <memory_resource>
+#endif
+
+
 namespace lar {
   /// Namespace hiding implementation details
   namespace details {
@@ -39,7 +46,8 @@ namespace lar {
     memory_error(): std::bad_alloc() {}
     memory_error(const char* message): std::bad_alloc(), msg(message) {}
 
-    virtual const char* what() const throw() override { return msg; }
+    virtual const char* what() const throw() override
+      { return msg? msg: "lar::memory_error"; }
 
       private:
     const char* msg = nullptr;
@@ -53,12 +61,10 @@ namespace lar {
    * elements of type T. The memory will never be deleted! (but read further)
    *
    * @note With C++17, an allocator called `std::pmr::monotonic_buffer_resource`
-   *       is available that seems to have pretty much the same functionality as
-   *       this one (but STL quality).
-   *       When C++17 is adopted by LArSoft (and the supported compilers have a
-   *       complete enough support for it), the users of `BulkAllocator` should
-   *       migrate to that one. Note that the interface is different, and
-   *       probably the way to use it is also different.
+   *       is available that has pretty much the same functionality as this one
+   *       (but it is not thread-safe). Where the standard library supports it,
+   *       `lar::BulkMemoryResource` offers the memory pool of this allocator
+   *       as a `std::pmr::memory_resource`.
    *
    * <h3>Deletion policy</h3>
    *
@@ -74,6 +80,9 @@ namespace lar {
    * this self-distruction; if you are completely sure that no other container
    * is currently using the same allocator, you can explicitly Free() its
    * memory.
+   * Each allocator object is a user, including copies and the allocators of
+   * different type created from it (e.g. by `std::map`, which allocates tree
+   * nodes rather than `T`).
    *
    * <h3>One allocator for them all</h3>
    *
@@ -84,26 +93,34 @@ namespace lar {
    * allocated already).
    *
    * This is implemented hiding a singleton in the allocator (as a static
-   * member). Each allocator type has its own singleton, i.e., a
+   * function variable). Each allocator type has its own singleton, i.e., a
    * BulkAllocator<int> does not share memory with a BulkAllocator<double>,
    * but all BulkAllocator<int> share.
+   *
+   * <h3>Multithreading</h3>
+   *
+   * Allocation is thread-safe. The pool has a few independent arenas, each
+   * one with its own current chunk and its own lock, and each thread always
+   * draws from the same arena: threads rarely compete for the same lock, and
+   * the elements allocated by one thread tend to be contiguous in memory.
+   * A new chunk is allocated only when the chunk of the arena of the calling
+   * thread is exhausted.
+   * `Free()` must not be called while other threads are using the pool.
    */
   template <typename T>
-  class BulkAllocator: public std::allocator<T> {
+  class BulkAllocator {
       public:
-    using BaseAllocator_t = std::allocator<T>;
-
-    // import types from the STL allocator
-    typedef typename BaseAllocator_t::size_type size_type;
-    typedef typename BaseAllocator_t::difference_type difference_type;
+    // types required by the STL allocator interface
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
 
-    typedef typename BaseAllocator_t::value_type value_type;
+    using value_type = T;
 
-    typedef typename BaseAllocator_t::pointer pointer;
-    typedef typename BaseAllocator_t::const_pointer const_pointer;
+    using pointer = T*;
+    using const_pointer = T const*;
 
-    typedef typename BaseAllocator_t::reference reference;
-    typedef typename BaseAllocator_t::const_reference const_reference;
+    using reference = T&;
+    using const_reference = T const&;
 
     template<typename U>
     struct rebind {
@@ -114,19 +131,21 @@ namespace lar {
     BulkAllocator() noexcept: BulkAllocator(GetChunkSize(), false) {}
 
     /// Constructor: sets chunk size and optionally allocates the first chunk
-    BulkAllocator(size_type ChunkSize, bool bPreallocate = false) noexcept
+    BulkAllocator(size_type ChunkSize, bool bPreallocate = false)
       { CreateGlobalAllocator(ChunkSize, bPreallocate); }
 
-    /// Copy constructor: default
-    BulkAllocator(const BulkAllocator &a) noexcept = default;
+    /// Copy constructor: adds a user to the shared pool
+    BulkAllocator(const BulkAllocator &) noexcept
+      { GlobalAllocator().AddUser(); }
 
-    /// Move  constructor: default
-    BulkAllocator(BulkAllocator &&a) noexcept = default;
+    /// Move constructor: adds a user to the shared pool
+    BulkAllocator(BulkAllocator &&) noexcept
+      { GlobalAllocator().AddUser(); }
 
-    /// General copy constructor; currently, it does not preallocate
+    /// General copy constructor; it adds a user with the current parameters
     template <class U>
-    BulkAllocator(const BulkAllocator<U> &a) noexcept:
-      BaseAllocator_t(a) { SetChunkSize(a.GetChunkSize()); }
+    BulkAllocator(const BulkAllocator<U> &) noexcept
+      { GlobalAllocator().AddUser(); }
 
     /// Copy assignment: default
     BulkAllocator& operator = (const BulkAllocator &a) = default;
@@ -135,7 +154,7 @@ namespace lar {
     BulkAllocator& operator = (BulkAllocator &&a) = default;
 
     /// Destructor; memory is freed only if no allocators are left around
-    ~BulkAllocator() { GlobalAllocator.RemoveUser(); }
+    ~BulkAllocator() { GlobalAllocator().RemoveUser(); }
 
     /// Allocates memory for n elements
     pointer allocate(size_type n, const void* /* hint */ = 0);
@@ -144,14 +163,21 @@ namespace lar {
     void deallocate(pointer p, size_type n);
 
     /// Releases all the allocated memory: dangerous!
-    static void Free() { GlobalAllocator.Free(); }
+    static void Free() { GlobalAllocator().Free(); }
 
     /// Returns the chunk size of the underlying global allocator
-    static size_type GetChunkSize() { return GlobalAllocator.GetChunkSize(); }
+    static size_type GetChunkSize() { return GlobalAllocator().GetChunkSize(); }
 
     /// Sets chunk size of global allocator; only affects future allocations!
     static void SetChunkSize(size_type ChunkSize)
-      { GlobalAllocator.SetChunkSize(ChunkSize); }
+      { GlobalAllocator().SetChunkSize(ChunkSize); }
+
+    /// Returns the number of used and unused elements in the shared pool
+    static std::array<size_type, 2> GetCounts()
+      { return GlobalAllocator().GetCounts(); }
+
+    /// Returns the number of memory chunks allocated in the shared pool
+    static size_type NChunks() { return GlobalAllocator().NChunks(); }
 
       private:
     typedef details::bulk_allocator::BulkAllocatorBase<T>
@@ -161,21 +187,34 @@ namespace lar {
     void CreateGlobalAllocator(size_type ChunkSize, bool bPreallocate = false);
 
     /// The allocator shared by all instances of this object
-    static SharedAllocator_t GlobalAllocator;
+    static SharedAllocator_t& GlobalAllocator();
 
 
   }; // class BulkAllocator<>
 
+
+  /// All bulk allocators share the same memory and they are equivalent.
+  template <typename T, typename U>
+  bool operator== (BulkAllocator<T> const&, BulkAllocator<U> const&)
+    { return true; }
+
+  template <typename T, typename U>
+  bool operator!= (BulkAllocator<T> const&, BulkAllocator<U> const&)
+    { return false; }
+
 } // namespace lar
 
 
 //------------------------------------------------------------------------------
 #include <algorithm> // std::max()
-#include <vector>
+#include <deque>
 #include <iostream>
-#include <array>
 #include <typeinfo>
 #include <string>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <functional> // std::hash<>
 #ifdef __GNUG__
 # include <cxxabi.h>
 #endif // __GNUG__
@@ -235,12 +274,19 @@ namespace lar {
         /// Adds a user to the users count
         void AddUser() { ++counter; }
 
-        /// Removed a user to the users count; returns false if no user yet
-        bool RemoveUser()
-          { if (!counter) return false; --counter; return true; }
+        /// Removes a user from the users count; returns the users left
+        /// (`0` also if there was no user to begin with)
+        Counter_t RemoveUser()
+          {
+            Counter_t count = counter.load();
+            do {
+              if (!count) return 0;
+            } while (!counter.compare_exchange_weak(count, count - 1));
+            return count - 1;
+          }
 
           private:
-        Counter_t counter = 0;
+        std::atomic<Counter_t> counter { 0 };
       }; // class ReferenceCounter
 
 
@@ -251,7 +297,11 @@ namespace lar {
        * Memory is never freed, until the last user is removed (which is
        * responsibility of the caller), this object is destroyed of Free() is
        * explicitly called.
-       * The amount of memory on
+       *
+       * The pool is split in `NArenas` arenas. Each thread draws memory always
+       * from the same arena, which has its current chunk and its lock.
+       * The arenas start with no chunk, so that a single thread will use only
+       * one of them.
        *
        * This class has a users counter. The count must be explicitly handled by
        * the caller.
@@ -263,6 +313,9 @@ namespace lar {
         typedef T value_type;
         typedef T* pointer;
 
+        /// Number of independent arenas in the pool.
+        static constexpr size_type NArenas = 16U;
+
         /// Constructor; preallocates memory if explicitly requested
         BulkAllocatorBase(
           size_type NewChunkSize = DefaultChunkSize, bool bPreallocate = false
@@ -286,7 +339,8 @@ namespace lar {
         /// Add a new pool user with new parameters
         void AddUser(size_type NewChunkSize, bool bPreallocate = false);
 
-        /// Removed a user to the users count; if no user is left, free the pool
+        /// Removes a user from the users count; if no user is left, frees the
+        /// pool; returns whether there are users left
         bool RemoveUser();
 
         /// Returns the total number of entries in the pool
@@ -299,7 +353,7 @@ namespace lar {
         size_type FreeCount() const;
 
         /// Returns the number of memory pool chunks allocated
-        size_type NChunks() const { return MemoryPool.size(); }
+        size_type NChunks() const;
 
         /// Returns an array equivalent to { UsedCount(), FreeCount() }
         std::array<size_type, 2> GetCounts() const;
@@ -337,13 +391,14 @@ namespace lar {
               free = begin;
             } // MemoryChunk_t()
           MemoryChunk_t(const MemoryChunk_t&) = delete; ///< Can't copy
-          MemoryChunk_t(MemoryChunk_t&&); ///< Move constructor
+          MemoryChunk_t(MemoryChunk_t&&) = delete; ///< Can't move
 
-          ~MemoryChunk_t() { allocator->deallocate(begin, size()); }
+          ~MemoryChunk_t() { if (begin) allocator->deallocate(begin, size()); }
 
           MemoryChunk_t& operator=(const MemoryChunk_t&) = delete;
             ///< Can't assign
-          MemoryChunk_t& operator=(MemoryChunk_t&&); ///< Move assignment
+          MemoryChunk_t& operator=(MemoryChunk_t&&) = delete;
+            ///< Can't assign
 
           /// Returns the number of elements in this pool
           size_type size() const { return end - begin; }
@@ -363,22 +418,27 @@ namespace lar {
           /// Returns a pointer to n free items, or nullptr if not available
           pointer get(size_t n)
             {
+              if (n > available()) return nullptr;
               pointer ptr = free;
-              if ((free += n) <= end) return ptr;
-              free = ptr;
-              return nullptr;
+              free += n;
+              return ptr;
             }
 
-            private:
-          ///< Default constructor (does nothing)
-          MemoryChunk_t(): allocator(nullptr) {}
-
         }; // class MemoryChunk_t
 
-        typedef std::vector<MemoryChunk_t> MemoryPool_t;
+        /// A part of the pool with its own current chunk.
+        struct Arena_t {
+          std::mutex lock; ///< protects the current chunk
+          MemoryChunk_t* chunk = nullptr; ///< chunk memory is drawn from
+        }; // Arena_t
+
+        /// all chunks; chunks do not move when new ones are added
+        typedef std::deque<MemoryChunk_t> MemoryPool_t;
 
-        size_type ChunkSize; ///< size of the chunks to add
-        MemoryPool_t MemoryPool; ///< list of all memory chunks; first is free
+        std::atomic<size_type> ChunkSize; ///< size of the chunks to add
+        MemoryPool_t MemoryPool; ///< list of all memory chunks
+        mutable std::mutex PoolLock; ///< protects `MemoryPool`
+        mutable std::array<Arena_t, NArenas> Arenas; ///< the arenas
 
         /// Default chunk size (default: 10000)
         static size_type DefaultChunkSize;
@@ -386,27 +446,21 @@ namespace lar {
         /// Preallocates a chunk of the given size; allocates if free space < n
         void Preallocate(size_type n);
 
-      }; // class BulkAllocatorBase<>
+        /// Releases the pool (if `bOnlyIfUnused`, only if there are no users);
+        /// returns whether the pool was released
+        bool FreePool(bool bOnlyIfUnused);
 
+        /// Returns the arena of the current thread
+        Arena_t& ThreadArena() const;
 
-      template <typename T>
-      BulkAllocatorBase<T>::MemoryChunk_t::MemoryChunk_t(MemoryChunk_t&& from) {
-        std::swap(allocator, from.allocator);
-        std::swap(begin, from.begin);
-        std::swap(end, from.end);
-        std::swap(free, from.free);
-      } // BulkAllocatorBase<T>::MemoryChunk_t::MemoryChunk_t(MemoryChunk_t&&)
+        /// Adds a chunk with room for at least n elements to the pool
+        MemoryChunk_t& NewChunk(size_type n);
 
-      template <typename T>
-      typename BulkAllocatorBase<T>::MemoryChunk_t&
-        BulkAllocatorBase<T>::MemoryChunk_t::operator= (MemoryChunk_t&& from)
-      {
-        std::swap(allocator, from.allocator);
-        std::swap(begin, from.begin);
-        std::swap(end, from.end);
-        std::swap(free, from.free);
-        return *this;
-      } // BulkAllocatorBase<T>::MemoryChunk_t::operator= (MemoryChunk_t&&)
+        /// Calls op(chunk) on all chunks, with all arenas locked
+        template <typename Op>
+        void ForEachChunk(Op op) const;
+
+      }; // class BulkAllocatorBase<>
 
 
       template <typename T>
@@ -418,7 +472,7 @@ namespace lar {
         (size_type NewChunkSize, bool bPreallocate /* = false */):
         ChunkSize(NewChunkSize), MemoryPool()
       {
-        Preallocate(bPreallocate? ChunkSize: 0);
+        if (bPreallocate) Preallocate(ChunkSize);
         if (bDebug) {
           std::cout << "BulkAllocatorBase[" << ((void*) this)
             << "] created for type " << demangle<value_type>()
@@ -431,22 +485,36 @@ namespace lar {
 
 
       template <typename T>
-      void BulkAllocatorBase<T>::Free() {
+      void BulkAllocatorBase<T>::Free() { FreePool(false); }
+
+
+      template <typename T>
+      bool BulkAllocatorBase<T>::FreePool(bool bOnlyIfUnused) {
         if (bDebug) {
           std::cout << "BulkAllocatorBase[" << ((void*) this) << "] freeing "
             << NChunks() << " memory chunks with " << AllocatedCount()
             << " elements" << std::endl;
         } // if debug
-        MemoryPool.clear();
-      } // BulkAllocatorBase<T>::Free()
+        bool bFreed = false;
+        for (Arena_t& arena: Arenas) arena.lock.lock();
+        {
+          std::lock_guard<std::mutex> guard(PoolLock);
+          // a user added meanwhile may already have memory from the pool
+          if (!bOnlyIfUnused || !hasUsers()) {
+            for (Arena_t& arena: Arenas) arena.chunk = nullptr;
+            MemoryPool.clear();
+            bFreed = true;
+          }
+        }
+        for (Arena_t& arena: Arenas) arena.lock.unlock();
+        return bFreed;
+      } // BulkAllocatorBase<T>::FreePool()
 
 
       template <typename T>
       bool BulkAllocatorBase<T>::RemoveUser() {
-        ReferenceCounter::RemoveUser();
-        if (hasUsers()) return true;
-        Free();
-        return false;
+        if (ReferenceCounter::RemoveUser() > 0) return true;
+        return !FreePool(true);
       } // BulkAllocatorBase<T>::RemoveUser()
 
 
@@ -456,15 +524,50 @@ namespace lar {
       {
         AddUser();
         SetChunkSize(NewChunkSize);
-        Preallocate(bPreallocate? ChunkSize: 0);
+        if (bPreallocate) Preallocate(ChunkSize);
       } // BulkAllocatorBase<T>::AddUser(size_type, bool )
 
 
       template <typename T>
       void BulkAllocatorBase<T>::Preallocate(size_type n) {
-        if (MemoryPool.empty() || (MemoryPool.front().available() < n))
-          MemoryPool.emplace_back(allocator, n);
-      } // BulkAllocatorBase<T>::RemoveUser()
+        Arena_t& arena = ThreadArena();
+        std::lock_guard<std::mutex> guard(arena.lock);
+        if (!arena.chunk || (arena.chunk->available() < n))
+          arena.chunk = &NewChunk(n);
+      } // BulkAllocatorBase<T>::Preallocate()
+
+
+      template <typename T>
+      auto BulkAllocatorBase<T>::ThreadArena() const -> Arena_t& {
+        static thread_local size_type const index
+          = std::hash<std::thread::id>()(std::this_thread::get_id()) % NArenas;
+        return Arenas[index];
+      } // BulkAllocatorBase<T>::ThreadArena()
+
+
+      template <typename T>
+      auto BulkAllocatorBase<T>::NewChunk(size_type n) -> MemoryChunk_t& {
+        std::lock_guard<std::mutex> guard(PoolLock);
+        if (bDebug) {
+          std::cout << "BulkAllocatorBase[" << ((void*) this)
+            << "] allocating " << n << " more elements (on top of the current "
+            << MemoryPool.size() << " chunks)" << std::endl;
+        } // if debug
+        MemoryPool.emplace_back(allocator, n);
+        return MemoryPool.back();
+      } // BulkAllocatorBase<T>::NewChunk()
+
+
+      template <typename T>
+      template <typename Op>
+      void BulkAllocatorBase<T>::ForEachChunk(Op op) const {
+        for (Arena_t& arena: Arenas) arena.lock.lock();
+        {
+          std::lock_guard<std::mutex> guard(PoolLock);
+          for (const auto& chunk: MemoryPool) op(chunk);
+        }
+        for (Arena_t& arena: Arenas) arena.lock.unlock();
+      } // BulkAllocatorBase<T>::ForEachChunk()
 
 
       template <typename T>
@@ -472,7 +575,7 @@ namespace lar {
         BulkAllocatorBase<T>::AllocatedCount() const
       {
         size_type n = 0;
-        for (const auto& chunk: MemoryPool) n += chunk.size();
+        ForEachChunk([&n](MemoryChunk_t const& chunk){ n += chunk.size(); });
         return n;
       } // AllocatedCount()
 
@@ -482,11 +585,31 @@ namespace lar {
         BulkAllocatorBase<T>::UsedCount() const
       {
         size_type n = 0;
-        for (const auto& chunk: MemoryPool) n += chunk.used();
+        ForEachChunk([&n](MemoryChunk_t const& chunk){ n += chunk.used(); });
         return n;
       } // BulkAllocatorBase<T>::UsedCount()
 
 
+      template <typename T>
+      typename BulkAllocatorBase<T>::size_type
+        BulkAllocatorBase<T>::FreeCount() const
+      {
+        size_type n = 0;
+        ForEachChunk
+          ([&n](MemoryChunk_t const& chunk){ n += chunk.available(); });
+        return n;
+      } // BulkAllocatorBase<T>::FreeCount()
+
+
+      template <typename T>
+      typename BulkAllocatorBase<T>::size_type
+        BulkAllocatorBase<T>::NChunks() const
+      {
+        std::lock_guard<std::mutex> guard(PoolLock);
+        return MemoryPool.size();
+      } // BulkAllocatorBase<T>::NChunks()
+
+
       template <typename T>
       std::array<typename BulkAllocatorBase<T>::size_type, 2>
         BulkAllocatorBase<T>::GetCounts() const
@@ -494,10 +617,10 @@ namespace lar {
         // BUG the double brace syntax is required to work around clang bug 21629
         // (https://bugs.llvm.org/show_bug.cgi?id=21629)
         std::array<BulkAllocatorBase<T>::size_type, 2> stats = {{ 0U, 0U }};
-        for (const auto& chunk: MemoryPool) {
+        ForEachChunk([&stats](MemoryChunk_t const& chunk){
           stats[0] += chunk.used();
           stats[1] += chunk.available();
-        } // for
+        });
         return stats;
       } // BulkAllocatorBase<T>::GetCounts()
 
@@ -523,22 +646,17 @@ namespace lar {
         (size_type n)
       {
         if (n == 0) return nullptr;
-        // get the free pointer from the latest chunk (#0)
-        pointer ptr = MemoryPool.front().get(n);
-        if (ptr) return ptr;
-        // no free element left in that chunk:
-        // - create a new one in the first position of the pool (move the rest)
-        // - return the pointer from the new pool
-        //   (if it fails, it fails... but how could that happen?)
-        if (bDebug) {
-          std::array<size_type, 2> stats = GetCounts();
-          std::cout << "BulkAllocatorBase[" << ((void*) this)
-            << "] allocating " << std::max(ChunkSize, n)
-            << " more elements (on top of the current " << (stats[0] + stats[1])
-            << " elements, " << stats[1] << " unused)" << std::endl;
-        } // if debug
-        return MemoryPool.emplace
-          (MemoryPool.begin(), allocator, std::max(ChunkSize, n))->get(n);
+        Arena_t& arena = ThreadArena();
+        std::lock_guard<std::mutex> guard(arena.lock);
+        // get the free pointer from the current chunk of the arena
+        if (arena.chunk) {
+          pointer ptr = arena.chunk->get(n);
+          if (ptr) return ptr;
+        }
+        // no room left in that chunk: replace it with a new one; the rest of
+        // the old chunk is left unused
+        arena.chunk = &NewChunk(std::max(size_type(ChunkSize), n));
+        return arena.chunk->get(n);
       } // BulkAllocatorBase<T>::Get()
 
 
@@ -547,27 +665,116 @@ namespace lar {
 
 
   template <typename T>
-  typename BulkAllocator<T>::SharedAllocator_t
-    BulkAllocator<T>::GlobalAllocator;
+  typename BulkAllocator<T>::SharedAllocator_t&
+    BulkAllocator<T>::GlobalAllocator()
+  {
+    static SharedAllocator_t GlobalAllocator;
+    return GlobalAllocator;
+  } // BulkAllocator<T>::GlobalAllocator()
 
   template <typename T>
   void BulkAllocator<T>::CreateGlobalAllocator
     (size_type ChunkSize, bool bPreallocate /* = false */)
   {
-    GlobalAllocator.AddUser(ChunkSize, bPreallocate);
+    GlobalAllocator().AddUser(ChunkSize, bPreallocate);
   } // BulkAllocator<T>::CreateGlobalAllocator()
 
   template <typename T>
   inline typename BulkAllocator<T>::pointer BulkAllocator<T>::allocate
     (size_type n, const void * /* hint = 0 */)
-    { return GlobalAllocator.Get(n); }
+    { return GlobalAllocator().Get(n); }
 
   template <typename T>
-  inline void BulkAllocator<T>::deallocate(pointer p, size_type n) {
-    return GlobalAllocator.Release(p);
+  inline void BulkAllocator<T>::deallocate(pointer p, size_type) {
+    return GlobalAllocator().Release(p);
   } // BulkAllocator<T>::deallocate()
+
+
+#if __has_include(<memory_resource>)
+  /**
+   * @brief Memory resource drawing memory from a bulk memory pool
+   *
+   * This is a `std::pmr::memory_resource` with the same policy as
+   * `lar::BulkAllocator`: memory is allocated in large chunks and it is never
+   * released until `release()` is called or the resource is destroyed.
+   * Unlike `std::pmr::monotonic_buffer_resource`, it can be used concurrently
+   * by many threads. Each resource has its own pool, and it can be used by
+   * many containers of different types:
+   * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~{.cpp}
+   * lar::BulkMemoryResource eventMemory;
+   * std::pmr::vector<recob::Hit> hits(&eventMemory);
+   * std::pmr::map<int, std::pmr::vector<float>> charges(&eventMemory);
+   * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+   * The memory must not be used after the resource is destroyed.
+   * Requests with an alignment larger than the one of `std::max_align_t` are
+   * forwarded to the global `operator new` and `operator delete`.
+   */
+  class BulkMemoryResource: public std::pmr::memory_resource {
+      public:
+    /// Default size of the memory chunks [bytes]
+    static constexpr std::size_t DefaultChunkBytes = 1048576U;
+
+    /// Constructor: sets the size of the memory chunks [bytes]
+    explicit BulkMemoryResource(std::size_t chunkBytes = DefaultChunkBytes)
+      : pool(Units(chunkBytes))
+      {}
+
+    /// Releases all the allocated memory: dangerous!
+    void release() { pool.Free(); }
+
+    /// Returns the size of the memory chunks [bytes]
+    std::size_t GetChunkSize() const
+      { return pool.GetChunkSize() * UnitSize; }
+
+    /// Sets the size of the future memory chunks [bytes]
+    void SetChunkSize(std::size_t chunkBytes)
+      { pool.SetChunkSize(Units(chunkBytes)); }
+
+    /// Returns the number of used and unused bytes in the pool
+    std::array<std::size_t, 2> GetCounts() const
+      {
+        std::array<std::size_t, 2> counts = pool.GetCounts();
+        for (std::size_t& count: counts) count *= UnitSize;
+        return counts;
+      }
+
+    /// Returns the number of memory chunks allocated in the pool
+    std::size_t NChunks() const { return pool.NChunks(); }
+
+      protected:
+    virtual void* do_allocate(std::size_t bytes, std::size_t alignment) override
+      {
+        if (alignment > alignof(Unit_t))
+          return ::operator new(bytes, std::align_val_t(alignment));
+        return pool.Get(std::max(Units(bytes), std::size_t(1)));
+      }
+
+    virtual void do_deallocate
+      (void* p, std::size_t /* bytes */, std::size_t alignment) override
+      {
+        if (alignment > alignof(Unit_t))
+          ::operator delete(p, std::align_val_t(alignment));
+      }
+
+    virtual bool do_is_equal
+      (std::pmr::memory_resource const& other) const noexcept override
+      { return this == &other; }
+
+      private:
+    using Unit_t = std::max_align_t; ///< allocation unit, with max alignment
+
+    static constexpr std::size_t UnitSize = sizeof(Unit_t);
+
+    /// Returns the number of units needed to hold `bytes` bytes
+    static std::size_t Units(std::size_t bytes)
+      { return (bytes + UnitSize - 1) / UnitSize; }
+
+    details::bulk_allocator::BulkAllocatorBase<Unit_t> pool; ///< memory pool
+
+  }; // class BulkMemoryResource
+#endif // __has_include(<memory_resource>)
+
 } // namespace lar
 
 
 #endif // BULKALLOCATOR_H
-
@@ -11,6 +11,9 @@
 #define LARDATA_UTILITIES_CHISQUAREACCUMULATOR_H
 
 
+// LArSoft libraries
+#include "lardata/Utilities/CompensatedSum.h"
+
 // C/C++ standard libraries
 #include <utility> // std::move(), std::forward()
 
@@ -22,6 +25,7 @@ namespace lar {
      * @brief Computes a &chi;&sup2; from expectation function and data points.
      * @tparam F type of the function
      * @tparam T type of data
+     * @tparam S type of the &chi;&sup2; sum (by default, plain `T`)
      *
      * The formula used is the simple
      * @f$ \chi^{2} = \sum_{i} \left(\frac{y_{i} - e(x_{i})}{\sigma_{i}}\right)^{2} @f$
@@ -50,12 +54,19 @@ namespace lar {
      * will check three observations against the prediction of `2 - x`,
      * returning a `chi2value` of `8.0` and a `degreesOfFreedom` of `0`
      * (note that the `3` degrees are manually subtracted).
+     *
+     * Points can also be removed (`remove()`), and accumulators with the same
+     * expectation merged (`merge()`). A &chi;&sup2; on a sliding window of
+     * points, updated at each step with one addition and one removal, should
+     * keep its sum with compensation of the rounding errors, with
+     * `S = lar::util::CompensatedSum<T>`.
      */
-    template <typename F, typename T = double>
+    template <typename F, typename T = double, typename S = T>
     class ChiSquareAccumulator {
         public:
       using Function_t = F; ///< Type of function for the expectation.
       using Data_t = T; ///< Type of parameter and observed values.
+      using Sum_t = S; ///< Type of the accumulated &chi;&sup2; sum.
 
       //@{
       /**
@@ -76,7 +87,7 @@ namespace lar {
 
       // @{
       /// Returns the value of &chi;&sup2; currently accumulated.
-      Data_t chiSquare() const { return fChiSq; }
+      Data_t chiSquare() const { return Data_t(fChiSq); }
       Data_t operator() () const { return chiSquare(); }
       operator Data_t() const { return chiSquare(); }
       //@}
@@ -120,15 +131,61 @@ namespace lar {
       void add(Data_t x, Data_t y, Data_t s)
         { fChiSq += sqr(z(y, expected(x), s)); ++fN; }
 
+      /**
+       * @brief Removes a data point from the &chi;&sup2;.
+       * @param x parameter
+       * @param y observed data with the `x` parameter
+       * @see add(Data_t, Data_t)
+       *
+       * The point must have been previously added with `add(x, y)`; this is
+       * not checked.
+       */
+      void remove(Data_t x, Data_t y)
+        { fChiSq -= sqr(y - expected(x)); --fN; }
+
+      /**
+       * @brief Removes a data point from the &chi;&sup2;.
+       * @param x parameter
+       * @param y observed data with the `x` parameter
+       * @param s uncertainty on the observed data
+       * @see add(Data_t, Data_t, Data_t)
+       *
+       * The point must have been previously added with `add(x, y, s)`; this is
+       * not checked.
+       */
+      void remove(Data_t x, Data_t y, Data_t s)
+        { fChiSq -= sqr(z(y, expected(x), s)); --fN; }
+
+      /**
+       * @brief Adds all the data points of another accumulator.
+       * @param other the accumulator to be merged into this one
+       *
+       * The contributions of `other` are added as they were computed, that is
+       * with the expectation function of `other`, which is assumed to be the
+       * same as this one.
+       */
+      void merge(ChiSquareAccumulator const& other)
+        { fChiSq += other.fChiSq; fN += other.fN; }
+
+      /**
+       * @brief Removes all the data points of another accumulator.
+       * @param other the accumulator with the points to be removed
+       * @see merge()
+       *
+       * The points in `other` must have been added to this accumulator too.
+       */
+      void remove(ChiSquareAccumulator const& other)
+        { fChiSq -= other.fChiSq; fN -= other.fN; }
+
       /// Resets all the counts, starting from no data.
-      void clear() { fChiSq = Data_t{0}; fN = 0U; }
+      void clear() { fChiSq = Sum_t(0); fN = 0U; }
 
       /// @}
       // --- END -- Data manipulation ------------------------------------------
 
         private:
       unsigned int fN = 0U; ///< Number of data entries.
-      Data_t fChiSq = 0.0;  ///< Accumulated &chi;&sup2; value.
+      Sum_t fChiSq = Sum_t(0); ///< Accumulated &chi;&sup2; value.
 
       Function_t fExpected; ///< Function for the expectation.
 
@@ -164,9 +221,10 @@ namespace lar {
     /**
      * @brief Creates a `ChiSquareAccumulator` object with the specified function.
      * @tparam T type of data (default: `double`)
+     * @tparam S type of the &chi;&sup2; sum (default: `T`)
      * @tparam F type of function (deduced from `e`)
      * @param e expectation function
-     * @return a `ChiSquareAccumulator<F,T>` instance with specified expectation
+     * @return a `ChiSquareAccumulator<F,T,S>` instance with specified expectation
      *
      * Example of usage:
      * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~{.cpp}
@@ -176,9 +234,9 @@ namespace lar {
      * declare `chiSquare` in a way equivalent to:
      * `lar::util::ChiSquareAccumulator<decltype(zero), float> chiSquare(zero)`.
      */
-    template <typename T, typename F>
+    template <typename T, typename S = T, typename F>
     auto makeChiSquareAccumulator(F&& e)
-      { return lar::util::ChiSquareAccumulator<F, T>(std::forward<F>(e)); }
+      { return lar::util::ChiSquareAccumulator<F, T, S>(std::forward<F>(e)); }
 
 
     //--------------------------------------------------------------------------
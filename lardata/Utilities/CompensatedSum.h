@@ -0,0 +1,142 @@
+/**
+ * @file   lardata/Utilities/CompensatedSum.h
+ * @brief  Sum with compensation of the rounding errors (Kahan/Neumaier).
+ * @see    `test/Utilities/CompensatedSum_test.cc`
+ *
+ * This is a header-only library.
+ */
+
+#ifndef LARDATA_UTILITIES_COMPENSATEDSUM_H
+#define LARDATA_UTILITIES_COMPENSATEDSUM_H
+
+
+// C/C++ standard libraries
+#include <cmath> // std::abs()
+
+
+namespace lar {
+  namespace util {
+
+    /**
+     * @brief Sum of floating point values with compensation of rounding errors.
+     * @tparam T type of the summed values
+     *
+     * The sum is kept as a running value plus a compensation term, which
+     * accumulates the low order bits lost in each addition (Neumaier variant
+     * of the Kahan summation algorithm).
+     * The precision of the result is then almost independent of the number of
+     * terms, and of whether values are later subtracted again: adding and then
+     * removing the same values leaves the sum (almost) exactly as it was.
+     *
+     * Example of usage:
+     * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~{.cpp}
+     * lar::util::CompensatedSum<double> sum;
+     * sum += 1.0;
+     * sum += 1e100;
+     * sum += 1.0;
+     * sum -= 1e100;
+     * double const total = sum; // 2.0
+     * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+     * A plain `double` sum would yield `0.0` instead.
+     *
+     * @note The algorithm relies on strict IEEE floating point semantics:
+     *       compiling with `-ffast-math` or equivalent options may optimize the
+     *       compensation away.
+     */
+    template <typename T>
+    class CompensatedSum {
+        public:
+      using Data_t = T; ///< Type of the summed values.
+
+      /// Constructor: starts from a sum of `0`.
+      CompensatedSum() = default;
+
+      /// Constructor: starts from the specified value.
+      CompensatedSum(Data_t value): fSum(value) {}
+
+
+      // --- BEGIN -- Access to results ----------------------------------------
+      /// @name Access to results
+      /// @{
+
+      //@{
+      /// Returns the compensated value of the sum.
+      Data_t value() const { return fSum + fCompensation; }
+      operator Data_t() const { return value(); }
+      //@}
+
+      /// Returns the uncompensated running sum.
+      Data_t sum() const { return fSum; }
+
+      /// Returns the current compensation term.
+      Data_t compensation() const { return fCompensation; }
+
+      /// @}
+      // --- END -- Access to results ------------------------------------------
+
+
+      // --- BEGIN -- Data manipulation ----------------------------------------
+      /// @name Data manipulation
+      /// @{
+
+      /// Adds a value to the sum.
+      CompensatedSum& add(Data_t v);
+
+      /// Subtracts a value from the sum.
+      CompensatedSum& sub(Data_t v) { return add(-v); }
+
+      /// Adds another sum, including its compensation.
+      CompensatedSum& add(CompensatedSum const& other)
+        { add(other.fSum); fCompensation += other.fCompensation; return *this; }
+
+      /// Subtracts another sum, including its compensation.
+      CompensatedSum& sub(CompensatedSum const& other)
+        { sub(other.fSum); fCompensation -= other.fCompensation; return *this; }
+
+      //@{
+      /// Adds or subtracts a value or another sum.
+      CompensatedSum& operator+= (Data_t v) { return add(v); }
+      CompensatedSum& operator-= (Data_t v) { return sub(v); }
+      CompensatedSum& operator+= (CompensatedSum const& other)
+        { return add(other); }
+      CompensatedSum& operator-= (CompensatedSum const& other)
+        { return sub(other); }
+      //@}
+
+      /// Resets the sum to `0`.
+      void clear() { fSum = Data_t{0}; fCompensation = Data_t{0}; }
+
+      /// @}
+      // --- END -- Data manipulation ------------------------------------------
+
+        private:
+      Data_t fSum = Data_t{0}; ///< Running (uncompensated) sum.
+      Data_t fCompensation = Data_t{0}; ///< Accumulated rounding errors.
+
+    }; // CompensatedSum<>
+
+
+    //--------------------------------------------------------------------------
+
+  } // namespace util
+} // namespace lar
+
+
+//------------------------------------------------------------------------------
+//--- template implementation
+//------------------------------------------------------------------------------
+template <typename T>
+auto lar::util::CompensatedSum<T>::add(Data_t v) -> CompensatedSum& {
+  Data_t const t = fSum + v;
+  // the bits lost are the ones of the smaller addend
+  if (std::abs(fSum) >= std::abs(v)) fCompensation += (fSum - t) + v;
+  else                               fCompensation += (v - t) + fSum;
+  fSum = t;
+  return *this;
+} // lar::util::CompensatedSum<>::add()
+
+
+//------------------------------------------------------------------------------
+
+
+#endif // LARDATA_UTILITIES_COMPENSATEDSUM_H
@@ -3,6 +3,14 @@
  * @brief  Map of counters, stored compactly
  * @author Gianluca Petrillo (petrillo@fnal.gov)
  * @date   August 22th, 2014
+ *
+ * This header provides:
+ *
+ * * `lar::CountersMap`: map of counters, allocated in blocks
+ * * storage policies for it: `lar::CountersMapTreeStorage` (default),
+ *   `lar::CountersMapHashStorage` and `lar::CountersMapPagedStorage`
+ * * `lar::HashCountersMap`, `lar::PagedCountersMap`: shortcuts for
+ *   `CountersMap` with a non-default storage
  */
 
 #ifndef COUNTERSMAP_H
@@ -10,8 +18,12 @@
 
 // interface include
 #include <cstddef> // std::ptrdiff_t
+#include <climits> // CHAR_BIT
 #include <map>
+#include <vector>
 #include <array>
+#include <algorithm> // std::fill(), std::min()
+#include <stdexcept> // std::out_of_range
 #include <functional> // std::less<>
 #include <memory> // std::allocator<>
 #include <utility> // std::pair<>
@@ -31,8 +43,19 @@ namespace lar {
 
   namespace details {
 
-    /// Type of block of counters (just a STL array until SUBCOUNTERS are in)
-    template <typename COUNTER, std::size_t NCounters>
+    /**
+     * @brief Type of block of counters
+     * @tparam COUNTER type of each counter
+     * @tparam NCounters number of counters in the block
+     * @tparam SUBCOUNTERS number of subcounters packed in each counter
+     *
+     * With more than one subcounter, each counter is split into `SUBCOUNTERS`
+     * fields of equal number of bits, and each field is a (sub)counter.
+     * The `get()`, `set()` and `add()` methods access the subcounters, while
+     * the array interface accesses the whole (packed) counters.
+     */
+    template
+      <typename COUNTER, std::size_t NCounters, unsigned int SUBCOUNTERS = 1>
     class CounterBlock: public std::array<COUNTER, NCounters> {
         public:
       using Counter_t = COUNTER;
@@ -40,12 +63,48 @@ namespace lar {
       using Array_t = std::array<Counter_t, NCounters>; ///< type of base class
       using value_type = typename Array_t::value_type;
 
+      /// Number of bits of each subcounter
+      static constexpr unsigned int SubcounterBits
+        = sizeof(Counter_t) * CHAR_BIT / SUBCOUNTERS;
+
       /// Default constructor: initializes the array to 0
       CounterBlock(): Array_t() { Array_t::fill(0); }
 
       /// Convenience constructor: initializes all counters to 0, except one
       CounterBlock(size_t index, Counter_t value): CounterBlock()
-        { Array_t::operator[](index) = value; }
+        { set(index, value); }
+
+      /// Returns the value of the specified subcounter
+      Counter_t get(size_t index) const
+        {
+          if constexpr (SUBCOUNTERS == 1) return Array_t::operator[](index);
+          else {
+            return (Array_t::operator[](index / SUBCOUNTERS) >> shift(index))
+              & SubcounterMask;
+          }
+        } // get()
+
+      /// Sets the specified subcounter (value is truncated); returns the value
+      Counter_t set(size_t index, Counter_t value)
+        {
+          if constexpr (SUBCOUNTERS == 1)
+            return Array_t::operator[](index) = value;
+          else {
+            Counter_t& counter = Array_t::operator[](index / SUBCOUNTERS);
+            value &= SubcounterMask;
+            counter = (counter & ~(SubcounterMask << shift(index)))
+              | (value << shift(index));
+            return value;
+          }
+        } // set()
+
+      /// Adds delta to the specified subcounter (wrapping); returns the value
+      Counter_t add(size_t index, Counter_t delta)
+        {
+          if constexpr (SUBCOUNTERS == 1)
+            return Array_t::operator[](index) += delta;
+          else return set(index, get(index) + delta);
+        } // add()
 
       void fill(const value_type& value) { Array_t::fill(value); }
       void fill(size_t begin, size_t n, const value_type& value)
@@ -54,12 +113,24 @@ namespace lar {
             (Array_t::data() + begin, Array_t::data() + begin + n, value);
         }
 
+        private:
+      /// Mask of the bits of a subcounter (in the lowest bits)
+      static constexpr Counter_t SubcounterMask = Counter_t(
+        Counter_t(~Counter_t(0))
+          >> (sizeof(Counter_t) * CHAR_BIT - SubcounterBits)
+        );
+
+      /// Position of the lowest bit of the specified subcounter
+      static constexpr unsigned int shift(size_t index)
+        { return (index % SUBCOUNTERS) * SubcounterBits; }
+
     }; // CounterBlock
 
     template <
       typename KEY,
       typename COUNTER,
-      size_t SIZE
+      size_t SIZE,
+      unsigned int SUBCOUNTERS = 1
       >
     struct CountersMapTraits {
 
@@ -70,7 +141,7 @@ namespace lar {
       static constexpr size_t NCounters = SIZE;
 
       /// Type of counter block actually stored.
-      using CounterBlock_t = CounterBlock<Counter_t, NCounters>;
+      using CounterBlock_t = CounterBlock<Counter_t, NCounters, SUBCOUNTERS>;
 
       /// General type of map (no special allocator specified).
       using PlainBaseMap_t = std::map<Key_t, CounterBlock_t, std::less<Key_t>>;
@@ -88,17 +159,385 @@ namespace lar {
 
     }; // struct CountersMapTraits
 
+
+    /**
+     * @brief Storage of counter blocks in a STL map
+     * @tparam Key type of the key of the blocks
+     * @tparam Block type of counter block
+     * @tparam Alloc allocator (rebound to the map value type)
+     *
+     * All the storage classes of the counter blocks have the same interface:
+     * `find()` returns a pointer to the block with the specified key, or
+     * `nullptr` if not present; `get()` returns the block with the specified
+     * key, creating it (with all counters at 0) if not present; the iterators
+     * point to pairs of block key and block.
+     *
+     * This storage iterates blocks in key order.
+     */
+    template <typename Key, typename Block, typename Alloc>
+    class CountersTreeMap {
+      using Map_t = std::map<
+        Key, Block, std::less<Key>,
+        typename std::allocator_traits<Alloc>::template rebind_alloc
+          <std::pair<const Key, Block>>
+        >;
+
+        public:
+      using value_type = typename Map_t::value_type;
+      using const_iterator = typename Map_t::const_iterator;
+
+      CountersTreeMap(Alloc const& alloc = Alloc()): map(alloc) {}
+
+      /// Returns the block with the specified key, `nullptr` if not present
+      Block const* find(Key key) const
+        {
+          auto const iBlock = map.find(key);
+          return (iBlock == map.end())? nullptr: &(iBlock->second);
+        }
+
+      /// Returns the block with the specified key, creating it if needed
+      Block& get(Key key)
+        {
+          auto iBlock = map.lower_bound(key);
+          if ((iBlock != map.end()) && (iBlock->first == key))
+            return iBlock->second;
+          // hint to insert before the block in the position we have already
+          // found (this is optimal in STL map for C++11)
+          return map.emplace_hint(iBlock, key, Block())->second;
+        }
+
+      bool empty() const { return map.empty(); }
+      std::size_t size() const { return map.size(); }
+      void clear() { map.clear(); }
+
+      const_iterator begin() const { return map.begin(); }
+      const_iterator end() const { return map.end(); }
+
+        private:
+      Map_t map; ///< the actual storage
+
+    }; // CountersTreeMap
+
+
+    /// Slot of the flat storages of counter blocks.
+    template <typename Key, typename Block>
+    struct CountersSlot {
+      std::pair<Key, Block> value; ///< key and block
+      bool used = false; ///< whether the slot holds a block
+    }; // CountersSlot
+
+
+    /// Forward iterator through the used slots in an array.
+    template <typename Slot>
+    class CountersSlotIterator {
+        public:
+      using value_type = decltype(Slot::value);
+      using difference_type = std::ptrdiff_t;
+      using pointer = value_type const*;
+      using reference = value_type const&;
+      using iterator_category = std::forward_iterator_tag;
+
+      CountersSlotIterator() = default;
+
+      /// Constructor: points to the first used slot from `begin` on
+      CountersSlotIterator(Slot const* begin, Slot const* end)
+        : ptr(begin), last(end)
+        { skipUnused(); }
+
+      reference operator*() const { return ptr->value; }
+      pointer operator->() const { return &(ptr->value); }
+
+      CountersSlotIterator& operator++() { ++ptr; skipUnused(); return *this; }
+
+      bool operator== (CountersSlotIterator const& other) const
+        { return ptr == other.ptr; }
+      bool operator!= (CountersSlotIterator const& other) const
+        { return ptr != other.ptr; }
+
+        private:
+      Slot const* ptr = nullptr; ///< current slot
+      Slot const* last = nullptr; ///< end of the slots
+
+      void skipUnused() { while ((ptr != last) && !ptr->used) ++ptr; }
+
+    }; // CountersSlotIterator
+
+
+    /**
+     * @brief Storage of counter blocks in an open addressing hash table
+     * @tparam Key type of the key of the blocks
+     * @tparam Block type of counter block
+     * @tparam KeySpan difference between the keys of consecutive blocks
+     * @tparam Alloc allocator (rebound to the slot type)
+     * @see CountersTreeMap
+     *
+     * The blocks are stored in a single array, at a position from a
+     * (Fibonacci) hash of their key; collisions are resolved with linear
+     * probing, and the table doubles when it is half full.
+     * Finding a block costs on average a bit more than one memory access.
+     * This storage iterates blocks in no specific order.
+     */
+    template
+      <typename Key, typename Block, std::size_t KeySpan, typename Alloc>
+    class CountersHashMap {
+      using Slot_t = CountersSlot<Key, Block>;
+      using Slots_t = std::vector<
+        Slot_t,
+        typename std::allocator_traits<Alloc>::template rebind_alloc<Slot_t>
+        >;
+
+        public:
+      using value_type = std::pair<Key, Block>;
+      using const_iterator = CountersSlotIterator<Slot_t>;
+
+      CountersHashMap(Alloc const& alloc = Alloc()): slots(alloc) {}
+
+      /// Returns the block with the specified key, `nullptr` if not present
+      Block const* find(Key key) const
+        {
+          if (slots.empty()) return nullptr;
+          for (std::size_t i = slotOf(key); ; i = (i + 1) & mask()) {
+            Slot_t const& slot = slots[i];
+            if (!slot.used) return nullptr;
+            if (slot.value.first == key) return &(slot.value.second);
+          } // for
+        }
+
+      /// Returns the block with the specified key, creating it if needed
+      Block& get(Key key)
+        {
+          if ((nUsed + 1) * 2 > slots.size()) grow();
+          for (std::size_t i = slotOf(key); ; i = (i + 1) & mask()) {
+            Slot_t& slot = slots[i];
+            if (slot.used) {
+              if (slot.value.first == key) return slot.value.second;
+              continue;
+            }
+            slot.value.first = key;
+            slot.used = true;
+            ++nUsed;
+            return slot.value.second;
+          } // for
+        }
+
+      bool empty() const { return nUsed == 0; }
+      std::size_t size() const { return nUsed; }
+      void clear() { slots.clear(); nUsed = 0; hashShift = 64; }
+
+      const_iterator begin() const
+        { return { slots.data(), slots.data() + slots.size() }; }
+      const_iterator end() const
+        {
+          return
+            { slots.data() + slots.size(), slots.data() + slots.size() };
+        }
+
+        private:
+      /// Initial number of slots in the table.
+      static constexpr std::size_t MinSlots = 16;
+
+      Slots_t slots; ///< the table
+      std::size_t nUsed = 0; ///< number of used slots
+      unsigned int hashShift = 64; ///< 64 - log2(slots.size())
+
+      std::size_t mask() const { return slots.size() - 1; }
+
+      /// Returns the preferred slot for the block with the specified key
+      std::size_t slotOf(Key key) const
+        {
+          using UKey_t = std::make_unsigned_t<Key>;
+          unsigned long long const blockNo
+            = static_cast<UKey_t>(key) / KeySpan;
+          return static_cast<std::size_t>
+            ((blockNo * 11400714819323198485ULL) >> hashShift);
+        }
+
+      /// Doubles the size of the table
+      void grow()
+        {
+          std::size_t const newSize = slots.empty()? MinSlots: 2 * slots.size();
+          Slots_t oldSlots(newSize, Slot_t(), slots.get_allocator());
+          std::swap(slots, oldSlots);
+          hashShift = 64;
+          while ((std::size_t(1) << (64 - hashShift)) < newSize) --hashShift;
+          for (Slot_t& oldSlot: oldSlots) {
+            if (!oldSlot.used) continue;
+            std::size_t i = slotOf(oldSlot.value.first);
+            while (slots[i].used) i = (i + 1) & mask();
+            slots[i] = std::move(oldSlot);
+          } // for
+        }
+
+    }; // CountersHashMap
+
+
+    /**
+     * @brief Storage of counter blocks in an array of pages, indexed by key
+     * @tparam Key type of the key of the blocks
+     * @tparam Block type of counter block
+     * @tparam KeySpan difference between the keys of consecutive blocks
+     * @tparam Alloc allocator (rebound to the slot and page types)
+     * @tparam PageSize number of blocks in a page
+     * @see CountersTreeMap
+     *
+     * The blocks are stored directly at the position of their key, in pages
+     * of `PageSize` blocks which are allocated the first time one of their
+     * blocks is needed. Finding a block costs two memory accesses.
+     * Keys must not be negative, and the memory needed grows with the largest
+     * key: this storage is suited for bounded key ranges, like channel
+     * numbers. This storage iterates blocks in key order.
+     */
+    template <
+      typename Key, typename Block, std::size_t KeySpan, typename Alloc,
+      std::size_t PageSize
+      >
+    class CountersPagedMap {
+      using Slot_t = CountersSlot<Key, Block>;
+      using Page_t = std::vector<
+        Slot_t,
+        typename std::allocator_traits<Alloc>::template rebind_alloc<Slot_t>
+        >;
+      using Pages_t = std::vector<
+        Page_t,
+        typename std::allocator_traits<Alloc>::template rebind_alloc<Page_t>
+        >;
+
+        public:
+      using value_type = std::pair<Key, Block>;
+
+      /// Forward iterator through the blocks of all pages
+      class const_iterator {
+          public:
+        using value_type = CountersPagedMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = value_type const*;
+        using reference = value_type const&;
+        using iterator_category = std::forward_iterator_tag;
+
+        const_iterator() = default;
+
+        /// Constructor: points to the first used slot from page `iPage` on
+        const_iterator(Pages_t const* allPages, std::size_t firstPage)
+          : pages(allPages), iPage(firstPage)
+          { skipUnused(); }
+
+        reference operator*() const { return slot().value; }
+        pointer operator->() const { return &(slot().value); }
+
+        const_iterator& operator++() { ++iSlot; skipUnused(); return *this; }
+
+        bool operator== (const_iterator const& other) const
+          { return (iPage == other.iPage) && (iSlot == other.iSlot); }
+        bool operator!= (const_iterator const& other) const
+          { return !(*this == other); }
+
+          private:
+        Pages_t const* pages = nullptr; ///< all pages
+        std::size_t iPage = 0; ///< current page
+        std::size_t iSlot = 0; ///< current slot in the page
+
+        Slot_t const& slot() const { return (*pages)[iPage][iSlot]; }
+
+        void skipUnused()
+          {
+            while (iPage < pages->size()) {
+              Page_t const& page = (*pages)[iPage];
+              while (iSlot < page.size()) {
+                if (page[iSlot].used) return;
+                ++iSlot;
+              }
+              ++iPage;
+              iSlot = 0;
+            } // while
+          }
+      }; // const_iterator
+
+      CountersPagedMap(Alloc const& alloc = Alloc()): pages(alloc) {}
+
+      /// Returns the block with the specified key, `nullptr` if not present
+      Block const* find(Key key) const
+        {
+          if (key < 0) return nullptr;
+          std::size_t const blockNo = static_cast<std::size_t>(key) / KeySpan;
+          std::size_t const iPage = blockNo / PageSize;
+          if (iPage >= pages.size()) return nullptr;
+          Page_t const& page = pages[iPage];
+          if (page.empty()) return nullptr;
+          Slot_t const& slot = page[blockNo % PageSize];
+          return slot.used? &(slot.value.second): nullptr;
+        }
+
+      /// Returns the block with the specified key, creating it if needed
+      /// @throw std::out_of_range if the key is negative
+      Block& get(Key key)
+        {
+          if (key < 0) {
+            throw std::out_of_range
+              ("lar::CountersMap: negative key not supported by paged storage");
+          }
+          std::size_t const blockNo = static_cast<std::size_t>(key) / KeySpan;
+          std::size_t const iPage = blockNo / PageSize;
+          if (iPage >= pages.size()) {
+            pages.resize(iPage + 1, Page_t(pages.get_allocator()));
+          }
+          Page_t& page = pages[iPage];
+          if (page.empty()) page.resize(PageSize);
+          Slot_t& slot = page[blockNo % PageSize];
+          if (!slot.used) {
+            slot.value.first = key;
+            slot.used = true;
+            ++nUsed;
+          }
+          return slot.value.second;
+        }
+
+      bool empty() const { return nUsed == 0; }
+      std::size_t size() const { return nUsed; }
+      void clear() { pages.clear(); nUsed = 0; }
+
+      const_iterator begin() const { return { &pages, 0 }; }
+      const_iterator end() const { return { &pages, pages.size() }; }
+
+        private:
+      Pages_t pages; ///< pages of blocks; empty pages are not allocated
+      std::size_t nUsed = 0; ///< number of used slots
+
+    }; // CountersPagedMap
+
   } // namespace details
 
 
+  /// Storage policy for `CountersMap`: STL map (ordered, the default).
+  struct CountersMapTreeStorage {
+    template <typename Key, typename Block, std::size_t KeySpan, typename Alloc>
+    using Map_t = details::CountersTreeMap<Key, Block, Alloc>;
+  }; // CountersMapTreeStorage
+
+  /// Storage policy for `CountersMap`: open addressing hash table (unordered).
+  struct CountersMapHashStorage {
+    template <typename Key, typename Block, std::size_t KeySpan, typename Alloc>
+    using Map_t = details::CountersHashMap<Key, Block, KeySpan, Alloc>;
+  }; // CountersMapHashStorage
+
+  /// Storage policy for `CountersMap`: array of pages indexed by key (ordered,
+  /// non-negative keys only); `PAGESIZE` blocks are allocated together.
+  template <std::size_t PAGESIZE = 256>
+  struct CountersMapPagedStorage {
+    template <typename Key, typename Block, std::size_t KeySpan, typename Alloc>
+    using Map_t
+      = details::CountersPagedMap<Key, Block, KeySpan, Alloc, PAGESIZE>;
+  }; // CountersMapPagedStorage
+
+
 
   /**
    * @brief Map storing counters in a compact way
    * @param KEY the type of the key of the counters map
    * @param COUNTER the type of a basic counter (can be signed or unsigned)
    * @param BLOCKSIZE the number of counters in a cluster
-   * @param ALLOC allocator for the underlying STL map
-   * @param SUBCOUNTERS split each counter in subcounters (not implemented yet)
+   * @param ALLOC allocator for the underlying storage
+   * @param SUBCOUNTERS split each counter in subcounters
+   * @param STORAGE policy for the storage of the counter blocks
    *
    * This class is designed for the need of a vast number of counters with
    * a integral numerical key, when the counter keys are usually clustered.
@@ -117,14 +556,30 @@ namespace lar {
    * "next counter" is well defined and we can store contiguous counters
    * in a fixed structure.
    *
+   * <h3>Storage</h3>
+   * The blocks of counters are stored according to the `STORAGE` policy:
+   * * `CountersMapTreeStorage` (default): a STL map; finding a block takes
+   *   a tree walk, and iteration is in key order
+   * * `CountersMapHashStorage`: an open addressing hash table; finding a block
+   *   takes about one memory access, and iteration is in no specific order
+   * * `CountersMapPagedStorage`: an array indexed by key, allocated in pages
+   *   as needed; finding a block takes two memory accesses, and iteration is in
+   *   key order; keys must not be negative, and the memory grows with the
+   *   largest key (good for bounded ranges, e.g. channel numbers)
+   *
+   * `HashCountersMap` and `PagedCountersMap` are shortcuts for the latter two.
+   *
    * <h3>Subcounters</h3>
    * The idea behind subcounters is that you migt want to split a counter into
    * subcounters to save memory if the maximum counter value is smaller than
    * the range of the counter type.
-   * <strong>The implementation is delayed</strong> since in the end the same
-   * effect can be achieved by using a small counter type (e.g. signed char),
-   * unless the range is smaller that 16 (or 4, or 2), in which case the
-   * character can be split into bits. That will cause some overhead for
+   * With `SUBCOUNTERS` larger than 1, each counter (which must be of unsigned
+   * type) is split into `SUBCOUNTERS` fields of equal number of bits, each one
+   * being a counter for a different key: e.g. with `COUNTER` an 8-bit type and
+   * `SUBCOUNTERS` 4, each counter holds four counts of 2 bits, in the range
+   * from 0 to 3. A block then holds `SIZE * SUBCOUNTERS` counts.
+   * Counts wrap around on overflow and underflow, like unsigned types do,
+   * without affecting the other subcounters. That will cause some overhead for
    * increment and decrement instructions.
    */
   template <
@@ -133,15 +588,22 @@ namespace lar {
     size_t SIZE,
     typename ALLOC
       = typename details::CountersMapTraits<KEY, COUNTER, SIZE>::DefaultAllocator_t,
-    unsigned int SUBCOUNTERS=1
+    unsigned int SUBCOUNTERS=1,
+    typename STORAGE = CountersMapTreeStorage
     >
   class CountersMap {
-    static_assert(SUBCOUNTERS == 1, "subcounters not implemented yet");
     static_assert(IsPowerOf2(SIZE),
       "the size of the cluster of counters must be a power of 2");
+    static_assert(IsPowerOf2(SUBCOUNTERS),
+      "the number of subcounters must be a power of 2");
+    static_assert(SUBCOUNTERS <= sizeof(COUNTER) * CHAR_BIT,
+      "subcounters can't be smaller than one bit");
+    static_assert((SUBCOUNTERS == 1) || std::is_unsigned<COUNTER>::value,
+      "subcounters require an unsigned counter type");
 
     /// Set of data types pertaining this counter.
-    using Traits_t = details::CountersMapTraits<KEY, COUNTER, SIZE>;
+    using Traits_t
+      = details::CountersMapTraits<KEY, COUNTER, SIZE, SUBCOUNTERS>;
 
       public:
     using Key_t = KEY; ///< type of counter key in the map
@@ -149,7 +611,8 @@ namespace lar {
     using Allocator_t = ALLOC; ///< type of the single counter
 
     /// This class
-    using CounterMap_t = CountersMap<KEY, COUNTER, SIZE, ALLOC, SUBCOUNTERS>;
+    using CounterMap_t
+      = CountersMap<KEY, COUNTER, SIZE, ALLOC, SUBCOUNTERS, STORAGE>;
 
 
     /// Number of counters in one counter block
@@ -165,10 +628,8 @@ namespace lar {
     using CounterBlock_t = typename Traits_t::CounterBlock_t;
 
     /// Type of the map used in the implementation
-    using BaseMap_t = typename Traits_t::template BaseMap_t<
-      typename std::allocator_traits<Allocator_t>::template rebind_alloc
-        <typename Traits_t::MapValue_t>
-      >;
+    using BaseMap_t = typename STORAGE::template Map_t
+      <Key_t, CounterBlock_t, NSubcounters, Allocator_t>;
 
     /*
     /// Iterator through the allocated elements
@@ -195,7 +656,7 @@ namespace lar {
     CountersMap() {}
 
     /// Constructor, specifies an allocator
-    CountersMap(Allocator_t alloc): BaseMap_t(alloc) {}
+    CountersMap(Allocator_t alloc): counter_map(alloc) {}
 
 
     /// Read-only access to an element; returns 0 if no counter is present
@@ -232,6 +693,7 @@ namespace lar {
     ///@{
     /// @name Iterators (experimental)
     // this stuff needs serious work to be completed
+    // (iteration order depends on the storage; see the class documentation)
 
     /// Returns an iterator to the begin of the counters
     const_iterator begin() const;
@@ -265,6 +727,7 @@ namespace lar {
      * If there is a key in one map but not in the other, first_difference
      * stores that key; if a counter is present in both maps but with a
      * different count, first_difference reports the key of that counter.
+     * Of all the differences, the one with the lowest key is reported.
      * If no difference is found, first_difference is left untouched.
      */
     template <typename OALLOC>
@@ -359,15 +822,13 @@ namespace lar {
     BaseMap_t counter_map; ///< the actual data structure for counters
 
 
-    /// Returns the value of the counter at the specified split key
+    /// Returns the value of the (packed) counter at the specified split key
     Counter_t GetCounter(CounterKey_t key) const;
 
     /// Returns the value of the subcounter at the specified split key
-    // Since subcounters are not implemented yet, this is a no-op
-    SubCounter_t GetSubCounter(CounterKey_t key) const
-      { return GetCounter(key); }
+    SubCounter_t GetSubCounter(CounterKey_t key) const;
 
-    /// Returns the counter at the specified split key
+    /// Returns the (packed) counter at the specified split key
     Counter_t& GetOrCreateCounter(CounterKey_t key);
 
 
@@ -410,6 +871,28 @@ namespace lar {
   } // namespace details
 
 
+  /// `CountersMap` with blocks in a hash table (see `CountersMapHashStorage`).
+  template <
+    typename KEY, typename COUNTER, size_t SIZE, unsigned int SUBCOUNTERS = 1
+    >
+  using HashCountersMap = CountersMap<
+    KEY, COUNTER, SIZE,
+    typename details::CountersMapTraits<KEY, COUNTER, SIZE>::DefaultAllocator_t,
+    SUBCOUNTERS, CountersMapHashStorage
+    >;
+
+  /// `CountersMap` with blocks in pages (see `CountersMapPagedStorage`).
+  template <
+    typename KEY, typename COUNTER, size_t SIZE, unsigned int SUBCOUNTERS = 1,
+    std::size_t PAGESIZE = 256
+    >
+  using PagedCountersMap = CountersMap<
+    KEY, COUNTER, SIZE,
+    typename details::CountersMapTraits<KEY, COUNTER, SIZE>::DefaultAllocator_t,
+    SUBCOUNTERS, CountersMapPagedStorage<PAGESIZE>
+    >;
+
+
   inline constexpr int LowestSetBit(unsigned long long int v)
     { return (v == 0)? -1: details::LowestSetBitScaler(v, 0); }
 
@@ -420,22 +903,31 @@ namespace lar {
   // (or else the reference would not be needed).
   // I am not providing the same for the protected and private members
   // (just because of laziness).
-  template <typename K, typename C, size_t S, typename A, unsigned int SUB>
-  constexpr size_t CountersMap<K, C, S, A, SUB>::NCounters;
+  template <
+    typename K, typename C, size_t S, typename A, unsigned int SUB,
+    typename ST
+    >
+  constexpr size_t CountersMap<K, C, S, A, SUB, ST>::NCounters;
 
-  template <typename K, typename C, size_t S, typename A, unsigned int SUB>
-  constexpr size_t CountersMap<K, C, S, A, SUB>::NSubcounters;
+  template <
+    typename K, typename C, size_t S, typename A, unsigned int SUB,
+    typename ST
+    >
+  constexpr size_t CountersMap<K, C, S, A, SUB, ST>::NSubcounters;
 
 
   // CountersMap<>::const_iterator does not fully implement the STL iterator
   // interface, since it does not implement operator-> () (for technical reason:
   // the value does not actually exist and it does not have an address),
   // in addition to std::swap().
-  template <typename K, typename C, size_t S, typename A, unsigned int SUB>
-  class CountersMap<K, C, S, A, SUB>::const_iterator:
+  template <
+    typename K, typename C, size_t S, typename A, unsigned int SUB,
+    typename ST
+    >
+  class CountersMap<K, C, S, A, SUB, ST>::const_iterator:
     public std::bidirectional_iterator_tag
   {
-    friend CountersMap<K, C, S, A, SUB>;
+    friend CountersMap<K, C, S, A, SUB, ST>;
 
       public:
     using value_type = typename CounterMap_t::value_type; ///< value type: pair
@@ -450,7 +942,7 @@ namespace lar {
     const_iterator() = default;
 
     /// Access to the pointed pair
-    value_type operator*() const { return { key(), iter->second[index] }; }
+    value_type operator*() const { return { key(), iter->second.get(index) }; }
 
     iterator_type& operator++()
       {
@@ -490,165 +982,143 @@ namespace lar {
   }; // CountersMap<>::const_iterator
 
 
-  template <typename K, typename C, size_t S, typename A, unsigned int SUB>
-  inline typename CountersMap<K, C, S, A, SUB>::SubCounter_t
-    CountersMap<K, C, S, A, SUB>::set(Key_t key, SubCounter_t value)
+  template <
+    typename K, typename C, size_t S, typename A, unsigned int SUB,
+    typename ST
+    >
+  inline typename CountersMap<K, C, S, A, SUB, ST>::SubCounter_t
+    CountersMap<K, C, S, A, SUB, ST>::set(Key_t key, SubCounter_t value)
     { return unchecked_set(CounterKey_t(key), value); }
 
-  template <typename K, typename C, size_t S, typename A, unsigned int SUB>
-  inline typename CountersMap<K, C, S, A, SUB>::SubCounter_t
-    CountersMap<K, C, S, A, SUB>::increment(Key_t key)
+  template <
+    typename K, typename C, size_t S, typename A, unsigned int SUB,
+    typename ST
+    >
+  inline typename CountersMap<K, C, S, A, SUB, ST>::SubCounter_t
+    CountersMap<K, C, S, A, SUB, ST>::increment(Key_t key)
     { return unchecked_add(CounterKey_t(key), +1); }
 
-  template <typename K, typename C, size_t S, typename A, unsigned int SUB>
-  inline typename CountersMap<K, C, S, A, SUB>::SubCounter_t
-    CountersMap<K, C, S, A, SUB>::decrement(Key_t key)
+  template <
+    typename K, typename C, size_t S, typename A, unsigned int SUB,
+    typename ST
+    >
+  inline typename CountersMap<K, C, S, A, SUB, ST>::SubCounter_t
+    CountersMap<K, C, S, A, SUB, ST>::decrement(Key_t key)
     { return unchecked_add(CounterKey_t(key), -1); }
 
 
-  template <typename K, typename C, size_t S, typename A, unsigned int SUB>
-  inline typename CountersMap<K, C, S, A, SUB>::const_iterator
-    CountersMap<K, C, S, A, SUB>::begin() const
+  template <
+    typename K, typename C, size_t S, typename A, unsigned int SUB,
+    typename ST
+    >
+  inline typename CountersMap<K, C, S, A, SUB, ST>::const_iterator
+    CountersMap<K, C, S, A, SUB, ST>::begin() const
     { return const_iterator{ counter_map.begin(), 0 }; }
 
-  template <typename K, typename C, size_t S, typename A, unsigned int SUB>
-  inline typename CountersMap<K, C, S, A, SUB>::const_iterator
-    CountersMap<K, C, S, A, SUB>::end() const
+  template <
+    typename K, typename C, size_t S, typename A, unsigned int SUB,
+    typename ST
+    >
+  inline typename CountersMap<K, C, S, A, SUB, ST>::const_iterator
+    CountersMap<K, C, S, A, SUB, ST>::end() const
     { return const_iterator{ counter_map.end(), 0 }; }
 
 
-  template <typename K, typename C, size_t S, typename A, unsigned int SUB>
+  template <
+    typename K, typename C, size_t S, typename A, unsigned int SUB,
+    typename ST
+    >
   template <typename OALLOC>
-  bool CountersMap<K, C, S, A, SUB>::is_equal(
+  bool CountersMap<K, C, S, A, SUB, ST>::is_equal(
     const std::map<Key_t, SubCounter_t, std::less<Key_t>, OALLOC>& to,
     Key_t& first_difference
   ) const {
-    // this function is not optimised
-    using CompMap_t
-      = const std::map<Key_t, SubCounter_t, std::less<Key_t>, OALLOC>;
-    typename CompMap_t::const_iterator to_iter = to.begin(), to_end = to.end();
+    // this function is not optimised;
+    // it does not rely on the iteration order of either map, since it depends
+    // on the storage; all the differences are checked to report the lowest
+    bool bSame = true;
+    auto const difference = [&bSame, &first_difference](Key_t key){
+      if (bSame || (key < first_difference)) first_difference = key;
+      bSame = false;
+    };
+
+    // every counter here must match the one there, or be 0 if not there
     for (const typename const_iterator::value_type& p: *this) {
-
-      if (to_iter != to_end) { // we have still counters to find
-        // if counter is already beyond the next non-empty one froml STL map,
-        // then we are missing some
-        if (p.first > to_iter->first) {
-          first_difference = to_iter->first;
-          return false;
-        }
-    //    while (p.first > to_iter->first) {
-    //      ++nMissingKeys;
-    //      std::cout << "ERROR missing key " << to_iter->first << std::endl;
-    //      if (++to_iter == to_end) break;
-    //    } // while
-    //  } // if
-    //
-    //  if (to_iter != to_end) { // we have still counters to find
-        if (p.first == to_iter->first) {
-          // if the counter is in SLT map, the two counts must match
-        //  std::cout << "  " << p.first << " " << p.second << std::endl;
-          if (to_iter->second != p.second) {
-          //  std::cout << "ERROR wrong counter value " << p.second
-          //    << ", expected " << to_iter->second << std::endl;
-          //  ++nMismatchValue;
-            first_difference = to_iter->first;
-            return false;
-          }
-          ++to_iter; // done with it
-        }
-        else if (p.first < to_iter->first) {
-          // if the counter is not in STL map, then it must be 0
-          if (p.second != 0) {
-          //  ++nExtraKeys;
-          //  std::cout << "ERROR extra key " << p.first << " (" << p.second << ")"
-          //    << std::endl;
-            first_difference = p.first;
-            return false;
-          }
-        //  else {
-        //    std::cout << "  " << p.first << " " << p.second << " (not in STL)"
-        //      << std::endl;
-        //  }
-        }
-      }
-      else { // if we are at the end of compared map
-        // no more keys in STL map
-        if (p.second != 0) {
-        //  ++nExtraKeys;
-        //  std::cout << "ERROR extra key " << p.first << " (" << p.second << ")"
-        //    << std::endl;
-          first_difference = p.first;
-          return false;
-        }
-      }
+      auto const to_iter = to.find(p.first);
+      SubCounter_t const expected
+        = (to_iter == to.end())? SubCounter_t(0): to_iter->second;
+      if (p.second != expected) difference(p.first);
     } // for element in map
 
-    return true;
+    // every counter there must be here too (it might be in no block)
+    for (auto const& p: to) {
+      if (GetSubCounter(SplitKey(p.first)) != p.second) difference(p.first);
+    } // for element in the other map
+
+    return bSame;
   } // CountersMap<>::is_equal()
 
 
-  template <typename K, typename C, size_t S, typename A, unsigned int SUB>
-  inline typename CountersMap<K, C, S, A, SUB>::Counter_t
-    CountersMap<K, C, S, A, SUB>::GetCounter(CounterKey_t key) const
+  template <
+    typename K, typename C, size_t S, typename A, unsigned int SUB,
+    typename ST
+    >
+  inline typename CountersMap<K, C, S, A, SUB, ST>::Counter_t
+    CountersMap<K, C, S, A, SUB, ST>::GetCounter(CounterKey_t key) const
   {
-    typename BaseMap_t::const_iterator iBlock = counter_map.find(key.block);
-    return (iBlock == counter_map.end())? 0: iBlock->second[key.counter];
+    CounterBlock_t const* block = counter_map.find(key.block);
+    return block? (*block)[key.counter / SUB]: 0;
   } // CountersMap<>::GetCounter() const
 
 
-  template <typename K, typename C, size_t S, typename A, unsigned int SUB>
-  inline typename CountersMap<K, C, S, A, SUB>::Counter_t&
-    CountersMap<K, C, S, A, SUB>::GetOrCreateCounter(CounterKey_t key)
-    { return counter_map[key.block][key.counter]; }
+  template <
+    typename K, typename C, size_t S, typename A, unsigned int SUB,
+    typename ST
+    >
+  inline typename CountersMap<K, C, S, A, SUB, ST>::SubCounter_t
+    CountersMap<K, C, S, A, SUB, ST>::GetSubCounter(CounterKey_t key) const
+  {
+    CounterBlock_t const* block = counter_map.find(key.block);
+    return block? block->get(key.counter): 0;
+  } // CountersMap<>::GetSubCounter() const
 
 
-  template <typename K, typename C, size_t S, typename A, unsigned int SUB>
-  typename CountersMap<K, C, S, A, SUB>::SubCounter_t
-    CountersMap<K, C, S, A, SUB>::unchecked_set
+  template <
+    typename K, typename C, size_t S, typename A, unsigned int SUB,
+    typename ST
+    >
+  inline typename CountersMap<K, C, S, A, SUB, ST>::Counter_t&
+    CountersMap<K, C, S, A, SUB, ST>::GetOrCreateCounter(CounterKey_t key)
+    { return counter_map.get(key.block)[key.counter / SUB]; }
+
+
+  template <
+    typename K, typename C, size_t S, typename A, unsigned int SUB,
+    typename ST
+    >
+  typename CountersMap<K, C, S, A, SUB, ST>::SubCounter_t
+    CountersMap<K, C, S, A, SUB, ST>::unchecked_set
     (CounterKey_t key, SubCounter_t value)
   {
-    // take it low level here
-    // first get the iterator to the block
-    typename BaseMap_t::iterator iBlock = counter_map.lower_bound(key.block);
-    if (iBlock != counter_map.end()) {
-      if (iBlock->first == key.block) { // sweet, we have that counter already
-        return iBlock->second[key.counter] = value;
-      }
-    }
-    // no counter there yet: create one;
-    // hint to insert before the block in the position we jave already found
-    // (this is optimal in STL map for C++11);
-    // create a block using the special constructor;
-    // the temporary value created here is moved to the map
-    counter_map.insert(iBlock, { key.block, { key.counter, value } } );
-    return value;
-  } // CountersMap<>::unchecked_add() const
-
-
-  template <typename K, typename C, size_t S, typename A, unsigned int SUB>
-  typename CountersMap<K, C, S, A, SUB>::SubCounter_t
-    CountersMap<K, C, S, A, SUB>::unchecked_add
+    // the storage creates the block (all counters at 0) if not there yet
+    return counter_map.get(key.block).set(key.counter, value);
+  } // CountersMap<>::unchecked_set()
+
+
+  template <
+    typename K, typename C, size_t S, typename A, unsigned int SUB,
+    typename ST
+    >
+  typename CountersMap<K, C, S, A, SUB, ST>::SubCounter_t
+    CountersMap<K, C, S, A, SUB, ST>::unchecked_add
     (CounterKey_t key, SubCounter_t delta)
   {
-    // take it low level here
-    // first get the iterator to the block
-    typename BaseMap_t::iterator iBlock = counter_map.lower_bound(key.block);
-    if (iBlock != counter_map.end()) {
-      if (iBlock->first == key.block) { // sweet, we have that counter already
-        return iBlock->second[key.counter] += delta;
-      }
-    }
-    // no counter there yet: create one;
-    // hint to insert before the block in the position we jave already found
-    // (this is optimal in STL map for C++11);
-    // create a block using the special constructor;
-    // the temporary value created here is moved to the map
-    counter_map.insert(iBlock, { key.block, { key.counter, delta } } );
-    return delta;
-  } // CountersMap<>::unchecked_add() const
+    // the storage creates the block (all counters at 0) if not there yet
+    return counter_map.get(key.block).add(key.counter, delta);
+  } // CountersMap<>::unchecked_add()
 
 
 } // namespace lar
 
 
-#endif // BULKALLOCATOR_H
+#endif // COUNTERSMAP_H
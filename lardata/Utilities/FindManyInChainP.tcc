@@ -21,10 +21,13 @@
 #include "canvas/Utilities/Exception.h"
 
 // C/C++ standard library
-#include <map>
+#include <unordered_map>
+#include <vector>
+#include <optional>
+#include <limits> // std::numeric_limits<>
 #include <iterator> // std::begin(), std::cbegin(), std::distance()...
 #include <tuple> // std::tuple_cat(), ...
-#include <algorithm> // std::lower_bound(), std::sort(), std::transform()...
+#include <algorithm> // std::transform()...
 #include <utility> // std::pair<>, std::move(), std::declval()...
 #include <type_traits> // std::decay_t<>, std::enable_if_t<>, ...
 
@@ -137,145 +140,195 @@ namespace lar {
 
 
     //--------------------------------------------------------------------------
-    template <typename Value>
-    class SimpleDataIndex {
+    /**
+     * @brief Index of the positions of art pointers in a list.
+     *
+     * The index returns in constant time the positions in the original list
+     * where a given art pointer appears (all of them, in order).
+     * The pointers are grouped by product ID (there are usually very few).
+     * For each product, the implementation is chosen based on the data:
+     * * if the keys are not too sparse (which is the common case of pointers
+     *   to most of the elements of a data product), a table indexed directly
+     *   by key is used;
+     * * otherwise, a hash table keyed by the pointer key is used.
+     */
+    class PtrPositionIndex {
         public:
-      using Value_t = Value;
+      /// Value returned when there is no (further) position.
+      static constexpr std::size_t NoPosition
+        = std::numeric_limits<std::size_t>::max();
 
-      /// Constructor: indexes pointers to data in the specified collection.
-      template <typename BeginIter, typename EndIter>
-      SimpleDataIndex(BeginIter begin, EndIter end) { init(begin, end); }
+      /// A direct table is used if keys span less than this times the pointers.
+      static constexpr std::size_t MaxDenseSparseness = 4U;
 
-      /// Constructor: indexes pointers to data in the specified collection.
-      template <typename Coll>
-      SimpleDataIndex(Coll& data)
-        { using std::begin; using std::end; init(begin(data), end(data)); }
-
-      /// Returns a pointer to the matched data, nullptr if none.
-      std::size_t const* operator() (Value_t const& key) const
-        {
-          auto const e = index.cend();
-          auto const it = std::lower_bound(index.cbegin(), e, key, comparer());
-          return ((it == e) || (key < it->first))? nullptr: &(it->second);
-        }
+      /// Index of the pointers of a single data product.
+      class ProductIndex {
+          public:
+        /// Returns the product ID of this index.
+        art::ProductID const& id() const { return fID; }
 
+        /// Returns whether a direct table is used.
+        bool isDense() const { return fDense; }
 
-        private:
-      using IndexElement_t = std::pair<Value_t const*, std::size_t>;
+        /// Returns the first position of the pointer with `key`, or
+        /// `NoPosition` if no pointer has that key.
+        std::size_t first(std::size_t key) const
+          {
+            if (fDense)
+              return (key < fDenseFirst.size())? fDenseFirst[key]: NoPosition;
+            auto const it = fSparseFirst.find(key);
+            return (it == fSparseFirst.end())? NoPosition: it->second;
+          }
 
-      std::vector<IndexElement_t> index; ///< The index.
+          private:
+        friend class PtrPositionIndex;
 
-      template <typename BeginIter, typename EndIter>
-      void init(BeginIter begin, EndIter end)
-        {
-          index.reserve(std::distance(begin, end)); // hope it's fast
-          std::size_t i = 0;
-          for (auto it = begin; it != end; ++it, ++i)
-            index.emplace_back(&*it, i);
-          std::sort(index.begin(), index.end(), comparer());
-        }
+        art::ProductID fID; ///< ID of the product.
+        std::size_t fCount = 0U; ///< Number of pointers.
+        std::size_t fKeyEnd = 0U; ///< One plus the largest key.
+        bool fDense = true; ///< Whether `fDenseFirst` is used.
 
-      struct KeyComparer {
-        bool operator() (Value_t const& a, Value_t const& b) const
-          { return a < b; }
-        bool operator() (IndexElement_t  const& a, Value_t const& b) const
-          { return *(a.first) < b; }
-        bool operator() (Value_t const& a, IndexElement_t const& b) const
-          { return a < *(b.first); }
-        bool operator() (IndexElement_t const& a, IndexElement_t const& b) const
-          { return *(a.first) < *(b.first); }
-      }; // struct KeyComparer
+        /// First position, by key (dense mode).
+        std::vector<std::size_t> fDenseFirst;
 
-      static auto comparer() { return KeyComparer(); }
+        /// First position, by key (sparse mode).
+        std::unordered_map<std::size_t, std::size_t> fSparseFirst;
 
-    }; // class SimpleDataIndex
+      }; // class ProductIndex
 
 
-    template <typename Key, typename Value>
-    class DataIndex {
-        public:
-      using Key_t = Key;
-      using Value_t = Value;
-      using ValuePtr_t = std::add_pointer_t<Value_t>;
-
-      /// Constructor: indexes pointers to data in the specified collection.
-      template <typename BeginIter, typename EndIter, typename KeyExtractor>
-      DataIndex(BeginIter begin, EndIter end, KeyExtractor&& getKey)
-        { init(begin, end, std::forward<KeyExtractor>(getKey)); }
-
-      /// Constructor: indexes pointers to data in the specified collection.
-      template <typename Coll, typename KeyExtractor>
-      DataIndex(Coll& data, KeyExtractor&& getKey)
+      /// Constructor: indexes the pointers from `begin` to `end`.
+      template <typename BeginIter, typename EndIter>
+      PtrPositionIndex(BeginIter begin, EndIter end)
+        : PtrPositionIndex(begin, end, [](auto const& ptr){ return ptr; })
+        {}
+
+      /// Constructor: indexes the pointers `getPtr(elem)` of the elements
+      /// from `begin` to `end`.
+      template <typename BeginIter, typename EndIter, typename GetPtr>
+      PtrPositionIndex(BeginIter begin, EndIter end, GetPtr getPtr);
+
+      /// Returns the index of the product with the specified `id`, or
+      /// `nullptr` if no pointer is from that product.
+      ProductIndex const* product(art::ProductID const& id) const
         {
-          using std::begin;
-          using std::end;
-          init(begin(data), end(data), std::forward<KeyExtractor>(getKey));
+          for (ProductIndex const& index: fProducts)
+            if (index.id() == id) return &index;
+          return nullptr;
         }
 
-      /// Returns a pointer to the matched data, nullptr if none.
-      ValuePtr_t operator() (Key_t const& key) const
+      /// Returns the index of all products.
+      std::vector<ProductIndex> const& products() const { return fProducts; }
+
+      /// Returns the first position of `ptr`, or `NoPosition` if not present.
+      template <typename Ptr>
+      std::size_t first(Ptr const& ptr) const
         {
-          auto const e = index.cend();
-          auto const it = std::lower_bound(index.cbegin(), e, key, comparer());
-          return ((it == e) || (key < it->first))? nullptr: it->second;
+          ProductIndex const* index = product(ptr.id());
+          return index? index->first(ptr.key()): NoPosition;
         }
 
+      /// Returns the next position of the pointer at `pos`, or `NoPosition`.
+      std::size_t next(std::size_t pos) const { return fNext[pos]; }
 
-        private:
-      using IndexElement_t = std::pair<Key_t, Value_t*>;
-
-      std::vector<IndexElement_t> index; ///< The index.
-
-      template <typename BeginIter, typename EndIter, typename KeyExtractor>
-      void init(BeginIter begin, EndIter end, KeyExtractor&& getKey)
+      /// Calls `f(pos)` for each position `pos` of the pointer with `key`
+      /// in the product `index`.
+      template <typename F>
+      void forEachPosition
+        (ProductIndex const& index, std::size_t key, F&& f) const
         {
-          index.reserve(std::distance(begin, end)); // hope it's fast
-          for (auto it = begin; it != end; ++it)
-            index.emplace_back(getKey(*it), &*it);
-          std::sort(index.begin(), index.end(), comparer());
+          for (std::size_t pos = index.first(key); pos != NoPosition;
+            pos = next(pos)
+          )
+            f(pos);
         }
 
-      struct KeyComparer {
-        bool operator() (Key_t const& a, Key_t const& b) const
-          { return a < b; }
-        bool operator() (IndexElement_t  const& a, Key_t const& b) const
-          { return a.first < b; }
-        bool operator() (Key_t const& a, IndexElement_t const& b) const
-          { return a < b.first; }
-        bool operator() (IndexElement_t const& a, IndexElement_t const& b) const
-          { return a.first < b.first; }
-      }; // struct KeyComparer
 
-      static auto comparer() { return KeyComparer(); }
+        private:
+      std::vector<ProductIndex> fProducts; ///< Index of each product.
+      std::vector<std::size_t> fNext; ///< Next position with the same pointer.
 
-    }; // class DataIndex
+      /// Returns the index of the product with the specified ID, created anew
+      /// if not present yet.
+      ProductIndex& productOrNew(art::ProductID const& id)
+        {
+          for (ProductIndex& index: fProducts)
+            if (index.id() == id) return index;
+          fProducts.emplace_back();
+          fProducts.back().fID = id;
+          return fProducts.back();
+        }
 
+    }; // class PtrPositionIndex
 
-    /// Returns a new index for data using the keys extracted by getKey.
-    template <typename Coll, typename KeyExtractor>
-    auto makeIndex(Coll& data, KeyExtractor&& getKey)
-      {
-        using Value_t = typename Coll::value_type;
-        using Key_t = std::decay_t<decltype(getKey(std::declval<Value_t>()))>;
-        return
-          DataIndex<Key_t, Value_t>(data, std::forward<KeyExtractor>(getKey));
-      }
 
-    /// Returns a new index for data in range using the data itself as key.
-    template <typename BeginIter, typename EndIter>
-    auto makeSimpleIndex(BeginIter begin, EndIter end)
-      {
-        using Value_t = std::decay_t<decltype(*begin)>;
-        return SimpleDataIndex<Value_t>(begin, end);
-      }
+    template <typename BeginIter, typename EndIter, typename GetPtr>
+    PtrPositionIndex::PtrPositionIndex
+      (BeginIter begin, EndIter end, GetPtr getPtr)
+    {
+      //
+      // first pass: collect products and their key range
+      //
+      std::size_t n = 0;
+      ProductIndex* lastIndex = nullptr;
+      for (auto it = begin; it != end; ++it, ++n) {
+        auto const& ptr = getPtr(*it);
+        if (!lastIndex || (lastIndex->fID != ptr.id()))
+          lastIndex = &productOrNew(ptr.id());
+        ++(lastIndex->fCount);
+        std::size_t const key = ptr.key();
+        if (key >= lastIndex->fKeyEnd) lastIndex->fKeyEnd = key + 1U;
+      } // for
+
+      std::vector<std::vector<std::size_t>> last; // last position, by key
+      std::vector<std::unordered_map<std::size_t, std::size_t>> sparseLast;
+      last.resize(fProducts.size());
+      sparseLast.resize(fProducts.size());
+      for (std::size_t iProd = 0; iProd < fProducts.size(); ++iProd) {
+        ProductIndex& index = fProducts[iProd];
+        index.fDense = (index.fKeyEnd <= MaxDenseSparseness * index.fCount);
+        if (index.fDense) {
+          index.fDenseFirst.resize(index.fKeyEnd, NoPosition);
+          last[iProd].resize(index.fKeyEnd, NoPosition);
+        }
+        else {
+          index.fSparseFirst.reserve(index.fCount);
+          sparseLast[iProd].reserve(index.fCount);
+        }
+      } // for products
+
+      //
+      // second pass: fill, chaining the positions of repeated pointers
+      //
+      fNext.resize(n, NoPosition);
+      std::size_t pos = 0;
+      std::size_t iProd = 0;
+      for (auto it = begin; it != end; ++it, ++pos) {
+        auto const& ptr = getPtr(*it);
+        if (fProducts[iProd].fID != ptr.id()) {
+          iProd = 0;
+          while (fProducts[iProd].fID != ptr.id()) ++iProd;
+        }
+        ProductIndex& index = fProducts[iProd];
+        std::size_t const key = ptr.key();
+        if (index.fDense) {
+          std::size_t& lastPos = last[iProd][key];
+          if (lastPos == NoPosition) index.fDenseFirst[key] = pos;
+          else fNext[lastPos] = pos;
+          lastPos = pos;
+        }
+        else {
+          auto const [ itLast, isNew ]
+            = sparseLast[iProd].emplace(key, pos);
+          if (isNew) index.fSparseFirst.emplace(key, pos);
+          else {
+            fNext[itLast->second] = pos;
+            itLast->second = pos;
+          }
+        }
+      } // for
 
-    /// Returns a new index for data using the data itself as key.
-    template <typename Coll>
-    auto makeSimpleIndex(Coll& data)
-      {
-        using Value_t = typename Coll::value_type;
-        return SimpleDataIndex<Value_t>(data);
-      }
+    } // PtrPositionIndex::PtrPositionIndex()
 
 
     //--------------------------------------------------------------------------
@@ -284,94 +337,6 @@ namespace lar {
 
     namespace AssociationFinderBase {
 
-      /// Information on a single source: its index in the source list, and
-      /// "key" (it can be any sortable object).
-      template <typename Key = std::size_t>
-      struct SourceIDinfo_t: public std::tuple<Key, std::size_t> {
-        using Base_t = std::tuple<Key, std::size_t>;
-        using Key_t = Key;
-
-        /// Returns the key of the art pointer to this source element.
-        Key_t const& key() const { return std::get<0>(*this); }
-        /// Returns the index of this source element within the source list.
-        std::size_t position() const { return std::get<1>(*this); }
-
-        using Base_t::Base_t; // inherit constructor
-
-        /// Comparison functor: compares art pointer keys.
-        struct Comparer_t {
-          bool operator()
-            (SourceIDinfo_t const& a, SourceIDinfo_t const& b) const
-            { return a.key() < b.key(); }
-          bool operator() (SourceIDinfo_t const& a, Key_t const& b) const
-            { return a.key() < b; }
-          bool operator() (Key_t const& a, SourceIDinfo_t const& b) const
-            { return a < b.key(); }
-        }; // struct SourceIDinfo_t::Comparer_t
-
-        static Comparer_t comparer() { return {}; }
-      }; // struct SourceIDinfo_t
-
-      template <typename Key = std::size_t>
-      struct SourceVector_t: private std::vector<SourceIDinfo_t<Key>> {
-        using Base_t = std::vector<SourceIDinfo_t<Key>>;
-        using Info_t = typename Base_t::value_type;
-        using Key_t = typename Info_t::Key_t;
-
-        using const_iterator = typename Base_t::const_iterator;
-
-        using Base_t::begin;
-        using Base_t::end;
-        using Base_t::size;
-        using Base_t::empty;
-        using Base_t::reserve;
-
-        struct MatchConstIterator_t: public std::pair<const_iterator, bool> {
-          using Base_t = std::pair<const_iterator, bool>;
-          using Base_t::Base_t; // inherit all constructors
-          auto const& operator->() const { return std::get<0>(*this); }
-          operator bool() const { return std::get<1>(*this); }
-          bool operator!() const { return !this->operator bool(); }
-        }; // struct MatchConstIterator_t
-
-        /// Default constructor: starts empty.
-        SourceVector_t() = default;
-
-        /// Constructor: from the elements between the specified iterators.
-        template <typename BeginIter, typename EndIter>
-        SourceVector_t(BeginIter b, EndIter e) { assign(b, e); }
-
-        /// Sorts the vector according to keys.
-        void sort()
-          { std::sort(Base_t::begin(), Base_t::end(), Info_t::comparer()); }
-
-        /// Constructs a new element at the end of the vector.
-        void emplace_back(Key_t const& key, std::size_t pos)
-          { Base_t::emplace_back(key, pos); }
-
-        /// Returns iterator to element with key, if it exists.
-        /// Requires the vector to be sort()ed.
-        /// If key is not present it may return end() or the wrong element.
-        auto find(Key_t const& key) const
-          {
-            auto const e = end();
-            auto it = std::lower_bound(begin(), e, key, Info_t::comparer());
-            return MatchConstIterator_t(it, (it != e) && (it->key() == key));
-          }
-
-        /// Resets the content to map a container delimited by the iterators.
-        template <typename BeginIter, typename EndIter>
-        void assign(BeginIter b, EndIter e)
-          {
-            Base_t::clear();
-            std::size_t i = 0;
-            for (auto it = b; it != e; ++it, ++i) emplace_back(it->key(), i);
-            sort();
-          }
-
-      }; // struct SourceVector_t
-
-
       /// Returns a tuple of NTags elements, including all specified tags and
       /// then copies of the default one to make it N.
       template <unsigned int NTags, typename DefaultTag, typename... InputTags>
@@ -567,10 +532,19 @@ namespace lar {
           auto&& BC = other;
           ConnectionList<APtr_t, CPtr_t> AC(KeysFromOtherList, data);
 
-          // the match object returns the iterator to the list connected to the
-          // specified key; it does not own the data structure;
-          auto const match
-            = makeIndex(BC, [](auto const& elem){ return elem.key(); });
+          // Usually `other` was obtained from the list of `allConnected()`,
+          // and its elements are in the same order as our connected Bs:
+          // in that case, the Cs for a B are at the position of that B in the
+          // flattened list, and no lookup is needed. We verify that for each
+          // B, and if the order does not match we fall back to a lookup
+          // by pointer, created only on demand.
+          std::optional<PtrPositionIndex> match;
+          std::size_t iFlatB = 0; // position of the B in the flattened list
+
+          // Cs moved away from `BC` when matched in place: they are now the
+          // first `n` elements of the Cs of A number `iA`; sorted by `iConnBC`
+          struct MovedCs_t { std::size_t iConnBC, iA, n; };
+          std::vector<MovedCs_t> moved;
 
           for (std::size_t iA = 0; iA < AB.size(); iA++) {
             auto const& connAB = AB[iA]; // connections for this A
@@ -581,13 +555,43 @@ namespace lar {
             // for each B connected to this A:
             for (auto const& key: BsForA) {
 
-              auto iConnBC = match(key);
-              if (!iConnBC) continue; // no C's associated to the matching B
-
-              // matched! move or copy the while list of Cs
-              auto& CsForB = iConnBC->connectedTo(); // (this list)
-              if (CsForA.empty()) CsForA = std::move(CsForB); // move
-              else CsForA.insert(CsForA.end(), cbegin(CsForB), cend(CsForB));
+              std::size_t const iConnBC = iFlatB++;
+              if ((iConnBC < BC.size()) && (BC[iConnBC].key() == key)) {
+                // matched in place! this list is used only here: move it
+                auto& CsForB = BC[iConnBC].connectedTo(); // (this list)
+                if (CsForA.empty()) {
+                  moved.push_back({ iConnBC, iA, CsForB.size() });
+                  CsForA = std::move(CsForB); // move
+                }
+                else CsForA.insert(CsForA.end(), cbegin(CsForB), cend(CsForB));
+                continue;
+              }
+
+              if (!match) {
+                match.emplace(cbegin(BC), cend(BC),
+                  [](auto const& elem){ return elem.key(); });
+              }
+              std::size_t const iMatch = match->first(key);
+              if (iMatch == PtrPositionIndex::NoPosition)
+                continue; // no C's associated to the matching B
+
+              // matched! the list might be needed again: copy it;
+              // if it was moved away already, copy it from where it went
+              auto const itMoved = std::lower_bound(
+                moved.cbegin(), moved.cend(), iMatch,
+                [](MovedCs_t const& m, std::size_t i){ return m.iConnBC < i; }
+                );
+              if ((itMoved != moved.cend()) && (itMoved->iConnBC == iMatch)) {
+                auto const& movedTo = AC[itMoved->iA].connectedTo();
+                // copy first, since `movedTo` may be `CsForA` itself
+                std::decay_t<decltype(CsForA)> const CsForB
+                  (movedTo.cbegin(), movedTo.cbegin() + itMoved->n);
+                CsForA.insert(CsForA.end(), cbegin(CsForB), cend(CsForB));
+              }
+              else {
+                auto const& CsForB = BC[iMatch].connectedTo(); // (this list)
+                CsForA.insert(CsForA.end(), cbegin(CsForB), cend(CsForB));
+              }
 
             } // for connected Bs
           } // for iA
@@ -702,11 +706,11 @@ namespace lar {
         Result_t<Source_t> result(nSources);
 
         // These are the source "pointers" we still have to find; they are all
-        // on the same product ID. We keep track of the original position too
-        // (unordered map may or may not be better...);
-        // given that these are all from the same product ID, the product ID is
-        // not saved. SourceVector_t provides log(N) lookup.
-        SourceVector_t<std::size_t> sourceInfos(sbegin, send);
+        // on the same product ID. PtrPositionIndex provides constant time
+        // lookup of their original position.
+        PtrPositionIndex const sourceInfos(sbegin, send);
+        auto const* sourcesWithinID = sourceInfos.product(sourceID);
+        if (!sourcesWithinID) return result;
 
         // get the association, following the content of the assns data product
         for (decltype(auto) assn: assns) {
@@ -717,12 +721,12 @@ namespace lar {
           // same module produced source and its association is wrong)
           if (sourcePtr.id() != sourceID) continue;
 
-          // is this pointer interesting?
-          auto iSrcInfo = sourceInfos.find(sourcePtr.key());
-          if (!iSrcInfo) continue; // it's not it
-
-          // match! push target pointer into the result of the matched source
-          result[iSrcInfo->position()].connectedTo().push_back(assn.second);
+          // is this pointer interesting? if so, push target pointer into the
+          // result of the matched source (all of them, if repeated)
+          sourceInfos.forEachPosition(*sourcesWithinID, sourcePtr.key(),
+            [&result, &assn](std::size_t pos)
+              { result[pos].connectedTo().push_back(assn.second); }
+            );
 
         } // for
 
@@ -740,11 +744,13 @@ namespace lar {
         /*
          * The strategy of this implementation is:
          *
-         * 1. collect all source art pointers, sorted by key for faster lookup
+         * 1. index all source art pointers for constant time lookup
+         *    (see `PtrPositionIndex`)
          * 2. parse all the associated pairs
          *     1. if the source pointer of a pair is in the list of
          *        interesting source pointers, push the target pointer of the
-         *        pair into the results for this source
+         *        pair into the results for this source (for all the copies
+         *        of the source pointer in the list)
          *
          */
 
@@ -761,22 +767,30 @@ namespace lar {
       //  std::size_t const nSources = result.size();
 
         // use this index for fast lookup of the sources
-        auto match = makeSimpleIndex(sbegin, send);
+        PtrPositionIndex const match(sbegin, send);
 
         // fetch the association data product
         auto const& assns
           = *(event.template getValidHandle<Assns_t<Source_t>>(tag));
 
-        // get the association, following the content of the assns data product
+        // get the association, following the content of the assns data product;
+        // associations are usually grouped by product ID, so we cache the
+        // index of the last product
+        PtrPositionIndex::ProductIndex const* sourcesWithinID = nullptr;
         for (decltype(auto) assn: assns) {
           SourcePtr_t const& sourcePtr = assn.first;
 
-          // is this pointer interesting?
-          auto iPos = match(sourcePtr);
-          if (!iPos) continue; // it's not it
+          if (!sourcesWithinID || (sourcesWithinID->id() != sourcePtr.id())) {
+            sourcesWithinID = match.product(sourcePtr.id());
+            if (!sourcesWithinID) continue; // no source from this product
+          }
 
-          // match! push target pointer into the result of the matched source
-          result[*iPos].connectedTo().push_back(assn.second);
+          // is this pointer interesting? if so, push target pointer into the
+          // result of the matched source (all of them, if repeated)
+          match.forEachPosition(*sourcesWithinID, sourcePtr.key(),
+            [&result, &assn](std::size_t pos)
+              { result[pos].connectedTo().push_back(assn.second); }
+            );
 
         } // for
 
@@ -793,8 +807,8 @@ namespace lar {
         /*
          * The strategy of this implementation is:
          *
-         * 1. collect all the source art pointers, grouped by product ID
-         *    (and sorted by key for faster lookup)
+         * 1. index all the source art pointers, grouped by product ID
+         *    (see `PtrPositionIndex`)
          * 2. for each interesting product ID:
          *    1. fetch the association collection; this is assumed to have been
          *       created with the same input tag as the source product
@@ -803,10 +817,9 @@ namespace lar {
          *          interesting source pointers, push the target pointer of the
          *          pair into the results for this source
          *
-         * The maximum complexity of this algorithm is N log(M), where M is no
-         * larger than the maximum number of source pointers with a single
-         * product ID and N is the number of associations in each association
-         * data product.
+         * The complexity of this algorithm is linear with N + M, where M is the
+         * number of source pointers and N is the number of associations in
+         * each association data product.
          *
          */
 
@@ -822,24 +835,15 @@ namespace lar {
         Result_t<Source_t> result(KeysFrom, sbegin, send);
 
         // These are the source pointers we still have to find,
-        // organised by product ID; we keep track of the original position too
-        // (unordered map may or may not be better...);
-        // given that these are all from the same product ID, the product ID is
-        // not saved.
-        // Also, for fast lookup the lists are sorted by pointer key.
-        std::map<art::ProductID, SourceVector_t<std::size_t>>
-          sourcesLeft;
-        std::size_t iSource = 0;
-        for (auto it = sbegin; it != send; ++it, ++iSource)
-          sourcesLeft[it->id()].emplace_back(it->key(), iSource);
-        for (auto& sourcesWithinID: sourcesLeft)
-          sourcesWithinID.second.sort();
+        // organised by product ID; we keep track of the original position too.
+        // The index of each product is either a table indexed by key or,
+        // for sparse keys, a hash table.
+        PtrPositionIndex const sourcesLeft(sbegin, send);
 
         // look for all sources in each product ID
-        for (auto const& sourcesWithinID: sourcesLeft) {
+        for (auto const& sourcesWithinID: sourcesLeft.products()) {
 
-          art::ProductID sourceID = sourcesWithinID.first;
-          auto const& sourceInfos = sourcesWithinID.second;
+          art::ProductID sourceID = sourcesWithinID.id();
 
           // need to get the association between source and target,
           // as produced by the same producer that produced the source itself
@@ -859,12 +863,12 @@ namespace lar {
             // same module produced source and its association is wrong)
             if (sourcePtr.id() != sourceID) continue;
 
-            // is this pointer interesting?
-            auto iSrcInfo = sourceInfos.find(sourcePtr.key());
-            if (!iSrcInfo) continue; // it's not it
-
-            // match! push target pointer into the result of the matched source
-            result[iSrcInfo->position()].connectedTo().push_back(assn.second);
+            // is this pointer interesting? if so, push target pointer into the
+            // result of the matched source (all of them, if repeated)
+            sourcesLeft.forEachPosition(sourcesWithinID, sourcePtr.key(),
+              [&result, &assn](std::size_t pos)
+                { result[pos].connectedTo().push_back(assn.second); }
+              );
 
           } // for
 
@@ -19,7 +19,9 @@
 
 #include "TLorentzVector.h"
 
+#include <algorithm>
 #include <cmath>
+#include <set>
 
 namespace util {
 
@@ -40,6 +42,55 @@ namespace util {
     fWiretoCm = fWirePitch;
     fTimetoCm = fTimeTick * fDriftVelocity;
     fWireTimetoCmCm = fTimetoCm / fWirePitch;
+
+    fTriggerOffset = trigger_offset(fClocks);
+
+    // cache the plane quantities used by projections, angles and pitches
+    fAngleStart.SetXYZ(fGeom.DetHalfWidth(), 0., fGeom.DetLength() / 2.);
+    fPlaneInfo.resize(fNPlanes);
+    for (UInt_t ip = 0; ip < fNPlanes; ip++) {
+      PlaneInfo_t& info = fPlaneInfo[ip];
+      geo::PlaneGeo const& plane = fGeom.Plane(ip);
+
+      info.vertSin = std::sin(vertangle[ip]);
+      info.vertCos = std::cos(vertangle[ip]);
+
+      geo::View_t const view = plane.View();
+      info.hasPitch = (view != geo::kUnknown && view != geo::k3D);
+      info.wirePitch = fGeom.WirePitch(ip);
+      if (info.hasPitch) {
+        double const alpha = 0.5 * TMath::Pi() - fGeom.WireAngleToVertical(view);
+        info.pitchSin = std::sin(alpha);
+        info.pitchCos = std::cos(alpha);
+        info.angleOffsetW = fGeom.DetHalfHeight() * std::sin(std::abs(alpha));
+        info.angleStartW = AngleWire(info, fAngleStart[1], fAngleStart[2]);
+      }
+
+      const double origin[3] = {0.};
+      Double_t pos[3];
+      plane.LocalToWorld(origin, pos);
+      info.originX = pos[0];
+      info.originTicks = (info.originX / fDriftVelocity) * (1. / fTimeTick);
+    }
+  }
+
+  //-----------------------------------------------------------------------------
+  GeometryUtilities::PlaneInfo_t const&
+  GeometryUtilities::GetPlaneInfo(unsigned int plane) const
+  {
+    if (plane >= fPlaneInfo.size())
+      throw UtilException(Form("Invalid plane %u (only %u planes)", plane, fNPlanes));
+    return fPlaneInfo[plane];
+  }
+
+  GeometryUtilities::PlaneInfo_t const&
+  GeometryUtilities::GetPitchPlaneInfo(unsigned int plane) const
+  {
+    PlaneInfo_t const& info = GetPlaneInfo(plane);
+    if (!info.hasPitch)
+      throw UtilException(
+        Form("No wire angle foreseen for view %d of plane %u", fGeom.Plane(plane).View(), plane));
+    return info;
   }
 
   //-----------------------------------------------------------------------------
@@ -66,9 +117,9 @@ namespace util {
     // If both are non-zero, collection is the one with the negative angle.
     UInt_t Cplane = 0, Iplane = 1;
 
-    // angleC and angleI are the respective angles to vertical in C/I
-    // planes and slopeC, slopeI are the tangents of the track.
-    Double_t angleC, angleI, slopeC, slopeI, omegaC, omegaI;
+    // slopeC, slopeI are the tangents of the track in C/I planes;
+    // the sines and cosines of their angles to vertical are cached.
+    Double_t slopeC, slopeI, omegaC, omegaI;
     omegaC = kINVALID_DOUBLE;
     omegaI = kINVALID_DOUBLE;
 
@@ -125,8 +176,6 @@ namespace util {
 
     slopeC = tan(omegaC);
     slopeI = tan(omegaI);
-    angleC = vertangle[Cplane];
-    angleI = vertangle[Iplane];
 
     // 0 -1 factor depending on if one of the planes is vertical.
     bool nfact = !(vertangle[Cplane]);
@@ -138,10 +187,13 @@ namespace util {
       ln = -1;
 
     // calculate x and z using y ( ln )
-    mn = (ln / (2 * sin(angleI))) * ((cos(angleI) / (slopeC * cos(angleC))) - (1 / slopeI) +
-                                     nfact * (cos(angleI) / (cos(angleC) * slopeC) - 1 / slopeI));
+    Double_t const sinI = fPlaneInfo[Iplane].vertSin;
+    Double_t const cosI = fPlaneInfo[Iplane].vertCos;
+    Double_t const cosC = fPlaneInfo[Cplane].vertCos;
+    mn = (ln / (2 * sinI)) * ((cosI / (slopeC * cosC)) - (1 / slopeI) +
+                              nfact * (cosI / (cosC * slopeC) - 1 / slopeI));
 
-    nn = (ln / (2 * cos(angleC))) *
+    nn = (ln / (2 * cosC)) *
          ((1 / slopeC) + (1 / slopeI) + nfact * ((1 / slopeC) - (1 / slopeI)));
 
     // Direction angles
@@ -208,9 +260,11 @@ namespace util {
       sdw = dw0;
     }
 
-    Double_t top = (std::cos(vertangle[splane]) - std::cos(vertangle[lplane]) * sdw / ldw);
-    Double_t bottom = tan(vertangle[lplane] * std::cos(vertangle[splane]));
-    bottom -= tan(vertangle[splane] * std::cos(vertangle[lplane])) * sdw / ldw;
+    Double_t const scos = fPlaneInfo[splane].vertCos;
+    Double_t const lcos = fPlaneInfo[lplane].vertCos;
+    Double_t top = (scos - lcos * sdw / ldw);
+    Double_t bottom = tan(vertangle[lplane] * scos);
+    bottom -= tan(vertangle[splane] * lcos) * sdw / ldw;
 
     Double_t tantheta = top / bottom;
 
@@ -227,7 +281,8 @@ namespace util {
 
     Double_t pitch = -1.;
 
-    if (fGeom.Plane(iplane).View() == geo::kUnknown || fGeom.Plane(iplane).View() == geo::k3D) {
+    PlaneInfo_t const& info = GetPlaneInfo(iplane);
+    if (!info.hasPitch) {
       mf::LogError(Form("Warning :  no Pitch foreseen for view %d", fGeom.Plane(iplane).View()));
       return pitch;
     }
@@ -237,19 +292,11 @@ namespace util {
       Double_t fTheta = pi / 2 - theta;
       Double_t fPhi = -(phi + pi / 2);
 
-      for (UInt_t i = 0; i < fGeom.Nplanes(); ++i) {
-        if (i == iplane) {
-          Double_t wirePitch = fGeom.WirePitch(i);
-          Double_t angleToVert =
-            0.5 * TMath::Pi() - fGeom.WireAngleToVertical(fGeom.Plane(i).View());
-          Double_t cosgamma =
-            TMath::Abs(TMath::Sin(angleToVert) * TMath::Cos(fTheta) +
-                       TMath::Cos(angleToVert) * TMath::Sin(fTheta) * TMath::Sin(fPhi));
+      Double_t cosgamma = TMath::Abs(info.pitchSin * TMath::Cos(fTheta) +
+                                     info.pitchCos * TMath::Sin(fTheta) * TMath::Sin(fPhi));
 
-          if (cosgamma > 0) pitch = wirePitch / cosgamma;
-        } // end if the correct view
-      }   // end loop over planes
-    }     // end if a reasonable view
+      if (cosgamma > 0) pitch = info.wirePitch / cosgamma;
+    } // end if a reasonable view
 
     return pitch;
   }
@@ -264,7 +311,8 @@ namespace util {
 
     Double_t pitch = -1.;
 
-    if (fGeom.Plane(iplane).View() == geo::kUnknown || fGeom.Plane(iplane).View() == geo::k3D) {
+    PlaneInfo_t const& info = GetPlaneInfo(iplane);
+    if (!info.hasPitch) {
       mf::LogError(Form("Warning :  no Pitch foreseen for view %d", fGeom.Plane(iplane).View()));
       return pitch;
     }
@@ -273,19 +321,11 @@ namespace util {
       Double_t fTheta = theta;
       Double_t fPhi = phi;
 
-      for (UInt_t i = 0; i < fGeom.Nplanes(); ++i) {
-        if (i == iplane) {
-          Double_t wirePitch = fGeom.WirePitch(i);
-          Double_t angleToVert =
-            0.5 * TMath::Pi() - fGeom.WireAngleToVertical(fGeom.Plane(i).View());
-          Double_t cosgamma =
-            TMath::Abs(TMath::Sin(angleToVert) * TMath::Cos(fTheta) +
-                       TMath::Cos(angleToVert) * TMath::Sin(fTheta) * TMath::Sin(fPhi));
+      Double_t cosgamma = TMath::Abs(info.pitchSin * TMath::Cos(fTheta) +
+                                     info.pitchCos * TMath::Sin(fTheta) * TMath::Sin(fPhi));
 
-          if (cosgamma > 0) pitch = wirePitch / cosgamma;
-        } // end if the correct view
-      }   // end loop over planes
-    }     // end if a reasonable view
+      if (cosgamma > 0) pitch = info.wirePitch / cosgamma;
+    } // end if a reasonable view
 
     return pitch;
   }
@@ -400,30 +440,42 @@ namespace util {
   double
   GeometryUtilities::Get2DangleFrom3D(unsigned int plane, TVector3 dir_vector) const
   {
-    double alpha = 0.5 * TMath::Pi() - fGeom.WireAngleToVertical(fGeom.Plane(plane).View());
+    PlaneInfo_t const& info = GetPitchPlaneInfo(plane);
     // create dummy  xyz point in middle of detector and another one in unit
     // length. calculate correspoding points in wire-time space and use the
     // differnces between those to return 2D a angle
+    // (the start point, fAngleStart, is projected once at construction)
 
-    TVector3 start(fGeom.DetHalfWidth(), 0., fGeom.DetLength() / 2.);
-    TVector3 end = start + dir_vector;
+    TVector3 end = fAngleStart + dir_vector;
 
     // the wire coordinate is already in cm. The time needs to be converted.
-    util::PxPoint startp(
-      plane,
-      (fGeom.DetHalfHeight() * sin(fabs(alpha)) + start[2] * cos(alpha) - start[1] * sin(alpha)),
-      start[0]);
+    util::PxPoint startp(plane, info.angleStartW, fAngleStart[0]);
 
-    util::PxPoint endp(
-      plane,
-      (fGeom.DetHalfHeight() * sin(fabs(alpha)) + end[2] * cos(alpha) - end[1] * sin(alpha)),
-      end[0]);
+    util::PxPoint endp(plane, AngleWire(info, end[1], end[2]), end[0]);
 
     double angle = Get2Dangle(&endp, &startp);
 
     return angle;
   }
 
+  void
+  GeometryUtilities::Get2DanglesFrom3D(std::size_t n,
+                                       TVector3 const* dir_vectors,
+                                       double* angles) const
+  {
+    for (UInt_t plane = 0; plane < fNPlanes; ++plane) {
+      PlaneInfo_t const& info = GetPitchPlaneInfo(plane);
+      double* planeAngles = angles + plane * n;
+      for (std::size_t i = 0; i < n; ++i) {
+        TVector3 const& dir = dir_vectors[i];
+        double const dwire =
+          AngleWire(info, fAngleStart[1] + dir[1], fAngleStart[2] + dir[2]) - info.angleStartW;
+        double const dtime = (fAngleStart[0] + dir[0]) - fAngleStart[0];
+        planeAngles[i] = Get2Dangle(dwire, dtime);
+      }
+    }
+  }
+
   //////////////////////////////////////
   // Calculate 2D distance
   // in "cm" "cm" coordinates
@@ -612,10 +664,8 @@ namespace util {
     // the shower.
     UInt_t chan1 = fGeom.PlaneWireToChannel(p0->plane, p0->w);
     UInt_t chan2 = fGeom.PlaneWireToChannel(p1->plane, p1->w);
-    const double origin[3] = {0.};
     Double_t pos[3] = {0.};
-    fGeom.Plane(p0->plane).LocalToWorld(origin, pos);
-    Double_t x = (p0->t - trigger_offset(fClocks)) * fTimetoCm + pos[0];
+    Double_t x = (p0->t - fTriggerOffset) * fTimetoCm + GetPlaneInfo(p0->plane).originX;
 
     Double_t y, z;
     if (!fGeom.ChannelsIntersect(chan1, chan2, y, z)) return -1;
@@ -694,10 +744,7 @@ namespace util {
   Int_t
   GeometryUtilities::GetXYZ(const PxPoint* p0, const PxPoint* p1, Double_t* xyz) const
   {
-    const double origin[3] = {0.};
-    Double_t pos[3] = {0.};
-    fGeom.Plane(p0->plane).LocalToWorld(origin, pos);
-    Double_t x = (p0->t) - trigger_offset(fClocks) * fTimetoCm + pos[0];
+    Double_t x = (p0->t) - fTriggerOffset * fTimetoCm + GetPlaneInfo(p0->plane).originX;
     double yz[2];
 
     GetYZ(p0, p1, yz);
@@ -716,24 +763,45 @@ namespace util {
   {
 
     PxPoint pN(0, 0, 0);
-    const double origin[3] = {0.};
-    Double_t pos[3];
-    fGeom.Plane(plane).LocalToWorld(origin, pos);
+    PlaneInfo_t const& info = GetPlaneInfo(plane);
+    Double_t pos[3]{info.originX, xyz[1], xyz[2]};
     Double_t drifttick = (xyz[0] / fDriftVelocity) * (1. / fTimeTick);
 
-    pos[1] = xyz[1];
-    pos[2] = xyz[2];
-
     ///\todo: this should use the cryostat and tpc as well in the NearestWire
     /// method
 
     pN.w = fGeom.NearestWire(pos, plane);
-    pN.t = drifttick - (pos[0] / fDriftVelocity) * (1. / fTimeTick) + trigger_offset(fClocks);
+    pN.t = drifttick - info.originTicks + fTriggerOffset;
     pN.plane = plane;
 
     return pN;
   }
 
+  void
+  GeometryUtilities::Get2DPointProjections(std::size_t n,
+                                           double const* xyz,
+                                           util::PxPoint* points) const
+  {
+    for (UInt_t plane = 0; plane < fNPlanes; ++plane) {
+      PlaneInfo_t const& info = GetPlaneInfo(plane);
+      util::PxPoint* planePoints = points + plane * n;
+
+      // the wire is still a geometry query for each point...
+      for (std::size_t i = 0; i < n; ++i) {
+        double const* point = xyz + 3 * i;
+        Double_t pos[3]{info.originX, point[1], point[2]};
+        planePoints[i].plane = plane;
+        planePoints[i].w = fGeom.NearestWire(pos, plane);
+      }
+
+      // ... while the time is a plain linear loop
+      for (std::size_t i = 0; i < n; ++i) {
+        Double_t const drifttick = (xyz[3 * i] / fDriftVelocity) * (1. / fTimeTick);
+        planePoints[i].t = drifttick - info.originTicks + fTriggerOffset;
+      }
+    }
+  }
+
   //////////////////////////////////////////////////////////////
   // for now this returns the vlause in CM/CM space.
   // this will become the default, but don't want to break the code that depends
@@ -788,12 +856,9 @@ namespace util {
   GeometryUtilities::GetTimeTicks(Double_t x, Int_t plane) const
   {
 
-    const double origin[3] = {0.};
-    Double_t pos[3];
-    fGeom.Plane(plane).LocalToWorld(origin, pos);
     Double_t drifttick = (x / fDriftVelocity) * (1. / fTimeTick);
 
-    return drifttick - (pos[0] / fDriftVelocity) * (1. / fTimeTick) + trigger_offset(fClocks);
+    return drifttick - GetPlaneInfo(plane).originTicks + fTriggerOffset;
   }
 
   //----------------------------------------------------------------------
@@ -805,19 +870,9 @@ namespace util {
     Double_t dirs[3] = {0.};
     GetDirectionCosines(phi, theta, dirs);
 
-    /// \todo switch to using new Geometry::WireAngleToVertical(geo::View_t)
-    /// \todo and Geometry::WirePitch(geo::View_t) methods
-    Double_t wirePitch = 0.;
-    Double_t angleToVert = 0.;
-
-    wirePitch = fGeom.WirePitch(plane);
-    angleToVert = fGeom.WireAngleToVertical(fGeom.Plane(plane).View()) - 0.5 * TMath::Pi();
+    PlaneInfo_t const& info = GetPitchPlaneInfo(plane);
 
-    //(sin(angleToVert),std::cos(angleToVert)) is the direction perpendicular to
-    // wire fDir.front() is the direction of the track at the beginning of its
-    // trajectory
-    Double_t cosgamma =
-      TMath::Abs(TMath::Sin(angleToVert) * dirs[1] + TMath::Cos(angleToVert) * dirs[2]);
+    Double_t cosgamma = PitchCosGamma(info, dirs);
 
     if (cosgamma < 1.e-5)
     // throw UtilException("cosgamma is basically 0, that can't be right");
@@ -826,7 +881,29 @@ namespace util {
       return 100;
     }
 
-    return wirePitch / cosgamma;
+    return info.wirePitch / cosgamma;
+  }
+
+  void
+  GeometryUtilities::PitchesInView(std::size_t n,
+                                   double const* phi,
+                                   double const* theta,
+                                   double* pitches) const
+  {
+    for (UInt_t plane = 0; plane < fNPlanes; ++plane)
+      GetPitchPlaneInfo(plane); // validation only
+
+    for (std::size_t i = 0; i < n; ++i) {
+      // the direction is the same for all planes
+      Double_t dirs[3] = {0.};
+      GetDirectionCosines(phi[i], theta[i], dirs);
+
+      for (UInt_t plane = 0; plane < fNPlanes; ++plane) {
+        PlaneInfo_t const& info = fPlaneInfo[plane];
+        Double_t const cosgamma = PitchCosGamma(info, dirs);
+        pitches[plane * n + i] = (cosgamma < 1.e-5) ? 100. : info.wirePitch / cosgamma;
+      }
+    }
   }
 
   //////////////////////////////////////////////////
@@ -867,14 +944,23 @@ namespace util {
                                         util::PxHit& averageHit) const
   {
 
-    hitlistlocal.clear();
     std::vector<unsigned int> hitlistlocal_index;
 
-    hitlistlocal_index.clear();
-
     SelectLocalHitlistIndex(
       hitlist, hitlistlocal_index, startHit, linearlimit, ortlimit, lineslopetest);
 
+    FillLocalHitlist(hitlist, hitlistlocal_index, hitlistlocal, startHit, averageHit);
+  }
+
+  void
+  GeometryUtilities::FillLocalHitlist(const std::vector<util::PxHit>& hitlist,
+                                      std::vector<unsigned int> const& hitlistlocal_index,
+                                      std::vector<const util::PxHit*>& hitlistlocal,
+                                      util::PxPoint const& startHit,
+                                      util::PxHit& averageHit) const
+  {
+    hitlistlocal.clear();
+
     double timesum = 0;
     double wiresum = 0;
     for (size_t i = 0; i < hitlistlocal_index.size(); ++i) {
@@ -904,50 +990,163 @@ namespace util {
     double locintercept = startHit.t - startHit.w * lineslopetest;
 
     for (size_t i = 0; i < hitlist.size(); ++i) {
+      if (IsLocalHit(hitlist[i], startHit, lineslopetest, locintercept, linearlimit, ortlimit)) {
+        hitlistlocal_index.push_back(i);
+      }
+    }
+  }
 
-      util::PxPoint hitonline;
+  bool
+  GeometryUtilities::IsLocalHit(const util::PxHit& hit,
+                                const util::PxPoint& startHit,
+                                double const slope,
+                                double const intercept,
+                                double const linearlimit,
+                                double const ortlimit) const
+  {
+    util::PxPoint hitonline;
 
-      GetPointOnLine(lineslopetest, locintercept, (const util::PxHit*)(&hitlist.at(i)), hitonline);
+    GetPointOnLine(slope, intercept, (const util::PxPoint*)(&hit), hitonline);
 
-      // calculate linear distance from start point and orthogonal distance from
-      // axis
-      Double_t lindist =
-        Get2DDistance((const util::PxPoint*)(&hitonline), (const util::PxPoint*)(&startHit));
-      Double_t ortdist =
-        Get2DDistance((const util::PxPoint*)(&hitlist.at(i)), (const util::PxPoint*)(&hitonline));
+    // calculate linear distance from start point and orthogonal distance from
+    // axis
+    Double_t lindist =
+      Get2DDistance((const util::PxPoint*)(&hitonline), (const util::PxPoint*)(&startHit));
+    Double_t ortdist = Get2DDistance((const util::PxPoint*)(&hit), (const util::PxPoint*)(&hitonline));
 
-      if (lindist < linearlimit && ortdist < ortlimit) { hitlistlocal_index.push_back(i); }
-    }
+    return lindist < linearlimit && ortdist < ortlimit;
   }
 
-  //////////////////////////////////////////////////////////////////
-  //////////////////////////////////////////////////////////////////
+  //////////////////////////////////////////////////////////////////////////////////
+  // Same selection as above, using the index of the hit list.
+  // A selected hit is closer than hypot(linearlimit, ortlimit) to startHit
+  // (the line goes through startHit and the two distances are orthogonal),
+  // so only the cells in that box are tested.
+  ///////////////////////////////////////////////////////////////////////////////////
 
   void
-  GeometryUtilities::SelectPolygonHitList(std::vector<util::PxHit> const& hitlist,
-                                          std::vector<util::PxHit const*>& hitlistlocal) const
+  GeometryUtilities::SelectLocalHitlist(const util::PxHitIndex& hitindex,
+                                        std::vector<const util::PxHit*>& hitlistlocal,
+                                        util::PxPoint& startHit,
+                                        Double_t& linearlimit,
+                                        Double_t& ortlimit,
+                                        Double_t& lineslopetest) const
   {
-    if (empty(hitlist)) { throw UtilException("Provided empty hit list!"); }
+    util::PxHit testHit;
+    SelectLocalHitlist(
+      hitindex, hitlistlocal, startHit, linearlimit, ortlimit, lineslopetest, testHit);
+  }
 
-    hitlistlocal.clear();
-    unsigned char plane = hitlist.front().plane;
+  void
+  GeometryUtilities::SelectLocalHitlist(const util::PxHitIndex& hitindex,
+                                        std::vector<const util::PxHit*>& hitlistlocal,
+                                        util::PxPoint& startHit,
+                                        Double_t& linearlimit,
+                                        Double_t& ortlimit,
+                                        Double_t& lineslopetest,
+                                        util::PxHit& averageHit) const
+  {
+    std::vector<unsigned int> hitlistlocal_index;
 
-    // Define subset of hits to define polygon
-    std::map<double, const util::PxHit*> hitmap;
+    SelectLocalHitlistIndex(
+      hitindex, hitlistlocal_index, startHit, linearlimit, ortlimit, lineslopetest);
+
+    FillLocalHitlist(hitindex.hits(), hitlistlocal_index, hitlistlocal, startHit, averageHit);
+  }
+
+  void
+  GeometryUtilities::SelectLocalHitlistIndex(const util::PxHitIndex& hitindex,
+                                             std::vector<unsigned int>& hitlistlocal_index,
+                                             util::PxPoint& startHit,
+                                             Double_t& linearlimit,
+                                             Double_t& ortlimit,
+                                             Double_t& lineslopetest) const
+  {
+    auto const& hitlist = hitindex.hits();
+
+    // a small margin protects from rounding in the distances
+    double const reach = std::hypot(linearlimit, ortlimit) * (1.0 + 1e-9);
+    if (!std::isfinite(reach)) {
+      SelectLocalHitlistIndex(
+        hitlist, hitlistlocal_index, startHit, linearlimit, ortlimit, lineslopetest);
+      return;
+    }
+
+    hitlistlocal_index.clear();
+    double locintercept = startHit.t - startHit.w * lineslopetest;
+
+    hitindex.forEachInBox(startHit.w - reach,
+                          startHit.w + reach,
+                          startHit.t - reach,
+                          startHit.t + reach,
+                          [&](unsigned int i) {
+                            if (IsLocalHit(hitlist[i],
+                                           startHit,
+                                           lineslopetest,
+                                           locintercept,
+                                           linearlimit,
+                                           ortlimit)) {
+                              hitlistlocal_index.push_back(i);
+                            }
+                          });
+
+    // same order as the scan of the whole list
+    std::sort(hitlistlocal_index.begin(), hitlistlocal_index.end());
+  }
+
+  //////////////////////////////////////////////////////////////////
+  // The hits with the highest charge, up to the requested fraction of
+  // the total; of hits with the same charge, only the first in the list
+  // is used (as with a std::map keyed by charge).
+  // The hits are extracted in order of decreasing charge from a heap, so
+  // that only the ones actually selected are sorted.
+  //////////////////////////////////////////////////////////////////
+  std::vector<const util::PxHit*>
+  GeometryUtilities::SelectHighChargeHits(std::vector<util::PxHit> const& hitlist,
+                                          double const fraction)
+  {
+    std::vector<const util::PxHit*> hitheap;
+    hitheap.reserve(hitlist.size());
     double qtotal = 0;
     for (auto const& h : hitlist) {
-      hitmap.try_emplace(h.charge, &h);
+      hitheap.push_back(&h);
       qtotal += h.charge;
     }
+    // on top: highest charge, and the first in the list among equal charges
+    auto const lowerCharge = [](const util::PxHit* a, const util::PxHit* b) {
+      return (a->charge < b->charge) || ((a->charge == b->charge) && (a > b));
+    };
+    std::make_heap(hitheap.begin(), hitheap.end(), lowerCharge);
+
     double qintegral = 0;
     std::vector<const util::PxHit*> ordered_hits;
     ordered_hits.reserve(hitlist.size());
-    for (auto hiter = hitmap.rbegin(); qintegral < qtotal * 0.95 && hiter != hitmap.rend();
-         ++hiter) {
+    for (auto heapend = hitheap.end(); qintegral < qtotal * fraction && heapend != hitheap.begin();) {
 
-      qintegral += (*hiter).first;
-      ordered_hits.push_back((*hiter).second);
+      std::pop_heap(hitheap.begin(), heapend, lowerCharge);
+      const util::PxHit* hit = *(--heapend);
+      if (!ordered_hits.empty() && (hit->charge == ordered_hits.back()->charge)) continue;
+
+      qintegral += hit->charge;
+      ordered_hits.push_back(hit);
     }
+    return ordered_hits;
+  }
+
+  //////////////////////////////////////////////////////////////////
+  //////////////////////////////////////////////////////////////////
+
+  void
+  GeometryUtilities::SelectPolygonHitList(std::vector<util::PxHit> const& hitlist,
+                                          std::vector<util::PxHit const*>& hitlistlocal) const
+  {
+    if (empty(hitlist)) { throw UtilException("Provided empty hit list!"); }
+
+    hitlistlocal.clear();
+    unsigned char plane = hitlist.front().plane;
+
+    // Define subset of hits to define polygon
+    std::vector<const util::PxHit*> const ordered_hits = SelectHighChargeHits(hitlist, 0.95);
 
     // Define container to hold found polygon corner PxHit index & distance
     std::vector<size_t> hit_index(8, 0);
@@ -1151,4 +1350,26 @@ namespace util {
     return ret_ind;
   }
 
+  util::PxHit
+  GeometryUtilities::FindClosestHit(util::PxHitIndex const& hitindex,
+                                    unsigned int const wirein,
+                                    double const timein) const
+  {
+    return hitindex.hits()[FindClosestHitIndex(hitindex, wirein, timein)];
+  }
+
+  //////////////////////////////////////////////////////////////////
+  // Same result as the scan of the whole list (including the choice
+  // of the first hit among the ones at the same distance).
+  //////////////////////////////////////////////////////////////////
+  unsigned int
+  GeometryUtilities::FindClosestHitIndex(util::PxHitIndex const& hitindex,
+                                         unsigned int const wirein,
+                                         double const timein) const
+  {
+    std::size_t const closest =
+      hitindex.closestHit(wirein, timein, fWiretoCm, fTimetoCm, 99999);
+    return (closest < hitindex.size()) ? closest : 0;
+  }
+
 } // namespace
@@ -13,7 +13,10 @@
 #include "TVector3.h"
 
 #include "PxUtils.h"
+#include "lardata/Utilities/PxHitIndex.h"
 
+#include <cmath>
+#include <cstddef>
 #include <limits>
 #include <vector>
 
@@ -64,6 +67,9 @@ namespace util {
 
     double Get2DangleFrom3D(unsigned int plane, TVector3 dir_vector) const;
 
+    // batch version of the above, see Get2DPointProjections() for the layout
+    void Get2DanglesFrom3D(std::size_t n, TVector3 const* dir_vectors, double* angles) const;
+
     Double_t Get2Dslope(Double_t deltawire, Double_t deltatime) const;
 
     Double_t Get2Dslope(Double_t wireend,
@@ -119,6 +125,12 @@ namespace util {
 
     PxPoint Get2DPointProjection(Double_t* xyz, Int_t plane) const;
 
+    // batch versions: the n inputs are projected on all the planes, and the
+    // result for input i on plane p is stored at index (p * n + i) of the output
+    // (which must have room for Nplanes() * n elements);
+    // the points are n consecutive (x, y, z) triplets
+    void Get2DPointProjections(std::size_t n, double const* xyz, util::PxPoint* points) const;
+
     PxPoint Get2DPointProjectionCM(std::vector<double> xyz, int plane) const;
 
     PxPoint Get2DPointProjectionCM(double* xyz, int plane) const;
@@ -137,12 +149,28 @@ namespace util {
                                      unsigned int wirein,
                                      double timein) const;
 
+    // same as above, searching only the cells of the index around the point
+    util::PxHit FindClosestHit(util::PxHitIndex const& hitindex,
+                               unsigned int wirein,
+                               double timein) const;
+
+    unsigned int FindClosestHitIndex(util::PxHitIndex const& hitindex,
+                                     unsigned int wirein,
+                                     double timein) const;
+
     Int_t GetYZ(const PxPoint* p0, const PxPoint* p1, Double_t* yz) const;
 
     Int_t GetXYZ(const PxPoint* p0, const PxPoint* p1, Double_t* xyz) const;
 
     Double_t PitchInView(UInt_t plane, Double_t phi, Double_t theta) const;
 
+    // batch version of the above (without printout), see
+    // Get2DPointProjections() for the layout
+    void PitchesInView(std::size_t n,
+                       double const* phi,
+                       double const* theta,
+                       double* pitches) const;
+
     void GetDirectionCosines(Double_t phi, Double_t theta, Double_t* dirs) const;
 
     // interface without average Hit
@@ -168,9 +196,40 @@ namespace util {
                                  Double_t& ortlimit,
                                  Double_t& lineslopetest) const;
 
+    // interfaces with a prebuilt index of the hit list: same results as the
+    // ones above, testing only the hits in the cells around startHit
+    void SelectLocalHitlist(const util::PxHitIndex& hitindex,
+                            std::vector<const util::PxHit*>& hitlistlocal,
+                            util::PxPoint& startHit,
+                            Double_t& linearlimit,
+                            Double_t& ortlimit,
+                            Double_t& lineslopetest) const;
+
+    void SelectLocalHitlist(const util::PxHitIndex& hitindex,
+                            std::vector<const util::PxHit*>& hitlistlocal,
+                            util::PxPoint& startHit,
+                            Double_t& linearlimit,
+                            Double_t& ortlimit,
+                            Double_t& lineslopetest,
+                            util::PxHit& averageHit) const;
+
+    void SelectLocalHitlistIndex(const util::PxHitIndex& hitindex,
+                                 std::vector<unsigned int>& hitlistlocal_index,
+                                 util::PxPoint& startHit,
+                                 Double_t& linearlimit,
+                                 Double_t& ortlimit,
+                                 Double_t& lineslopetest) const;
+
     void SelectPolygonHitList(const std::vector<util::PxHit>& hitlist,
                               std::vector<const util::PxHit*>& hitlistlocal) const;
 
+    // hits with the highest charge, in decreasing charge order, until their
+    // charge reaches the specified fraction of the total; only the first of
+    // the hits with the same charge is included (used by SelectPolygonHitList)
+    static std::vector<const util::PxHit*> SelectHighChargeHits(
+      const std::vector<util::PxHit>& hitlist,
+      double fraction);
+
     std::vector<size_t> PolyOverlap(std::vector<const util::PxHit*> ordered_hits,
                                     std::vector<size_t> candidate_polygon) const;
 
@@ -198,6 +257,57 @@ namespace util {
     }
 
   private:
+    // plane quantities computed once at construction
+    struct PlaneInfo_t {
+      double vertSin = 0.;       // sine of the wire angle wrt vertical
+      double vertCos = 1.;       // cosine of the wire angle wrt vertical
+      bool hasPitch = false;     // whether the view has wire pitch and angle
+      double wirePitch = 0.;     // wire pitch [cm]
+      double pitchSin = 0.;      // sine of (pi/2 - wire angle to vertical)
+      double pitchCos = 1.;      // cosine of (pi/2 - wire angle to vertical)
+      double angleOffsetW = 0.;  // DetHalfHeight * sin(|pi/2 - wire angle to vertical|)
+      double angleStartW = 0.;   // wire coordinate of the Get2DangleFrom3D() start
+      double originX = 0.;       // x of the plane center [cm]
+      double originTicks = 0.;   // drift time of originX [ticks]
+    };
+
+    // returns the information of the plane, throws UtilException if invalid
+    PlaneInfo_t const& GetPlaneInfo(unsigned int plane) const;
+
+    // as above, also throws if the plane view has no wire angle
+    PlaneInfo_t const& GetPitchPlaneInfo(unsigned int plane) const;
+
+    // wire coordinate of a point in the Get2DangleFrom3D() convention
+    static double
+    AngleWire(PlaneInfo_t const& info, double y, double z)
+    {
+      return info.angleOffsetW + z * info.pitchCos - y * info.pitchSin;
+    }
+
+    // cosine of the angle between a direction and the normal to the wires;
+    // (sin(angleToVert), cos(angleToVert)) is the direction perpendicular to the
+    // wires, with angleToVert = wire angle to vertical - pi/2
+    static double
+    PitchCosGamma(PlaneInfo_t const& info, double const* dirs)
+    {
+      return std::abs(-info.pitchSin * dirs[1] + info.pitchCos * dirs[2]);
+    }
+
+    // whether hit is within the limits along and across the line from startHit
+    bool IsLocalHit(const util::PxHit& hit,
+                    const util::PxPoint& startHit,
+                    double slope,
+                    double intercept,
+                    double linearlimit,
+                    double ortlimit) const;
+
+    // fills the local hit list and its average from the selected hit indices
+    void FillLocalHitlist(const std::vector<util::PxHit>& hitlist,
+                          std::vector<unsigned int> const& hitlistlocal_index,
+                          std::vector<const util::PxHit*>& hitlistlocal,
+                          util::PxPoint const& startHit,
+                          util::PxHit& averageHit) const;
+
     geo::GeometryCore const& fGeom;
     detinfo::DetectorClocksData const& fClocks;
     detinfo::DetectorPropertiesData const& fDetProp;
@@ -207,6 +317,9 @@ namespace util {
     Double_t fTimeTick;
     Double_t fDriftVelocity;
     UInt_t fNPlanes;
+    std::vector<PlaneInfo_t> fPlaneInfo;
+    TVector3 fAngleStart; // reference point of Get2DangleFrom3D()
+    Double_t fTriggerOffset;
     Double_t fWiretoCm;
     Double_t fTimetoCm;
     Double_t fWireTimetoCmCm;
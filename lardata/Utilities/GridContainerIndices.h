@@ -24,7 +24,9 @@
 
 // C/C++ standard libraries
 #include <cstddef> // std::ptrdiff_t
+#include <vector>
 #include <array>
+#include <algorithm> // std::max()
 
 
 namespace util {
@@ -52,9 +54,26 @@ namespace util {
       /// type of cell coordinate (x, y, z)
       using CellID_t = std::array<CellDimIndex_t, dims()>;
 
+      /**
+       * @brief Offsets of the cells in the neighbourhood of a cell
+       *
+       * The neighbourhood of radius `radius` of a cell includes all the cells
+       * whose coordinates differ from the ones of that cell by no more than
+       * `radius` (the cell itself included): 3x3 cells in 2D for radius `1`,
+       * 5x5x5 in 3D for radius `2`, and so on.
+       * The stencil depends on the grid it was created by (`makeStencil()`),
+       * and it should be used only with grids of the same size.
+       */
+      struct Stencil_t {
+        CellDimIndex_t radius = 0; ///< Radius of the neighbourhood [cells].
+        std::vector<CellID_t> cellOffsets; ///< Offset of each neighbour.
+        std::vector<CellIndexOffset_t> indexOffsets; ///< Same, as index offset.
+      }; // Stencil_t
+
       /// Constructor: specifies the size of the container and allocates it
       GridContainerIndicesBase(std::array<size_t, dims()> const& new_dims)
         : indices(new_dims.begin())
+        , dimSizes(new_dims)
         {}
 
       /// @{
@@ -67,6 +86,10 @@ namespace util {
       /// Returns the number of cells in the grid
       size_t size() const { return indices.size(); }
 
+      /// Returns whether the specified cell is in the grid
+      bool hasCell(CellID_t const& id) const
+        { return indices.has(id.begin()); }
+
       /// @}
 
       /// @{
@@ -80,11 +103,53 @@ namespace util {
         (CellID_t const& origin, CellID_t const& cellID) const
         { return index(cellID) - index(origin); }
 
+      /// @}
+
+      /// @{
+      /// @name Neighbourhood
+
+      /// Returns the stencil of the neighbourhood with the specified radius
+      Stencil_t makeStencil(CellDimIndex_t radius) const;
+
+      /**
+       * @brief Calls `op(CellIndex_t)` on each neighbour cell in the grid
+       * @param center the cell the neighbourhood is centred on
+       * @param stencil the neighbourhood, from `makeStencil()`
+       * @param op callable to be called with the index of each neighbour
+       *
+       * The cells of the neighbourhood outside the grid are skipped; the
+       * center cell itself is included. If the whole neighbourhood is within
+       * the grid, no bound check is performed at all.
+       */
+      template <typename Op>
+      void forEachNeighbour
+        (CellID_t const& center, Stencil_t const& stencil, Op op) const;
+
+      /**
+       * @brief Calls `op(CellIndex_t)` on each cell of a shell in the grid
+       * @param center the cell the shell is centred on
+       * @param radius distance of the cells of the shell from `center`
+       * @param op callable to be called with the index of each cell
+       * @see maxShellRadius()
+       *
+       * The shell is made of all the cells whose largest coordinate difference
+       * from `center` is exactly `radius`; shell `0` is `center` itself.
+       * The cells of the shell outside the grid are skipped.
+       */
+      template <typename Op>
+      void forEachInShell
+        (CellID_t const& center, CellDimIndex_t radius, Op op) const;
+
+      /// Returns the radius of the largest shell around `center` in the grid
+      CellDimIndex_t maxShellRadius(CellID_t const& center) const;
+
       /// @}
 
         protected:
       IndexManager_t indices; ///< the actual worker
 
+      std::array<size_t, dims()> dimSizes; ///< size of each dimension
+
       /// Returns the index of the element from its cell coordinates (no check!)
       CellIndex_t index(CellID_t id) const
         { return indices(id.begin()); }
@@ -187,6 +252,145 @@ namespace util {
 } // namespace util
 
 
+//------------------------------------------------------------------------------
+//--- template implementation
+//---
+template <unsigned int DIMS>
+auto util::details::GridContainerIndicesBase<DIMS>::makeStencil
+  (CellDimIndex_t radius) const -> Stencil_t
+{
+  Stencil_t stencil;
+  stencil.radius = radius;
+
+  // "odometer" loop on all the offsets from (-radius, ...) to (radius, ...)
+  CellID_t offset;
+  offset.fill(-radius);
+  unsigned int dim = 0;
+  do {
+    stencil.cellOffsets.push_back(offset);
+    CellIndexOffset_t indexOffset = 0;
+    for (unsigned int d = 0; d < dims(); ++d) {
+      indexOffset = indexOffset * (CellIndexOffset_t) dimSizes[d] + offset[d];
+    }
+    stencil.indexOffsets.push_back(indexOffset);
+
+    for (dim = dims(); dim-- > 0; ) {
+      if (++offset[dim] <= radius) break;
+      offset[dim] = -radius;
+    } // for
+  } while (dim < dims());
+
+  return stencil;
+} // util::details::GridContainerIndicesBase<>::makeStencil()
+
+
+//------------------------------------------------------------------------------
+template <unsigned int DIMS>
+template <typename Op>
+void util::details::GridContainerIndicesBase<DIMS>::forEachNeighbour
+  (CellID_t const& center, Stencil_t const& stencil, Op op) const
+{
+  bool inside = true;
+  for (unsigned int d = 0; d < dims(); ++d) {
+    if ((center[d] >= stencil.radius)
+      && (center[d] + stencil.radius < (CellDimIndex_t) dimSizes[d])
+      )
+      continue;
+    inside = false;
+    break;
+  } // for
+
+  if (inside) { // fast path: no bound checks
+    CellIndex_t const centerIndex = index(center);
+    for (CellIndexOffset_t indexOffset: stencil.indexOffsets)
+      op(static_cast<CellIndex_t>(centerIndex + indexOffset));
+    return;
+  }
+
+  CellID_t cellID;
+  for (CellID_t const& offset: stencil.cellOffsets) {
+    for (unsigned int d = 0; d < dims(); ++d)
+      cellID[d] = center[d] + offset[d];
+    if (hasCell(cellID)) op(index(cellID));
+  } // for
+} // util::details::GridContainerIndicesBase<>::forEachNeighbour()
+
+
+//------------------------------------------------------------------------------
+template <unsigned int DIMS>
+template <typename Op>
+void util::details::GridContainerIndicesBase<DIMS>::forEachInShell
+  (CellID_t const& center, CellDimIndex_t radius, Op op) const
+{
+  if (radius <= 0) {
+    if ((radius == 0) && hasCell(center)) op(index(center));
+    return;
+  }
+
+  /*
+   * The shell is visited one face at a time: the face on dimension `d` has
+   * that coordinate fixed at `center[d] - radius` or `center[d] + radius`.
+   * The cells on the edges shared with the faces on a previous dimension `e`
+   * have already been visited, so the range on `e` excludes its two ends.
+   * Each cell is visited once, and cells inside the shell are never visited.
+   */
+  for (unsigned int d = 0; d < dims(); ++d) {
+    for (CellDimIndex_t const side: { -radius, radius }) {
+      CellDimIndex_t const faceCoord = center[d] + side;
+      if ((faceCoord < 0) || (faceCoord >= (CellDimIndex_t) dimSizes[d]))
+        continue; // this face is all out of the grid
+
+      // the range of the coordinates of the face cells clamped into the grid
+      CellID_t first, last;
+      bool empty = false;
+      for (unsigned int e = 0; e < dims(); ++e) {
+        if (e == d) {
+          first[e] = last[e] = faceCoord;
+          continue;
+        }
+        CellDimIndex_t const margin = (e < d)? radius - 1: radius;
+        first[e] = std::max(center[e] - margin, (CellDimIndex_t) 0);
+        last[e] = std::min
+          (center[e] + margin, (CellDimIndex_t) dimSizes[e] - 1);
+        if (first[e] > last[e]) empty = true;
+      } // for
+      if (empty) continue;
+
+      // "odometer" loop on all cells of the face
+      CellID_t cellID = first;
+      unsigned int dim = 0;
+      do {
+        op(index(cellID));
+
+        for (dim = dims(); dim-- > 0; ) {
+          if (++cellID[dim] <= last[dim]) break;
+          cellID[dim] = first[dim];
+        } // for
+      } while (dim < dims());
+
+    } // for sides
+  } // for faces
+
+} // util::details::GridContainerIndicesBase<>::forEachInShell()
+
+
+//------------------------------------------------------------------------------
+template <unsigned int DIMS>
+auto util::details::GridContainerIndicesBase<DIMS>::maxShellRadius
+  (CellID_t const& center) const -> CellDimIndex_t
+{
+  CellDimIndex_t radius = 0;
+  for (unsigned int d = 0; d < dims(); ++d) {
+    radius = std::max({
+      radius, center[d], (CellDimIndex_t) dimSizes[d] - 1 - center[d]
+      });
+  } // for
+  return radius;
+} // util::details::GridContainerIndicesBase<>::maxShellRadius()
+
+
+//------------------------------------------------------------------------------
+
 
 #endif // LARDATA_UTILITIES_GRIDCONTAINERINDICES_H
 
@@ -8,6 +8,8 @@
  *
  * * GridContainer2D: container on data in 2D space
  * * GridContainer3D: container of data in 3D space
+ * * FlatGridContainer2D, FlatGridContainer3D: same, with all data in a single
+ *   contiguous array, filled all at once
  * * GridContainerBase: base class for containers in a N-dimension space
  *
  * This is a pure header that contains only template classes.
@@ -22,6 +24,13 @@
 // C/C++ standard libraries
 #include <vector>
 #include <array>
+#include <iterator> // std::begin(), std::end()
+#include <numeric> // std::partial_sum()
+#include <algorithm> // std::push_heap(), std::pop_heap(), std::sort_heap()
+#include <utility> // std::forward()
+#include <thread>
+#include <exception> // std::exception_ptr
+#include <cstddef> // std::size_t
 
 
 namespace util {
@@ -153,25 +162,299 @@ namespace util {
 
     }; // GridContainerBase<>
 
+
+    /// Functor returning its argument.
+    struct GridIdentity {
+      template <typename T>
+      T&& operator() (T&& value) const { return std::forward<T>(value); }
+    }; // GridIdentity
+
+
+    /// Range of consecutive data in a cell of a flat grid container.
+    template <typename T>
+    class GridCellRange {
+        public:
+      using value_type = T; ///< type of datum
+      using iterator = T*; ///< type of iterator to the data
+
+      GridCellRange(T* begin, T* end): b(begin), e(end) {}
+
+      iterator begin() const { return b; } ///< Begin iterator to the data.
+      iterator end() const { return e; } ///< End iterator to the data.
+
+      /// Returns the number of data in the cell
+      std::size_t size() const { return e - b; }
+
+      /// Returns whether the cell holds no data
+      bool empty() const { return b == e; }
+
+      /// Returns the datum at the specified position in the cell (no check!)
+      T& operator[] (std::size_t i) const { return b[i]; }
+
+        private:
+      T* b; ///< pointer to the first datum
+      T* e; ///< pointer after the last datum
+    }; // GridCellRange<>
+
+
+    /**
+     * @brief Base class for a grid container with all data in a single array
+     * @tparam DATUM type of datum to be contained
+     * @tparam IXMAN type of the grid index manager
+     *
+     * This container has the same cell indexing and access interface as
+     * `GridContainerBase`, but the data of all cells are stored in a single
+     * contiguous array, ordered by cell index, with an array of the offsets
+     * of each cell in it ("compressed sparse row" layout).
+     * Compared to `GridContainerBase`, it needs one memory allocation in
+     * total rather than one per cell, and the data of neighbouring cells are
+     * close in memory.
+     *
+     * The price is that data can't be inserted one by one: the container is
+     * filled all at once with `build()` (or at construction), which first
+     * counts the elements of each cell and then places them.
+     * The data in each cell keep the order they had in the input range.
+     * Access to a cell returns a range (`GridCellRange`) of its data rather
+     * than a container.
+     *
+     * Example of use: data can be pointers to the elements of a collection
+     * of space points, distributed in cells according to their position:
+     * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~{.cpp}
+     * util::FlatGridContainer3D<recob::SpacePoint const*> grid({{ nx, ny, nz }});
+     * grid.build(points,
+     *   [&](recob::SpacePoint const& point){ return cellOf(point.XYZ()); },
+     *   [](recob::SpacePoint const& point){ return &point; }
+     *   );
+     * for (recob::SpacePoint const* point: grid[{{ 1, 2, 3 }}]) {
+     *   // ...
+     * }
+     * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+     */
+    template <typename DATUM, typename IXMAN>
+    class FlatGridContainerBase {
+
+        public:
+      using Datum_t = DATUM; ///< type of contained datum
+      using Indexer_t = IXMAN; /// type of index manager
+
+      using Grid_t = FlatGridContainerBase<Datum_t, Indexer_t>; ///< this type
+
+
+      static constexpr unsigned int dims() { return IXMAN::dims(); }
+
+      /// type of index for direct access to the cell
+      using CellIndex_t = typename Indexer_t::CellIndex_t;
+
+      /// type of difference between indices
+      using CellIndexOffset_t = typename Indexer_t::CellIndexOffset_t;
+
+      /// type of difference between indices
+      using CellDimIndex_t = typename Indexer_t::CellDimIndex_t;
+
+      /// type of cell coordinate (x, y, z)
+      using CellID_t = typename Indexer_t::CellID_t;
+
+      /// type of a single cell (range of data)
+      using Cell_t = GridCellRange<Datum_t>;
+
+      /// type of a single cell with constant data
+      using ConstCell_t = GridCellRange<Datum_t const>;
+
+      /// Constructor: specifies the size of the container, with no data
+      FlatGridContainerBase(std::array<size_t, dims()> const& dims)
+        : indices(dims)
+        , offsets(indices.size() + 1, 0U)
+        {}
+
+      /// Constructor: specifies the size of the container and fills it
+      /// (see `build()`)
+      template
+        <typename Range, typename CellOf, typename DatumOf = GridIdentity>
+      FlatGridContainerBase(
+        std::array<size_t, dims()> const& dims,
+        Range const& range, CellOf cellOf, DatumOf datumOf = {}
+        )
+        : FlatGridContainerBase(dims)
+        { build(range, cellOf, datumOf); }
+
+      /// @{
+      /// @name Data structure
+
+      /// Returns the total size of the container
+      size_t size() const { return indices.size(); }
+
+      /// Returns whether the specified index is valid
+      bool has(CellIndexOffset_t index) const { return indices.has(index); }
+
+      /// Returns the total number of data in all the cells
+      size_t nData() const { return data.size(); }
+
+      /// @}
+
+      /// @{
+      /// @name Data access
+
+      /// Return the index of the element from its cell coordinates (no check!)
+      CellIndex_t index(CellID_t const& id) const { return indices[id]; }
+
+      /// Returns the difference in index from two cells
+      CellIndexOffset_t indexOffset
+        (CellID_t const& origin, CellID_t const& cellID) const
+        { return indices.offset(origin, cellID); }
+
+      /// Returns the data in the specified cell
+      Cell_t operator[] (CellID_t const& id) { return cell(index(id)); }
+
+      /// Returns the constant data in the specified cell
+      ConstCell_t operator[] (CellID_t const& id) const
+        { return cell(index(id)); }
+
+      /// Returns the data in the cell with specified index
+      Cell_t operator[] (CellIndex_t index) { return cell(index); }
+
+      /// Returns the constant data in the cell with specified index
+      ConstCell_t operator[] (CellIndex_t index) const { return cell(index); }
+
+      ///@}
+
+      /// @{
+      /// @name Data insertion
+
+      /**
+       * @brief Replaces the content of the container with the data of a range
+       * @tparam Range type of range of input elements
+       * @tparam CellOf type of callable returning the cell of an element
+       * @tparam DatumOf type of callable returning the datum of an element
+       * @param range the input elements
+       * @param cellOf returns the cell of an element, as `CellID_t` or as
+       *               `CellIndex_t` (no check!)
+       * @param datumOf returns the datum to be stored for an element
+       *                (by default, the element itself)
+       *
+       * The range is traversed once, and its iterators must stay valid until
+       * the end of the call. `cellOf` is called once per element, and so is
+       * `datumOf`.
+       */
+      template
+        <typename Range, typename CellOf, typename DatumOf = GridIdentity>
+      void build(Range const& range, CellOf cellOf, DatumOf datumOf = {});
+
+      /**
+       * @brief Replaces the content of the container, using multiple threads
+       * @param nThreads number of threads to use (`0`: one per core)
+       * @param range the input elements
+       * @param cellOf returns the cell of an element (see `build()`)
+       * @param datumOf returns the datum to be stored for an element
+       * @see build()
+       *
+       * The result is the same as the one of `build()`.
+       * The range must have random access iterators, and `Datum_t` must be
+       * default-constructible. `cellOf` and `datumOf` are called concurrently
+       * from different threads, and they must not change any shared state.
+       * An exception thrown by them is rethrown after all the threads have
+       * stopped, leaving the container content undefined (call `clear()`).
+       *
+       * Each thread fills the data of a block of consecutive elements, after
+       * all threads have counted the elements of their block in each cell.
+       * The memory needed for these counts is proportional to the number of
+       * threads times the number of cells in the grid, so that this method is
+       * not convenient for sparse grids with few data.
+       */
+      template
+        <typename Range, typename CellOf, typename DatumOf = GridIdentity>
+      void buildParallel(
+        unsigned int nThreads,
+        Range const& range, CellOf cellOf, DatumOf datumOf = {}
+        );
+
+      /// Removes all the data, keeping the size of the grid
+      void clear()
+        { data.clear(); offsets.assign(offsets.size(), 0U); }
+
+      /// @}
+
+      /// Returns the index manager of the grid
+      Indexer_t const& indexManager() const { return indices; }
+
+
+        protected:
+      Indexer_t indices; ///< manager of the indices of the container
+
+      /// position in `data` of the first datum of each cell, plus the total
+      std::vector<size_t> offsets;
+
+      std::vector<Datum_t> data; ///< data of all the cells, in cell order
+
+      /// Returns the data in the cell with the specified index
+      Cell_t cell(CellIndex_t index)
+        {
+          return
+            { data.data() + offsets[index], data.data() + offsets[index + 1] };
+        }
+
+      /// Returns the constant data in the cell with the specified index
+      ConstCell_t cell(CellIndex_t index) const
+        {
+          return
+            { data.data() + offsets[index], data.data() + offsets[index + 1] };
+        }
+
+      /// Returns the index of the specified cell
+      CellIndex_t cellIndex(CellID_t const& id) const { return index(id); }
+
+      /// Returns the specified cell index
+      CellIndex_t cellIndex(CellIndex_t index) const { return index; }
+
+    }; // FlatGridContainerBase<>
+
   } // namespace details
 
 
+  /// Result of a search in a grid container: a datum and its distance.
+  template <typename DATUM>
+  struct GridMatch {
+    DATUM const* datum; ///< Pointer to the datum in the container.
+    double distance2; ///< Square of the distance of the datum.
+  }; // GridMatch<>
+
+
   /**
    * @brief Base class for a container of data arranged on a 1D-grid
    * @tparam DATUM type of datum to be contained
    * @tparam IXMAN type of the grid index manager
+   * @tparam STORAGE base class storing the data (e.g. `GridContainerBase`)
    *
    *
    */
-  template <typename DATUM, typename IXMAN>
-  class GridContainerBase1D: public details::GridContainerBase<DATUM, IXMAN> {
-    using Base_t = details::GridContainerBase<DATUM, IXMAN>;
+  template <
+    typename DATUM, typename IXMAN,
+    template <typename, typename> class STORAGE = details::GridContainerBase
+    >
+  class GridContainerBase1D: public STORAGE<DATUM, IXMAN> {
+    using Base_t = STORAGE<DATUM, IXMAN>;
     static_assert(Base_t::dims() >= 1,
       "GridContainerBase1D must have dimensions 1 or larger.");
 
       public:
 
-    using Base_t::GridContainerBase;
+    using Datum_t = typename Base_t::Datum_t; ///< type of contained datum
+
+    /// type of cell coordinate (x, y, z)
+    using CellID_t = typename Base_t::CellID_t;
+
+    /// type of difference between indices along a dimension
+    using CellDimIndex_t = typename Base_t::CellDimIndex_t;
+
+    /// type of index for direct access to the cell
+    using CellIndex_t = typename Base_t::CellIndex_t;
+
+    /// type of neighbourhood description
+    using Stencil_t = typename IXMAN::Stencil_t;
+
+    /// type of result of a search
+    using Match_t = GridMatch<Datum_t>;
+
+    using Base_t::Base_t;
 
     /// @{
     /// @name Data structure
@@ -183,6 +466,85 @@ namespace util {
     /// Returns the size of the container in the first dimension (x)
     size_t sizeX() const { return Base_t::indices.sizeX(); }
 
+    /// Returns whether the specified cell is in the grid
+    bool hasCell(CellID_t const& id) const
+      { return Base_t::indices.hasCell(id); }
+
+    /// @}
+
+    /// @{
+    /// @name Neighbourhood and search
+
+    /// Returns the neighbourhood of the specified radius (in cells)
+    /// @see `forEachNeighbourCell()`
+    Stencil_t makeStencil(CellDimIndex_t radius) const
+      { return Base_t::indices.makeStencil(radius); }
+
+    /**
+     * @brief Calls `op(cell)` with each cell around the specified one
+     * @param center the cell the neighbourhood is centred on
+     * @param stencil the neighbourhood (from `makeStencil()`)
+     * @param op callable to be called with the content of each cell
+     *
+     * The cells out of the grid are skipped, and the center cell is included.
+     * The stencil should be created once and reused for all the cells:
+     * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~{.cpp}
+     * auto const stencil = grid.makeStencil(1); // 3x3x3 cells
+     * std::size_t n = 0;
+     * grid.forEachNeighbourCell
+     *   (cellID, stencil, [&n](auto const& cell){ n += cell.size(); });
+     * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+     */
+    template <typename Op>
+    void forEachNeighbourCell
+      (CellID_t const& center, Stencil_t const& stencil, Op op) const
+      {
+        Base_t::indices.forEachNeighbour(center, stencil,
+          [this, &op](CellIndex_t index){ op((*this)[index]); }
+          );
+      }
+
+    /**
+     * @brief Returns the data within a distance, in the specified neighbourhood
+     * @tparam Dist2 type of callable returning the squared distance of a datum
+     * @param center the cell the neighbourhood is centred on
+     * @param stencil the neighbourhood to be searched (from `makeStencil()`)
+     * @param dist2 callable returning the squared distance of a datum from the
+     *              query point
+     * @param maxDist2 the square of the largest distance accepted
+     * @return a `Match_t` for each datum with `dist2(datum) <= maxDist2`
+     *
+     * Only the data in the cells of the neighbourhood are tested: the stencil
+     * must be large enough to cover the whole search sphere.
+     * The matches are not sorted.
+     */
+    template <typename Dist2>
+    std::vector<Match_t> findWithin(
+      CellID_t const& center, Stencil_t const& stencil,
+      Dist2 dist2, double maxDist2
+      ) const;
+
+    /**
+     * @brief Returns the `k` data nearest to a point
+     * @tparam Dist2 type of callable returning the squared distance of a datum
+     * @param center the cell the query point lies in
+     * @param k the number of data to be returned
+     * @param dist2 callable returning the squared distance of a datum from the
+     *              query point
+     * @param cellSize the shortest side of the cells, in the same unit as the
+     *                 distance
+     * @return up to `k` matches, sorted by increasing distance
+     *
+     * The cells are visited in shells of increasing distance from `center`
+     * (see `GridContainerIndicesBase::forEachInShell()`) and the search stops
+     * when the closest still unvisited cell is farther than the `k`-th match.
+     * If there are fewer than `k` data in the grid, they are all returned.
+     */
+    template <typename Dist2>
+    std::vector<Match_t> findNearest(
+      CellID_t const& center, std::size_t k, Dist2 dist2, double cellSize
+      ) const;
+
     /// @}
 
       protected:
@@ -193,12 +555,16 @@ namespace util {
    * @brief Base class for a container of data arranged on a 2D-grid
    * @tparam DATUM type of datum to be contained
    * @tparam IXMAN type of the grid index manager
+   * @tparam STORAGE base class storing the data (e.g. `GridContainerBase`)
    *
    *
    */
-  template <typename DATUM, typename IXMAN>
-  class GridContainerBase2D: public GridContainerBase1D<DATUM, IXMAN> {
-    using Base_t = GridContainerBase1D<DATUM, IXMAN>;
+  template <
+    typename DATUM, typename IXMAN,
+    template <typename, typename> class STORAGE = details::GridContainerBase
+    >
+  class GridContainerBase2D: public GridContainerBase1D<DATUM, IXMAN, STORAGE> {
+    using Base_t = GridContainerBase1D<DATUM, IXMAN, STORAGE>;
     static_assert(Base_t::dims() >= 2,
       "GridContainerBase2D must have dimensions 2 or larger.");
 
@@ -226,12 +592,16 @@ namespace util {
    * @brief Base class for a container of data arranged on a 3D-grid
    * @tparam DATUM type of datum to be contained
    * @tparam IXMAN type of the grid index manager
+   * @tparam STORAGE base class storing the data (e.g. `GridContainerBase`)
    *
    *
    */
-  template <typename DATUM, typename IXMAN>
-  class GridContainerBase3D: public GridContainerBase2D<DATUM, IXMAN> {
-    using Base_t = GridContainerBase2D<DATUM, IXMAN>;
+  template <
+    typename DATUM, typename IXMAN,
+    template <typename, typename> class STORAGE = details::GridContainerBase
+    >
+  class GridContainerBase3D: public GridContainerBase2D<DATUM, IXMAN, STORAGE> {
+    using Base_t = GridContainerBase2D<DATUM, IXMAN, STORAGE>;
     static_assert(Base_t::dims() >= 3,
       "GridContainerBase3D must have dimensions 3 or larger.");
 
@@ -278,7 +648,232 @@ namespace util {
   template <typename DATUM>
   using GridContainer3D = GridContainerBase3D<DATUM, GridContainer3DIndices>;
 
+
+  /**
+   * @brief Container allowing 2D indexing, with all data in a single array
+   * @tparam DATUM type of contained data
+   * @see GridContainer2D, details::FlatGridContainerBase
+   *
+   * This container is filled all at once with `build()`.
+   * See the documentation of `details::FlatGridContainerBase`.
+   */
+  template <typename DATUM>
+  using FlatGridContainer2D = GridContainerBase2D
+    <DATUM, GridContainer2DIndices, details::FlatGridContainerBase>;
+
+
+  /**
+   * @brief Container allowing 3D indexing, with all data in a single array
+   * @tparam DATUM type of contained data
+   * @see GridContainer3D, details::FlatGridContainerBase
+   *
+   * This container is filled all at once with `build()`.
+   * See the documentation of `details::FlatGridContainerBase`.
+   */
+  template <typename DATUM>
+  using FlatGridContainer3D = GridContainerBase3D
+    <DATUM, GridContainer3DIndices, details::FlatGridContainerBase>;
+
 } // namespace util
 
 
+//------------------------------------------------------------------------------
+//--- template implementation
+//---
+template <typename DATUM, typename IXMAN>
+template <typename Range, typename CellOf, typename DatumOf>
+void util::details::FlatGridContainerBase<DATUM, IXMAN>::build
+  (Range const& range, CellOf cellOf, DatumOf datumOf)
+{
+  using std::begin;
+  using std::end;
+  using Iterator_t = decltype(begin(range));
+
+  //
+  // first pass: find the cell of each element
+  //
+  std::vector<Iterator_t> elements;
+  std::vector<CellIndex_t> cellIndices;
+  for (auto iElem = begin(range); iElem != end(range); ++iElem) {
+    elements.push_back(iElem);
+    cellIndices.push_back(cellIndex(cellOf(*iElem)));
+  } // for
+  std::size_t const n = elements.size();
+
+  //
+  // count the elements in each cell, and the offset of each cell
+  //
+  offsets.assign(size() + 1, 0U);
+  for (CellIndex_t index: cellIndices) ++offsets[index + 1];
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+  //
+  // place each element in its cell, in the original order
+  //
+  std::vector<std::size_t> order(n);
+  std::vector<std::size_t> next(offsets.begin(), offsets.end() - 1);
+  for (std::size_t i = 0; i < n; ++i) order[next[cellIndices[i]]++] = i;
+
+  data.clear();
+  data.reserve(n);
+  for (std::size_t i: order) data.push_back(datumOf(*(elements[i])));
+
+} // util::details::FlatGridContainerBase<>::build()
+
+
+//------------------------------------------------------------------------------
+template <typename DATUM, typename IXMAN>
+template <typename Range, typename CellOf, typename DatumOf>
+void util::details::FlatGridContainerBase<DATUM, IXMAN>::buildParallel(
+  unsigned int nThreads, Range const& range, CellOf cellOf, DatumOf datumOf
+) {
+  using std::begin;
+  using std::end;
+
+  auto const first = begin(range);
+  std::size_t const n = std::distance(first, end(range));
+
+  if (nThreads == 0U) nThreads = std::thread::hardware_concurrency();
+  if (nThreads > n) nThreads = static_cast<unsigned int>(n);
+  if (nThreads <= 1U) {
+    build(range, cellOf, datumOf);
+    return;
+  }
+
+  std::size_t const nCells = size();
+  std::vector<CellIndex_t> cellIndices(n);
+  // element counts per cell of each thread, then first position to fill
+  std::vector<std::size_t> positions(nThreads * nCells, 0U);
+  std::vector<std::exception_ptr> errors(nThreads);
+
+  // runs `work(iThread, begin, end)` on all the threads, each on its block
+  auto const runOnBlocks = [&](auto work){
+    std::vector<std::thread> threads;
+    threads.reserve(nThreads);
+    for (unsigned int iThread = 0; iThread < nThreads; ++iThread) {
+      threads.emplace_back([&, iThread](){
+        try {
+          work(iThread, n * iThread / nThreads, n * (iThread + 1) / nThreads);
+        }
+        catch (...) { errors[iThread] = std::current_exception(); }
+      });
+    } // for
+    for (std::thread& thread: threads) thread.join();
+    for (std::exception_ptr const& error: errors)
+      if (error) std::rethrow_exception(error);
+  }; // runOnBlocks()
+
+  //
+  // first pass: find the cell of each element and count them
+  //
+  runOnBlocks([&](unsigned int iThread, std::size_t begin, std::size_t end){
+    std::size_t* counts = positions.data() + iThread * nCells;
+    for (std::size_t i = begin; i < end; ++i) {
+      CellIndex_t const index = cellIndex(cellOf(first[i]));
+      cellIndices[i] = index;
+      ++counts[index];
+    } // for
+  });
+
+  //
+  // offset of each cell, and where each thread starts filling it
+  //
+  offsets.assign(nCells + 1, 0U);
+  std::size_t position = 0U;
+  for (std::size_t iCell = 0; iCell < nCells; ++iCell) {
+    offsets[iCell] = position;
+    for (unsigned int iThread = 0; iThread < nThreads; ++iThread) {
+      std::size_t& count = positions[iThread * nCells + iCell];
+      std::size_t const nElements = count;
+      count = position;
+      position += nElements;
+    } // for threads
+  } // for cells
+  offsets[nCells] = position;
+
+  //
+  // second pass: place each element in its cell, in the original order
+  //
+  data.clear();
+  data.resize(n);
+  runOnBlocks([&](unsigned int iThread, std::size_t begin, std::size_t end){
+    std::size_t* next = positions.data() + iThread * nCells;
+    for (std::size_t i = begin; i < end; ++i)
+      data[next[cellIndices[i]]++] = datumOf(first[i]);
+  });
+
+} // util::details::FlatGridContainerBase<>::buildParallel()
+
+
+//------------------------------------------------------------------------------
+template
+  <typename DATUM, typename IXMAN, template <typename, typename> class STORAGE>
+template <typename Dist2>
+auto util::GridContainerBase1D<DATUM, IXMAN, STORAGE>::findWithin(
+  CellID_t const& center, Stencil_t const& stencil,
+  Dist2 dist2, double maxDist2
+) const -> std::vector<Match_t> {
+
+  std::vector<Match_t> matches;
+  forEachNeighbourCell(center, stencil, [&](auto const& cell){
+    for (Datum_t const& datum: cell) {
+      double const d2 = dist2(datum);
+      if (d2 <= maxDist2) matches.push_back({ &datum, d2 });
+    } // for
+  });
+  return matches;
+
+} // util::GridContainerBase1D<>::findWithin()
+
+
+//------------------------------------------------------------------------------
+template
+  <typename DATUM, typename IXMAN, template <typename, typename> class STORAGE>
+template <typename Dist2>
+auto util::GridContainerBase1D<DATUM, IXMAN, STORAGE>::findNearest(
+  CellID_t const& center, std::size_t k, Dist2 dist2, double cellSize
+) const -> std::vector<Match_t> {
+
+  // matches are kept in a max-heap, the farthest on top
+  auto const closer = [](Match_t const& a, Match_t const& b)
+    { return a.distance2 < b.distance2; };
+
+  std::vector<Match_t> matches;
+  if (k == 0U) return matches;
+  matches.reserve(k);
+
+  auto const addCell = [&](CellIndex_t index){
+    for (Datum_t const& datum: (*this)[index]) {
+      double const d2 = dist2(datum);
+      if (matches.size() < k) {
+        matches.push_back({ &datum, d2 });
+        std::push_heap(matches.begin(), matches.end(), closer);
+      }
+      else if (d2 < matches.front().distance2) {
+        std::pop_heap(matches.begin(), matches.end(), closer);
+        matches.back() = { &datum, d2 };
+        std::push_heap(matches.begin(), matches.end(), closer);
+      }
+    } // for
+  }; // addCell()
+
+  CellDimIndex_t const maxRadius = Base_t::indices.maxShellRadius(center);
+  for (CellDimIndex_t radius = 0; radius <= maxRadius; ++radius) {
+    if ((radius > 0) && (matches.size() == k)) {
+      // no point in this shell is closer than this to the query point
+      double const minDist = (radius - 1) * cellSize;
+      if (minDist * minDist >= matches.front().distance2) break;
+    }
+    Base_t::indices.forEachInShell(center, radius, addCell);
+  } // for
+
+  std::sort_heap(matches.begin(), matches.end(), closer);
+  return matches;
+
+} // util::GridContainerBase1D<>::findNearest()
+
+
+//------------------------------------------------------------------------------
+
+
 #endif // LARDATA_UTILITIES_GRIDCONTAINERS_H
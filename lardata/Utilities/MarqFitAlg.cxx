@@ -4,45 +4,77 @@
 
 namespace gshf{
 
+  MarqFitAlg::MarqFitAlg() {}
+
+  /* size the workspace; after the first call with a given size no allocation happens */
+  void MarqFitAlg::Workspace::setup(const int npar, const int ndat){
+    res.resize(ndat);
+    dydp.resize(npar*ndat);
+    beta.resize(npar);
+    alpha.resize(npar*npar);
+    alpSav.resize(npar);
+    pSav.resize(npar);
+    dp.resize(npar);
+  }
+
+  /* the workspace of the overloads without one: each thread has its own */
+  MarqFitAlg::Workspace& MarqFitAlg::thread_workspace(){
+    thread_local Workspace ws;
+    return ws;
+  }
+
   /* multi-Gaussian function, number of Gaussians is npar divided by 3 */
   void MarqFitAlg::fgauss(const float yd[], const float p[], const int npar, const int ndat, std::vector<float> &res){
-    #if defined WITH_OPENMP
-    #pragma omp simd
-    #endif
-    for(int i=0;i<ndat;i++){
-      float yf=0.;
-      for(int j=0;j<npar;j+=3){
-	yf = yf + p[j]*std::exp(-0.5*std::pow((float(i)-p[j+1])/p[j+2],2));
+    float* __restrict__ r = res.data();
+    for(int i=0;i<ndat;i++) r[i]=0.;
+    /* ... one Gaussian at a time, so that the loop on the ticks vectorizes */
+    for(int j=0;j<npar;j+=3){
+      const float amp=p[j];
+      const float mu=p[j+1];
+      const float invsg=1.f/p[j+2];
+      #if defined WITH_OPENMP
+      #pragma omp simd
+      #endif
+      for(int i=0;i<ndat;i++){
+	const float xmu_sg=(float(i)-mu)*invsg;
+	r[i]+=amp*std::exp(-0.5f*xmu_sg*xmu_sg);
       }
-      res[i]=yd[i]-yf;
     }
+    for(int i=0;i<ndat;i++) r[i]=yd[i]-r[i];
   }
 
-  /* analytic derivatives for multi-Gaussian function in fgauss */
+  /* analytic derivatives for multi-Gaussian function in fgauss;
+     the derivative by parameter j at tick i is stored in dydp[j*ndat+i] */
   void MarqFitAlg::dgauss(const float p[], const int npar, const int ndat, std::vector<float> &dydp){
-    #if defined WITH_OPENMP
-    //#pragma GCC ivdep
-     #pragma omp simd
-    #endif
-    for(int i=0;i<ndat;i++){
-      for(int j=0;j<npar;j+=3){
-	const float xmu=float(i)-p[j+1];
-	const float xmu_sg=xmu/p[j+2];
-	const float xmu_sg2=xmu_sg*xmu_sg;
-	dydp[i*npar+j] = std::exp(-0.5*xmu_sg2);
-	dydp[i*npar+j+1]=p[j]*dydp[i*npar+j]*xmu_sg/p[j+2];
-	dydp[i*npar+j+2]=dydp[i*npar+j+1]*xmu_sg;
+    for(int j=0;j<npar;j+=3){
+      const float amp=p[j];
+      const float mu=p[j+1];
+      const float invsg=1.f/p[j+2];
+      float* __restrict__ dAmp=dydp.data()+j*ndat;
+      float* __restrict__ dMu=dAmp+ndat;
+      float* __restrict__ dSg=dMu+ndat;
+      #if defined WITH_OPENMP
+      #pragma omp simd
+      #endif
+      for(int i=0;i<ndat;i++){
+	const float xmu_sg=(float(i)-mu)*invsg;
+	const float g=std::exp(-0.5f*xmu_sg*xmu_sg);
+	dAmp[i]=g;
+	dMu[i]=amp*g*xmu_sg*invsg;
+	dSg[i]=dMu[i]*xmu_sg;
       }
     }
   }
 
   /* calculate ChiSquared */
   float MarqFitAlg::cal_xi2(const std::vector<float> &res, const int ndat){
-    int i;
-    float xi2;
-    xi2=0.;
-    for(i=0;i<ndat;i++){
-      xi2+=res[i]*res[i];
+    const float* r = res.data();
+    float xi2=0.;
+    #if defined WITH_OPENMP
+    #pragma omp simd reduction(+:xi2)
+    #endif
+    for(int i=0;i<ndat;i++){
+      xi2+=r[i]*r[i];
     }
     return xi2;
   }
@@ -50,84 +82,130 @@ namespace gshf{
   /* setup the beta and  (curvature) matrices */
   void MarqFitAlg::setup_matrix(const std::vector<float> &res, const std::vector<float> &dydp, const int npar, const int ndat, std::vector<float> &beta, std::vector<float> &alpha)
   {
-    int i,j,k;
+    const float* r = res.data();
 
     /* ... Calculate beta */
-    #if defined WITH_OPENMP
-     #pragma omp simd
-    //#pragma GCC ivdep
-    #endif
-    for(j=0;j<npar;j++){
-      beta[j]=0.0;
-      for(i=0;i<ndat;i++){
-	beta[j]+=res[i]*dydp[i*npar+j];
+    for(int j=0;j<npar;j++){
+      const float* dj = dydp.data()+j*ndat;
+      float b=0.;
+      #if defined WITH_OPENMP
+      #pragma omp simd reduction(+:b)
+      #endif
+      for(int i=0;i<ndat;i++){
+	b+=r[i]*dj[i];
       }
+      beta[j]=b;
     }
 
-    /* ... Calculate alpha */
-    #if defined WITH_OPENMP
-    #pragma omp simd
-    //#pragma GCC ivdep
-    #endif
-    for (j = 0; j < npar; j++){
-      for (k = j; k < npar; k++){
-	alpha[j*npar+k]=0.0;
-	for(i=0;i<ndat;i++){
-	  alpha[j*npar+k]+=dydp[i*npar+j]*dydp[i*npar+k];
+    /* ... Calculate alpha (symmetric, only the upper half is computed) */
+    for(int j=0;j<npar;j++){
+      const float* dj = dydp.data()+j*ndat;
+      for(int k=j;k<npar;k++){
+	const float* dk = dydp.data()+k*ndat;
+	float a=0.;
+	#if defined WITH_OPENMP
+	#pragma omp simd reduction(+:a)
+	#endif
+	for(int i=0;i<ndat;i++){
+	  a+=dj[i]*dk[i];
 	}
-	if(k!=j)alpha[k*npar+j]=alpha[j*npar+k];
+	alpha[j*npar+k]=a;
+	alpha[k*npar+j]=a;
+      }
+    }
+  }
+
+  /* solve system of linear equations by Cholesky decomposition of alpha;
+     alpha is symmetric and, with the damping term, positive definite */
+  void MarqFitAlg::solve_matrix(Workspace &ws, const std::vector<float> &beta, const std::vector<float> &alpha, const int npar, std::vector<float> &dp)
+  {
+    ws.chol.resize(npar*npar);
+    ws.tmp.resize(npar);
+    double* L = ws.chol.data();
+
+    /* ... decompose alpha = L L^T, with L lower triangular */
+    for(int j=0;j<npar;j++){
+      double d=alpha[j*npar+j];
+      for(int k=0;k<j;k++) d-=L[j*npar+k]*L[j*npar+k];
+      if(!(d>0.)){
+	/* not positive definite (numerically): use the pivoting elimination */
+	solve_matrix_gj(ws, beta, alpha, npar, dp);
+	return;
+      }
+      const double ljj=std::sqrt(d);
+      L[j*npar+j]=ljj;
+      for(int i=j+1;i<npar;i++){
+	double s=alpha[i*npar+j];
+	for(int k=0;k<j;k++) s-=L[i*npar+k]*L[j*npar+k];
+	L[i*npar+j]=s/ljj;
       }
     }
+
+    /* ... forward substitution: L z = beta */
+    for(int i=0;i<npar;i++){
+      double s=beta[i];
+      for(int k=0;k<i;k++) s-=L[i*npar+k]*ws.tmp[k];
+      ws.tmp[i]=s/L[i*npar+i];
+    }
+    /* ... back substitution: L^T dp = z */
+    for(int i=npar-1;i>=0;i--){
+      double s=ws.tmp[i];
+      for(int k=i+1;k<npar;k++) s-=L[k*npar+i]*ws.tmp[k];
+      ws.tmp[i]=s/L[i*npar+i];
+      dp[i]=ws.tmp[i];
+    }
   }
 
-  /* solve system of linear equations */
-  void MarqFitAlg::solve_matrix(const std::vector<float> &beta, const std::vector<float> &alpha, const int npar, std::vector<float> &dp)
+  /* solve system of linear equations by Gauss-Jordan elimination */
+  void MarqFitAlg::solve_matrix_gj(Workspace &ws, const std::vector<float> &beta, const std::vector<float> &alpha, const int npar, std::vector<float> &dp)
   {
     int i,j,k,imax;
     float hmax,hsav;
 
-    std::vector<std::vector<float>> h(npar, std::vector<float>(npar+1,0));
+    const int ncol=npar+1;
+    ws.aug.resize(npar*ncol);
+    float* h = ws.aug.data();
 
     /* ... set up augmented N x N+1 matrix */
     for(i=0;i<npar;i++){
-      h[i][npar]=beta[i];
+      h[i*ncol+npar]=beta[i];
       for(j=0;j<npar;j++){
-	h[i][j]=alpha[i*npar+j];
+	h[i*ncol+j]=alpha[i*npar+j];
       }
     }
 
     /* ... diagonalize N x N matrix but do only terms required for solution */
     for(i=0;i<npar;i++){
-      hmax=h[i][i];
+      hmax=h[i*ncol+i];
       imax=i;
       for(j=i+1;j<npar;j++){
-	if(h[j][i]>hmax){
-	  hmax=h[j][i];
+	if(h[j*ncol+i]>hmax){
+	  hmax=h[j*ncol+i];
 	  imax=j;
 	}
       }
       if(imax!=i){
 	for(k=0;k<=npar;k++){
-	  hsav=h[i][k];
-	  h[i][k]=h[imax][k];
-	  h[imax][k]=hsav;
+	  hsav=h[i*ncol+k];
+	  h[i*ncol+k]=h[imax*ncol+k];
+	  h[imax*ncol+k]=hsav;
 	}
       }
       for(j=0;j<npar;j++){
 	if(j==i)continue;
 	for(k=i;k<npar;k++){
-	  h[j][k+1]-=h[i][k+1]*h[j][i]/h[i][i];
+	  h[j*ncol+k+1]-=h[i*ncol+k+1]*h[j*ncol+i]/h[i*ncol+i];
 	}
       }
     }
     /* ... scale (N+1)'th column with factor which normalizes the diagonal */
     for(i=0;i<npar;i++){
-      dp[i]=h[i][npar]/h[i][i];
+      dp[i]=h[i*ncol+npar]/h[i*ncol+i];
     }
 
   }
 
-  float MarqFitAlg::invrt_matrix(std::vector<float> &alphaf, const int npar)
+  float MarqFitAlg::invrt_matrix(Workspace &ws, std::vector<float> &alphaf, const int npar)
   {
     /*
      Inverts the curvature matrix alpha using Gauss-Jordan elimination and
@@ -140,11 +218,14 @@ namespace gshf{
     */
 
     //turn input alphas into doubles
-    std::vector<double> alpha(npar*npar);
+    ws.inv.resize(npar*npar);
+    ws.ik.resize(npar);
+    ws.jk.resize(npar);
+    double* alpha = ws.inv.data();
+    int* ik = ws.ik.data();
+    int* jk = ws.jk.data();
 
     int i, j, k;
-    std::vector<int> ik(npar);
-    std::vector<int> jk(npar);
     double aMax, save, det;
     float detf;
 
@@ -158,9 +239,6 @@ namespace gshf{
       aMax = 0;
       for (i = k; i < npar; i++){
 	for (j = k; j < npar;j++){
-
-	  //	  alpha[i*npar+j]=alphaf[i*npar+j];
-
 	  if  (fabs(alpha[i*npar+j]) > fabs(aMax)){
 	    aMax = alpha[i*npar+j];
 	    ik[k] = i;
@@ -192,13 +270,13 @@ namespace gshf{
       for (i = 0; i < npar; i++){
 	if (i != k) alpha[i*npar+k] = -alpha[i*npar+k]/aMax;
       }
-      #if defined WITH_OPENMP
-      #pragma omp simd
-	//#pragma GCC ivdep
-      #endif
       for (i = 0; i < npar; i++){
+	if (i == k) continue;
+	#if defined WITH_OPENMP
+	#pragma omp simd
+	#endif
 	for (j = 0; j < npar;j++){
-	  if ((i != k)&&(j!= k))alpha[i*npar+j]=alpha[i*npar+j]+alpha[i*npar+k]*alpha[k*npar+j];
+	  if (j != k) alpha[i*npar+j]=alpha[i*npar+j]+alpha[i*npar+k]*alpha[k*npar+j];
 	}
       }
       for (j = 0; j < npar;j++){
@@ -240,31 +318,27 @@ namespace gshf{
   /* Calculate parameter errors */
   int MarqFitAlg::cal_perr(float p[], float y[], const int nParam, const int nData, float perr[])
   {
-    int i,j;
+    return cal_perr(thread_workspace(), p, y, nParam, nData, perr);
+  }
+
+  int MarqFitAlg::cal_perr(Workspace &ws, float p[], float y[], const int nParam, const int nData, float perr[])
+  {
+    int i;
     float det;
 
-    std::vector<float> res(nData);
-    std::vector<float> dydp(nData*nParam);
-    std::vector<float> beta(nParam);
-    std::vector<float> alpha(nParam*nParam);
-    std::vector<std::vector<float>> alpsav(nParam,std::vector<float>(nParam));
+    ws.setup(nParam, nData);
 
-    fgauss(y, p, nParam, nData, res);
-    dgauss(p, nParam, nData, dydp);
-    setup_matrix(res, dydp, nParam, nData, beta,alpha);
-    for(i=0;i<nParam;i++){
-      for(j=0;j<nParam;j++){
-	alpsav[i][j]=alpha[i*nParam+j];
-      }
-    }
-    det=invrt_matrix(alpha, nParam);
+    fgauss(y, p, nParam, nData, ws.res);
+    dgauss(p, nParam, nData, ws.dydp);
+    setup_matrix(ws.res, ws.dydp, nParam, nData, ws.beta, ws.alpha);
+    det=invrt_matrix(ws, ws.alpha, nParam);
 
     if(det==0)return 1;
     for(i=0;i<nParam;i++){
-      if(alpha[i*nParam+i]>=0.){
-	perr[i]=sqrt(alpha[i*nParam+i]);
+      if(ws.alpha[i*nParam+i]>=0.){
+	perr[i]=sqrt(ws.alpha[i*nParam+i]);
       }else{
-	perr[i]=alpha[i*nParam+i];
+	perr[i]=ws.alpha[i*nParam+i];
       }
     }
 
@@ -273,60 +347,97 @@ namespace gshf{
 
   int MarqFitAlg::mrqdtfit(float &lambda, float p[], float y[], const int nParam, const int nData, float &chiSqr, float &dchiSqr)
   {
-    std::vector<float> plimmin(nParam,std::numeric_limits<float>::lowest());
-    std::vector<float> plimmax(nParam,std::numeric_limits<float>::max());
-    return mrqdtfit(lambda, p, &plimmin[0], &plimmax[0], y, nParam, nData, chiSqr, dchiSqr);
+    return mrqdtfit(thread_workspace(), lambda, p, y, nParam, nData, chiSqr, dchiSqr);
   }
 
   int MarqFitAlg::mrqdtfit(float &lambda, float p[], float plimmin[], float plimmax[], float y[], const int nParam, const int nData, float &chiSqr, float &dchiSqr)
   {
-    int j;
-    float nu,rho,lzmlh,amax,chiSq0;
+    return mrqdtfit(thread_workspace(), lambda, p, plimmin, plimmax, y, nParam, nData, chiSqr, dchiSqr);
+  }
 
-    std::vector<float> res(nData);
-    std::vector<float> beta(nParam);
-    std::vector<float> dp(nParam);
-    std::vector<float> alpsav(nParam);
-    std::vector<float> psav(nParam);
-    std::vector<float> dydp(nData*nParam);
-    std::vector<float> alpha(nParam*nParam);
+  int MarqFitAlg::mrqdtfit(Workspace &ws, float &lambda, float p[], float y[], const int nParam, const int nData, float &chiSqr, float &dchiSqr)
+  {
+    return fit_step(ws, lambda, p, nullptr, nullptr, y, nParam, nData, chiSqr, dchiSqr);
+  }
 
+  int MarqFitAlg::mrqdtfit(Workspace &ws, float &lambda, float p[], float plimmin[], float plimmax[], float y[], const int nParam, const int nData, float &chiSqr, float &dchiSqr)
+  {
     bool haslimits = false;
-    for(j=0;j<nParam;j++){
+    for(int j=0;j<nParam;j++){
       if (plimmin[j]>std::numeric_limits<float>::lowest() || plimmax[j]<std::numeric_limits<float>::max()) {
         haslimits = true;
         break;
       }
     }
+    return haslimits
+      ? fit_step(ws, lambda, p, plimmin, plimmax, y, nParam, nData, chiSqr, dchiSqr)
+      : fit_step(ws, lambda, p, nullptr, nullptr, y, nParam, nData, chiSqr, dchiSqr);
+  }
+
+  int MarqFitAlg::mrqdtfit(const int nFits, float lambda[], float p[], float y[], const int nParam, const int nData, float chiSqr[], float dchiSqr[])
+  {
+    return mrqdtfit(thread_workspace(), nFits, lambda, p, y, nParam, nData, chiSqr, dchiSqr);
+  }
+
+  int MarqFitAlg::mrqdtfit(const int nFits, float lambda[], float p[], float plimmin[], float plimmax[], float y[], const int nParam, const int nData, float chiSqr[], float dchiSqr[])
+  {
+    return mrqdtfit(thread_workspace(), nFits, lambda, p, plimmin, plimmax, y, nParam, nData, chiSqr, dchiSqr);
+  }
+
+  int MarqFitAlg::mrqdtfit(Workspace &ws, const int nFits, float lambda[], float p[], float y[], const int nParam, const int nData, float chiSqr[], float dchiSqr[])
+  {
+    int nFailed=0;
+    for(int f=0;f<nFits;f++){
+      if(fit_step(ws, lambda[f], p+f*nParam, nullptr, nullptr, y+f*nData, nParam, nData, chiSqr[f], dchiSqr[f])) ++nFailed;
+    }
+    return nFailed;
+  }
+
+  int MarqFitAlg::mrqdtfit(Workspace &ws, const int nFits, float lambda[], float p[], float plimmin[], float plimmax[], float y[], const int nParam, const int nData, float chiSqr[], float dchiSqr[])
+  {
+    int nFailed=0;
+    for(int f=0;f<nFits;f++){
+      if(mrqdtfit(ws, lambda[f], p+f*nParam, plimmin, plimmax, y+f*nData, nParam, nData, chiSqr[f], dchiSqr[f])) ++nFailed;
+    }
+    return nFailed;
+  }
+
+  /* one Levenberg-Marquardt step; limits are not checked if plimmin is null */
+  int MarqFitAlg::fit_step(Workspace &ws, float &lambda, float p[], const float plimmin[], const float plimmax[], const float y[], const int nParam, const int nData, float &chiSqr, float &dchiSqr)
+  {
+    int j;
+    float nu,rho,lzmlh,amax,chiSq0;
+
+    ws.setup(nParam, nData);
 
-    fgauss(y, p, nParam, nData, res);
-    chiSq0=cal_xi2(res, nData);
-    dgauss(p, nParam, nData, dydp);
-    setup_matrix(res, dydp, nParam, nData, beta, alpha);
+    fgauss(y, p, nParam, nData, ws.res);
+    chiSq0=cal_xi2(ws.res, nData);
+    dgauss(p, nParam, nData, ws.dydp);
+    setup_matrix(ws.res, ws.dydp, nParam, nData, ws.beta, ws.alpha);
     if(lambda<0.){
       amax=-999.;
       for(j = 0; j < nParam; j++){
-	if(alpha[j*nParam+j]>amax)amax=alpha[j*nParam+j];
+	if(ws.alpha[j*nParam+j]>amax)amax=ws.alpha[j*nParam+j];
       }
       lambda=0.001*amax;
     }
     for(j = 0; j < nParam; j++){
-      alpsav[j]=alpha[j*nParam+j];
-      alpha[j*nParam+j]=alpsav[j]+lambda;
+      ws.alpSav[j]=ws.alpha[j*nParam+j];
+      ws.alpha[j*nParam+j]=ws.alpSav[j]+lambda;
     }
-    solve_matrix(beta, alpha, nParam, dp);
+    solve_matrix(ws, ws.beta, ws.alpha, nParam, ws.dp);
 
     nu=2.;
     rho=-1.;
 
     do{
       for(j=0;j<nParam;j++){
-	psav[j] = p[j];
-	p[j] = p[j] + dp[j];
+	ws.pSav[j] = p[j];
+	p[j] = p[j] + ws.dp[j];
       }
-      fgauss(y, p, nParam, nData, res);
-      chiSqr = cal_xi2(res, nData);
-      if (haslimits) {
+      fgauss(y, p, nParam, nData, ws.res);
+      chiSqr = cal_xi2(ws.res, nData);
+      if (plimmin) {
         for(j=0;j<nParam;j++){
           if (p[j]<=plimmin[j] || p[j]>=plimmax[j]) chiSqr*=10000;//penalty for going out of limits!
         }
@@ -334,21 +445,22 @@ namespace gshf{
 
       lzmlh=0.;
       for(j=0;j<nParam;j++){
-	lzmlh+=dp[j]*(lambda*dp[j]+beta[j]);
+	lzmlh+=ws.dp[j]*(lambda*ws.dp[j]+ws.beta[j]);
       }
       rho=2.*(chiSq0-chiSqr)/lzmlh;
       if (rho<0.){
-	for (j=0;j<nParam;j++)p[j]=psav[j];
+	for (j=0;j<nParam;j++)p[j]=ws.pSav[j];
 	chiSqr=chiSq0;
 	lambda = nu*lambda;
 	nu=2.*nu;
 	for(j = 0; j < nParam; j++){
-	  alpha[j*nParam+j]=alpsav[j]+lambda;
+	  ws.alpha[j*nParam+j]=ws.alpSav[j]+lambda;
 	}
-	solve_matrix(beta, alpha, nParam, dp);
+	solve_matrix(ws, ws.beta, ws.alpha, nParam, ws.dp);
       }
     } while(rho<0.);
-    lambda=lambda*fmax(0.333333,1.-pow(2.*rho-1.,3));
+    const double t=2.*rho-1.;
+    lambda=lambda*fmax(0.333333,1.-t*t*t);
     dchiSqr=chiSqr-chiSq0;
     return 0;
 
@@ -18,8 +18,47 @@
 
 namespace gshf{
 
+  /**
+   * @brief Levenberg-Marquardt fitter of a sum of Gaussian functions.
+   *
+   * The data are sampled at the integral abscissae `0` to `nData - 1`; each
+   * Gaussian is described by three consecutive parameters (amplitude, mean
+   * and width), and `nParam` must be a multiple of 3.
+   *
+   * Each call to `mrqdtfit()` performs a single Levenberg-Marquardt step,
+   * updating the parameters and the damping factor `lambda`; the caller
+   * iterates until the change in chi square `dchiSqr` is small enough.
+   *
+   * The working buffers of the fit are kept in a `Workspace`. The overloads
+   * taking a workspace reuse it, so that after the first fit of a given size
+   * no memory is allocated any more; a workspace must not be shared by
+   * concurrent threads. The overloads without a workspace use one private to
+   * the calling thread, so that a single fitter can still be used by many
+   * threads at the same time.
+   */
   class MarqFitAlg {
     public:
+
+      /// Working buffers of the fit, reused across calls.
+      struct Workspace {
+        std::vector<float> res;    ///< residuals (`ndat`)
+        std::vector<float> dydp;   ///< derivatives, parameter-major (`npar x ndat`)
+        std::vector<float> beta;   ///< gradient (`npar`)
+        std::vector<float> alpha;  ///< curvature matrix (`npar x npar`)
+        std::vector<float> alpSav; ///< undamped diagonal of the curvature (`npar`)
+        std::vector<float> pSav;   ///< parameters before the step (`npar`)
+        std::vector<float> dp;     ///< parameter step (`npar`)
+        std::vector<double> chol;  ///< Cholesky factor (`npar x npar`)
+        std::vector<double> tmp;   ///< solution vector of the Cholesky solve (`npar`)
+        std::vector<float> aug;    ///< augmented matrix for Gauss-Jordan (`npar x npar+1`)
+        std::vector<double> inv;   ///< matrix being inverted (`npar x npar`)
+        std::vector<int> ik;       ///< row pivots of the inversion (`npar`)
+        std::vector<int> jk;       ///< column pivots of the inversion (`npar`)
+
+        /// Sizes the buffers for the specified fit.
+        void setup(const int npar, const int ndat);
+      }; // struct Workspace
+
       explicit MarqFitAlg();
       virtual ~MarqFitAlg() {}
 
@@ -27,15 +66,53 @@ namespace gshf{
       int mrqdtfit(float &lambda, float p[], float y[], const int nParam, const int nData, float &chiSqr, float &dchiSqr);
       int mrqdtfit(float &lambda, float p[], float plimmin[], float plimmax[], float y[], const int nParam, const int nData, float &chiSqr, float &dchiSqr);
 
+      /// Same as `cal_perr()`, using the buffers in `ws`.
+      int cal_perr(Workspace &ws, float p[], float y[], const int nParam, const int nData, float perr[]);
+
+      /// Same as `mrqdtfit()`, using the buffers in `ws`.
+      int mrqdtfit(Workspace &ws, float &lambda, float p[], float y[], const int nParam, const int nData, float &chiSqr, float &dchiSqr);
+      int mrqdtfit(Workspace &ws, float &lambda, float p[], float plimmin[], float plimmax[], float y[], const int nParam, const int nData, float &chiSqr, float &dchiSqr);
+
+      /**
+       * @brief Performs one fit step on each of many independent candidates.
+       * @param ws buffers of the fit
+       * @param nFits number of candidates
+       * @param lambda damping factors, one per candidate
+       * @param p parameters, `nParam` consecutive values per candidate
+       * @param y data, `nData` consecutive values per candidate
+       * @param nParam number of parameters of each candidate
+       * @param nData number of data points of each candidate
+       * @param chiSqr (output) chi square, one per candidate
+       * @param dchiSqr (output) change of chi square, one per candidate
+       * @return the number of candidates whose step failed
+       *
+       * The result for each candidate is the same as from a call of the single
+       * candidate `mrqdtfit()` on its parameters and data.
+       * Candidates are processed one after the other, sharing the workspace:
+       * the saving is in the allocations and calls, not in running candidates
+       * in parallel vector lanes.
+       */
+      int mrqdtfit(Workspace &ws, const int nFits, float lambda[], float p[], float y[], const int nParam, const int nData, float chiSqr[], float dchiSqr[]);
+
+      /// Batch version of `mrqdtfit()` with parameter limits common to all candidates.
+      int mrqdtfit(Workspace &ws, const int nFits, float lambda[], float p[], float plimmin[], float plimmax[], float y[], const int nParam, const int nData, float chiSqr[], float dchiSqr[]);
+
+      /// Batch fit step using the buffers of the calling thread.
+      int mrqdtfit(const int nFits, float lambda[], float p[], float y[], const int nParam, const int nData, float chiSqr[], float dchiSqr[]);
+      int mrqdtfit(const int nFits, float lambda[], float p[], float plimmin[], float plimmax[], float y[], const int nParam, const int nData, float chiSqr[], float dchiSqr[]);
+
 
     private:
       //these functions are  called by the public functions
-      void fgauss(const float yd[], const float p[], const int npar, const int ndat, std::vector<float> &res);
-      void dgauss(const float p[], const int npar, const int ndat, std::vector<float> &dydp);
-      float cal_xi2(const std::vector<float> &res, const int ndat);
-      void setup_matrix(const std::vector<float> &res, const std::vector<float> &dydp, const int npar, const int ndat, std::vector<float> &beta, std::vector<float> &alpha);
-      void solve_matrix(const std::vector<float> &beta, const std::vector<float> &alpha, const int npar, std::vector<float> &dp);
-      float invrt_matrix(std::vector<float> &alphaf, const int npar);
+      static Workspace& thread_workspace();
+      static int fit_step(Workspace &ws, float &lambda, float p[], const float plimmin[], const float plimmax[], const float y[], const int nParam, const int nData, float &chiSqr, float &dchiSqr);
+      static void fgauss(const float yd[], const float p[], const int npar, const int ndat, std::vector<float> &res);
+      static void dgauss(const float p[], const int npar, const int ndat, std::vector<float> &dydp);
+      static float cal_xi2(const std::vector<float> &res, const int ndat);
+      static void setup_matrix(const std::vector<float> &res, const std::vector<float> &dydp, const int npar, const int ndat, std::vector<float> &beta, std::vector<float> &alpha);
+      static void solve_matrix(Workspace &ws, const std::vector<float> &beta, const std::vector<float> &alpha, const int npar, std::vector<float> &dp);
+      static void solve_matrix_gj(Workspace &ws, const std::vector<float> &beta, const std::vector<float> &alpha, const int npar, std::vector<float> &dp);
+      static float invrt_matrix(Workspace &ws, std::vector<float> &alphaf, const int npar);
 
   };
 
@@ -0,0 +1,126 @@
+////////////////////////////////////////////////////////////////////////
+//  \file PxHitIndex.cxx
+//
+//  \brief Spatial index of a list of hits on the (wire, time) plane
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "lardata/Utilities/PxHitIndex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace util {
+
+  PxHitIndex::PxHitIndex(std::vector<util::PxHit> const& hits) : PxHitIndex(hits, 0.0, 0.0) {}
+
+  PxHitIndex::PxHitIndex(std::vector<util::PxHit> const& hits,
+                         double const cellSizeW,
+                         double const cellSizeT)
+    : fHits{&hits}, fBox{makeBox(hits, cellSizeW, cellSizeT)}, fGrid{fBox.dims}
+  {
+    std::vector<unsigned int> indices(hits.size());
+    for (std::size_t i = 0; i < indices.size(); ++i)
+      indices[i] = i;
+    fGrid.build(indices, [this](unsigned int i) {
+      util::PxHit const& hit = (*fHits)[i];
+      return cellOf(hit.w, hit.t);
+    });
+  }
+
+  //----------------------------------------------------------------------------
+  PxHitIndex::CellID_t
+  PxHitIndex::cellOf(double const w, double const t) const
+  {
+    return {{cellCoord(w, fBox.minW, fBox.cellW, fBox.dims[0]),
+             cellCoord(t, fBox.minT, fBox.cellT, fBox.dims[1])}};
+  }
+
+  //----------------------------------------------------------------------------
+  std::size_t
+  PxHitIndex::closestHit(double const w,
+                         double const t,
+                         double const scaleW,
+                         double const scaleT,
+                         double const maxDist) const
+  {
+    std::vector<util::PxHit> const& hits = *fHits;
+    double minDist = maxDist;
+    std::size_t closest = hits.size();
+
+    // hits in shell `radius` or beyond are farther than `(radius - 1)` cells
+    double const cellSize =
+      std::min(fBox.cellW * std::abs(scaleW), fBox.cellT * std::abs(scaleT));
+
+    CellID_t const center = cellOf(w, t);
+    CellDimIndex_t const maxRadius = maxShellRadius(center);
+    for (CellDimIndex_t radius = 0; radius <= maxRadius; ++radius) {
+      if ((radius > 0) && ((radius - 1) * cellSize > minDist)) break;
+      forEachInShell(center, radius, [&](unsigned int const iHit) {
+        util::PxHit const& hit = hits[iHit];
+        double const dist = std::hypot((w - hit.w) * scaleW, (t - hit.t) * scaleT);
+        // among equal distances the first hit wins, but only if within maxDist
+        if ((dist < minDist) ||
+            ((dist == minDist) && (closest < hits.size()) && (iHit < closest))) {
+          minDist = dist;
+          closest = iHit;
+        }
+      });
+    }
+    return closest;
+  }
+
+  //----------------------------------------------------------------------------
+  PxHitIndex::Box_t
+  PxHitIndex::makeBox(std::vector<util::PxHit> const& hits, double cellW, double cellT)
+  {
+    Box_t box;
+
+    // extent of the hits (non-finite coordinates end up in the border cells)
+    bool first = true;
+    for (util::PxHit const& hit : hits) {
+      if (!std::isfinite(hit.w) || !std::isfinite(hit.t)) continue;
+      if (first) {
+        box.minW = box.maxW = hit.w;
+        box.minT = box.maxT = hit.t;
+        first = false;
+        continue;
+      }
+      box.minW = std::min(box.minW, hit.w);
+      box.maxW = std::max(box.maxW, hit.w);
+      box.minT = std::min(box.minT, hit.t);
+      box.maxT = std::max(box.maxT, hit.t);
+    }
+    double const rangeW = box.maxW - box.minW;
+    double const rangeT = box.maxT - box.minT;
+
+    if (!(cellW > 0.0) || !(cellT > 0.0)) {
+      // square cells with about two hits each on average;
+      // the longer side of the box never has more cells than half the hits
+      double const n = std::max<double>(hits.size(), 1.0);
+      double side = std::max(std::sqrt(2.0 * rangeW * rangeT / n), 2.0 * std::max(rangeW, rangeT) / n);
+      if (!(side > 0.0) || !std::isfinite(side)) side = 1.0;
+      cellW = cellT = side;
+    }
+    box.cellW = cellW;
+    box.cellT = cellT;
+
+    // the number of cells is capped to keep their count representable
+    double const maxCells = std::numeric_limits<unsigned int>::max() / 2;
+    box.dims[0] = 1U + static_cast<std::size_t>(std::min(std::floor(rangeW / cellW), maxCells));
+    box.dims[1] = 1U + static_cast<std::size_t>(std::min(std::floor(rangeT / cellT), maxCells));
+    return box;
+  }
+
+  //----------------------------------------------------------------------------
+  PxHitIndex::CellDimIndex_t
+  PxHitIndex::cellCoord(double const x, double const min, double const cellSize, std::size_t const n)
+  {
+    double const pos = std::floor((x - min) / cellSize);
+    if (!(pos > 0.0)) return 0; // also NaN
+    if (pos >= static_cast<double>(n - 1)) return n - 1;
+    return static_cast<CellDimIndex_t>(pos);
+  }
+
+} // namespace util
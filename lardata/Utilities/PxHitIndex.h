@@ -0,0 +1,206 @@
+////////////////////////////////////////////////////////////////////////
+// \file PxHitIndex.h
+//
+// \brief Spatial index of a list of hits on the (wire, time) plane
+//
+////////////////////////////////////////////////////////////////////////
+#ifndef UTIL_PXHITINDEX_H
+#define UTIL_PXHITINDEX_H
+
+#include "lardata/Utilities/GridContainers.h"
+#include "lardata/Utilities/PxUtils.h"
+
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace util {
+
+  /**
+   * @brief Spatial index of a list of hits on the (wire, time) plane.
+   *
+   * The hits of the list are distributed in a grid of rectangular cells
+   * according to their `w` and `t` coordinates; each cell holds the indices
+   * of its hits in the list, in increasing order.
+   * The index is built once, and can then be used by many queries (see e.g.
+   * `GeometryUtilities::SelectLocalHitlistIndex()` and
+   * `GeometryUtilities::FindClosestHitIndex()`), each of which visits only the
+   * cells around the point of interest instead of the whole list.
+   *
+   * The index refers to the hit list it was built from, which must stay
+   * unchanged and alive as long as the index is used.
+   *
+   * Example:
+   * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~{.cpp}
+   * util::PxHitIndex const index{hitlist};
+   * for (auto const& startHit : startHits) {
+   *   std::vector<unsigned int> local;
+   *   geomUtils.SelectLocalHitlistIndex(
+   *     index, local, startHit, linearlimit, ortlimit, slope);
+   *   // ...
+   * }
+   * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+   */
+  class PxHitIndex {
+  public:
+    using Grid_t = util::FlatGridContainer2D<unsigned int>; ///< hit indices
+    using CellID_t = Grid_t::CellID_t;
+    using CellDimIndex_t = Grid_t::CellDimIndex_t;
+
+    /// Indexes the hits, with square cells of a size suited to their density.
+    explicit PxHitIndex(std::vector<util::PxHit> const& hits);
+
+    /// Indexes the hits, with cells of the specified sides (same units as hits).
+    PxHitIndex(std::vector<util::PxHit> const& hits, double cellSizeW, double cellSizeT);
+
+    /// Returns the indexed hit list.
+    std::vector<util::PxHit> const&
+    hits() const
+    {
+      return *fHits;
+    }
+
+    /// Returns the number of indexed hits.
+    std::size_t
+    size() const
+    {
+      return fHits->size();
+    }
+
+    /// Returns the side of the cells along the wire coordinate.
+    double
+    cellSizeW() const
+    {
+      return fBox.cellW;
+    }
+
+    /// Returns the side of the cells along the time coordinate.
+    double
+    cellSizeT() const
+    {
+      return fBox.cellT;
+    }
+
+    /// Returns the grid of hit indices.
+    Grid_t const&
+    grid() const
+    {
+      return fGrid;
+    }
+
+    /// Returns the cell of the specified point, moved into the grid if outside.
+    CellID_t cellOf(double w, double t) const;
+
+    /**
+     * @brief Calls `op(index)` for each hit in the cells overlapping a box.
+     * @param wmin lower bound of the box along the wire coordinate
+     * @param wmax upper bound of the box along the wire coordinate
+     * @param tmin lower bound of the box along the time coordinate
+     * @param tmax upper bound of the box along the time coordinate
+     * @param op callable taking the index of a hit in `hits()`
+     *
+     * Hits just outside the box may be included as well, as the whole of each
+     * cell is visited: `op` needs to apply its own selection.
+     */
+    template <typename Op>
+    void forEachInBox(double wmin, double wmax, double tmin, double tmax, Op op) const;
+
+    /**
+     * @brief Calls `op(index)` for each hit in a shell of cells.
+     * @param center the cell the shell is centred on
+     * @param radius distance (in cells) of the shell from `center`
+     * @param op callable taking the index of a hit in `hits()`
+     *
+     * All hits in cells at shell `radius` or more are farther from any point
+     * in `center` than `(radius - 1)` times the shorter cell side.
+     */
+    template <typename Op>
+    void
+    forEachInShell(CellID_t const& center, CellDimIndex_t radius, Op op) const
+    {
+      fGrid.indexManager().forEachInShell(center, radius, [this, &op](auto index) {
+        for (unsigned int const iHit : fGrid[index])
+          op(iHit);
+      });
+    }
+
+    /// Returns the largest shell radius around `center` still in the grid.
+    CellDimIndex_t
+    maxShellRadius(CellID_t const& center) const
+    {
+      return fGrid.indexManager().maxShellRadius(center);
+    }
+
+    /**
+     * @brief Returns the index of the hit closest to the specified point.
+     * @param w wire coordinate of the point
+     * @param t time coordinate of the point
+     * @param scaleW factor converting wire coordinate differences to distance
+     * @param scaleT factor converting time coordinate differences to distance
+     * @param maxDist only hits closer than this are considered
+     * @return the index of the closest hit in `hits()`, `size()` if none
+     *
+     * The distance of a hit is
+     * `std::hypot((w - hit.w) * scaleW, (t - hit.t) * scaleT)`.
+     * Of the hits at the same distance, the first in the list is chosen, so
+     * that the result is the same as from a scan of the whole list.
+     * Cells are visited in shells of increasing distance from the point,
+     * until no closer hit can be found.
+     */
+    std::size_t closestHit(double w,
+                           double t,
+                           double scaleW = 1.0,
+                           double scaleT = 1.0,
+                           double maxDist = std::numeric_limits<double>::max()) const;
+
+  private:
+    /// Placement of the grid on the (wire, time) plane.
+    struct Box_t {
+      double minW = 0.0;
+      double minT = 0.0;
+      double maxW = 0.0;
+      double maxT = 0.0;
+      double cellW = 1.0;
+      double cellT = 1.0;
+      std::array<std::size_t, 2U> dims{{1U, 1U}};
+    };
+
+    std::vector<util::PxHit> const* fHits; ///< the indexed hits
+    Box_t fBox;                            ///< placement of the grid
+    Grid_t fGrid;                          ///< hit indices in each cell
+
+    /// Returns the placement of a grid for `hits` (automatic cell size if not positive).
+    static Box_t makeBox(std::vector<util::PxHit> const& hits, double cellW, double cellT);
+
+    /// Returns the cell coordinate of `x` on a dimension, clamped into the grid.
+    static CellDimIndex_t cellCoord(double x, double min, double cellSize, std::size_t n);
+
+  }; // class PxHitIndex
+
+} // namespace util
+
+//------------------------------------------------------------------------------
+template <typename Op>
+void
+util::PxHitIndex::forEachInBox(double const wmin,
+                               double const wmax,
+                               double const tmin,
+                               double const tmax,
+                               Op op) const
+{
+  if (fHits->empty()) return;
+  if (wmax < fBox.minW || wmin > fBox.maxW || tmax < fBox.minT || tmin > fBox.maxT) return;
+
+  CellID_t const first = cellOf(wmin, tmin);
+  CellID_t const last = cellOf(wmax, tmax);
+  CellID_t cellID;
+  for (cellID[0] = first[0]; cellID[0] <= last[0]; ++cellID[0]) {
+    for (cellID[1] = first[1]; cellID[1] <= last[1]; ++cellID[1]) {
+      for (unsigned int const iHit : fGrid[cellID])
+        op(iHit);
+    }
+  }
+}
+
+#endif // UTIL_PXHITINDEX_H
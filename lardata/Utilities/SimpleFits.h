@@ -5,8 +5,8 @@
  * @date    March 31st, 2015
  *
  * Currently includes:
- *  - LinearFit
- *  -
+ *  - LinearFit, QuadraticFit, GaussianFit
+ *  - PolyFitBatch (LinearFitBatch, QuadraticFitBatch), GaussianFitBatch
  *
  */
 
@@ -22,9 +22,13 @@
 #include <type_traits> // std::enable_if<>, std::is_const<>
 #include <stdexcept> // std::range_error
 #include <ostream> // std::endl
+#include <vector>
+#include <limits> // std::numeric_limits<>
+#include <cstddef> // std::size_t
 
 
 #include "lardataalg/Utilities/StatCollector.h" // lar::util::identity
+#include "lardata/Utilities/CompensatedSum.h"
 #include "lardata/Utilities/FastMatrixMathHelper.h" // lar::util::details::FastMatrixOperations
 
 namespace lar {
@@ -32,41 +36,97 @@ namespace lar {
 
     namespace details {
 
-      /// Class providing data collection for the simple polynomial fitters
-      template <typename T, unsigned int D>
-      class FitDataCollector {
+      /**
+       * @brief Weighted power sums of ( x ; y ) data, as needed by polynomial fits
+       * @tparam T type of the data
+       * @tparam D degree of the polynomial
+       * @tparam S type of each sum (by default, plain `T`)
+       *
+       * Each point @f$ ( x ; y \pm s ) @f$ enters the sums with weight
+       * @f$ w = s^{-2} @f$. The sums of @f$ w x^{k} @f$ are stored for
+       * @f$ k = 0 \ldots 2D @f$ (`x[0]` being the sum of the weights), the sums
+       * of @f$ w x^{k} y @f$ for @f$ k = 0 \ldots D @f$, and the sum of
+       * @f$ w y^{2} @f$ (for the @f$ \chi^{2} @f$).
+       *
+       * The sum type `S` must support `+=` and `-=` with `T` values and with
+       * other `S` sums, and be convertible to `T`; for example,
+       * `lar::util::CompensatedSum<T>` keeps the sums precise when points are
+       * repeatedly added and removed.
+       */
+      template <typename T, unsigned int D, typename S = T>
+      struct FitPowerSums {
+        /// Degree of the fit
+        static constexpr unsigned int Degree = D;
 
-        /**
-         * @details
-         * The "extractor" is just a C++ trick to replace a statement like:
-         *
-         *     (N == 0)? weight.Weights(): sums.template SumN<N>()
-         *
-         * where N is a constexpr number. The problem is that SumN<0> is not
-         * valid (in our case, it raises a static assertion). The analysis of
-         * the full statement shows that it would not be a problem, since the
-         * compiler could remove the ternary operator since it always knows
-         * whether N is 0 or not. Matter of fact, the compiler can also choose
-         * to be dumb and compile the whole thing, including a SumN<0>.
-         *
-         * The trick is in the form of a class that gets specialized for N = 0.
-         * A long list of limitations in C++ (up to 2014 at least) forces the
-         * implementation in a struct.
-         */
-        template <unsigned int Power, unsigned int N>
-        struct SumExtractor {
-          static T Sum
-            (WeightTracker<T> const&, DataTracker<Power, T> const& sums)
-            { return sums.template SumN<N>(); }
-        }; // SumExtractor
-
-        // specialization
-        template <unsigned int Power>
-        struct SumExtractor<Power, 0U> {
-          static T Sum
-            (WeightTracker<T> const& weight, DataTracker<Power, T> const&)
-            { return weight.Weights(); }
-        }; // SumExtractor<>
+        /// Number of sums of x^k/s^2 (including the weights)
+        static constexpr unsigned int NXSums = 2 * Degree + 1;
+
+        /// Number of sums of x^k y/s^2 (including y/s^2)
+        static constexpr unsigned int NXYSums = Degree + 1;
+
+        int n = 0;                   ///< number of points
+        std::array<S, NXSums> x{};   ///< sums of x^k/s^2
+        std::array<S, NXYSums> xy{}; ///< sums of x^k y/s^2
+        S y2 = S(0);                 ///< sum of y^2/s^2
+
+        /// Adds a point with the specified weight (no check is performed)
+        void add(T x_value, T y_value, T w);
+
+        /// Removes a point previously added with the specified weight
+        void remove(T x_value, T y_value, T w);
+
+        /// Adds all the sums from another set
+        template <typename OS>
+        void add(FitPowerSums<T, D, OS> const& other);
+
+        /// Removes all the sums of another set (a subset of this one)
+        template <typename OS>
+        void remove(FitPowerSums<T, D, OS> const& other);
+
+        /// Resets all the sums
+        void clear() { *this = FitPowerSums(); }
+
+      }; // struct FitPowerSums<>
+
+
+      /**
+       * @brief Adds points from contiguous arrays to power sums
+       * @tparam T type of the data
+       * @tparam D degree of the polynomial
+       * @param sums the sums to be increased
+       * @param x array of the x values
+       * @param y array of the y values
+       * @param sy array of the uncertainties on y (if null, all are 1)
+       * @param n number of points in the arrays
+       * @return number of points added
+       *
+       * Points with zero or infinite uncertainty are ignored, as in
+       * `FitDataCollector::add()`.
+       * The points are summed into a local set of sums, which is added to
+       * `sums` at the end.
+       */
+      template <typename T, unsigned int D, typename S>
+      unsigned int accumulatePowerSums(
+        FitPowerSums<T, D, S>& sums,
+        T const* x, T const* y, T const* sy, std::size_t n
+        );
+
+
+      /**
+       * @brief Class providing data collection for the simple polynomial fitters
+       * @tparam T type of the data
+       * @tparam D degree of the polynomial
+       * @tparam S type of the weighted sums (by default, plain `T`)
+       *
+       * Points can be removed (`remove()`) and whole collections merged
+       * (`merge()`) in constant time. With plain sums, the rounding errors
+       * of the removed points stay in the sums; a sliding window fit, moving
+       * along the data adding one point and removing another at each step,
+       * should rather use `S = lar::util::CompensatedSum<T>`, which keeps the
+       * sums precise at the cost of slower additions.
+       */
+      template <typename T, unsigned int D, typename S = T>
+      class FitDataCollector {
 
           public:
         /// Degree of the fit
@@ -75,6 +135,11 @@ namespace lar {
 
         using Data_t = T; ///< type of the data
 
+        using Sum_t = S; ///< type of each of the weighted sums
+
+        /// type of the collected sums
+        using Sums_t = FitPowerSums<Data_t, Degree, Sum_t>;
+
         /// type of measurement without uncertainty
         using Measurement_t = std::tuple<Data_t, Data_t>;
 
@@ -121,6 +186,28 @@ namespace lar {
               add(std::get<0>(value), std::get<1>(value), std::get<2>(value));
           }
 
+        /**
+         * @brief Adds entries from contiguous arrays of x, y and uncertainty
+         * @param x array of the x values
+         * @param y array of the y values
+         * @param sy array of the uncertainties on y
+         * @param n number of entries in the arrays
+         * @return number of points added
+         * @see details::accumulatePowerSums()
+         *
+         * Entries with zero or infinite uncertainty are ignored and not added.
+         * This is equivalent to adding the entries one by one with `add()`,
+         * except that the new entries are summed separately before being
+         * added to the existing sums.
+         */
+        unsigned int add_arrays
+          (Data_t const* x, Data_t const* y, Data_t const* sy, std::size_t n)
+          { return accumulatePowerSums(sums, x, y, sy, n); }
+
+        /// Adds entries from contiguous arrays of x and y (uncertainty 1)
+        unsigned int add_arrays(Data_t const* x, Data_t const* y, std::size_t n)
+          { return add_arrays(x, y, nullptr, n); }
+
 
         /**
          * @brief Adds measurements from a sequence, with no uncertainty
@@ -256,6 +343,43 @@ namespace lar {
 
         ///@}
 
+
+        /// @{
+        /// @name Remove and merge elements
+
+        /**
+         * @brief Removes one entry with specified x, y and uncertainty
+         * @param x value of x
+         * @param y value of y
+         * @param sy value of uncertainty on y (1 by default)
+         * @return whether the point was removed
+         *
+         * The entry must have been added before with the same values, which is
+         * not checked. As in `add()`, if the uncertainty is exactly 0 the entry
+         * is ignored.
+         */
+        bool remove(Data_t x, Data_t y, Data_t sy = Data_t(1.0));
+
+        /// Removes one entry with specified ( x ; y ) and uncertainty
+        bool remove(Measurement_t value, Data_t sy = Data_t(1.0))
+          { return remove(std::get<0>(value), std::get<1>(value), sy); }
+
+        /// Removes one entry with specified ( x ; y ; sy )
+        bool remove(MeasurementAndUncertainty_t value)
+          {
+            return
+              remove(std::get<0>(value), std::get<1>(value), std::get<2>(value));
+          }
+
+        /// Adds all the entries collected by another collector
+        void merge(FitDataCollector const& other) { sums.add(other.sums); }
+
+        /// Removes all the entries of another collector (must be a subset)
+        void remove(FitDataCollector const& other) { sums.remove(other.sums); }
+
+        /// @}
+
+
         /// Clears all the statistics
         void clear();
 
@@ -263,7 +387,7 @@ namespace lar {
         /// @name Statistic retrieval
 
         /// Returns the number of entries added
-        int N() const { return s2.N(); }
+        int N() const { return sums.n; }
 
         /**
          * @brief Returns an average of the uncertainties
@@ -274,8 +398,7 @@ namespace lar {
          * (that is, the errors squared):
          * @f$ \bar{s}^{-2} = \frac{1}{N} \sum_{i=1}^{N} s_{y}^{-2} @f$
          */
-        Data_t AverageUncertainty() const
-          { return WeightToUncertainty(s2.AverageWeight()); }
+        Data_t AverageUncertainty() const;
 
 
         /// Returns the square of the specified value
@@ -284,27 +407,35 @@ namespace lar {
 
 
         /// Returns the weighted sum of x^n
-        Data_t XN(unsigned int n) const
-          { return (n == 0)? s2.Weights(): x.Sum(n); }
+        Data_t XN(unsigned int n) const { return sums.x[n]; }
 
         /// Returns the weighted sum of x^n y
-        Data_t XNY(unsigned int n) const
-          { return (n == 0)? y.Weights(): xy.Sum(n); }
+        Data_t XNY(unsigned int n) const { return sums.xy[n]; }
 
 
         /// Returns the weighted sum of x^N
         template <unsigned int N>
         Data_t XN() const
-          { return SumExtractor<decltype(x)::Power, N>::Sum(s2, x); }
+          {
+            static_assert(N < Sums_t::NXSums, "Invalid power of x");
+            return std::get<N>(sums.x);
+          }
 
         /// Returns the weighted sum of x^N y
         template <unsigned int N>
         Data_t XNY() const
-          { return SumExtractor<decltype(xy)::Power, N>::Sum(y, xy); }
+          {
+            static_assert(N < Sums_t::NXYSums, "Invalid power of x");
+            return std::get<N>(sums.xy);
+          }
 
 
         /// Returns the weighted sum of y^2
-        Data_t Y2() const { return y2.template SumN<1>(); }
+        Data_t Y2() const { return sums.y2; }
+
+
+        /// Returns all the sums collected so far
+        Sums_t const& Sums() const { return sums; }
 
 
         /// @}
@@ -324,25 +455,21 @@ namespace lar {
 
           protected:
 
-        WeightTracker<Data_t> s2;        ///< accumulator for uncertainty
-        DataTracker<Degree*2, Data_t> x; ///< accumulator for variable x^k
-        WeightTracker<Data_t> y;         ///< accumulator for y
-        DataTracker<1, Data_t> y2;       ///< accumulator for y2
-        DataTracker<Degree, Data_t> xy;  ///< accumulator for variable xy
+        Sums_t sums; ///< accumulator of all the weighted sums
 
       }; // class FitDataCollector<>
 
 
-      template <typename T, unsigned int D>
+      template <typename T, unsigned int D, typename S>
       inline std::ostream& operator<<
-        (std::ostream& out, FitDataCollector<T, D> const& stats)
+        (std::ostream& out, FitDataCollector<T, D, S> const& stats)
         { stats.Print(out); return out; }
 
 
       /// Base class providing data collection for the simple polynomial fitters
-      template <typename T, unsigned int D>
+      template <typename T, unsigned int D, typename S = T>
       class SimplePolyFitterDataBase {
-        using Collector_t = FitDataCollector<T, D>; ///< class storing input
+        using Collector_t = FitDataCollector<T, D, S>; ///< class storing input
 
           public:
         /// Degree of the fit
@@ -350,6 +477,9 @@ namespace lar {
 
         using Data_t = typename Collector_t::Data_t; ///< type of the data
 
+        /// type of each of the weighted sums
+        using Sum_t = typename Collector_t::Sum_t;
+
         /// type of measurement without uncertainty
         using Measurement_t = typename Collector_t::Measurement_t;
 
@@ -372,6 +502,13 @@ namespace lar {
         bool add(MeasurementAndUncertainty_t value)
           { return stats.add(value); }
 
+        unsigned int add_arrays
+          (Data_t const* x, Data_t const* y, Data_t const* sy, std::size_t n)
+          { return stats.add_arrays(x, y, sy, n); }
+
+        unsigned int add_arrays(Data_t const* x, Data_t const* y, std::size_t n)
+          { return stats.add_arrays(x, y, n); }
+
 
         template <typename Iter>
         void add_without_uncertainty(Iter begin, Iter end)
@@ -417,6 +554,31 @@ namespace lar {
 
         ///@}
 
+
+        /// @{
+        /// @name Remove and merge elements
+        /// @see FitDataCollector
+
+        bool remove(Data_t x, Data_t y, Data_t sy = Data_t(1.0))
+          { return stats.remove(x, y, sy); }
+
+        bool remove(Measurement_t value, Data_t sy = Data_t(1.0))
+          { return stats.remove(value, sy); }
+
+        bool remove(MeasurementAndUncertainty_t value)
+          { return stats.remove(value); }
+
+        /// Adds all the points collected by another fitter
+        void merge(SimplePolyFitterDataBase const& other)
+          { stats.merge(other.stats); }
+
+        /// Removes all the points of another fitter (must be a subset)
+        void remove(SimplePolyFitterDataBase const& other)
+          { stats.remove(other.stats); }
+
+        ///@}
+
+
         /// Clears all the statistics
         void clear() { stats.clear(); }
 
@@ -633,13 +795,13 @@ namespace lar {
 
 
       /// Base class providing virtual fitting interface for polynomial fitters
-      template <typename T, unsigned int D>
+      template <typename T, unsigned int D, typename S = T>
       class SimplePolyFitterBase:
         public SimpleFitterInterface<T, D + 1>,
-        public SimplePolyFitterDataBase<T, D>
+        public SimplePolyFitterDataBase<T, D, S>
       {
         using Interface_t = SimpleFitterInterface<T, D + 1>; ///< interface
-        using Base_t = SimplePolyFitterDataBase<T, D>; ///< class storing input
+        using Base_t = SimplePolyFitterDataBase<T, D, S>; ///< class storing input
 
           public:
         using Base_t::sqr;
@@ -828,7 +990,7 @@ namespace lar {
     /** ************************************************************************
      * @brief Performs a linear regression of data
      * @tparam T type of the quantities
-     * @tparam W type of the weight (as T by default)
+     * @tparam S type of the weighted sums (as T by default)
      *
      * The linear regression connects measurements
      * @f$ ( y_{i} \pm \sigma_{y,i} ) @f$ with a parameter @f$ ( x_{i} ) @f$
@@ -844,10 +1006,14 @@ namespace lar {
      * In particular that is true also for ChiSquare(), that requires the full
      * parameters set and therefore reruns the full fit (FitParameters())
      * and for the covariance matrix of the parameters.
+     *
+     * Points can be removed and fitters merged (see
+     * `details::FitDataCollector`); for a sliding window, use
+     * `LinearFit<T, lar::util::CompensatedSum<T>>`.
      */
-    template <typename T>
-    class LinearFit: public details::SimplePolyFitterBase<T, 1U> {
-      using Base_t = details::SimplePolyFitterBase<T, 1U>;
+    template <typename T, typename S = T>
+    class LinearFit: public details::SimplePolyFitterBase<T, 1U, S> {
+      using Base_t = details::SimplePolyFitterBase<T, 1U, S>;
 
         public:
       using Base_t::Degree;
@@ -932,7 +1098,7 @@ namespace lar {
     /** ************************************************************************
      * @brief Performs a second-degree fit of data
      * @tparam T type of the quantities
-     * @tparam W type of the weight (as T by default)
+     * @tparam S type of the weighted sums (as T by default)
      *
      * The quadratic fit connects measurements
      * @f$ ( y_{i} \pm \sigma_{y,i} ) @f$ with a parameter @f$ ( x_{i} ) @f$
@@ -948,10 +1114,14 @@ namespace lar {
      * In particular that is true also for ChiSquare(), that requires the full
      * parameters set and therefore reruns the full fit (FitParameters())
      * and for the covariance matrix of the parameters.
+     *
+     * Points can be removed and fitters merged (see
+     * `details::FitDataCollector`); for a sliding window, use
+     * `QuadraticFit<T, lar::util::CompensatedSum<T>>`.
      */
-    template <typename T>
-    class QuadraticFit: public details::SimplePolyFitterBase<T, 2U> {
-      using Base_t = details::SimplePolyFitterBase<T, 2U>;
+    template <typename T, typename S = T>
+    class QuadraticFit: public details::SimplePolyFitterBase<T, 2U, S> {
+      using Base_t = details::SimplePolyFitterBase<T, 2U, S>;
 
         public:
       using Base_t::Degree;
@@ -999,9 +1169,13 @@ namespace lar {
 
 
 
+    template <typename T>
+    class GaussianFitBatch;
+
     /** **********************************************************************
      * @brief "Fast" Gaussian fit
      * @tparam T data type
+     * @tparam S type of the weighted sums (as T by default)
      *
      * This class performs a Gaussian fit on demand.
      * This fit translates the data to its logarithm and then internally
@@ -1014,10 +1188,10 @@ namespace lar {
      * not documented here -- see the base class(es) documentation
      * (mostly SimplePolyFitterBase).
      */
-    template <typename T>
+    template <typename T, typename S = T>
     class GaussianFit: public details::SimpleFitterInterface<T, 3> {
       using Base_t = details::SimpleFitterInterface<T, 3>; ///< base class
-      using Fitter_t = QuadraticFit<T>; ///< base class
+      using Fitter_t = QuadraticFit<T, S>; ///< base class
 
         public:
       /// Number of parameters in the fit
@@ -1056,6 +1230,14 @@ namespace lar {
             add(std::get<0>(value), std::get<1>(value), std::get<2>(value));
         }
 
+      unsigned int add_arrays
+        (Data_t const* x, Data_t const* y, Data_t const* sy, std::size_t n);
+
+      /// Adds entries from arrays; as `add_without_uncertainty()`, the encoded
+      /// values are given uncertainty 1
+      unsigned int add_arrays(Data_t const* x, Data_t const* y, std::size_t n)
+        { return add_arrays(x, y, nullptr, n); }
+
 
       template <typename Iter>
       void add_without_uncertainty(Iter begin, Iter end)
@@ -1093,6 +1275,25 @@ namespace lar {
         { return add_with_uncertainty(std::begin(cont), std::end(cont)); }
 
 
+      /// Removes a point previously added with the same values
+      bool remove(Data_t x, Data_t y, Data_t sy = Data_t(1.0));
+
+      bool remove(Measurement_t value, Data_t sy = Data_t(1.0))
+        { return remove(std::get<0>(value), std::get<1>(value), sy); }
+
+      bool remove(MeasurementAndUncertainty_t value)
+        {
+          return
+            remove(std::get<0>(value), std::get<1>(value), std::get<2>(value));
+        }
+
+      /// Adds all the points collected by another fitter
+      void merge(GaussianFit const& other) { fitter.merge(other.fitter); }
+
+      /// Removes all the points of another fitter (must be a subset)
+      void remove(GaussianFit const& other) { fitter.remove(other.fitter); }
+
+
       /// Clears all the input statistics
       void clear() { fitter.clear(); }
 
@@ -1425,9 +1626,332 @@ namespace lar {
       static void ThrowNotImplemented [[noreturn]] (std::string method)
         { throw std::logic_error("Method " + method + "() not implemented"); }
 
+      // the batch fitter shares the parameter conversions
+      template <typename> friend class GaussianFitBatch;
+
     }; // class GaussianFit<>
 
 
+
+    /** ************************************************************************
+     * @brief Polynomial fits of many independent datasets
+     * @tparam T type of the quantities
+     * @tparam D degree of the polynomial
+     *
+     * This class performs the same fit as `LinearFit` (`D = 1`) and
+     * `QuadraticFit` (`D = 2`) on many independent datasets at once, e.g. one
+     * per hit or per cluster.
+     * The statistics of all datasets are stored in a structure-of-arrays
+     * layout, and no virtual call is involved.
+     *
+     * Each dataset is added in full from contiguous arrays of x, y and,
+     * optionally, uncertainty on y; the power sums are accumulated by
+     * `details::accumulatePowerSums()`.
+     * The parameters are obtained with a single matrix inversion per dataset.
+     * Fit results are computed on demand for a single dataset, or for all of
+     * them with `FitAll()`:
+     * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~{.cpp}
+     * lar::util::LinearFitBatch<float> fits;
+     * fits.add(nClusters, offsets.data(), x.data(), y.data(), sy.data());
+     *
+     * std::vector<lar::util::LinearFitBatch<float>::FitParameters_t>
+     *   params(fits.size());
+     * std::vector<float> chi2(fits.size());
+     * fits.FitAll(params.data(), nullptr, chi2.data());
+     * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+     * fits one line on each cluster, whose points are in the ranges of `x`, `y`
+     * and `sy` delimited by consecutive entries of `offsets`.
+     */
+    template <typename T, unsigned int D>
+    class PolyFitBatch {
+      using Sums_t = details::FitPowerSums<T, D>; ///< sums of a dataset
+
+        public:
+      /// Degree of the fit
+      static constexpr unsigned int Degree = D;
+
+      /// Number of parameters in the fit
+      static constexpr unsigned int NParams = Degree + 1;
+
+      using Data_t = T; ///< type of the data
+
+      using MatrixOps = details::FastMatrixOperations<Data_t, NParams>;
+
+      /// type of set of fit parameters
+      using FitParameters_t = std::array<Data_t, NParams>;
+
+      /// type of matrix for covariance (a std::array)
+      using FitMatrix_t = typename MatrixOps::Matrix_t;
+
+
+      // default constructor, destructor and all the rest
+
+      /// @{
+      /// @name Add datasets
+
+      /// Prepares room for the specified number of datasets
+      void reserve(std::size_t n);
+
+      /**
+       * @brief Adds a dataset from contiguous arrays
+       * @param x array of the x values
+       * @param y array of the y values
+       * @param sy array of the uncertainties on y (if null, all are 1)
+       * @param n number of points in the arrays
+       * @return the index of the new dataset
+       *
+       * Points with zero or infinite uncertainty are ignored.
+       */
+      std::size_t add
+        (Data_t const* x, Data_t const* y, Data_t const* sy, std::size_t n);
+
+      /// Adds a dataset from contiguous arrays of x and y (uncertainty 1)
+      std::size_t add(Data_t const* x, Data_t const* y, std::size_t n)
+        { return add(x, y, nullptr, n); }
+
+      /**
+       * @brief Adds many datasets stored one after the other
+       * @param nSets number of datasets
+       * @param offsets index of the first point of each dataset, and one more
+       * @param x array of the x values
+       * @param y array of the y values
+       * @param sy array of the uncertainties on y (if null, all are 1)
+       *
+       * Dataset `i` is made of the points from `offsets[i]` to
+       * `offsets[i + 1]` (excluded), so that `offsets` has `nSets + 1`
+       * entries. The new datasets are appended after the existing ones.
+       */
+      void add(
+        std::size_t nSets, std::size_t const* offsets,
+        Data_t const* x, Data_t const* y, Data_t const* sy = nullptr
+        );
+
+      /// Removes all the datasets
+      void clear();
+
+      /// @}
+
+
+      /// @{
+      /// @name Statistic retrieval
+
+      /// Returns the number of datasets
+      std::size_t size() const { return fN.size(); }
+
+      /// Returns whether there is no dataset
+      bool empty() const { return fN.empty(); }
+
+      /// Returns the number of (valid) points of the dataset `i`
+      int N(std::size_t i) const { return fN[i]; }
+
+      /// Returns the degrees of freedom of the fit of the dataset `i`
+      int NDF(std::size_t i) const { return N(i) - int(NParams); }
+
+      /// @}
+
+
+      /// @{
+      /// @name Fitting
+
+      /// Returns whether the fit of the dataset `i` has valid results
+      bool isValid(std::size_t i) const;
+
+      /**
+       * @brief Fills the results of the fit of the dataset `i`
+       * @param i index of the dataset
+       * @param params the fitted values of the parameters
+       * @param Xmat the matrix of the x^n/s^2 sums
+       * @param det the determinant of Xmat
+       * @param Smat the covariance matrix
+       * @return true if the fit is valid (i.e. if a unique solution exists)
+       * @see details::SimplePolyFitterBase::FillResults()
+       */
+      bool FillResults(
+        std::size_t i, FitParameters_t& params,
+        FitMatrix_t& Xmat, Data_t& det, FitMatrix_t& Smat
+        ) const;
+
+      /// Fills the parameters and their errors of the fit of the dataset `i`
+      bool FillResults
+        (std::size_t i, FitParameters_t& params, FitParameters_t& paramerrors)
+        const;
+
+      /**
+       * @brief Computes and returns the parameters of the fit of dataset `i`
+       * @throws std::range_error if there is no unique solution
+       */
+      FitParameters_t FitParameters(std::size_t i) const;
+
+      /// Returns the @f$ \chi^{2} @f$ of the dataset `i` with given parameters
+      Data_t ChiSquare(std::size_t i, FitParameters_t const& params) const;
+
+      /// Returns the @f$ \chi^{2} @f$ of the fit of the dataset `i`
+      Data_t ChiSquare(std::size_t i) const
+        { return ChiSquare(i, FitParameters(i)); }
+
+      /**
+       * @brief Fits all the datasets
+       * @param params (output) parameters, one set per dataset
+       * @param paramerrors (output) parameter errors, one set per dataset
+       * @param chiSquares (output) @f$ \chi^{2} @f$, one per dataset
+       * @param valid (output) whether each fit is valid
+       * @return the number of valid fits
+       *
+       * All the output arrays must have room for `size()` elements; all but
+       * `params` can be null, in which case that output is not produced.
+       * Parameters of invalid fits are set to 0.
+       */
+      std::size_t FitAll(
+        FitParameters_t* params, FitParameters_t* paramerrors = nullptr,
+        Data_t* chiSquares = nullptr, bool* valid = nullptr
+        ) const;
+
+      /// @}
+
+
+      /// Evaluates a polynomial with the specified parameters at one point
+      static Data_t Evaluate(Data_t x, FitParameters_t const& params);
+
+
+        protected:
+      std::vector<int> fN; ///< number of points of each dataset
+
+      /// sums of x^k/s^2, one vector per power
+      std::array<std::vector<Data_t>, Sums_t::NXSums> fX;
+
+      /// sums of x^k y/s^2, one vector per power
+      std::array<std::vector<Data_t>, Sums_t::NXYSums> fXY;
+
+      std::vector<Data_t> fY2; ///< sums of y^2/s^2
+
+      /// Sets the number of datasets (new ones are empty)
+      void resize(std::size_t n);
+
+      /// Stores the specified sums as the ones of dataset `i`
+      void store(std::size_t i, Sums_t const& sums);
+
+      /// Fills and returns the matrix of x^n sum coefficients of dataset `i`
+      FitMatrix_t MakeMatrixX(std::size_t i) const;
+
+      /// Fills and returns the vector of x^n y sum coefficients of dataset `i`
+      FitParameters_t MakeMatrixY(std::size_t i) const;
+
+    }; // class PolyFitBatch<>
+
+
+    /// Linear fits of many independent datasets
+    template <typename T>
+    using LinearFitBatch = PolyFitBatch<T, 1U>;
+
+    /// Quadratic fits of many independent datasets
+    template <typename T>
+    using QuadraticFitBatch = PolyFitBatch<T, 2U>;
+
+
+
+    /** ************************************************************************
+     * @brief "Fast" Gaussian fits of many independent datasets
+     * @tparam T data type
+     *
+     * This class performs the same fit as `GaussianFit` on many independent
+     * datasets, by means of a `QuadraticFitBatch` on the logarithm of the data.
+     * As in `GaussianFit`, non-positive values are ignored.
+     * The interface follows `PolyFitBatch`.
+     */
+    template <typename T>
+    class GaussianFitBatch {
+      using Fitter_t = QuadraticFitBatch<T>; ///< the actual fitter
+      using Gaussian_t = GaussianFit<T>; ///< single fitter (for conversions)
+
+        public:
+      /// Number of parameters in the fit
+      static constexpr unsigned int NParams = Gaussian_t::NParams;
+
+      using Data_t = T; ///< type of the data
+
+      using FitParameters_t = typename Fitter_t::FitParameters_t;
+      using FitMatrix_t = typename Fitter_t::FitMatrix_t;
+
+
+      /// @{
+      /// @name Add datasets
+      /// @see PolyFitBatch
+
+      void reserve(std::size_t n) { fitter.reserve(n); }
+
+      /**
+       * @brief Adds a dataset from contiguous arrays
+       * @param x array of the x values
+       * @param y array of the y values
+       * @param sy array of the uncertainties on y (if null, see below)
+       * @param n number of points in the arrays
+       * @return the index of the new dataset
+       *
+       * If no uncertainty is specified, as in
+       * `GaussianFit::add_without_uncertainty()`, the logarithm of each value
+       * is given uncertainty 1.
+       */
+      std::size_t add
+        (Data_t const* x, Data_t const* y, Data_t const* sy, std::size_t n);
+
+      std::size_t add(Data_t const* x, Data_t const* y, std::size_t n)
+        { return add(x, y, nullptr, n); }
+
+      void add(
+        std::size_t nSets, std::size_t const* offsets,
+        Data_t const* x, Data_t const* y, Data_t const* sy = nullptr
+        );
+
+      void clear() { fitter.clear(); }
+
+      /// @}
+
+
+      std::size_t size() const { return fitter.size(); }
+      bool empty() const { return fitter.empty(); }
+      int N(std::size_t i) const { return fitter.N(i); }
+      int NDF(std::size_t i) const { return fitter.NDF(i); }
+
+
+      /// @{
+      /// @name Fitting
+
+      /// Fills the Gaussian parameters (amplitude, mean, sigma) and errors
+      bool FillResults
+        (std::size_t i, FitParameters_t& params, FitParameters_t& paramerrors)
+        const;
+
+      /// Returns the @f$ \chi^{2} @f$ of the internal quadratic fit
+      Data_t ChiSquare(std::size_t i) const { return fitter.ChiSquare(i); }
+
+      /// Fits all the datasets (see `PolyFitBatch::FitAll()`)
+      std::size_t FitAll(
+        FitParameters_t* params, FitParameters_t* paramerrors = nullptr,
+        bool* valid = nullptr
+        ) const;
+
+      /// @}
+
+
+      /// Returns the internal fitter (mostly for debugging)
+      Fitter_t const& Fitter() const { return fitter; }
+
+
+        protected:
+      Fitter_t fitter; ///< the actual fitter and data holder
+
+      // buffers for the encoded data
+      std::vector<Data_t> fEncX; ///< encoded x values
+      std::vector<Data_t> fEncY; ///< encoded y values
+      std::vector<Data_t> fEncS; ///< encoded uncertainties on y
+
+      /// Encodes the points of a dataset into the buffers; returns their number
+      std::size_t Encode
+        (Data_t const* x, Data_t const* y, Data_t const* sy, std::size_t n);
+
+    }; // class GaussianFitBatch<>
+
+
   } // namespace util
 } // namespace lar
 
@@ -1437,33 +1961,131 @@ namespace lar {
 //==============================================================================
 
 
+//******************************************************************************
+//***  FitPowerSums<>
+//***
+
+template <typename T, unsigned int D, typename S>
+inline void lar::util::details::FitPowerSums<T, D, S>::add
+  (T x_value, T y_value, T w)
+{
+  ++n;
+  T wxk = w;
+  T wyxk = w * y_value;
+  y2 += wyxk * y_value;
+  for (unsigned int k = 0; k < NXSums; ++k) {
+    x[k] += wxk;
+    wxk *= x_value;
+    if (k < NXYSums) {
+      xy[k] += wyxk;
+      wyxk *= x_value;
+    }
+  } // for
+} // FitPowerSums<>::add(T, T, T)
+
+
+template <typename T, unsigned int D, typename S>
+inline void lar::util::details::FitPowerSums<T, D, S>::remove
+  (T x_value, T y_value, T w)
+{
+  --n;
+  T wxk = w;
+  T wyxk = w * y_value;
+  y2 -= wyxk * y_value;
+  for (unsigned int k = 0; k < NXSums; ++k) {
+    x[k] -= wxk;
+    wxk *= x_value;
+    if (k < NXYSums) {
+      xy[k] -= wyxk;
+      wyxk *= x_value;
+    }
+  } // for
+} // FitPowerSums<>::remove(T, T, T)
+
+
+template <typename T, unsigned int D, typename S>
+template <typename OS>
+inline void lar::util::details::FitPowerSums<T, D, S>::add
+  (FitPowerSums<T, D, OS> const& other)
+{
+  n += other.n;
+  for (unsigned int k = 0; k < NXSums; ++k) x[k] += other.x[k];
+  for (unsigned int k = 0; k < NXYSums; ++k) xy[k] += other.xy[k];
+  y2 += other.y2;
+} // FitPowerSums<>::add(FitPowerSums)
+
+
+template <typename T, unsigned int D, typename S>
+template <typename OS>
+inline void lar::util::details::FitPowerSums<T, D, S>::remove
+  (FitPowerSums<T, D, OS> const& other)
+{
+  n -= other.n;
+  for (unsigned int k = 0; k < NXSums; ++k) x[k] -= other.x[k];
+  for (unsigned int k = 0; k < NXYSums; ++k) xy[k] -= other.xy[k];
+  y2 -= other.y2;
+} // FitPowerSums<>::remove(FitPowerSums)
+
+
+template <typename T, unsigned int D, typename S>
+unsigned int lar::util::details::accumulatePowerSums(
+  FitPowerSums<T, D, S>& sums,
+  T const* x, T const* y, T const* sy, std::size_t n
+) {
+  // a weight is normal if in this range (NaN is excluded too)
+  constexpr T minWeight = std::numeric_limits<T>::min();
+  constexpr T maxWeight = std::numeric_limits<T>::max();
+
+  // local sums, that the compiler can keep in registers for the whole loop
+  FitPowerSums<T, D> local;
+  if (sy) {
+    for (std::size_t i = 0; i < n; ++i) {
+      T const w = T(1) / (sy[i] * sy[i]);
+      if ((w < minWeight) || (w > maxWeight)) continue;
+      local.add(x[i], y[i], w);
+    } // for
+  }
+  else {
+    for (std::size_t i = 0; i < n; ++i) local.add(x[i], y[i], T(1));
+  }
+  sums.add(local);
+  return local.n;
+} // accumulatePowerSums()
+
+
 //******************************************************************************
 //***  FitDataCollector<>
 //***
 
-template <typename T, unsigned int D>
-bool lar::util::details::FitDataCollector<T, D>::add
+template <typename T, unsigned int D, typename S>
+bool lar::util::details::FitDataCollector<T, D, S>::add
   (Data_t x_value, Data_t y_value, Data_t sy /* = Data_t(1.0) */)
 {
   Data_t w = UncertaintyToWeight(sy);
   if (!std::isnormal(w)) return false;
-  // the x section has a 1/s^2 weight; we track that weight separately
-  s2.add(w);
-  x.add(x_value, w);
-  // we treat the y section as if it were a x section with a y/s^2 weight;
-  // we track that weight separately
-  Data_t yw = y_value * w;
-  y.add(yw);
-  y2.add(sqr(y_value), w); // used only for chi^2
-  xy.add(x_value, yw);
+  // the x section has a 1/s^2 weight, the y section a y/s^2 weight;
+  // y^2/s^2 is used only for chi^2
+  sums.add(x_value, y_value, w);
 
   return true; // we did add the value
 } // FitDataCollector<>::add()
 
 
-template <typename T, unsigned int D>
+template <typename T, unsigned int D, typename S>
+bool lar::util::details::FitDataCollector<T, D, S>::remove
+  (Data_t x_value, Data_t y_value, Data_t sy /* = Data_t(1.0) */)
+{
+  Data_t w = UncertaintyToWeight(sy);
+  if (!std::isnormal(w)) return false;
+  sums.remove(x_value, y_value, w);
+
+  return true; // we did remove the value
+} // FitDataCollector<>::remove()
+
+
+template <typename T, unsigned int D, typename S>
 template <typename Iter, typename Pred>
-void lar::util::details::FitDataCollector<T, D>::add_without_uncertainty
+void lar::util::details::FitDataCollector<T, D, S>::add_without_uncertainty
   (Iter begin, Iter end, Pred extractor)
 {
   std::for_each
@@ -1471,10 +2093,10 @@ void lar::util::details::FitDataCollector<T, D>::add_without_uncertainty
 } // FitDataCollector<>::add_without_uncertainty(Iter, Pred)
 
 
-template <typename T, unsigned int D>
+template <typename T, unsigned int D, typename S>
 template <typename VIter, typename UIter, typename VPred, typename UPred>
 unsigned int
-lar::util::details::FitDataCollector<T, D>::add_with_uncertainty(
+lar::util::details::FitDataCollector<T, D, S>::add_with_uncertainty(
   VIter begin_value, VIter end_value,
   UIter begin_uncertainty,
   VPred value_extractor,
@@ -1493,9 +2115,9 @@ lar::util::details::FitDataCollector<T, D>::add_with_uncertainty(
 } // FitDataCollector<>::add_with_uncertainty(VIter, VIter, UIter, VPred, UPred)
 
 
-template <typename T, unsigned int D>
+template <typename T, unsigned int D, typename S>
 template <typename Iter>
-unsigned int lar::util::details::FitDataCollector<T, D>::add_with_uncertainty
+unsigned int lar::util::details::FitDataCollector<T, D, S>::add_with_uncertainty
   (Iter begin, Iter end)
 {
   unsigned int old_n = N();
@@ -1505,30 +2127,38 @@ unsigned int lar::util::details::FitDataCollector<T, D>::add_with_uncertainty
 
 
 
-template <typename T, unsigned int D>
-inline void lar::util::details::FitDataCollector<T, D>::clear() {
-  s2.clear();
-  x.clear();
-  y.clear();
-  y2.clear();
-  xy.clear();
+template <typename T, unsigned int D, typename S>
+inline void lar::util::details::FitDataCollector<T, D, S>::clear() {
+  sums.clear();
 } // FitDataCollector<>::clear()
 
 
-template <typename T, unsigned int D> template <typename Stream>
-void lar::util::details::FitDataCollector<T, D>::Print(Stream& out) const {
+template <typename T, unsigned int D, typename S>
+auto lar::util::details::FitDataCollector<T, D, S>::AverageUncertainty() const
+  -> Data_t
+{
+  if (N() == 0) {
+    throw std::range_error
+      ("FitDataCollector::AverageUncertainty(): no entries");
+  }
+  return WeightToUncertainty(XN(0) / N());
+} // FitDataCollector<>::AverageUncertainty()
+
+
+template <typename T, unsigned int D, typename S> template <typename Stream>
+void lar::util::details::FitDataCollector<T, D, S>::Print(Stream& out) const {
 
-  out << "Sums  1/s^2=" << s2.Weights()
-    << "\n      x/s^2=" << x.template SumN<1>();
-  for (unsigned int degree = 2; degree <= x.Power; ++degree)
-    out << "\n    x^" << degree << "/s^2=" << x.Sum(degree);
+  out << "Sums  1/s^2=" << XN(0)
+    << "\n      x/s^2=" << XN(1);
+  for (unsigned int degree = 2; degree < Sums_t::NXSums; ++degree)
+    out << "\n    x^" << degree << "/s^2=" << XN(degree);
   out
-    << "\n      y/s^2=" << y.Weights()
-    << "\n    y^2/s^2=" << y2.Sum();
-  if (xy.Power >= 1)
-    out << "\n     xy/s^2=" << xy.template SumN<1>();
-  for (unsigned int degree = 2; degree <= xy.Power; ++degree)
-    out << "\n   x^" << degree << "y/s^2=" << xy.Sum(degree);
+    << "\n      y/s^2=" << XNY(0)
+    << "\n    y^2/s^2=" << Y2();
+  if (Degree >= 1)
+    out << "\n     xy/s^2=" << XNY(1);
+  for (unsigned int degree = 2; degree < Sums_t::NXYSums; ++degree)
+    out << "\n   x^" << degree << "y/s^2=" << XNY(degree);
   out << std::endl;
 } // FitDataCollector<>::Print()
 
@@ -1536,23 +2166,23 @@ void lar::util::details::FitDataCollector<T, D>::Print(Stream& out) const {
 //******************************************************************************
 //***  SimplePolyFitterBase<>
 //***
-template <typename T, unsigned int D>
-inline bool lar::util::details::SimplePolyFitterBase<T, D>::isValid() const {
+template <typename T, unsigned int D, typename S>
+inline bool lar::util::details::SimplePolyFitterBase<T, D, S>::isValid() const {
   return (Base_t::N() > (int) Degree)
     && std::isnormal(Determinant(MakeMatrixX()));
 } // SimplePolyFitterBase<>::isValid()
 
 
-template <typename T, unsigned int D>
-inline auto lar::util::details::SimplePolyFitterBase<T, D>::FitParameter
+template <typename T, unsigned int D, typename S>
+inline auto lar::util::details::SimplePolyFitterBase<T, D, S>::FitParameter
   (unsigned int n) const -> Data_t
 {
   return Param(n, MakeMatrixX());
 } // SimplePolyFitterBase<>::FitParameter(unsigned int)
 
 
-template <typename T, unsigned int D>
-auto lar::util::details::SimplePolyFitterBase<T, D>::FitParameterError
+template <typename T, unsigned int D, typename S>
+auto lar::util::details::SimplePolyFitterBase<T, D, S>::FitParameterError
   (unsigned int n) const -> Data_t
 {
   if (n > Degree) return Data_t(0); // no parameter, no error
@@ -1560,8 +2190,8 @@ auto lar::util::details::SimplePolyFitterBase<T, D>::FitParameterError
 } // SimplePolyFitterBase<>::FitParameterError()
 
 
-template <typename T, unsigned int D>
-auto lar::util::details::SimplePolyFitterBase<T, D>::FitParameters() const
+template <typename T, unsigned int D, typename S>
+auto lar::util::details::SimplePolyFitterBase<T, D, S>::FitParameters() const
   -> FitParameters_t
 {
   FitMatrix_t Xmat = MakeMatrixX();
@@ -1572,16 +2202,16 @@ auto lar::util::details::SimplePolyFitterBase<T, D>::FitParameters() const
 } // SimplePolyFitterBase<>::FitParameters()
 
 
-template <typename T, unsigned int D>
-auto lar::util::details::SimplePolyFitterBase<T, D>::FitParameterErrors() const
+template <typename T, unsigned int D, typename S>
+auto lar::util::details::SimplePolyFitterBase<T, D, S>::FitParameterErrors() const
   -> FitParameters_t
 {
   return FitParameterErrors(FitParameterCovariance());
 } // SimplePolyFitterBase<>::FitParameterErrors()
 
 
-template <typename T, unsigned int D>
-auto lar::util::details::SimplePolyFitterBase<T, D>::FitParameterCovariance
+template <typename T, unsigned int D, typename S>
+auto lar::util::details::SimplePolyFitterBase<T, D, S>::FitParameterCovariance
   () const -> FitMatrix_t
 {
   FitMatrix_t Xmat = MakeMatrixX();
@@ -1594,8 +2224,8 @@ auto lar::util::details::SimplePolyFitterBase<T, D>::FitParameterCovariance
 } // SimplePolyFitterBase<>::FitParameterCovariance()
 
 
-template <typename T, unsigned int D>
-bool lar::util::details::SimplePolyFitterBase<T, D>::FillResults(
+template <typename T, unsigned int D, typename S>
+bool lar::util::details::SimplePolyFitterBase<T, D, S>::FillResults(
   FitParameters_t& params,
   FitMatrix_t& Xmat, Data_t& det, FitMatrix_t& Smat
 ) const {
@@ -1613,8 +2243,8 @@ bool lar::util::details::SimplePolyFitterBase<T, D>::FillResults(
 } // SimplePolyFitterBase<>::FillResults(params, matrices, determinant)
 
 
-template <typename T, unsigned int D>
-bool lar::util::details::SimplePolyFitterBase<T, D>::FillResults(
+template <typename T, unsigned int D, typename S>
+bool lar::util::details::SimplePolyFitterBase<T, D, S>::FillResults(
   FitParameters_t& params, FitParameters_t& paramerrors,
   FitMatrix_t& Xmat, Data_t& det, FitMatrix_t& Smat
 ) const {
@@ -1625,8 +2255,8 @@ bool lar::util::details::SimplePolyFitterBase<T, D>::FillResults(
 } // SimplePolyFitterBase<>::FillResults(params, errors, matrices, determinant)
 
 
-template <typename T, unsigned int D>
-bool lar::util::details::SimplePolyFitterBase<T, D>::FillResults(
+template <typename T, unsigned int D, typename S>
+bool lar::util::details::SimplePolyFitterBase<T, D, S>::FillResults(
   FitParameters_t& params, FitParameters_t& paramerrors
 ) const {
   // to compute the parameters, we need all the stuff;
@@ -1637,8 +2267,8 @@ bool lar::util::details::SimplePolyFitterBase<T, D>::FillResults(
 } // SimplePolyFitterBase<>::FillResults(params, errors)
 
 
-template <typename T, unsigned int D>
-auto lar::util::details::SimplePolyFitterBase<T, D>::Evaluate(Data_t x) const
+template <typename T, unsigned int D, typename S>
+auto lar::util::details::SimplePolyFitterBase<T, D, S>::Evaluate(Data_t x) const
   -> Data_t
 {
   FitParameters_t params = FitParameters();
@@ -1650,8 +2280,8 @@ auto lar::util::details::SimplePolyFitterBase<T, D>::Evaluate(Data_t x) const
 
 
 // --- protected methods follow ---
-template <typename T, unsigned int D>
-auto lar::util::details::SimplePolyFitterBase<T, D>::MakeMatrixX() const
+template <typename T, unsigned int D, typename S>
+auto lar::util::details::SimplePolyFitterBase<T, D, S>::MakeMatrixX() const
   -> FitMatrix_t
 {
   FitMatrix_t Xmat;
@@ -1664,8 +2294,8 @@ auto lar::util::details::SimplePolyFitterBase<T, D>::MakeMatrixX() const
 } // SimplePolyFitterBase<>::MakeMatrixX()
 
 
-template <typename T, unsigned int D>
-auto lar::util::details::SimplePolyFitterBase<T, D>::MakeMatrixY() const
+template <typename T, unsigned int D, typename S>
+auto lar::util::details::SimplePolyFitterBase<T, D, S>::MakeMatrixY() const
   -> FitParameters_t
 {
   FitParameters_t Ymat;
@@ -1674,8 +2304,8 @@ auto lar::util::details::SimplePolyFitterBase<T, D>::MakeMatrixY() const
 } // SimplePolyFitterBase<>::MakeMatrixY()
 
 
-template <typename T, unsigned int D>
-auto lar::util::details::SimplePolyFitterBase<T, D>::FitParameters
+template <typename T, unsigned int D, typename S>
+auto lar::util::details::SimplePolyFitterBase<T, D, S>::FitParameters
   (FitMatrix_t const& Xmat) const
   -> FitParameters_t
 {
@@ -1686,8 +2316,8 @@ auto lar::util::details::SimplePolyFitterBase<T, D>::FitParameters
 } // SimplePolyFitterBase<>::FitParameters(FitMatrix_t)
 
 
-template <typename T, unsigned int D>
-auto lar::util::details::SimplePolyFitterBase<T, D>::FitParameters
+template <typename T, unsigned int D, typename S>
+auto lar::util::details::SimplePolyFitterBase<T, D, S>::FitParameters
   (FitMatrix_t const& Smat, Data_t /* det */) const
   -> FitParameters_t
 {
@@ -1695,8 +2325,8 @@ auto lar::util::details::SimplePolyFitterBase<T, D>::FitParameters
 } // SimplePolyFitterBase<>::FitParameters(FitMatrix_t)
 
 
-template <typename T, unsigned int D>
-auto lar::util::details::SimplePolyFitterBase<T, D>::Param
+template <typename T, unsigned int D, typename S>
+auto lar::util::details::SimplePolyFitterBase<T, D, S>::Param
   (unsigned int n, FitMatrix_t const& Xmat) const -> Data_t
 {
   if (n > Degree) return Data_t(0); // no such a degree, its coefficient is 0
@@ -1710,8 +2340,8 @@ auto lar::util::details::SimplePolyFitterBase<T, D>::Param
 } // SimplePolyFitterBase<>::Param(unsigned int, FitMatrix_t)
 
 
-template <typename T, unsigned int D>
-auto lar::util::details::SimplePolyFitterBase<T, D>::ExtractParameterErrors
+template <typename T, unsigned int D, typename S>
+auto lar::util::details::SimplePolyFitterBase<T, D, S>::ExtractParameterErrors
   (FitMatrix_t const& Smat)
   -> FitParameters_t
 {
@@ -1722,8 +2352,8 @@ auto lar::util::details::SimplePolyFitterBase<T, D>::ExtractParameterErrors
 } // SimplePolyFitterBase<>::FitParameterErrors(FitMatrix_t)
 
 
-template <typename T, unsigned int D>
-auto lar::util::details::SimplePolyFitterBase<T, D>::Param
+template <typename T, unsigned int D, typename S>
+auto lar::util::details::SimplePolyFitterBase<T, D, S>::Param
   (unsigned int n, FitMatrix_t const& Xmat, Data_t detXmat) const -> Data_t
 {
   if (n > Degree) return Data_t(0); // no such a degree, its coefficient is 0
@@ -1737,8 +2367,8 @@ auto lar::util::details::SimplePolyFitterBase<T, D>::Param
 } // SimplePolyFitterBase<>::Param(unsigned int, FitMatrix_t, Data_t)
 
 
-template <typename T, unsigned int D>
-auto lar::util::details::SimplePolyFitterBase<T, D>::ChiSquare() const -> Data_t
+template <typename T, unsigned int D, typename S>
+auto lar::util::details::SimplePolyFitterBase<T, D, S>::ChiSquare() const -> Data_t
 {
   // the generic implementation of ChiSquare from sums is complex enough that
   // I freaked out
@@ -1752,8 +2382,8 @@ auto lar::util::details::SimplePolyFitterBase<T, D>::ChiSquare() const -> Data_t
 //***  LinearFit<>
 //***
 
-template <typename T>
-auto lar::util::LinearFit<T>::ChiSquare() const -> Data_t
+template <typename T, typename S>
+auto lar::util::LinearFit<T, S>::ChiSquare() const -> Data_t
 {
   FitParameters_t fit_params = this->FitParameters();
   const Data_t b = fit_params[0];
@@ -1767,8 +2397,8 @@ auto lar::util::LinearFit<T>::ChiSquare() const -> Data_t
 //***  QuadraticFit<>
 //***
 
-template <typename T>
-auto lar::util::QuadraticFit<T>::ChiSquare() const -> Data_t
+template <typename T, typename S>
+auto lar::util::QuadraticFit<T, S>::ChiSquare() const -> Data_t
 {
   FitParameters_t a = this->FitParameters();
   return Y2()           - Data_t(2) *        (a[0]*Y() + a[1]*XY() + a[2]*X2Y())
@@ -1785,8 +2415,8 @@ auto lar::util::QuadraticFit<T>::ChiSquare() const -> Data_t
 //
 // data interface
 //
-template <typename T>
-bool lar::util::GaussianFit<T>::add
+template <typename T, typename S>
+bool lar::util::GaussianFit<T, S>::add
   (Data_t x, Data_t y, Data_t sy /* = Data_t(1.0) */)
 {
   if (y <= Data_t(0)) return false; // ignore the non-positive values
@@ -1795,21 +2425,49 @@ bool lar::util::GaussianFit<T>::add
 } // GaussianFit<T>::add(Data_t, Data_t, Data_t)
 
 
-template <typename T>
+template <typename T, typename S>
+bool lar::util::GaussianFit<T, S>::remove
+  (Data_t x, Data_t y, Data_t sy /* = Data_t(1.0) */)
+{
+  if (y <= Data_t(0)) return false; // non-positive values were never added
+  Value_t value = EncodeValue(Value_t(y, sy));
+  return fitter.remove(x, value.value(), value.error());
+} // GaussianFit<T>::remove(Data_t, Data_t, Data_t)
+
+
+template <typename T, typename S>
+unsigned int lar::util::GaussianFit<T, S>::add_arrays
+  (Data_t const* x, Data_t const* y, Data_t const* sy, std::size_t n)
+{
+  unsigned int nAdded = 0;
+  for (std::size_t i = 0; i < n; ++i) {
+    if (y[i] <= Data_t(0)) continue; // ignore the non-positive values
+    if (sy) {
+      if (add(x[i], y[i], sy[i])) ++nAdded;
+    }
+    else {
+      if (fitter.add(x[i], EncodeValue(y[i]))) ++nAdded;
+    }
+  } // for
+  return nAdded;
+} // GaussianFit<T>::add_arrays()
+
+
+template <typename T, typename S>
 template <typename Iter, typename Pred>
-void lar::util::GaussianFit<T>::add_without_uncertainty
+void lar::util::GaussianFit<T, S>::add_without_uncertainty
   (Iter begin, Iter end, Pred extractor)
 {
   return fitter.add_without_uncertainty(begin, end, Encoder(extractor));
 } // GaussianFit<>::add_without_uncertainty(Iter, Iter, Pred)
 
 
-template <typename T>
+template <typename T, typename S>
 template <
   typename VIter, typename UIter,
   typename VPred, typename UPred
   >
-unsigned int lar::util::GaussianFit<T>::add_with_uncertainty(
+unsigned int lar::util::GaussianFit<T, S>::add_with_uncertainty(
         VIter begin_value, VIter end_value,
         UIter begin_uncertainty,
         VPred value_extractor,
@@ -1823,9 +2481,9 @@ unsigned int lar::util::GaussianFit<T>::add_with_uncertainty(
 } // GaussianFit<T>::add_with_uncertainty()
 
 
-template <typename T>
+template <typename T, typename S>
 template <typename Iter>
-unsigned int lar::util::GaussianFit<T>::add_with_uncertainty
+unsigned int lar::util::GaussianFit<T, S>::add_with_uncertainty
   (Iter begin, Iter end)
 {
   unsigned int old_n = N();
@@ -1837,14 +2495,14 @@ unsigned int lar::util::GaussianFit<T>::add_with_uncertainty
 //
 // fitting interface
 //
-template <typename T>
-auto lar::util::GaussianFit<T>::FitParameters() const -> FitParameters_t {
+template <typename T, typename S>
+auto lar::util::GaussianFit<T, S>::FitParameters() const -> FitParameters_t {
   return ConvertParameters(fitter.FitParameters());
 } // GaussianFit<>::FitParameters()
 
 
-template <typename T>
-auto lar::util::GaussianFit<T>::FitParameterErrors() const -> FitParameters_t {
+template <typename T, typename S>
+auto lar::util::GaussianFit<T, S>::FitParameterErrors() const -> FitParameters_t {
   FitParameters_t qpars, qparerrors;
   if (!FillResults(qpars, qparerrors)) {
     throw std::runtime_error
@@ -1854,8 +2512,8 @@ auto lar::util::GaussianFit<T>::FitParameterErrors() const -> FitParameters_t {
 } // GaussianFit<>::FitParameterErrors()
 
 
-template <typename T>
-auto lar::util::GaussianFit<T>::FitParameterCovariance() const -> FitMatrix_t
+template <typename T, typename S>
+auto lar::util::GaussianFit<T, S>::FitParameterCovariance() const -> FitMatrix_t
 {
   // we need to go through the whole chain to get the error matrix
   FitParameters_t params;
@@ -1870,8 +2528,8 @@ auto lar::util::GaussianFit<T>::FitParameterCovariance() const -> FitMatrix_t
 } // SimplePolyFitterBase<>::FitParameterCovariance()
 
 
-template <typename T>
-bool lar::util::GaussianFit<T>::FillResults
+template <typename T, typename S>
+bool lar::util::GaussianFit<T, S>::FillResults
   (FitParameters_t& params, FitParameters_t& paramerrors) const
 {
   FitParameters_t qpars;
@@ -1884,8 +2542,8 @@ bool lar::util::GaussianFit<T>::FillResults
 } // GaussianFit<>::FillResults()
 
 
-template <typename T>
-bool lar::util::GaussianFit<T>::FillResults(
+template <typename T, typename S>
+bool lar::util::GaussianFit<T, S>::FillResults(
   FitParameters_t& params, FitMatrix_t& Xmat, Data_t& det, FitMatrix_t& Smat
 ) const {
   FitParameters_t qpars;
@@ -1896,8 +2554,8 @@ bool lar::util::GaussianFit<T>::FillResults(
 } // GaussianFit::FillResults()
 
 
-template <typename T>
-bool lar::util::GaussianFit<T>::FillResults(
+template <typename T, typename S>
+bool lar::util::GaussianFit<T, S>::FillResults(
   FitParameters_t& params, FitParameters_t& paramerrors,
   FitMatrix_t& Xmat, Data_t& det, FitMatrix_t& Smat
 ) const {
@@ -1907,8 +2565,8 @@ bool lar::util::GaussianFit<T>::FillResults(
 } // GaussianFit::FillResults()
 
 
-template <typename T>
-auto lar::util::GaussianFit<T>::Evaluate(Data_t x, Data_t const* params)
+template <typename T, typename S>
+auto lar::util::GaussianFit<T, S>::Evaluate(Data_t x, Data_t const* params)
   -> Data_t
 {
   Data_t z = (x - params[1]) / params[2];
@@ -1916,8 +2574,8 @@ auto lar::util::GaussianFit<T>::Evaluate(Data_t x, Data_t const* params)
 } // GaussianFit<>::Evaluate()
 
 
-template <typename T>
-auto lar::util::GaussianFit<T>::ConvertParameters(FitParameters_t const& qpars)
+template <typename T, typename S>
+auto lar::util::GaussianFit<T, S>::ConvertParameters(FitParameters_t const& qpars)
   -> FitParameters_t
 {
   FitParameters_t params;
@@ -1934,8 +2592,8 @@ auto lar::util::GaussianFit<T>::ConvertParameters(FitParameters_t const& qpars)
 } // GaussianFit<>::ConvertParameters()
 
 
-template <typename T>
-void lar::util::GaussianFit<T>::ConvertParametersAndVariances(
+template <typename T, typename S>
+void lar::util::GaussianFit<T, S>::ConvertParametersAndVariances(
   FitParameters_t const& qpars, FitMatrix_t const& qparerrmat,
   FitParameters_t& params, FitParameters_t& paramvariances
   )
@@ -1970,8 +2628,8 @@ void lar::util::GaussianFit<T>::ConvertParametersAndVariances(
 } // GaussianFit<>::ConvertParametersAndVariances()
 
 
-template <typename T>
-void lar::util::GaussianFit<T>::ConvertParametersAndErrors(
+template <typename T, typename S>
+void lar::util::GaussianFit<T, S>::ConvertParametersAndErrors(
   FitParameters_t const& qpars, FitMatrix_t const& qparerrmat,
   FitParameters_t& params, FitParameters_t& paramerrors
   )
@@ -1982,8 +2640,8 @@ void lar::util::GaussianFit<T>::ConvertParametersAndErrors(
 } // GaussianFit<>::ConvertParametersAndErrors()
 
 
-template <typename T>
-void lar::util::GaussianFit<T>::ConvertParametersAndErrorMatrix(
+template <typename T, typename S>
+void lar::util::GaussianFit<T, S>::ConvertParametersAndErrorMatrix(
   FitParameters_t const& qpars, FitMatrix_t const& qparerrmat,
   FitParameters_t& params, FitMatrix_t& Smat
   )
@@ -2035,14 +2693,299 @@ void lar::util::GaussianFit<T>::ConvertParametersAndErrorMatrix(
 } // GaussianFit<>::ConvertParametersAndErrors()
 
 
-template <typename T>
-bool lar::util::GaussianFit<T>::isValid
+template <typename T, typename S>
+bool lar::util::GaussianFit<T, S>::isValid
   (FitParameters_t const& params, FitParameters_t const& qpars)
 {
   return (qpars[2] < Data_t(0)) && (params[0] >= Data_t(0));
 } // GaussianFit<>::isValid(FitParameters_t)
 
 
+//******************************************************************************
+//***  PolyFitBatch<>
+//***
+
+template <typename T, unsigned int D>
+void lar::util::PolyFitBatch<T, D>::reserve(std::size_t n) {
+  fN.reserve(n);
+  for (auto& sums: fX) sums.reserve(n);
+  for (auto& sums: fXY) sums.reserve(n);
+  fY2.reserve(n);
+} // PolyFitBatch<>::reserve()
+
+
+template <typename T, unsigned int D>
+void lar::util::PolyFitBatch<T, D>::clear() {
+  fN.clear();
+  for (auto& sums: fX) sums.clear();
+  for (auto& sums: fXY) sums.clear();
+  fY2.clear();
+} // PolyFitBatch<>::clear()
+
+
+template <typename T, unsigned int D>
+std::size_t lar::util::PolyFitBatch<T, D>::add
+  (Data_t const* x, Data_t const* y, Data_t const* sy, std::size_t n)
+{
+  std::size_t const i = size();
+  resize(i + 1);
+  Sums_t sums;
+  details::accumulatePowerSums(sums, x, y, sy, n);
+  store(i, sums);
+  return i;
+} // PolyFitBatch<>::add(x, y, sy, n)
+
+
+template <typename T, unsigned int D>
+void lar::util::PolyFitBatch<T, D>::add(
+  std::size_t nSets, std::size_t const* offsets,
+  Data_t const* x, Data_t const* y, Data_t const* sy /* = nullptr */
+) {
+  std::size_t const firstSet = size();
+  resize(firstSet + nSets);
+  for (std::size_t iSet = 0; iSet < nSets; ++iSet) {
+    std::size_t const first = offsets[iSet];
+    Sums_t sums;
+    details::accumulatePowerSums(sums, x + first, y + first,
+      sy? sy + first: nullptr, offsets[iSet + 1] - first);
+    store(firstSet + iSet, sums);
+  } // for
+} // PolyFitBatch<>::add(nSets, offsets, x, y, sy)
+
+
+template <typename T, unsigned int D>
+bool lar::util::PolyFitBatch<T, D>::isValid(std::size_t i) const {
+  return (N(i) > (int) Degree)
+    && std::isnormal(MatrixOps::Determinant(MakeMatrixX(i)));
+} // PolyFitBatch<>::isValid()
+
+
+template <typename T, unsigned int D>
+bool lar::util::PolyFitBatch<T, D>::FillResults(
+  std::size_t i, FitParameters_t& params,
+  FitMatrix_t& Xmat, Data_t& det, FitMatrix_t& Smat
+) const {
+  Xmat = MakeMatrixX(i);
+  det = MatrixOps::Determinant(Xmat);
+  if (!std::isnormal(det)) {
+    Smat.fill(Data_t(0));
+    params.fill(Data_t(0));
+    return false;
+  }
+  Smat = MatrixOps::InvertSymmetricMatrix(Xmat, det);
+  params = MatrixOps::MatrixVectorProduct(Smat, MakeMatrixY(i));
+  return true;
+} // PolyFitBatch<>::FillResults(params, matrices, determinant)
+
+
+template <typename T, unsigned int D>
+bool lar::util::PolyFitBatch<T, D>::FillResults
+  (std::size_t i, FitParameters_t& params, FitParameters_t& paramerrors) const
+{
+  FitMatrix_t Xmat, Smat;
+  Data_t det;
+  if (!FillResults(i, params, Xmat, det, Smat)) {
+    paramerrors.fill(Data_t(0));
+    return false;
+  }
+  for (unsigned int iParam = 0; iParam < NParams; ++iParam)
+    paramerrors[iParam] = std::sqrt(Smat[iParam * (NParams + 1)]);
+  return true;
+} // PolyFitBatch<>::FillResults(params, errors)
+
+
+template <typename T, unsigned int D>
+auto lar::util::PolyFitBatch<T, D>::FitParameters(std::size_t i) const
+  -> FitParameters_t
+{
+  FitParameters_t params;
+  FitMatrix_t Xmat, Smat;
+  Data_t det;
+  if (!FillResults(i, params, Xmat, det, Smat)) {
+    throw std::range_error
+      ("PolyFitBatch::FitParameters(): determinant 0 while fitting");
+  }
+  return params;
+} // PolyFitBatch<>::FitParameters()
+
+
+template <typename T, unsigned int D>
+auto lar::util::PolyFitBatch<T, D>::ChiSquare
+  (std::size_t i, FitParameters_t const& a) const -> Data_t
+{
+  // sum_i w_i (y_i - f(x_i))^2 expanded in terms of the power sums
+  Data_t chi2 = fY2[i];
+  for (unsigned int j = 0; j < NParams; ++j) {
+    chi2 -= Data_t(2) * a[j] * fXY[j][i];
+    chi2 += a[j] * a[j] * fX[2 * j][i];
+    for (unsigned int k = j + 1; k < NParams; ++k)
+      chi2 += Data_t(2) * a[j] * a[k] * fX[j + k][i];
+  } // for
+  return chi2;
+} // PolyFitBatch<>::ChiSquare()
+
+
+template <typename T, unsigned int D>
+std::size_t lar::util::PolyFitBatch<T, D>::FitAll(
+  FitParameters_t* params, FitParameters_t* paramerrors /* = nullptr */,
+  Data_t* chiSquares /* = nullptr */, bool* valid /* = nullptr */
+) const {
+  std::size_t nValid = 0;
+  FitParameters_t errors;
+  for (std::size_t i = 0; i < size(); ++i) {
+    bool const good = FillResults(i, params[i], errors);
+    if (good) ++nValid;
+    if (paramerrors) paramerrors[i] = errors;
+    if (chiSquares) chiSquares[i] = good? ChiSquare(i, params[i]): Data_t(0);
+    if (valid) valid[i] = good;
+  } // for
+  return nValid;
+} // PolyFitBatch<>::FitAll()
+
+
+template <typename T, unsigned int D>
+auto lar::util::PolyFitBatch<T, D>::Evaluate
+  (Data_t x, FitParameters_t const& params) -> Data_t
+{
+  unsigned int iParam = NParams - 1; // point to last parameter (highest degree)
+  Data_t v = params[iParam];
+  while (iParam > 0) v = v * x + params[--iParam];
+  return v;
+} // PolyFitBatch<>::Evaluate()
+
+
+// --- protected methods follow ---
+template <typename T, unsigned int D>
+void lar::util::PolyFitBatch<T, D>::resize(std::size_t n) {
+  fN.resize(n);
+  for (auto& sums: fX) sums.resize(n);
+  for (auto& sums: fXY) sums.resize(n);
+  fY2.resize(n);
+} // PolyFitBatch<>::resize()
+
+
+template <typename T, unsigned int D>
+void lar::util::PolyFitBatch<T, D>::store(std::size_t i, Sums_t const& sums) {
+  fN[i] = sums.n;
+  for (unsigned int k = 0; k < Sums_t::NXSums; ++k) fX[k][i] = sums.x[k];
+  for (unsigned int k = 0; k < Sums_t::NXYSums; ++k) fXY[k][i] = sums.xy[k];
+  fY2[i] = sums.y2;
+} // PolyFitBatch<>::store()
+
+
+template <typename T, unsigned int D>
+auto lar::util::PolyFitBatch<T, D>::MakeMatrixX(std::size_t i) const
+  -> FitMatrix_t
+{
+  FitMatrix_t Xmat;
+  for (unsigned int r = 0; r < NParams; ++r) { // row
+    for (unsigned int c = r; c < NParams; ++c) { // column
+      Xmat[c * NParams + r] = Xmat[r * NParams + c] = fX[r + c][i];
+    } // for c
+  } // for r
+  return Xmat;
+} // PolyFitBatch<>::MakeMatrixX()
+
+
+template <typename T, unsigned int D>
+auto lar::util::PolyFitBatch<T, D>::MakeMatrixY(std::size_t i) const
+  -> FitParameters_t
+{
+  FitParameters_t Ymat;
+  for (unsigned int r = 0; r < NParams; ++r) Ymat[r] = fXY[r][i];
+  return Ymat;
+} // PolyFitBatch<>::MakeMatrixY()
+
+
+//******************************************************************************
+//***  GaussianFitBatch<>
+//***
+
+template <typename T>
+std::size_t lar::util::GaussianFitBatch<T>::add
+  (Data_t const* x, Data_t const* y, Data_t const* sy, std::size_t n)
+{
+  std::size_t const nEncoded = Encode(x, y, sy, n);
+  return fitter.add(fEncX.data(), fEncY.data(), fEncS.data(), nEncoded);
+} // GaussianFitBatch<>::add(x, y, sy, n)
+
+
+template <typename T>
+void lar::util::GaussianFitBatch<T>::add(
+  std::size_t nSets, std::size_t const* offsets,
+  Data_t const* x, Data_t const* y, Data_t const* sy /* = nullptr */
+) {
+  reserve(size() + nSets);
+  for (std::size_t iSet = 0; iSet < nSets; ++iSet) {
+    std::size_t const first = offsets[iSet];
+    add(x + first, y + first, sy? sy + first: nullptr,
+      offsets[iSet + 1] - first);
+  } // for
+} // GaussianFitBatch<>::add(nSets, offsets, x, y, sy)
+
+
+template <typename T>
+bool lar::util::GaussianFitBatch<T>::FillResults
+  (std::size_t i, FitParameters_t& params, FitParameters_t& paramerrors) const
+{
+  FitParameters_t qpars;
+  FitMatrix_t qparerrmat;
+  FitMatrix_t Xmat; // not used
+  Data_t det; // not used
+  if (!fitter.FillResults(i, qpars, Xmat, det, qparerrmat)) {
+    params.fill(Data_t(0));
+    paramerrors.fill(Data_t(0));
+    return false;
+  }
+  Gaussian_t::ConvertParametersAndErrors(qpars, qparerrmat, params, paramerrors);
+  return Gaussian_t::isValid(params, qpars);
+} // GaussianFitBatch<>::FillResults()
+
+
+template <typename T>
+std::size_t lar::util::GaussianFitBatch<T>::FitAll(
+  FitParameters_t* params, FitParameters_t* paramerrors /* = nullptr */,
+  bool* valid /* = nullptr */
+) const {
+  std::size_t nValid = 0;
+  FitParameters_t errors;
+  for (std::size_t i = 0; i < size(); ++i) {
+    bool const good = FillResults(i, params[i], errors);
+    if (good) ++nValid;
+    if (paramerrors) paramerrors[i] = errors;
+    if (valid) valid[i] = good;
+  } // for
+  return nValid;
+} // GaussianFitBatch<>::FitAll()
+
+
+template <typename T>
+std::size_t lar::util::GaussianFitBatch<T>::Encode
+  (Data_t const* x, Data_t const* y, Data_t const* sy, std::size_t n)
+{
+  fEncX.resize(n);
+  fEncY.resize(n);
+  fEncS.resize(n);
+  std::size_t nEncoded = 0;
+  for (std::size_t i = 0; i < n; ++i) {
+    if (y[i] <= Data_t(0)) continue; // ignore the non-positive values
+    fEncX[nEncoded] = x[i];
+    if (sy) {
+      auto const value
+        = Gaussian_t::EncodeValue(typename Gaussian_t::Value_t(y[i], sy[i]));
+      fEncY[nEncoded] = value.value();
+      fEncS[nEncoded] = value.error();
+    }
+    else {
+      fEncY[nEncoded] = Gaussian_t::EncodeValue(y[i]);
+      fEncS[nEncoded] = Data_t(1);
+    }
+    ++nEncoded;
+  } // for
+  return nEncoded;
+} // GaussianFitBatch<>::Encode()
+
+
 //******************************************************************************
 
 
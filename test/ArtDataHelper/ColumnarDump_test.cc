@@ -0,0 +1,119 @@
+/**
+ * @file   lardata/test/ArtDataHelper/ColumnarDump_test.cc
+ * @brief  Unit test for `recob::dumper::ColumnarDumpWriter` and reader.
+ * @date   October 18, 2026
+ * @see    lardata/ArtDataHelper/Dumpers/ColumnarDump.h
+ *
+ * This is a Boost unit test with no specific configuration.
+ * It writes a file in the current directory.
+ */
+
+// LArSoft libraries
+#include "lardata/ArtDataHelper/Dumpers/ColumnarDump.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( ColumnarDump_test )
+#include <boost/test/unit_test.hpp> // BOOST_AUTO_TEST_CASE()
+#include <boost/test/test_tools.hpp> // BOOST_CHECK(), BOOST_CHECK_EQUAL()
+
+// framework libraries
+#include "cetlib_except/exception.h"
+
+// C/C++ standard libraries
+#include <vector>
+#include <string>
+#include <cstdint> // std::uint32_t, std::int16_t
+
+
+//------------------------------------------------------------------------------
+void WriteAndReadTest() {
+
+  using recob::dumper::ColumnarDumpWriter;
+  using recob::dumper::ColumnarDumpReader;
+  using recob::dumper::ColumnType_t;
+
+  std::string const path = "ColumnarDump_test.lcol";
+
+  std::vector<std::uint32_t> const channels { 3U, 5U, 8U };
+  std::vector<float> const times { 1.5f, -2.25f, 1e6f };
+  std::vector<std::int16_t> const samples { 1, -2, 3, -4, 5 };
+
+  {
+    ColumnarDumpWriter out(path, 64U); // small buffer to exercise flushing
+
+    // event 1: three objects
+    out.beginTable("hits", 1U, 2U, 3U, channels.size(), 3U);
+    out.writeColumn("channel", channels);
+    out.writeColumnOf
+      ("time", times, [](float t){ return static_cast<double>(t); });
+    out.writeColumn("samples", samples);
+
+    // the table is complete: no more columns allowed
+    BOOST_CHECK_THROW(out.writeColumn("extra", channels), cet::exception);
+
+    // event 2: empty table
+    out.beginTable("hits", 1U, 2U, 4U, 0U, 1U);
+    // the table is not complete: a new one can't start
+    BOOST_CHECK_THROW
+      (out.beginTable("hits", 1U, 2U, 5U, 0U, 0U), cet::exception);
+    out.writeColumn("channel", std::vector<std::uint32_t>{});
+  }
+
+  ColumnarDumpReader in(path);
+  ColumnarDumpReader::Table table;
+
+  BOOST_REQUIRE(in.next(table));
+  BOOST_CHECK_EQUAL(table.name, "hits");
+  BOOST_CHECK_EQUAL(table.run, 1U);
+  BOOST_CHECK_EQUAL(table.subRun, 2U);
+  BOOST_CHECK_EQUAL(table.event, 3U);
+  BOOST_CHECK_EQUAL(table.nRows, channels.size());
+  BOOST_CHECK_EQUAL(table.columns.size(), 3U);
+
+  BOOST_CHECK(table.hasColumn("time"));
+  BOOST_CHECK(!table.hasColumn("extra"));
+  BOOST_CHECK_THROW(table.column("extra"), cet::exception);
+
+  auto const& channelColumn = table.column("channel");
+  BOOST_CHECK(channelColumn.type == ColumnType_t::UInt32);
+  auto const readChannels = channelColumn.values<std::uint32_t>();
+  BOOST_CHECK_EQUAL_COLLECTIONS(
+    readChannels.begin(), readChannels.end(), channels.begin(), channels.end()
+    );
+  BOOST_CHECK_THROW(channelColumn.values<float>(), cet::exception);
+
+  auto const readTimes = table.column("time").values<double>();
+  BOOST_REQUIRE_EQUAL(readTimes.size(), times.size());
+  for (std::size_t i = 0; i < times.size(); ++i)
+    BOOST_CHECK_EQUAL(readTimes[i], static_cast<double>(times[i]));
+
+  auto const readSamples = table.column("samples").values<std::int16_t>();
+  BOOST_CHECK_EQUAL_COLLECTIONS(
+    readSamples.begin(), readSamples.end(), samples.begin(), samples.end()
+    );
+
+  ColumnarDumpReader::Table emptyTable;
+  BOOST_REQUIRE(in.next(emptyTable));
+  BOOST_CHECK_EQUAL(emptyTable.event, 4U);
+  BOOST_CHECK_EQUAL(emptyTable.nRows, 0U);
+  BOOST_CHECK_EQUAL(emptyTable.column("channel").size(), 0U);
+  BOOST_CHECK(emptyTable != table);
+
+  BOOST_CHECK(!in.next(emptyTable));
+
+  // a second reading gives identical tables
+  ColumnarDumpReader again(path);
+  ColumnarDumpReader::Table sameTable;
+  BOOST_REQUIRE(again.next(sameTable));
+  BOOST_CHECK(sameTable == table);
+
+} // WriteAndReadTest()
+
+
+//------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(ColumnarDumpTestCase) {
+  WriteAndReadTest();
+} // BOOST_AUTO_TEST_CASE(ColumnarDumpTestCase)
+
+
+//------------------------------------------------------------------------------
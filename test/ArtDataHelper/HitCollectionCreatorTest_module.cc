@@ -16,12 +16,14 @@
 #include "art/Framework/Core/ModuleMacros.h"
 #include "art/Framework/Core/EDProducer.h"
 #include "art/Framework/Principal/Event.h"
+#include "canvas/Utilities/Exception.h"
 
 #include "fhiclcpp/types/Atom.h"
 #include "fhiclcpp/types/Name.h"
 #include "fhiclcpp/types/Comment.h"
 
 // C/C++ standard libraries
+#include <algorithm> // std::is_sorted()
 #include <string>
 
 
@@ -32,7 +34,10 @@ namespace recob {
      * @brief Test module for `recob::HitCollector`.
      *
      * Currently exercises:
-     * @todo
+     * * `recob::HitCollectionCreator`, adding hits one by one
+     * * `recob::ConcurrentHitCollectionCreator`, filling buffers out of
+     *   channel order (the product has `Concurrent` appended to the instance
+     *   name)
      *
      * Throws an exception on failure.
      *
@@ -77,6 +82,9 @@ namespace recob {
 
       recob::HitCollectionCreatorManager hitCollManager;
 
+      /// Manager of the collection created by concurrent buffers.
+      recob::ConcurrentHitCollectionCreatorManager concurrentHitCollManager;
+
       std::string fInstanceName; ///< Instance name to be used for products.
 
 
@@ -84,6 +92,12 @@ namespace recob {
       /// Produces a collection of hits and stores it into the event.
       void produceHits(art::Event& event, std::string instanceName);
 
+      /// Produces a collection of hits from two buffers and stores it.
+      void produceConcurrentHits(art::Event& event);
+
+      /// Returns a test hit on the specified channel and time.
+      static recob::Hit makeHit(raw::ChannelID_t channel, double time);
+
     }; // HitCollectionCreatorTest
 
     DEFINE_ART_MODULE(HitCollectionCreatorTest)
@@ -103,12 +117,17 @@ recob::test::HitCollectionCreatorTest::HitCollectionCreatorTest
       producesCollector(), config().instanceName(),
       false /* doWireAssns */, false /* doRawDigitAssns */
     ) // produces<>() hit collections
+  , concurrentHitCollManager(
+      producesCollector(), config().instanceName() + "Concurrent",
+      false /* doWireAssns */, false /* doRawDigitAssns */
+    )
   {}
 
 
 //----------------------------------------------------------------------------
 void recob::test::HitCollectionCreatorTest::produce(art::Event& event) {
   produceHits(event, fInstanceName);
+  produceConcurrentHits(event);
 } // HitCollectionCreatorTest::produce()
 
 
@@ -123,34 +142,73 @@ void recob::test::HitCollectionCreatorTest::produceHits
   auto Hits = hitCollManager.collectionWriter(event);
 
   // create hits, one by one
-  for (double time: { 0.0, 200.0, 400.0 }) {
-    Hits.emplace_back(
-      recob::Hit(
-        raw::InvalidChannelID,       /* channel */
-        raw::TDCtick_t(1000 + time), /* start_tick */
-        raw::TDCtick_t(1010 + time), /* end_tick */
-        time,                        /* peak_time */
-        1.0,                         /* sigma_peak_time */
-        5.0,                         /* rms */
-        100.0,                       /* peak_amplitude */
-        1.0,                         /* sigma_peak_amplitude */
-        500.0,                       /* summedADC */
-        500.0,                       /* hit_integral */
-        1.0,                         /* hit_sigma_integral */
-        1,                           /* multiplicity */
-        0,                           /* local_index */
-        1.0,                         /* goodness_of_fit */
-        7,                           /* dof */
-        geo::kUnknown,               /* view */
-        geo::kMysteryType,           /* signal_type */
-        geo::WireID{}                /* wireID */
-        )
-    );
-  } // for hits
+  for (double time: { 0.0, 200.0, 400.0 })
+    Hits.emplace_back(makeHit(raw::InvalidChannelID, time));
 
   Hits.put_into(event);
 
 } // recob::test::HitCollectionCreatorTest::produceHits()
 
 
+//----------------------------------------------------------------------------
+void recob::test::HitCollectionCreatorTest::produceConcurrentHits
+  (art::Event& event)
+{
+
+  auto Hits = concurrentHitCollManager.collectionWriter(event);
+
+  // buffer #1 gets lower channels than buffer #0, and is filled first;
+  // channel 5 appears in both, and buffer #0 hit must come first
+  Hits.makeBuffers(2U);
+  for (raw::ChannelID_t channel: { 1U, 3U, 5U })
+    Hits.buffer(1).emplace_back(makeHit(channel, 100.0));
+  for (raw::ChannelID_t channel: { 5U, 8U, 9U })
+    Hits.buffer(0).emplace_back(makeHit(channel, 0.0));
+
+  Hits.merge();
+
+  auto const& hits = Hits.peek();
+  auto const byChannel = [](recob::Hit const& a, recob::Hit const& b)
+    { return a.Channel() < b.Channel(); };
+  if (!std::is_sorted(hits.begin(), hits.end(), byChannel)) {
+    throw art::Exception(art::errors::LogicError)
+      << "ConcurrentHitCollectionCreator did not sort hits by channel.";
+  }
+  if ((hits.size() != 6U) || (hits[2].PeakTime() != 0.0)) {
+    throw art::Exception(art::errors::LogicError)
+      << "ConcurrentHitCollectionCreator merged buffers in the wrong order.";
+  }
+
+  Hits.put_into();
+
+} // recob::test::HitCollectionCreatorTest::produceConcurrentHits()
+
+
+//----------------------------------------------------------------------------
+recob::Hit recob::test::HitCollectionCreatorTest::makeHit
+  (raw::ChannelID_t channel, double time)
+{
+  return recob::Hit(
+    channel,                     /* channel */
+    raw::TDCtick_t(1000 + time), /* start_tick */
+    raw::TDCtick_t(1010 + time), /* end_tick */
+    time,                        /* peak_time */
+    1.0,                         /* sigma_peak_time */
+    5.0,                         /* rms */
+    100.0,                       /* peak_amplitude */
+    1.0,                         /* sigma_peak_amplitude */
+    500.0,                       /* summedADC */
+    500.0,                       /* hit_integral */
+    1.0,                         /* hit_sigma_integral */
+    1,                           /* multiplicity */
+    0,                           /* local_index */
+    1.0,                         /* goodness_of_fit */
+    7,                           /* dof */
+    geo::kUnknown,               /* view */
+    geo::kMysteryType,           /* signal_type */
+    geo::WireID{}                /* wireID */
+    );
+} // recob::test::HitCollectionCreatorTest::makeHit()
+
+
 //----------------------------------------------------------------------------
@@ -0,0 +1,113 @@
+/**
+ * @file   MVAWrapperBase_benchmark.cc
+ * @brief  Times the per-type lookups of the MVA reader and writer wrappers.
+ * @date   October 18, 2026
+ * @see    lardata/ArtDataHelper/MVAWrapperBase.h
+ *
+ * `FVectorWriter` finds the collection of a data product type at each call
+ * of `setOutput()`, `getOutput()` and friends, and the reader and writer need
+ * the name of the type to find the data products. Each is done in two ways:
+ * 1. *before*: an `unordered_map` keyed by `std::type_info::hash_code()`, and
+ *    demangling `typeid(T).name()` at each call
+ * 2. *now*: a vector indexed by `FVectorWrapperBase::getTypeIndex<T>()`, and
+ *    the name cached by `FVectorWrapperBase::getProductName<T>()`
+ *
+ * The two ways are required to give the same result, and the time per call is
+ * printed. The program returns non-zero if they disagree.
+ *
+ * Usage: `MVAWrapperBase_benchmark [calls]` (default: 10 millions).
+ */
+
+// LArSoft libraries
+#include "lardata/ArtDataHelper/MVAWrapperBase.h"
+
+// C/C++ standard libraries
+#include <iostream>
+#include <vector>
+#include <unordered_map>
+#include <chrono>
+#include <string>
+#include <typeinfo>
+#include <cstddef> // std::size_t
+
+
+//------------------------------------------------------------------------------
+struct Hit {};
+struct Cluster {};
+struct Track {};
+
+
+/// Exposes the type lookup facilities of the wrappers.
+struct TypeLookup: public anab::FVectorWrapperBase {
+  using anab::FVectorWrapperBase::getProductName;
+  using anab::FVectorWrapperBase::getTypeIndex;
+}; // struct TypeLookup
+
+
+//------------------------------------------------------------------------------
+int main(int argc, char** argv) {
+
+  std::size_t const nCalls = (argc > 1)? std::stoul(argv[1]): 10000000U;
+  std::size_t const nNameCalls = nCalls / 10U; // demangling is slow
+
+  using Clock_t = std::chrono::steady_clock;
+  auto const nsPerCall = [](Clock_t::duration d, std::size_t n)
+    { return std::chrono::duration<double, std::nano>(d).count() / n; };
+
+  // collection ID for each type, in both ways
+  std::unordered_map<std::size_t, std::size_t> const IDByHash {
+    { typeid(Cluster).hash_code(), 0U },
+    { typeid(Hit).hash_code(), 1U },
+    { typeid(Track).hash_code(), 2U },
+  };
+  std::vector<std::size_t> IDByIndex(3U);
+  IDByIndex[TypeLookup::getTypeIndex<Cluster>()] = 0U;
+  IDByIndex[TypeLookup::getTypeIndex<Hit>()] = 1U;
+  IDByIndex[TypeLookup::getTypeIndex<Track>()] = 2U;
+
+  std::size_t sumByHash = 0U, sumByIndex = 0U;
+  auto const start = Clock_t::now();
+  for (std::size_t i = 0; i < nCalls; ++i)
+    sumByHash += IDByHash.find(typeid(Hit).hash_code())->second;
+  auto const middle = Clock_t::now();
+  for (std::size_t i = 0; i < nCalls; ++i) {
+    std::size_t const index = TypeLookup::getTypeIndex<Hit>();
+    if (index < IDByIndex.size()) sumByIndex += IDByIndex[index];
+  }
+  auto const end = Clock_t::now();
+
+  std::size_t nameLengthDemangled = 0U, nameLengthCached = 0U;
+  auto const nameStart = Clock_t::now();
+  for (std::size_t i = 0; i < nNameCalls; ++i)
+    nameLengthDemangled += TypeLookup::getProductName(typeid(Hit)).size();
+  auto const nameMiddle = Clock_t::now();
+  for (std::size_t i = 0; i < nNameCalls; ++i)
+    nameLengthCached += TypeLookup::getProductName<Hit>().size();
+  auto const nameEnd = Clock_t::now();
+
+  std::cout << "Collection ID lookup (" << nCalls << " calls):"
+    << "\n  map by type hash:  " << nsPerCall(middle - start, nCalls)
+    << " ns/call"
+    << "\n  vector by index:   " << nsPerCall(end - middle, nCalls)
+    << " ns/call"
+    << "\nProduct name (" << nNameCalls << " calls):"
+    << "\n  demangled:         " << nsPerCall(nameMiddle - nameStart, nNameCalls)
+    << " ns/call"
+    << "\n  cached:            " << nsPerCall(nameEnd - nameMiddle, nNameCalls)
+    << " ns/call"
+    << std::endl;
+
+  unsigned int nErrors = 0U;
+  if (sumByHash != sumByIndex) {
+    std::cerr << "Collection ID lookups disagree!" << std::endl;
+    ++nErrors;
+  }
+  if (nameLengthDemangled != nameLengthCached) {
+    std::cerr << "Product names disagree!" << std::endl;
+    ++nErrors;
+  }
+  return (nErrors > 0U)? 1: 0;
+} // main()
+
+
+//------------------------------------------------------------------------------
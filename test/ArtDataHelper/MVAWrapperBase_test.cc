@@ -0,0 +1,172 @@
+/**
+ * @file   MVAWrapperBase_test.cc
+ * @brief  Unit test for the accumulation of MVA outputs in `MVAWrapperBase`.
+ * @date   October 18, 2026
+ * @see    lardata/ArtDataHelper/MVAWrapperBase.h
+ *
+ * The batch accumulation `pAccumulateGroups()` is compared, group by group,
+ * with `pAccumulate()` on the items of each group.
+ */
+
+// LArSoft libraries
+#include "lardata/ArtDataHelper/MVAWrapperBase.h"
+
+// framework libraries
+#include "canvas/Persistency/Common/Ptr.h"
+#include "canvas/Persistency/Provenance/ProductID.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( MVAWrapperBase_test )
+#include <cetlib/quiet_unit_test.hpp> // BOOST_AUTO_TEST_CASE()
+#include <boost/test/test_tools.hpp> // BOOST_CHECK(), BOOST_CHECK_EQUAL()
+
+// C/C++ standard libraries
+#include <vector>
+#include <array>
+#include <cstddef> // std::size_t
+
+
+//------------------------------------------------------------------------------
+constexpr std::size_t N = 4U;
+
+struct Item {};
+
+/// Exposes the protected accumulation functions.
+struct Accumulator: public anab::MVAWrapperBase {
+  using anab::MVAWrapperBase::pAccumulate;
+  using anab::MVAWrapperBase::pAccumulateGroups;
+}; // struct Accumulator
+
+
+/// MVA outputs and groups of items.
+struct TestData {
+  std::vector<anab::FeatureVector<N>> outs; ///< Output of each item.
+  std::vector<float> flatOuts; ///< All outputs, item after item.
+  std::vector<std::size_t> offsets; ///< Start of each group in `keys`.
+  std::vector<std::size_t> keys; ///< Items in each group.
+  std::vector<float> weights; ///< Weight of each entry of `keys`.
+
+  /// Returns pointers to the items in group `g`.
+  std::vector<art::Ptr<Item>> items(std::size_t g) const
+    {
+      std::vector<art::Ptr<Item>> ptrs;
+      for (std::size_t k = offsets[g]; k < offsets[g + 1]; ++k)
+        ptrs.emplace_back(art::ProductID{ 1U }, keys[k], nullptr);
+      return ptrs;
+    }
+
+  /// Returns the weights of the items in group `g`.
+  std::vector<float> groupWeights(std::size_t g) const
+    {
+      return
+        { weights.begin() + offsets[g], weights.begin() + offsets[g + 1] };
+    }
+
+}; // struct TestData
+
+
+TestData makeTestData() {
+  TestData data;
+
+  // pseudo-random outputs, with some at 0 and 1 to exercise the clamping
+  unsigned int seed = 4321U;
+  auto const next = [&seed]()
+    { seed = seed * 1103515245U + 12345U; return (seed >> 16) & 0x7FFFU; };
+  std::size_t const nItems = 30U;
+  for (std::size_t iItem = 0; iItem < nItems; ++iItem) {
+    std::array<float, N> out;
+    float sum = 0.0;
+    for (float& p: out) sum += (p = float(next() % 1000U) + 1.0);
+    for (float& p: out) p /= sum;
+    if (iItem % 7U == 3U) out = { 0.0, 1.0, 0.0, 0.0 };
+    data.outs.emplace_back(out);
+    data.flatOuts.insert(data.flatOuts.end(), out.begin(), out.end());
+  } // for
+
+  // groups: empty ones (also first and last), single items, repeated items
+  std::vector<std::vector<std::size_t>> const groups {
+    {}, { 5 }, { 0, 1, 2 }, {}, { 3, 10, 3, 17, 29 }, { 24, 23, 22, 21 }, {},
+    { 9, 8, 7, 6, 5, 4, 3, 2, 1, 0, 11, 12, 13 }, {}
+  };
+  data.offsets.push_back(0U);
+  for (auto const& group: groups) {
+    data.keys.insert(data.keys.end(), group.begin(), group.end());
+    data.offsets.push_back(data.keys.size());
+  } // for
+
+  // weights, including some null ones (but not all in a group)
+  for (std::size_t k = 0; k < data.keys.size(); ++k)
+    data.weights.push_back((k % 5U == 2U)? 0.0: float(next() % 100U) / 10.0);
+
+  return data;
+} // makeTestData()
+
+
+/// Checks two accumulated outputs with the same number of components.
+void checkSameOutput
+  (std::array<float, N> const& result, std::array<float, N> const& expected)
+{
+  for (std::size_t i = 0; i < N; ++i)
+    BOOST_CHECK_CLOSE(result[i], expected[i], 1e-4); // percent
+} // checkSameOutput()
+
+
+//------------------------------------------------------------------------------
+void unweightedGroupsTest() {
+  Accumulator const acc;
+  TestData const data = makeTestData();
+  std::size_t const nGroups = data.offsets.size() - 1U;
+
+  auto const results = acc.pAccumulateGroups<N>
+    (data.offsets, data.keys, data.flatOuts.data());
+  BOOST_TEST_REQUIRE(results.size() == nGroups);
+
+  for (std::size_t g = 0; g < nGroups; ++g) {
+    BOOST_TEST_MESSAGE("Group #" << g);
+    checkSameOutput(results[g], acc.pAccumulate(data.items(g), data.outs));
+    if (data.offsets[g] == data.offsets[g + 1]) {
+      for (float p: results[g]) BOOST_CHECK_CLOSE(p, 1.0 / N, 1e-4);
+    }
+  } // for
+} // unweightedGroupsTest()
+
+
+void weightedGroupsTest() {
+  Accumulator const acc;
+  TestData const data = makeTestData();
+  std::size_t const nGroups = data.offsets.size() - 1U;
+
+  auto const results = acc.pAccumulateGroups<N>(
+    data.offsets, data.keys, data.flatOuts.data(),
+    [&data](std::size_t k){ return data.weights[k]; }
+    );
+  BOOST_TEST_REQUIRE(results.size() == nGroups);
+
+  for (std::size_t g = 0; g < nGroups; ++g) {
+    BOOST_TEST_MESSAGE("Group #" << g);
+    checkSameOutput(
+      results[g],
+      acc.pAccumulate(data.items(g), data.groupWeights(g), data.outs)
+      );
+  } // for
+} // weightedGroupsTest()
+
+
+void noGroupsTest() {
+  Accumulator const acc;
+  std::vector<float> const outs;
+
+  BOOST_CHECK(acc.pAccumulateGroups<N>({}, {}, outs.data()).empty());
+  BOOST_CHECK(acc.pAccumulateGroups<N>({ 0U }, {}, outs.data()).empty());
+} // noGroupsTest()
+
+
+//------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(AccumulateGroupsTestCase) {
+  unweightedGroupsTest();
+  weightedGroupsTest();
+  noGroupsTest();
+} // BOOST_AUTO_TEST_CASE(AccumulateGroupsTestCase)
+
+
+//------------------------------------------------------------------------------
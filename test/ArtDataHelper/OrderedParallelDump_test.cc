@@ -0,0 +1,117 @@
+/**
+ * @file   lardata/test/ArtDataHelper/OrderedParallelDump_test.cc
+ * @brief  Unit test for `recob::dumper::dumpInOrder()`.
+ * @date   October 18, 2026
+ * @see    lardata/ArtDataHelper/Dumpers/OrderedParallelDump.h
+ *
+ * This is a Boost unit test with no specific configuration.
+ */
+
+// LArSoft libraries
+#include "lardata/ArtDataHelper/Dumpers/OrderedParallelDump.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( OrderedParallelDump_test )
+#include <boost/test/unit_test.hpp> // BOOST_AUTO_TEST_CASE()
+#include <boost/test/test_tools.hpp> // BOOST_CHECK(), BOOST_CHECK_EQUAL()
+
+// C/C++ standard libraries
+#include <vector>
+#include <string>
+#include <ostream>
+#include <iomanip> // std::setprecision()
+#include <ios> // std::fixed
+#include <stdexcept> // std::runtime_error
+#include <cstddef> // std::size_t
+
+
+//------------------------------------------------------------------------------
+/// Formats an item, leaving the stream with modified format flags.
+void formatItem(std::ostream& out, std::size_t i) {
+  double const value = i * 0.37;
+  out << "item #" << i << ": " << value
+    << " (" << std::fixed << std::setprecision(3) << value << ")";
+} // formatItem()
+
+
+/// Returns the dump of `nItems` items made with `nThreads` threads.
+std::vector<std::string> dump
+  (std::size_t nItems, unsigned int nThreads, std::size_t chunkSize)
+{
+  std::vector<std::string> messages;
+  recob::dumper::dumpInOrder(nItems, nThreads, formatItem,
+    [&messages](std::string const& text){ messages.push_back(text); },
+    chunkSize
+    );
+  return messages;
+} // dump()
+
+
+//------------------------------------------------------------------------------
+void OrderTest() {
+
+  std::size_t const nItems = 10000U;
+
+  std::vector<std::string> const expected = dump(nItems, 1U, 64U);
+  BOOST_REQUIRE_EQUAL(expected.size(), nItems);
+  // format flags of one item do not leak into the next one
+  BOOST_CHECK_EQUAL(expected[1], "item #1: 0.37 (0.370)");
+  BOOST_CHECK_EQUAL(expected[2], "item #2: 0.74 (0.740)");
+
+  for (unsigned int nThreads: { 0U, 2U, 7U }) {
+    for (std::size_t chunkSize: { 1U, 13U, 64U, 20000U }) {
+      BOOST_TEST_MESSAGE
+        ("Threads: " << nThreads << ", chunk size: " << chunkSize);
+      std::vector<std::string> const messages
+        = dump(nItems, nThreads, chunkSize);
+      BOOST_CHECK_EQUAL_COLLECTIONS(
+        messages.begin(), messages.end(), expected.begin(), expected.end()
+        );
+    } // for chunk size
+  } // for threads
+
+  BOOST_CHECK(dump(0U, 4U, 64U).empty());
+
+} // OrderTest()
+
+
+//------------------------------------------------------------------------------
+void ExceptionTest() {
+
+  // exception from the formatting
+  BOOST_CHECK_THROW(
+    recob::dumper::dumpInOrder(1000U, 4U,
+      [](std::ostream&, std::size_t i)
+        { if (i == 500U) throw std::runtime_error("format"); },
+      [](std::string const&){},
+      10U
+      ),
+    std::runtime_error
+    );
+
+  // exception from the output: no more output after it
+  std::size_t nEmitted = 0U;
+  BOOST_CHECK_THROW(
+    recob::dumper::dumpInOrder(1000U, 4U, formatItem,
+      [&nEmitted](std::string const&)
+        { if (++nEmitted == 300U) throw std::runtime_error("emit"); },
+      10U
+      ),
+    std::runtime_error
+    );
+  BOOST_CHECK_EQUAL(nEmitted, 300U);
+
+} // ExceptionTest()
+
+
+//------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(OrderTestCase) {
+  OrderTest();
+} // BOOST_AUTO_TEST_CASE(OrderTestCase)
+
+BOOST_AUTO_TEST_CASE(ExceptionTestCase) {
+  ExceptionTest();
+} // BOOST_AUTO_TEST_CASE(ExceptionTestCase)
+
+
+//------------------------------------------------------------------------------
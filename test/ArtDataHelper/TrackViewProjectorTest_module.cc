@@ -0,0 +1,319 @@
+/**
+ * @file   TrackViewProjectorTest_module.cc
+ * @brief  Tests `lar::util::TrackViewProjector` against the single track utilities.
+ * @date   October 18, 2026
+ * @see    lardata/ArtDataHelper/TrackUtils.h
+ *
+ */
+
+
+// LArSoft libraries
+#include "lardata/ArtDataHelper/TrackUtils.h"
+#include "larcore/Geometry/Geometry.h"
+#include "larcore/CoreUtils/ServiceUtil.h" // lar::providerFrom<>()
+#include "larcorealg/Geometry/GeometryCore.h"
+#include "larcorealg/Geometry/TPCGeo.h"
+#include "larcorealg/Geometry/PlaneGeo.h"
+#include "larcorealg/Geometry/BoxBoundedGeo.h"
+#include "lardataobj/RecoBase/Track.h"
+#include "lardataobj/RecoBase/TrackTrajectory.h"
+#include "lardataobj/RecoBase/TrackingTypes.h" // recob::tracking::SMatrixSym55
+#include "larcoreobj/SimpleTypesAndConstants/geo_vectors.h" // geo::Vector_t
+
+// framework libraries
+#include "art/Framework/Core/EDAnalyzer.h"
+#include "art/Framework/Core/ModuleMacros.h"
+#include "art/Framework/Principal/Event.h"
+#include "messagefacility/MessageLogger/MessageLogger.h"
+#include "cetlib_except/exception.h"
+#include "fhiclcpp/types/Atom.h"
+#include "fhiclcpp/types/Name.h"
+#include "fhiclcpp/types/Comment.h"
+
+// Boost libraries
+#include <boost/test/test_tools.hpp> // BOOST_CHECK()
+
+// C/C++ libraries
+#include <vector>
+#include <algorithm> // std::count(), std::max()
+#include <utility> // std::move()
+#include <cmath> // std::sin(), std::cos(), std::isinf()
+#include <cstddef> // std::size_t
+
+
+//------------------------------------------------------------------------------
+/**
+ * @brief Compares the results of `lar::util::TrackViewProjector` with the ones
+ *        of `lar::util::TrackProjectedLength()` and `TrackPitchInView()`.
+ *
+ * Synthetic tracks are created within the active volume of the first TPC of
+ * the geometry, and their projected length and pitch are computed for each
+ * view both in batch, with `lar::util::TrackViewProjector`, and one by one.
+ * The results are required to be the same.
+ *
+ * This module uses Boost unit test library, and as such it must be run with
+ * `lar_ut` instead of `lar`.
+ */
+class TrackViewProjectorTest : public art::EDAnalyzer {
+    public:
+
+  struct Config {
+    using Name = fhicl::Name;
+    using Comment = fhicl::Comment;
+
+    fhicl::Atom<unsigned int> nTracks{
+      Name("nTracks"),
+      Comment("number of synthetic tracks to test"),
+      20U
+      };
+
+    fhicl::Atom<unsigned int> nPoints{
+      Name("nPoints"),
+      Comment("number of trajectory points in each track"),
+      12U
+      };
+
+  }; // struct Config
+
+  using Parameters = art::EDAnalyzer::Table<Config>;
+
+  explicit TrackViewProjectorTest(Parameters const& config)
+    : art::EDAnalyzer(config)
+    , fNTracks(config().nTracks())
+    , fNPoints(config().nPoints())
+    {}
+
+  virtual void analyze(art::Event const& event) override;
+
+    private:
+  unsigned int fNTracks; ///< Number of tracks to test.
+  unsigned int fNPoints; ///< Number of trajectory points per track.
+
+  /// Returns a track starting at `start` with a slowly turning direction.
+  recob::Track makeTrack
+    (geo::Point_t start, double theta, double phi, double turn) const;
+
+  /// Returns the synthetic tracks within `box`.
+  std::vector<recob::Track> makeTracks(geo::BoxBoundedGeo const& box) const;
+
+  /// Tests that batch projected lengths equal the single track ones.
+  void testProjectedLengths(
+    lar::util::TrackViewProjector const& projector,
+    std::vector<recob::Track> const& tracks
+    ) const;
+
+  /// Tests that batch pitches equal the single track ones.
+  void testPitches(
+    lar::util::TrackViewProjector const& projector,
+    std::vector<recob::Track> const& tracks
+    ) const;
+
+  /// Tests a track parallel to the wires of a view.
+  void testParallelTrack(
+    lar::util::TrackViewProjector const& projector,
+    geo::TPCGeo const& tpc
+    ) const;
+
+}; // class TrackViewProjectorTest
+
+
+//------------------------------------------------------------------------------
+recob::Track TrackViewProjectorTest::makeTrack
+  (geo::Point_t start, double theta, double phi, double turn) const
+{
+  recob::TrackTrajectory::Positions_t positions;
+  recob::TrackTrajectory::Momenta_t momenta;
+  geo::Point_t pos = start;
+  for (unsigned int iPoint = 0; iPoint < fNPoints; ++iPoint) {
+    double const t = theta + turn * iPoint, p = phi + 0.5 * turn * iPoint;
+    geo::Vector_t const dir
+      { std::sin(t) * std::cos(p), std::sin(t) * std::sin(p), std::cos(t) };
+    positions.push_back(pos);
+    momenta.push_back(dir * 2.0); // 2 GeV/c
+    pos += dir * 1.5; // 1.5 cm steps
+  } // for points
+  recob::TrackTrajectory::Flags_t flags(positions.size());
+
+  return recob::Track(
+    recob::TrackTrajectory
+      (std::move(positions), std::move(momenta), std::move(flags), true),
+    13, 1.0, 1,
+    recob::tracking::SMatrixSym55{}, recob::tracking::SMatrixSym55{},
+    0
+    );
+} // TrackViewProjectorTest::makeTrack()
+
+
+//------------------------------------------------------------------------------
+std::vector<recob::Track> TrackViewProjectorTest::makeTracks
+  (geo::BoxBoundedGeo const& box) const
+{
+  // tracks start in the middle part of the volume and are short enough
+  // (fNPoints x 1.5 cm) to stay in it
+  std::vector<recob::Track> tracks;
+  for (unsigned int iTrack = 0; iTrack < fNTracks; ++iTrack) {
+    double const f = 0.3 + 0.4 * iTrack / std::max(fNTracks, 1U);
+    geo::Point_t const start {
+      box.MinX() + f * (box.MaxX() - box.MinX()),
+      box.MinY() + (1.0 - f) * (box.MaxY() - box.MinY()),
+      box.MinZ() + f * (box.MaxZ() - box.MinZ())
+      };
+    double const theta = 0.1 + 2.9 * iTrack / std::max(fNTracks, 1U);
+    double const phi = 0.37 * iTrack;
+    double const turn = (iTrack % 3 == 0)? 0.0: 0.02 * (iTrack % 3);
+    tracks.push_back(makeTrack(start, theta, phi, turn));
+  } // for
+  return tracks;
+} // TrackViewProjectorTest::makeTracks()
+
+
+//------------------------------------------------------------------------------
+void TrackViewProjectorTest::testProjectedLengths(
+  lar::util::TrackViewProjector const& projector,
+  std::vector<recob::Track> const& tracks
+) const {
+
+  // batch, from tracks and from pointers to tracks
+  lar::util::TrackViewTable const lengths = projector.ProjectedLengths(tracks);
+  std::vector<recob::Track const*> trackPtrs;
+  for (recob::Track const& track: tracks) trackPtrs.push_back(&track);
+  lar::util::TrackViewTable const lengthsFromPtrs
+    = projector.ProjectedLengths(trackPtrs);
+
+  BOOST_CHECK(lengths.views == projector.Views());
+  BOOST_TEST_REQUIRE(lengths.values.size() == projector.NViews());
+
+  for (std::size_t iView = 0; iView < projector.NViews(); ++iView) {
+    geo::View_t const view = projector.Views()[iView];
+    BOOST_TEST_MESSAGE("View " << geo::PlaneGeo::ViewName(view));
+
+    // view-major layout: values[iView][iTrack]
+    std::vector<double> const& viewLengths = lengths.forView(view);
+    BOOST_CHECK_EQUAL(&viewLengths, &(lengths.values[iView]));
+    BOOST_TEST_REQUIRE(viewLengths.size() == tracks.size());
+
+    for (std::size_t iTrack = 0; iTrack < tracks.size(); ++iTrack) {
+      double const expected
+        = lar::util::TrackProjectedLength(tracks[iTrack], view);
+      BOOST_TEST_MESSAGE("  track #" << iTrack << ": " << expected << " cm");
+      BOOST_CHECK_CLOSE(viewLengths[iTrack], expected, 1e-10);
+      BOOST_CHECK_CLOSE
+        (lengthsFromPtrs.values[iView][iTrack], expected, 1e-10);
+      BOOST_CHECK_CLOSE
+        (projector.ProjectedLength(tracks[iTrack], view), expected, 1e-10);
+    } // for tracks
+  } // for views
+
+  BOOST_CHECK_THROW
+    (projector.ProjectedLength(tracks.front(), geo::kUnknown), cet::exception);
+
+} // TrackViewProjectorTest::testProjectedLengths()
+
+
+//------------------------------------------------------------------------------
+void TrackViewProjectorTest::testPitches(
+  lar::util::TrackViewProjector const& projector,
+  std::vector<recob::Track> const& tracks
+) const {
+
+  for (std::size_t point: { std::size_t(0U), std::size_t(fNPoints / 2U) }) {
+    BOOST_TEST_MESSAGE("Pitch at trajectory point #" << point);
+
+    lar::util::TrackViewTable const pitches
+      = projector.PitchesInViews(tracks, point);
+    BOOST_CHECK(pitches.views == projector.Views());
+    BOOST_TEST_REQUIRE(pitches.values.size() == projector.NViews());
+
+    for (std::size_t iView = 0; iView < projector.NViews(); ++iView) {
+      geo::View_t const view = projector.Views()[iView];
+      BOOST_TEST_MESSAGE("View " << geo::PlaneGeo::ViewName(view));
+      std::vector<double> const& viewPitches = pitches.forView(view);
+      BOOST_TEST_REQUIRE(viewPitches.size() == tracks.size());
+
+      for (std::size_t iTrack = 0; iTrack < tracks.size(); ++iTrack) {
+        double const expected
+          = lar::util::TrackPitchInView(tracks[iTrack], view, point);
+        BOOST_TEST_MESSAGE("  track #" << iTrack << ": " << expected << " cm");
+        BOOST_CHECK_CLOSE(viewPitches[iTrack], expected, 1e-10);
+      } // for tracks
+    } // for views
+  } // for points
+
+  BOOST_CHECK_THROW
+    (projector.PitchesInViews(tracks, fNPoints), cet::exception);
+
+} // TrackViewProjectorTest::testPitches()
+
+
+//------------------------------------------------------------------------------
+void TrackViewProjectorTest::testParallelTrack(
+  lar::util::TrackViewProjector const& projector,
+  geo::TPCGeo const& tpc
+) const {
+  /*
+   * A track along the wires of the first view: the single track pitch throws,
+   * the batch one is infinite on that view, and the other views are unaffected.
+   */
+  geo::View_t const parallelView = projector.Views().front();
+  geo::Vector_t const wireDir
+    = tpc.Plane(parallelView).GetWireDirection<geo::Vector_t>();
+
+  geo::BoxBoundedGeo const& box = tpc.ActiveBoundingBox();
+  geo::Point_t const start {
+    0.5 * (box.MinX() + box.MaxX()),
+    0.5 * (box.MinY() + box.MaxY()),
+    0.5 * (box.MinZ() + box.MaxZ())
+    };
+  std::vector<recob::Track> const tracks
+    { makeTrack(start, wireDir.Theta(), wireDir.Phi(), 0.0) };
+
+  lar::util::TrackViewTable const pitches = projector.PitchesInViews(tracks);
+  for (std::size_t iView = 0; iView < projector.NViews(); ++iView) {
+    geo::View_t const view = projector.Views()[iView];
+    double const pitch = pitches.values[iView][0];
+    if (view == parallelView) {
+      BOOST_CHECK(std::isinf(pitch));
+      BOOST_CHECK_THROW(
+        lar::util::TrackPitchInView(tracks.front(), view), cet::exception
+        );
+    }
+    else {
+      BOOST_CHECK_CLOSE
+        (pitch, lar::util::TrackPitchInView(tracks.front(), view), 1e-10);
+    }
+  } // for views
+
+} // TrackViewProjectorTest::testParallelTrack()
+
+
+//------------------------------------------------------------------------------
+void TrackViewProjectorTest::analyze(art::Event const&) {
+
+  geo::GeometryCore const& geom = *(lar::providerFrom<geo::Geometry>());
+  geo::TPCGeo const& tpc = geom.TPC();
+
+  lar::util::TrackViewProjector const projector { geom };
+  mf::LogVerbatim("TrackViewProjectorTest")
+    << "Testing " << fNTracks << " tracks on " << projector.NViews()
+    << " views";
+
+  // the projector covers all the views of the geometry
+  BOOST_CHECK_EQUAL(projector.NViews(), geom.Views().size());
+  for (geo::View_t view: geom.Views()) {
+    BOOST_CHECK(std::count
+      (projector.Views().begin(), projector.Views().end(), view) == 1
+      );
+  }
+
+  std::vector<recob::Track> const tracks
+    = makeTracks(tpc.ActiveBoundingBox());
+
+  testProjectedLengths(projector, tracks);
+  testPitches(projector, tracks);
+  testParallelTrack(projector, tpc);
+
+} // TrackViewProjectorTest::analyze()
+
+
+//------------------------------------------------------------------------------
+DEFINE_ART_MODULE(TrackViewProjectorTest)
@@ -0,0 +1,163 @@
+/**
+ * @file   WireROIBuilder_benchmark.cc
+ * @brief  Compares `recob::WireROIBuilder` with dense region extraction.
+ * @date   October 18, 2026
+ * @see    lardata/ArtDataHelper/WireCreator.h
+ *
+ * For each channel of a synthetic event, the regions of interest are built in
+ * two ways:
+ * 1. *dense*: the full waveform is written into a buffer, which is then scanned
+ *    for regions above threshold, in the way deconvolution code usually does
+ * 2. *streaming*: each sample is fed to a `recob::WireROIBuilder`
+ *
+ * The two results are required to be identical; the time spent and the size
+ * of the working buffers are printed.
+ * The program returns non-zero if the two methods disagree.
+ *
+ * Usage: `WireROIBuilder_benchmark [channels] [ticks]`
+ * (default: 10000 channels with 6000 ticks each).
+ */
+
+// LArSoft libraries
+#include "lardata/ArtDataHelper/WireCreator.h"
+
+// C/C++ standard libraries
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <string>
+#include <algorithm> // std::max(), std::min(), std::equal()
+#include <cmath> // std::abs()
+#include <cstddef> // std::size_t
+
+
+//------------------------------------------------------------------------------
+using RegionsOfInterest_t = recob::WireROIBuilder::RegionsOfInterest_t;
+using Sample_t = recob::WireROIBuilder::Sample_t;
+
+constexpr Sample_t Threshold = 3.0;
+constexpr std::size_t PadBefore = 5U;
+constexpr std::size_t PadAfter = 10U;
+
+
+/// Returns the synthetic signal of a channel at a tick: noise and few pulses.
+Sample_t sample(std::size_t channel, std::size_t tick) {
+  // noise below threshold
+  Sample_t value = Sample_t(((channel * 7919U + tick * 104729U) % 200U)) / 100.0
+    - 1.0;
+  // three pulses, 40 ticks long, at positions depending on the channel
+  for (std::size_t iPulse = 0; iPulse < 3U; ++iPulse) {
+    std::size_t const start = (channel * 37U + iPulse * 1999U) % 5900U;
+    if ((tick >= start) && (tick < start + 40U))
+      value += 20.0 - std::abs(Sample_t(tick - start) - 20.0);
+  } // for
+  return value;
+} // sample()
+
+
+/// Extracts the regions of interest from a full waveform.
+RegionsOfInterest_t denseROIs(std::vector<Sample_t> const& waveform) {
+
+  RegionsOfInterest_t ROIs;
+  std::size_t const nTicks = waveform.size();
+  auto const above
+    = [&waveform](std::size_t t){ return std::abs(waveform[t]) > Threshold; };
+
+  std::size_t lastEnd = 0U;
+  std::size_t tick = 0U;
+  while (tick < nTicks) {
+    if (!above(tick)) { ++tick; continue; }
+    std::size_t const begin
+      = std::max(lastEnd, (tick > PadBefore)? tick - PadBefore: 0U);
+    std::size_t last = tick++;
+    while ((tick < nTicks) && (tick - last <= PadAfter)) {
+      if (above(tick)) last = tick;
+      ++tick;
+    } // while
+    std::size_t const end = std::min(last + PadAfter + 1U, nTicks);
+    ROIs.add_range(begin, waveform.begin() + begin, waveform.begin() + end);
+    lastEnd = tick = end;
+  } // while
+  ROIs.resize(nTicks);
+  return ROIs;
+} // denseROIs()
+
+
+/// Returns whether two sets of regions of interest are identical.
+bool sameROIs(RegionsOfInterest_t const& a, RegionsOfInterest_t const& b) {
+  if (a.size() != b.size()) return false;
+  if (a.n_ranges() != b.n_ranges()) return false;
+  auto const& rangesA = a.get_ranges();
+  auto const& rangesB = b.get_ranges();
+  for (std::size_t i = 0; i < rangesA.size(); ++i) {
+    if (rangesA[i].begin_index() != rangesB[i].begin_index()) return false;
+    if (rangesA[i].end_index() != rangesB[i].end_index()) return false;
+    if (!std::equal(rangesA[i].begin(), rangesA[i].end(), rangesB[i].begin()))
+      return false;
+  } // for
+  return true;
+} // sameROIs()
+
+
+//------------------------------------------------------------------------------
+int main(int argc, char** argv) {
+
+  std::size_t const nChannels = (argc > 1)? std::stoul(argv[1]): 10000U;
+  std::size_t const nTicks = (argc > 2)? std::stoul(argv[2]): 6000U;
+
+  using Clock_t = std::chrono::steady_clock;
+  using Duration_t = std::chrono::duration<double, std::milli>;
+  Duration_t denseTime { 0.0 }, streamingTime { 0.0 };
+
+  std::size_t nROIs = 0U, nROISamples = 0U, maxROISize = 0U;
+  unsigned int nErrors = 0U;
+  for (std::size_t channel = 0; channel < nChannels; ++channel) {
+
+    // dense: full waveform buffer per channel, then scan
+    auto start = Clock_t::now();
+    std::vector<Sample_t> waveform(nTicks);
+    for (std::size_t tick = 0; tick < nTicks; ++tick)
+      waveform[tick] = sample(channel, tick);
+    RegionsOfInterest_t const dense = denseROIs(waveform);
+    denseTime += Clock_t::now() - start;
+
+    // streaming: samples fed to the builder
+    start = Clock_t::now();
+    recob::WireROIBuilder builder(nTicks, Threshold, PadBefore, PadAfter, 64U);
+    for (std::size_t tick = 0; tick < nTicks; ++tick)
+      builder.addSample(sample(channel, tick));
+    RegionsOfInterest_t const streamed = builder.finish();
+    streamingTime += Clock_t::now() - start;
+
+    if (!sameROIs(dense, streamed)) {
+      if (++nErrors <= 10U) {
+        std::cerr << "Channel #" << channel << ": " << dense.n_ranges()
+          << " regions from dense scan, " << streamed.n_ranges()
+          << " from streaming builder, and they differ!" << std::endl;
+      }
+    } // if mismatch
+
+    nROIs += streamed.n_ranges();
+    for (auto const& ROI: streamed.get_ranges()) {
+      nROISamples += ROI.size();
+      maxROISize = std::max(maxROISize, ROI.size());
+    }
+  } // for channels
+
+  std::cout << nChannels << " channels x " << nTicks << " ticks: "
+    << nROIs << " regions of interest with " << nROISamples << " samples"
+    << "\n  dense scan:       " << denseTime.count() << " ms, working buffer "
+    << (nTicks * sizeof(Sample_t)) << " bytes per channel"
+    << "\n  streaming build:  " << streamingTime.count()
+    << " ms, working buffer about "
+    << ((std::max<std::size_t>(maxROISize, 64U) + PadBefore) * sizeof(Sample_t))
+    << " bytes per channel"
+    << std::endl;
+
+  if (nErrors > 0U) {
+    std::cerr << nErrors << " channels differ between the two methods."
+      << std::endl;
+    return 1;
+  }
+  return 0;
+} // main()
@@ -0,0 +1,287 @@
+/**
+ * @file   WireROIBuilder_test.cc
+ * @brief  Unit test for `recob::WireROIBuilder`.
+ * @date   October 18, 2026
+ * @see    lardata/ArtDataHelper/WireCreator.h
+ *
+ * The regions of interest built by streaming the samples into a
+ * `recob::WireROIBuilder` are compared with the ones extracted from the full
+ * waveform by a straightforward scan of a dense buffer.
+ */
+
+// LArSoft libraries
+#include "lardata/ArtDataHelper/WireCreator.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( WireROIBuilder_test )
+#include <cetlib/quiet_unit_test.hpp> // BOOST_AUTO_TEST_CASE()
+#include <boost/test/test_tools.hpp> // BOOST_CHECK(), BOOST_CHECK_EQUAL()
+
+// C/C++ standard libraries
+#include <vector>
+#include <utility> // std::pair
+#include <algorithm> // std::max(), std::min()
+#include <cmath> // std::abs()
+#include <cstddef> // std::size_t
+
+
+//------------------------------------------------------------------------------
+using RegionsOfInterest_t = recob::WireROIBuilder::RegionsOfInterest_t;
+using Sample_t = recob::WireROIBuilder::Sample_t;
+using Waveform_t = std::vector<Sample_t>;
+using Range_t = std::pair<std::size_t, std::size_t>; // [ begin, end [
+
+
+/// Extracts the regions of interest from a full waveform.
+RegionsOfInterest_t denseROIs(
+  Waveform_t const& waveform, Sample_t threshold,
+  std::size_t padBefore, std::size_t padAfter
+) {
+  RegionsOfInterest_t ROIs;
+  std::size_t const nTicks = waveform.size();
+  auto const above = [&waveform, threshold](std::size_t t)
+    { return std::abs(waveform[t]) > threshold; };
+
+  std::size_t lastEnd = 0U;
+  std::size_t tick = 0U;
+  while (tick < nTicks) {
+    if (!above(tick)) { ++tick; continue; }
+    std::size_t const begin
+      = std::max(lastEnd, (tick > padBefore)? tick - padBefore: 0U);
+    std::size_t last = tick++;
+    while ((tick < nTicks) && (tick - last <= padAfter)) {
+      if (above(tick)) last = tick;
+      ++tick;
+    } // while
+    std::size_t const end = std::min(last + padAfter + 1U, nTicks);
+    ROIs.add_range(begin, waveform.begin() + begin, waveform.begin() + end);
+    lastEnd = tick = end;
+  } // while
+  ROIs.resize(nTicks);
+  return ROIs;
+} // denseROIs()
+
+
+/// Builds the regions of interest streaming all the samples of a waveform.
+RegionsOfInterest_t streamingROIs(
+  Waveform_t const& waveform, Sample_t threshold,
+  std::size_t padBefore, std::size_t padAfter
+) {
+  recob::WireROIBuilder builder
+    (waveform.size(), threshold, padBefore, padAfter);
+  for (Sample_t sample: waveform) builder.addSample(sample);
+  BOOST_CHECK_EQUAL(builder.currentTick(), waveform.size());
+  return builder.finish();
+} // streamingROIs()
+
+
+/// Checks that two sets of regions of interest are identical.
+void checkSameROIs
+  (RegionsOfInterest_t const& ROIs, RegionsOfInterest_t const& expected)
+{
+  BOOST_CHECK_EQUAL(ROIs.size(), expected.size());
+  BOOST_TEST_REQUIRE(ROIs.n_ranges() == expected.n_ranges());
+  auto const& ranges = ROIs.get_ranges();
+  auto const& expectedRanges = expected.get_ranges();
+  for (std::size_t i = 0; i < expectedRanges.size(); ++i) {
+    BOOST_TEST_MESSAGE("Region #" << i);
+    auto const& range = ranges[i];
+    auto const& expectedRange = expectedRanges[i];
+    BOOST_CHECK_EQUAL(range.begin_index(), expectedRange.begin_index());
+    BOOST_CHECK_EQUAL(range.end_index(), expectedRange.end_index());
+    BOOST_CHECK_EQUAL_COLLECTIONS(
+      range.begin(), range.end(), expectedRange.begin(), expectedRange.end()
+      );
+  } // for
+} // checkSameROIs()
+
+
+/// Checks the extent of the regions of interest.
+void checkRanges
+  (RegionsOfInterest_t const& ROIs, std::vector<Range_t> const& expected)
+{
+  BOOST_TEST_REQUIRE(ROIs.n_ranges() == expected.size());
+  auto const& ranges = ROIs.get_ranges();
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    BOOST_TEST_MESSAGE("Region #" << i);
+    BOOST_CHECK_EQUAL(ranges[i].begin_index(), expected[i].first);
+    BOOST_CHECK_EQUAL(ranges[i].end_index(), expected[i].second);
+  } // for
+} // checkRanges()
+
+
+/// Checks streaming against dense extraction, and the expected extent.
+void checkWaveform(
+  Waveform_t const& waveform, Sample_t threshold,
+  std::size_t padBefore, std::size_t padAfter,
+  std::vector<Range_t> const& expected
+) {
+  RegionsOfInterest_t const dense
+    = denseROIs(waveform, threshold, padBefore, padAfter);
+  RegionsOfInterest_t const streaming
+    = streamingROIs(waveform, threshold, padBefore, padAfter);
+  checkRanges(dense, expected);
+  checkSameROIs(streaming, dense);
+} // checkWaveform()
+
+
+/// Returns a waveform with `nTicks` ticks, with the specified pulses.
+Waveform_t makeWaveform
+  (std::size_t nTicks, std::vector<std::pair<std::size_t, Sample_t>> pulses)
+{
+  Waveform_t waveform(nTicks);
+  for (std::size_t tick = 0; tick < nTicks; ++tick) // noise below threshold
+    waveform[tick] = Sample_t((tick * 7U) % 5U) / 10.0 - 0.2;
+  for (auto const& pulse: pulses) waveform[pulse.first] = pulse.second;
+  return waveform;
+} // makeWaveform()
+
+
+//------------------------------------------------------------------------------
+void isolatedROITest() {
+  /*
+   * A single pulse two ticks long, and a negative one: padding on both sides.
+   */
+  Waveform_t const waveform
+    = makeWaveform(100U, { { 30U, 5.0 }, { 31U, 4.0 }, { 70U, -6.0 } });
+  checkWaveform(waveform, 1.0, 3U, 5U, { { 27U, 37U }, { 67U, 76U } });
+  checkWaveform(waveform, 1.0, 0U, 0U, { { 30U, 32U }, { 70U, 71U } });
+} // isolatedROITest()
+
+
+void mergedROITest() {
+  /*
+   * A pulse within the padding after the previous one extends its region.
+   */
+  checkWaveform(
+    makeWaveform(100U, { { 30U, 5.0 }, { 34U, 5.0 }, { 39U, 5.0 } }),
+    1.0, 3U, 5U, { { 27U, 45U } }
+    );
+  // the padding before the second pulse overlaps the first region
+  checkWaveform(
+    makeWaveform(100U, { { 30U, 5.0 }, { 39U, 5.0 } }),
+    1.0, 2U, 6U, { { 28U, 46U } }
+    );
+} // mergedROITest()
+
+
+void adjacentROITest() {
+  /*
+   * Pulses whose padded regions are adjacent are stored in a single region;
+   * if there is a gap, the padding before the second region does not include
+   * samples of the first one.
+   */
+  // the second region would start right at the end of the first one
+  checkWaveform(
+    makeWaveform(100U, { { 30U, 5.0 }, { 40U, 5.0 } }),
+    1.0, 3U, 6U, { { 27U, 47U } }
+    );
+  // one tick between the regions
+  checkWaveform(
+    makeWaveform(100U, { { 30U, 5.0 }, { 41U, 5.0 } }),
+    1.0, 3U, 6U, { { 27U, 37U }, { 38U, 48U } }
+    );
+} // adjacentROITest()
+
+
+void edgeROITest() {
+  /*
+   * Pulses at the very beginning and end of the waveform: padding is
+   * truncated; also, a waveform with no region at all.
+   */
+  checkWaveform(
+    makeWaveform(50U, { { 0U, 5.0 }, { 1U, 5.0 }, { 49U, 5.0 } }),
+    1.0, 4U, 3U, { { 0U, 5U }, { 45U, 50U } }
+    );
+  checkWaveform(
+    makeWaveform(50U, { { 2U, 5.0 }, { 47U, 5.0 } }),
+    1.0, 4U, 3U, { { 0U, 6U }, { 43U, 50U } }
+    );
+  checkWaveform(makeWaveform(50U, {}), 1.0, 4U, 3U, {});
+  checkWaveform(makeWaveform(0U, {}), 1.0, 4U, 3U, {});
+} // edgeROITest()
+
+
+void randomWaveformTest() {
+  /*
+   * Pseudo-random waveforms, compared with the dense extraction for several
+   * padding settings.
+   */
+  unsigned int seed = 12345U;
+  auto const next = [&seed]()
+    { seed = seed * 1103515245U + 12345U; return (seed >> 16) & 0x7FFFU; };
+
+  for (std::size_t padBefore: { 0U, 1U, 3U, 8U }) {
+    for (std::size_t padAfter: { 0U, 1U, 4U, 10U }) {
+      BOOST_TEST_MESSAGE("Padding: " << padBefore << " + " << padAfter);
+      Waveform_t waveform(500U);
+      for (Sample_t& sample: waveform) {
+        unsigned int const r = next();
+        sample = (r % 23U == 0U)
+          ? Sample_t(r % 11U) - 5.0 // occasional large (positive or negative)
+          : Sample_t(r % 100U) / 100.0 - 0.5; // noise
+      } // for
+      checkSameROIs(
+        streamingROIs(waveform, 1.0, padBefore, padAfter),
+        denseROIs(waveform, 1.0, padBefore, padAfter)
+        );
+    } // for padAfter
+  } // for padBefore
+} // randomWaveformTest()
+
+
+void addROITest() {
+  /*
+   * Regions added directly, between streamed samples.
+   */
+  Waveform_t const waveform = makeWaveform
+    (40U, { { 10U, 5.0 }, { 11U, 6.0 }, { 20U, 7.0 }, { 38U, 9.0 } });
+  Waveform_t const ROI { 1.0, 2.0 };
+
+  // region added while no region is being scanned
+  recob::WireROIBuilder builder(40U, 1.0);
+  builder.addSamples(waveform.begin(), waveform.begin() + 15);
+  BOOST_CHECK_EQUAL(builder.nROIs(), 1U);
+  builder.addROI(15U, ROI.begin(), ROI.end());
+  BOOST_CHECK_EQUAL(builder.currentTick(), 17U);
+  builder.addSamples(waveform.begin() + 17, waveform.end());
+  RegionsOfInterest_t const ROIs = builder.finish();
+  BOOST_CHECK_EQUAL(ROIs.size(), 40U);
+  checkRanges(ROIs, { { 10U, 12U }, { 15U, 17U }, { 20U, 21U }, { 38U, 39U } });
+  auto const& added = ROIs.get_ranges()[1];
+  BOOST_CHECK_EQUAL_COLLECTIONS
+    (added.begin(), added.end(), ROI.begin(), ROI.end());
+
+  // region added while a region is being scanned: the latter is closed first,
+  // and the padding of the next region does not reach into the added one
+  recob::WireROIBuilder padded(40U, 1.0, 3U, 3U);
+  padded.addSamples(waveform.begin(), waveform.begin() + 13);
+  padded.addROI(14U, ROI.begin(), ROI.end());
+  BOOST_CHECK_EQUAL(padded.currentTick(), 16U);
+  padded.addSamples(waveform.begin() + 16, waveform.end());
+  RegionsOfInterest_t const paddedROIs = padded.finish();
+  checkRanges(
+    paddedROIs, { { 7U, 13U }, { 14U, 16U }, { 17U, 24U }, { 35U, 40U } }
+    );
+  auto const& first = paddedROIs.get_ranges()[0];
+  BOOST_CHECK_EQUAL_COLLECTIONS
+    (first.begin(), first.end(), waveform.begin() + 7, waveform.begin() + 13);
+} // addROITest()
+
+
+//------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(ThresholdScanTestCase) {
+  isolatedROITest();
+  mergedROITest();
+  adjacentROITest();
+  edgeROITest();
+  randomWaveformTest();
+} // BOOST_AUTO_TEST_CASE(ThresholdScanTestCase)
+
+
+BOOST_AUTO_TEST_CASE(AddROITestCase) {
+  addROITest();
+} // BOOST_AUTO_TEST_CASE(AddROITestCase)
+
+
+//------------------------------------------------------------------------------
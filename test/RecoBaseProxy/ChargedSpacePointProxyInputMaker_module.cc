@@ -26,6 +26,8 @@
 
 // C/C++ standard libraries
 #include <memory> // std::make_unique()
+#include <utility> // std::move()
+#include <vector>
 
 
 namespace lar {
@@ -100,15 +102,23 @@ void lar::test::ChargedSpacePointProxyInputMaker::produce(art::Event& event) {
 
   const double err[6U] = { 1.0, 0.0, 1.0, 0.0, 0.0, 1.0 };
 
-  for (unsigned int iPoint = 0; iPoint < nPoints; ++iPoint) {
+  auto makePoint = [&err](unsigned int iPoint)
+    {
+      double const pos[3U]
+        = { double(iPoint), double(2.0 * iPoint), double(4.0 * iPoint) };
+      return recob::SpacePoint
+        { pos, err, 1.0 /* chisq */, int(iPoint) /* id */ };
+    };
+
+  // the first half of the points is added directly...
+  unsigned int const nDirectPoints = nPoints / 2U;
+  spacePoints.reserve(nDirectPoints);
+  for (unsigned int iPoint = 0; iPoint < nDirectPoints; ++iPoint) {
     BOOST_CHECK_EQUAL(spacePoints.size(), (std::size_t) iPoint);
 
-    double const pos[3U]
-      = { double(iPoint), double(2.0 * iPoint), double(4.0 * iPoint) };
-
     spacePoints.add(
-      { pos, err, 1.0 /* chisq */, int(iPoint) /* id */ }, // space point
-      { recob::PointCharge::Charge_t(iPoint) }                  // charge
+      makePoint(iPoint),                       // space point
+      { recob::PointCharge::Charge_t(iPoint) } // charge
       );
 
     mf::LogVerbatim("ChargedSpacePointProxyInputMaker")
@@ -118,7 +128,36 @@ void lar::test::ChargedSpacePointProxyInputMaker::produce(art::Event& event) {
       << " (ptr: " << spacePoints.lastChargePtr() << ")";
 
   } // for (iPoint)
+  BOOST_CHECK_EQUAL(spacePoints.size(), (std::size_t) nDirectPoints);
+
+  // ... and the second half via two buffers, the first one filled in bulk
+  spacePoints.makeBuffers(2U);
+  unsigned int const nFirstBufferPoints = (nPoints - nDirectPoints) / 2U;
+  std::vector<recob::SpacePoint> bulkPoints;
+  std::vector<recob::PointCharge> bulkCharges;
+  for (unsigned int iPoint = nDirectPoints; iPoint < nPoints; ++iPoint) {
+    if (iPoint < nDirectPoints + nFirstBufferPoints) {
+      bulkPoints.push_back(makePoint(iPoint));
+      bulkCharges.emplace_back(recob::PointCharge::Charge_t(iPoint));
+    }
+    else {
+      spacePoints.buffer(1U).add
+        (makePoint(iPoint), { recob::PointCharge::Charge_t(iPoint) });
+    }
+  } // for (iPoint)
+  spacePoints.buffer(0U).addAll(std::move(bulkPoints), std::move(bulkCharges));
+  BOOST_CHECK_EQUAL(spacePoints.buffer(0U).size(), nFirstBufferPoints);
+  BOOST_CHECK_EQUAL(spacePoints.size(), (std::size_t) nDirectPoints);
+
+  spacePoints.mergeBuffers();
   BOOST_CHECK_EQUAL(spacePoints.size(), (std::size_t) nPoints);
+  BOOST_CHECK(spacePoints.buffer(0U).empty());
+  BOOST_CHECK(spacePoints.buffer(1U).empty());
+  for (unsigned int iPoint = 0; iPoint < nPoints; ++iPoint) {
+    BOOST_CHECK_EQUAL(spacePoints.spacePoint(iPoint).ID(), int(iPoint));
+    BOOST_CHECK_EQUAL
+      (spacePoints.charge(iPoint).charge(), recob::PointCharge::Charge_t(iPoint));
+  } // for
 
   mf::LogInfo("ChargedSpacePointProxyInputMaker")
     << "Produced " << spacePoints.size() << " points and charges.";
@@ -0,0 +1,287 @@
+/**
+ * @file   TrackProxyBenchmark_module.cc
+ * @brief  Measures the cost of `proxy::Tracks` against `art::FindManyP`.
+ * @date   October 18, 2026
+ *
+ * The same information (hits and fit information of each track) is read in
+ * two ways: with a `proxy::Tracks` collection proxy and with the equivalent
+ * `art::FindManyP` and plain data product access. The time spent in each step
+ * is averaged on all the events and printed at the end of the job.
+ * If the two ways give different results, the job fails.
+ */
+
+// LArSoft libraries
+#include "lardata/RecoBaseProxy/Track.h" // proxy namespace
+#include "lardataobj/RecoBase/Track.h"
+#include "lardataobj/RecoBase/Hit.h"
+#include "lardataobj/RecoBase/TrackFitHitInfo.h"
+
+// framework libraries
+#include "art/Framework/Core/EDAnalyzer.h"
+#include "art/Framework/Core/ModuleMacros.h"
+#include "art/Framework/Principal/Event.h"
+#include "art/Framework/Principal/Handle.h"
+#include "canvas/Persistency/Common/FindManyP.h"
+#include "canvas/Persistency/Common/Ptr.h"
+#include "canvas/Utilities/InputTag.h"
+#include "canvas/Utilities/Exception.h"
+#include "messagefacility/MessageLogger/MessageLogger.h"
+#include "fhiclcpp/types/Atom.h"
+#include "fhiclcpp/types/Name.h"
+#include "fhiclcpp/types/Comment.h"
+
+// C/C++ standard libraries
+#include <map>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstddef> // std::size_t
+
+
+//------------------------------------------------------------------------------
+namespace lar {
+  namespace test {
+
+    /**
+     * @brief Times access to tracks via proxy and via `art::FindManyP`.
+     *
+     * For each event, and as many times as requested, the following steps are
+     * timed, each once with `proxy::Tracks` and once with `art::FindManyP`:
+     *
+     * * *construction*: creation of the proxy or of the `art::FindManyP` query
+     * * *hits*: loop on all the hits of all tracks, reading their integral
+     * * *points*: loop on all the trajectory points of all tracks, reading the
+     *     position, the hit and the fit information of each point
+     *
+     * The two methods are required to give the same result, and an exception
+     * is thrown at the first step where they do not. An estimation of
+     * the memory used by each method (not including the data products) is
+     * also reported.
+     *
+     * Configuration parameters
+     * =========================
+     *
+     * * *tracks* (input tag, mandatory): the tracks to be read; hits and fit
+     *     information must have been produced with the same tag
+     * * *repetitions* (unsigned integer, default: `1`): how many times each
+     *     measurement is repeated in each event
+     *
+     */
+    class TrackProxyBenchmark: public art::EDAnalyzer {
+        public:
+
+      struct Config {
+        using Name = fhicl::Name;
+        using Comment = fhicl::Comment;
+
+        fhicl::Atom<art::InputTag> tracksTag{
+          Name("tracks"),
+          Comment("tag of the recob::Track data products to read.")
+          };
+
+        fhicl::Atom<unsigned int> repetitions{
+          Name("repetitions"),
+          Comment("number of times each measurement is repeated per event"),
+          1U
+          };
+
+      }; // struct Config
+
+      using Parameters = art::EDAnalyzer::Table<Config>;
+
+      explicit TrackProxyBenchmark(Parameters const& config)
+        : art::EDAnalyzer(config)
+        , tracksTag(config().tracksTag())
+        , repetitions(config().repetitions())
+        {}
+
+      virtual void analyze(art::Event const& event) override;
+
+      virtual void endJob() override;
+
+        private:
+      using Clock_t = std::chrono::steady_clock;
+      using Duration_t = std::chrono::duration<double, std::milli>;
+
+      /// Accumulated timing of one step.
+      struct TimeStat_t {
+        Duration_t total { 0.0 };
+        unsigned int n = 0U;
+      }; // struct TimeStat_t
+
+      art::InputTag tracksTag; ///< Tag for the input tracks.
+      unsigned int repetitions; ///< Repetitions of each measurement.
+
+      std::map<std::string, TimeStat_t> timings; ///< Timing of each step.
+
+      std::size_t nHits = 0U; ///< Number of hits in the last event.
+      std::size_t nTracks = 0U; ///< Number of tracks in the last event.
+      std::size_t proxyMemory = 0U; ///< Estimated proxy memory (last event).
+      std::size_t findManyMemory = 0U; ///< Estimated query memory (last event).
+
+      /// Runs `f()`, adds its duration to the `step` timing, returns its value.
+      template <typename F>
+      auto timeIt(std::string const& step, F&& f);
+
+      /// Throws `art::Exception` if the results of the two methods differ.
+      void checkSame(std::string const& step, double proxy, double findMany)
+        const;
+
+    }; // class TrackProxyBenchmark
+
+  } // namespace test
+} // namespace lar
+
+
+//------------------------------------------------------------------------------
+template <typename F>
+auto lar::test::TrackProxyBenchmark::timeIt(std::string const& step, F&& f) {
+
+  auto const start = Clock_t::now();
+  auto result = f();
+  auto const stop = Clock_t::now();
+
+  TimeStat_t& stat = timings[step];
+  stat.total += Duration_t(stop - start);
+  ++stat.n;
+  return result;
+
+} // lar::test::TrackProxyBenchmark::timeIt()
+
+
+//------------------------------------------------------------------------------
+void lar::test::TrackProxyBenchmark::checkSame
+  (std::string const& step, double proxy, double findMany) const
+{
+  if (proxy == findMany) return;
+  throw art::Exception(art::errors::LogicError)
+    << "TrackProxyBenchmark: step '" << step << "': proxy result (" << proxy
+    << ") differs from art::FindManyP one (" << findMany << ")\n";
+} // lar::test::TrackProxyBenchmark::checkSame()
+
+
+//------------------------------------------------------------------------------
+void lar::test::TrackProxyBenchmark::analyze(art::Event const& event) {
+
+  auto const tracksHandle
+    = event.getValidHandle<std::vector<recob::Track>>(tracksTag);
+  auto const& tracksData = *tracksHandle;
+  auto const& fitInfoData
+    = *(event.getValidHandle<std::vector<std::vector<recob::TrackFitHitInfo>>>
+    (tracksTag));
+
+  for (unsigned int iRep = 0; iRep < repetitions; ++iRep) {
+
+    //
+    // construction
+    //
+    auto const hitsPerTrack = timeIt("construction (art::FindManyP)",
+      [&](){
+        return art::FindManyP<recob::Hit>(tracksHandle, event, tracksTag);
+      });
+
+    auto const tracks = timeIt("construction (proxy)",
+      [&](){
+        return proxy::getCollection<proxy::Tracks>
+          (event, tracksTag, proxy::withFitHitInfo());
+      });
+
+    //
+    // hit access
+    //
+    double const findManyHitSum = timeIt("hits (art::FindManyP)", [&](){
+      double sum = 0.0;
+      for (std::size_t iTrack = 0; iTrack < tracksData.size(); ++iTrack) {
+        for (art::Ptr<recob::Hit> const& hit: hitsPerTrack.at(iTrack))
+          sum += hit->Integral();
+      }
+      return sum;
+    });
+
+    double const proxyHitSum = timeIt("hits (proxy)", [&](){
+      double sum = 0.0;
+      for (auto const& track: tracks) {
+        for (auto const& hit: track.hits()) sum += hit->Integral();
+      }
+      return sum;
+    });
+
+    checkSame("hits", proxyHitSum, findManyHitSum);
+
+    //
+    // trajectory point access
+    //
+    double const findManyPointSum = timeIt("points (art::FindManyP)", [&](){
+      double sum = 0.0;
+      for (std::size_t iTrack = 0; iTrack < tracksData.size(); ++iTrack) {
+        recob::Track const& track = tracksData[iTrack];
+        auto const& hits = hitsPerTrack.at(iTrack);
+        auto const& fitInfo = fitInfoData[iTrack];
+        std::size_t const nPoints = track.NumberTrajectoryPoints();
+        for (std::size_t iPoint = 0; iPoint < nPoints; ++iPoint) {
+          sum += track.LocationAtPoint(iPoint).X();
+          if (iPoint < hits.size()) sum += hits[iPoint]->PeakTime();
+          sum += fitInfo[iPoint].hitMeas();
+        } // for points
+      } // for tracks
+      return sum;
+    });
+
+    double const proxyPointSum = timeIt("points (proxy)", [&](){
+      double sum = 0.0;
+      for (auto const& track: tracks) {
+        for (auto const& point: track.points()) {
+          sum += point.position().X();
+          recob::Hit const* hit = point.hit();
+          if (hit) sum += hit->PeakTime();
+          sum += point.fitInfoPtr()->hitMeas();
+        } // for points
+      } // for tracks
+      return sum;
+    });
+
+    checkSame("points", proxyPointSum, findManyPointSum);
+
+    //
+    // memory estimation
+    //
+    if (iRep > 0U) continue;
+
+    nTracks = tracksData.size();
+    nHits = 0U;
+    findManyMemory = sizeof(hitsPerTrack);
+    for (std::size_t iTrack = 0; iTrack < tracksData.size(); ++iTrack) {
+      auto const& hits = hitsPerTrack.at(iTrack);
+      nHits += hits.size();
+      findManyMemory += sizeof(hits) + hits.capacity() * sizeof(hits[0]);
+    } // for
+
+    // the proxy stores one boundary in the association per track, plus one
+    using HitIter_t = decltype(tracks[0].hits().begin());
+    proxyMemory = sizeof(tracks) + (nTracks + 1U) * sizeof(HitIter_t);
+
+  } // for repetitions
+
+} // lar::test::TrackProxyBenchmark::analyze()
+
+
+//------------------------------------------------------------------------------
+void lar::test::TrackProxyBenchmark::endJob() {
+
+  mf::LogInfo log("TrackProxyBenchmark");
+  log << "Timing of track access from '" << tracksTag.encode() << "' ("
+    << nTracks << " tracks with " << nHits << " hits in the last event):";
+  for (auto const& [ step, stat ]: timings) {
+    log << "\n  " << step << ": " << (stat.total.count() / stat.n)
+      << " ms average on " << stat.n << " measurements";
+  } // for
+  log << "\nEstimated memory (without data products): proxy "
+    << proxyMemory << " bytes, art::FindManyP " << findManyMemory << " bytes";
+
+} // lar::test::TrackProxyBenchmark::endJob()
+
+
+//------------------------------------------------------------------------------
+DEFINE_ART_MODULE(lar::test::TrackProxyBenchmark)
+
+//------------------------------------------------------------------------------
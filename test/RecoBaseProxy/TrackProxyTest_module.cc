@@ -9,6 +9,7 @@
 
 // LArSoft libraries
 #include "lardata/RecoBaseProxy/Track.h" // proxy namespace
+#include "lardata/RecoBaseProxy/HitColumns.h"
 #include "lardataobj/RecoBase/SpacePoint.h"
 #include "lardataobj/RecoBase/Track.h"
 #include "lardataobj/RecoBase/TrackTrajectory.h"
@@ -367,6 +368,39 @@ void TrackProxyTest::testTracks(art::Event const& event) {
   } // for
   BOOST_CHECK_EQUAL(iExpectedTrack, expectedTracks.size());
 
+  //
+  // hit columns
+  //
+  auto const hitColumns = proxy::makeTrackHitColumns(tracks);
+  BOOST_CHECK_EQUAL(hitColumns.nGroups(), expectedTracks.size());
+  auto const& channels = hitColumns.channels();
+  auto const& peakTimes = hitColumns.peakTimes();
+  auto const& integrals = hitColumns.integrals();
+  BOOST_CHECK_EQUAL(channels.size(), hitColumns.size());
+  std::size_t iHit = 0;
+  for (std::size_t iTrack = 0; iTrack < hitColumns.nGroups(); ++iTrack) {
+    BOOST_TEST_CHECKPOINT("Hit columns of track #" << iTrack);
+    auto const& expectedHits = hitsPerTrack.at(iTrack);
+    BOOST_CHECK_EQUAL(hitColumns.groupBegin(iTrack), iHit);
+    BOOST_CHECK_EQUAL(hitColumns.groupSize(iTrack), expectedHits.size());
+    BOOST_CHECK_EQUAL(
+      std::distance(
+        hitColumns.groupOf(integrals, iTrack).begin(),
+        hitColumns.groupOf(integrals, iTrack).end()
+        ),
+      expectedHits.size()
+      );
+    for (art::Ptr<recob::Hit> const& expectedHit: expectedHits) {
+      BOOST_CHECK_EQUAL
+        (std::addressof(hitColumns.hit(iHit)), expectedHit.get());
+      BOOST_CHECK_EQUAL(channels[iHit], expectedHit->Channel());
+      BOOST_CHECK_EQUAL(peakTimes[iHit], expectedHit->PeakTime());
+      BOOST_CHECK_EQUAL(integrals[iHit], expectedHit->Integral());
+      ++iHit;
+    } // for hits
+  } // for tracks
+  BOOST_CHECK_EQUAL(iHit, hitColumns.size());
+
 } // TrackProxyTest::testTracks()
 
 
@@ -53,6 +53,10 @@ namespace lar {
     *     for each produced track. If there are hits left after all the tracks
     *     specified here have been created, an additional track with all those
     *     hits is created. If there are not enough hits, an exception is thrown.
+    * * *repeatLast* (boolean, default: `false`): if set, after the tracks in
+    *     *hitsPerTrack* have been created, tracks with as many hits as the last
+    *     one in that list are created until hits run out (the very last track
+    *     may have fewer hits)
     *
     */
     class TrackProxyTrackMaker: public art::EDProducer {
@@ -72,6 +76,12 @@ namespace lar {
           Comment("number of hits per track; last takes all remaining ones.")
           };
 
+        fhicl::Atom<bool> repeatLast{
+          Name("repeatLast"),
+          Comment("keep making tracks as large as the last in hitsPerTrack"),
+          false
+          };
+
       }; // struct Config
 
       using Parameters = art::EDProducer::Table<Config>;
@@ -80,6 +90,7 @@ namespace lar {
         : EDProducer{config}
         , hitsTag(config().hitsTag())
         , hitsPerTrack(config().hitsPerTrack())
+        , repeatLast(config().repeatLast())
         {
           produces<std::vector<recob::TrackTrajectory>>();
           produces<art::Assns<recob::TrackTrajectory, recob::Hit>>();
@@ -94,6 +105,7 @@ namespace lar {
         private:
       art::InputTag hitsTag; ///< Input hit collection label.
       std::vector<unsigned int> hitsPerTrack; ///< Hits per produced track.
+      bool repeatLast; ///< Whether to repeat the last track size.
 
     };  // TrackProxyTrackMaker
 
@@ -130,6 +142,8 @@ void lar::test::TrackProxyTrackMaker::produce(art::Event& event) {
     // how many hits for this track:
     unsigned int const nTrackHits = (iTrack < hitsPerTrack.size())
       ? std::min(hitsPerTrack[iTrack], (unsigned int)(hits.size() - usedHits))
+      : (repeatLast && !hitsPerTrack.empty() && (hitsPerTrack.back() > 0))
+      ? std::min(hitsPerTrack.back(), (unsigned int)(hits.size() - usedHits))
       : (hits.size() - usedHits)
       ;
 
@@ -177,7 +191,7 @@ void lar::test::TrackProxyTrackMaker::produce(art::Event& event) {
         double(iPoint) * 1.5,              // aHitMeasErr2
         {},                                // aTrackStatePar
         { ROOT::Math::SMatrixIdentity{} }, // aTrackStateCov
-        hits[usedHits + iPoint].WireID()   // aWireId
+        hits[firstHit + iPoint].WireID()   // aWireId
         });
     } // for
 
@@ -0,0 +1,164 @@
+/**
+ * @file   lardata/test/Utilities/AssnsCSRIndex_test.cc
+ * @brief  Unit test for `util::AssnsCSRIndex` and `util::fillCSR()`.
+ * @date   October 18, 2026
+ *
+ * This is a Boost unit test with no specific configuration.
+ * The association is emulated by a simple collection of pairs of pointer-like
+ * objects, so that no framework library is needed.
+ */
+
+// LArSoft libraries
+#include "lardata/Utilities/AssnsCSRIndex.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( AssnsCSRIndex_test )
+#include <boost/test/unit_test.hpp> // BOOST_AUTO_TEST_CASE()
+#include <boost/test/test_tools.hpp> // BOOST_CHECK(), BOOST_CHECK_EQUAL()
+
+// C/C++ standard libraries
+#include <vector>
+#include <utility> // std::pair
+#include <cstddef> // std::size_t
+
+
+//------------------------------------------------------------------------------
+/// Emulates the part of `art::Ptr` interface used by the index.
+struct FakePtr {
+  int productID;
+  std::size_t index;
+
+  int id() const { return productID; }
+  std::size_t key() const { return index; }
+}; // struct FakePtr
+
+
+/// Emulates the part of `art::Assns` interface used by the index.
+template <typename Data>
+struct FakeAssns {
+  using assn_t = std::pair<FakePtr, FakePtr>;
+  using data_t = Data;
+
+  std::vector<assn_t> pairs;
+  std::vector<Data> metadata;
+
+  void add(FakePtr left, FakePtr right, Data data = {})
+    { pairs.emplace_back(left, right); metadata.push_back(data); }
+
+  std::size_t size() const { return pairs.size(); }
+  assn_t const& operator[] (std::size_t i) const { return pairs[i]; }
+  Data const& data(std::size_t i) const { return metadata[i]; }
+  auto begin() const { return pairs.begin(); }
+  auto end() const { return pairs.end(); }
+
+}; // struct FakeAssns
+
+
+/// Returns the content of a range as a vector.
+template <typename Range>
+std::vector<typename Range::value_type> toVector(Range const& range)
+  { return { range.begin(), range.end() }; }
+
+
+/// Returns a test association: left product 1 with 4 elements, right with 5.
+FakeAssns<double> makeTestAssns() {
+  FakeAssns<double> assns;
+  assns.add({ 1, 2 }, { 3, 4 }, 2.4);
+  assns.add({ 1, 0 }, { 3, 1 }, 0.1);
+  assns.add({ 1, 2 }, { 3, 0 }, 2.0);
+  assns.add({ 7, 1 }, { 3, 3 }, 1.3); // different left product
+  assns.add({ 1, 0 }, { 3, 4 }, 0.4);
+  assns.add({ 1, 3 }, { 3, 1 }, 3.1);
+  return assns;
+} // makeTestAssns()
+
+
+//------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(FillCSRTestCase) {
+
+  std::vector<std::pair<std::size_t, int>> const items
+    = { { 2U, 20 }, { 0U, 0 }, { 2U, 21 }, { 5U, 50 }, { 0U, 1 } };
+
+  auto const table = util::fillCSR<int>(items, 4U,
+    [](auto const& item){ return item.first; },
+    [](auto const& item){ return item.second; }
+    );
+
+  BOOST_CHECK_EQUAL(table.size(), 4U);
+  BOOST_CHECK_EQUAL(table.nValues(), 4U); // one item out of range
+  BOOST_CHECK((table.offsets == std::vector<std::size_t>{ 0, 2, 2, 4, 4 }));
+
+  BOOST_CHECK((toVector(table[0]) == std::vector<int>{ 0, 1 }));
+  BOOST_CHECK(table[1].empty());
+  BOOST_CHECK((toVector(table[2]) == std::vector<int>{ 20, 21 }));
+  BOOST_CHECK(table[3].empty());
+  BOOST_CHECK_EQUAL(table.count(2), 2U);
+
+} // FillCSRTestCase
+
+
+//------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(ForwardReverseTestCase) {
+
+  auto const assns = makeTestAssns();
+
+  auto index = util::makeAssnsCSRIndex(assns, 4U, 1);
+  BOOST_CHECK_EQUAL(index.size(), 4U);
+  BOOST_CHECK_EQUAL(index.nAssociations(), 5U);
+  BOOST_CHECK(!index.hasReverse());
+
+  using Keys_t = std::vector<std::size_t>;
+  BOOST_CHECK((toVector(index[0]) == Keys_t{ 1, 4 }));
+  BOOST_CHECK(index[1].empty());
+  BOOST_CHECK((toVector(index[2]) == Keys_t{ 4, 0 }));
+  BOOST_CHECK((toVector(index.forward()[3]) == Keys_t{ 1 }));
+
+  index.buildReverse(5U);
+  BOOST_CHECK(index.hasReverse());
+  auto const& reverse = index.reverse();
+  BOOST_CHECK_EQUAL(reverse.size(), 5U);
+  BOOST_CHECK((toVector(reverse[0]) == Keys_t{ 2 }));
+  BOOST_CHECK((toVector(reverse[1]) == Keys_t{ 0, 3 }));
+  BOOST_CHECK(reverse[2].empty());
+  BOOST_CHECK(reverse[3].empty()); // its association is on another product
+  BOOST_CHECK((toVector(reverse[4]) == Keys_t{ 0, 2 }));
+
+  // without the product filter, the other left product leaks in
+  auto const unfiltered = util::makeAssnsCSRIndex(assns, 4U);
+  BOOST_CHECK_EQUAL(unfiltered.nAssociations(), 6U);
+  BOOST_CHECK((toVector(unfiltered[1]) == Keys_t{ 3 }));
+
+} // ForwardReverseTestCase
+
+
+//------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(MetadataTestCase) {
+
+  auto const assns = makeTestAssns();
+
+  auto index = util::makeAssnsCSRIndexWithMetadata(assns, 4U);
+  static_assert(decltype(index)::hasMetadata);
+  index.buildReverse(5U);
+
+  using Data_t = std::vector<double>;
+  BOOST_CHECK((toVector(index.forwardMetadata(0)) == Data_t{ 0.1, 0.4 }));
+  BOOST_CHECK((toVector(index.forwardMetadata(1)) == Data_t{ 1.3 }));
+  BOOST_CHECK((toVector(index.forwardMetadata(2)) == Data_t{ 2.4, 2.0 }));
+  BOOST_CHECK((toVector(index.reverseMetadata(4)) == Data_t{ 0.4, 2.4 }));
+  BOOST_CHECK((toVector(index.reverseMetadata(1)) == Data_t{ 0.1, 3.1 }));
+
+} // MetadataTestCase
+
+
+//------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(EmptyTestCase) {
+
+  FakeAssns<double> const assns;
+  auto index = util::makeAssnsCSRIndex(assns, 3U);
+  index.buildReverse(0U);
+  BOOST_CHECK_EQUAL(index.size(), 3U);
+  BOOST_CHECK_EQUAL(index.nAssociations(), 0U);
+  for (std::size_t i = 0; i < index.size(); ++i) BOOST_CHECK(index[i].empty());
+  BOOST_CHECK_EQUAL(index.reverse().size(), 0U);
+
+} // EmptyTestCase
@@ -0,0 +1,80 @@
+/**
+ * @file   BulkAllocator_benchmark.cc
+ * @brief  Times filling lists with the standard and the bulk allocators.
+ * @date   October 18, 2026
+ * @see    lardata/Utilities/BulkAllocator.h
+ *
+ * Lists of integers are filled and destroyed from one and from four threads
+ * at once, each thread with its own list, first using `std::allocator` and
+ * then `lar::BulkAllocator`. The time taken in each case is printed.
+ * The program returns non-zero if the lists do not hold the expected values.
+ *
+ * Usage: `BulkAllocator_benchmark [elements]` (default: 1 million per list).
+ */
+
+// LArSoft libraries
+#include "lardata/Utilities/BulkAllocator.h"
+
+// C/C++ standard libraries
+#include <iostream>
+#include <list>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <string> // std::stoul()
+
+
+//------------------------------------------------------------------------------
+/// Fills and destroys one list per thread; returns the time in milliseconds.
+template <typename List>
+double FillListTime
+  (unsigned int NThreads, unsigned int NElements, unsigned int& nErrors)
+{
+  std::vector<unsigned int> errors(NThreads, 0U);
+  auto const start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (unsigned int iThread = 0; iThread < NThreads; ++iThread) {
+    threads.emplace_back([NElements, &errors, iThread](){
+      List list;
+      for (unsigned int i = 0; i < NElements; ++i) list.push_back(i);
+      if (list.size() != NElements) ++errors[iThread];
+      if (!list.empty() && (list.back() != int(NElements - 1)))
+        ++errors[iThread];
+    });
+  } // for
+  for (std::thread& thread: threads) thread.join();
+  double const time = std::chrono::duration<double, std::milli>
+    (std::chrono::steady_clock::now() - start).count();
+  for (unsigned int e: errors) nErrors += e;
+  return time;
+} // FillListTime()
+
+
+//------------------------------------------------------------------------------
+int main(int argc, char** argv) {
+
+  unsigned int const NElements = (argc > 1)? std::stoul(argv[1]): 1000000U;
+
+  using STLList_t = std::list<int>;
+  using BulkList_t = std::list<int, lar::BulkAllocator<int>>;
+
+  unsigned int nErrors = 0U;
+  for (unsigned int NThreads: { 1U, 4U }) {
+    double const stlTime
+      = FillListTime<STLList_t>(NThreads, NElements, nErrors);
+    double const bulkTime
+      = FillListTime<BulkList_t>(NThreads, NElements, nErrors);
+    std::cout << NThreads << " thread(s), " << NElements
+      << " list elements each: std::allocator " << stlTime
+      << " ms, lar::BulkAllocator " << bulkTime << " ms" << std::endl;
+  } // for
+
+  if (nErrors > 0U) {
+    std::cerr << nErrors << " lists do not hold the expected values!"
+      << std::endl;
+  }
+  return (nErrors > 0U)? 1: 0;
+} // main()
+
+
+//------------------------------------------------------------------------------
@@ -3,17 +3,23 @@
  * @brief   Tests the bulk allocator
  * @author  Gianluca Petrillo (petrillo@fnal.gov)
  * @date    20140817
- * @version 1.0
+ * @version 2.0
  *
  * See http://www.boost.org/libs/test for the Boost test library home page.
  *
  * Timing:
- * version 1.0 takes less than 3" on a 3 GHz machine FIXME
+ * version 2.0 takes a few seconds on a 3 GHz machine
  */
 
 // C/C++ standard libraries
 #include <map>
+#include <list>
+#include <vector>
 #include <random>
+#include <thread>
+#include <iostream>
+#include <algorithm> // std::equal()
+#include <cstdint> // std::uintptr_t
 
 // Boost libraries
 /*
@@ -128,6 +134,218 @@ void RunHoughTransformTreeTest() {
 } // RunHoughTransformTreeTest()
 
 
+//------------------------------------------------------------------------------
+/// A type with its own allocator pool, so that statistics are predictable.
+struct StatTestType_t { double a, b; };
+
+/**
+ * @brief Tests the statistics and the user count of the allocator
+ *
+ * The test allocates memory in known amounts and checks the statistics of
+ * the pool; it also verifies that the pool survives as long as any allocator
+ * (including copies) is around.
+ */
+void StatisticsTest() {
+
+  using Allocator_t = lar::BulkAllocator<StatTestType_t>;
+
+  Allocator_t allocator(100U);
+  BOOST_CHECK_EQUAL(Allocator_t::GetChunkSize(), 100U);
+  BOOST_CHECK_EQUAL(Allocator_t::NChunks(), 0U);
+
+  StatTestType_t* first = allocator.allocate(30U);
+  BOOST_CHECK(first != nullptr);
+  BOOST_CHECK_EQUAL(Allocator_t::NChunks(), 1U);
+  auto counts = Allocator_t::GetCounts();
+  BOOST_CHECK_EQUAL(counts[0], 30U);
+  BOOST_CHECK_EQUAL(counts[1], 70U);
+
+  // this does not fit in the current chunk: a new one is started
+  StatTestType_t* second = allocator.allocate(80U);
+  BOOST_CHECK(second != nullptr);
+  BOOST_CHECK_EQUAL(Allocator_t::NChunks(), 2U);
+  counts = Allocator_t::GetCounts();
+  BOOST_CHECK_EQUAL(counts[0], 110U);
+  BOOST_CHECK_EQUAL(counts[1], 90U);
+
+  // larger than a chunk: gets a chunk of its own size
+  allocator.allocate(250U);
+  BOOST_CHECK_EQUAL(Allocator_t::NChunks(), 3U);
+  counts = Allocator_t::GetCounts();
+  BOOST_CHECK_EQUAL(counts[0], 360U);
+  BOOST_CHECK_EQUAL(counts[1], 90U);
+
+  // deallocation does not give memory back
+  allocator.deallocate(first, 30U);
+  BOOST_CHECK_EQUAL(Allocator_t::GetCounts()[0], 360U);
+
+  // copies are users too: destroying one does not free the pool
+  {
+    Allocator_t copy(allocator);
+    lar::BulkAllocator<int> other(copy); // rebound: a user of the int pool
+    BOOST_CHECK(copy == allocator);
+  }
+  BOOST_CHECK_EQUAL(Allocator_t::NChunks(), 3U);
+
+  Allocator_t::Free();
+  BOOST_CHECK_EQUAL(Allocator_t::NChunks(), 0U);
+  counts = Allocator_t::GetCounts();
+  BOOST_CHECK_EQUAL(counts[0], 0U);
+  BOOST_CHECK_EQUAL(counts[1], 0U);
+
+  // the allocator is still usable after Free()
+  BOOST_CHECK(allocator.allocate(10U) != nullptr);
+  BOOST_CHECK_EQUAL(Allocator_t::GetCounts()[0], 10U);
+  BOOST_CHECK(allocator.allocate(0U) == nullptr);
+
+} // StatisticsTest()
+
+
+//------------------------------------------------------------------------------
+/**
+ * @brief Fills lists with the bulk allocator from many threads at once
+ *
+ * Each thread fills its own list with known values; all lists must hold
+ * their values after all threads are done.
+ */
+void MultithreadStressTest() {
+
+  constexpr unsigned int NThreads = 8;
+  constexpr unsigned int NElements = 200000;
+
+  using List_t = std::list<unsigned int, lar::BulkAllocator<unsigned int>>;
+
+  std::vector<List_t> lists(NThreads);
+  std::vector<std::thread> threads;
+  for (unsigned int iThread = 0; iThread < NThreads; ++iThread) {
+    threads.emplace_back([&lists, iThread](){
+      List_t& list = lists[iThread];
+      for (unsigned int i = 0; i < NElements; ++i)
+        list.push_back(iThread * NElements + i);
+    });
+  } // for
+  for (std::thread& thread: threads) thread.join();
+
+  for (unsigned int iThread = 0; iThread < NThreads; ++iThread) {
+    List_t const& list = lists[iThread];
+    BOOST_CHECK_EQUAL(list.size(), NElements);
+    unsigned int expected = iThread * NElements;
+    bool bSame = true;
+    for (unsigned int value: list) {
+      if (value == expected++) continue;
+      bSame = false;
+      break;
+    } // for
+    BOOST_CHECK(bSame);
+  } // for
+
+} // MultithreadStressTest()
+
+
+#if __has_include(<memory_resource>)
+//------------------------------------------------------------------------------
+/**
+ * @brief Tests the bulk memory pool as a polymorphic memory resource
+ *
+ * Containers of different types draw from the same resource, from many
+ * threads at once.
+ */
+void MemoryResourceTest() {
+
+  constexpr unsigned int NThreads = 4;
+  constexpr unsigned int NElements = 50000;
+
+  lar::BulkMemoryResource resource(4096U);
+  BOOST_CHECK_EQUAL(resource.GetChunkSize(), 4096U);
+  BOOST_CHECK(resource.is_equal(resource));
+  BOOST_CHECK(!resource.is_equal(*std::pmr::new_delete_resource()));
+
+  std::vector<std::pmr::list<double>> lists;
+  for (unsigned int iThread = 0; iThread < NThreads; ++iThread)
+    lists.emplace_back(&resource);
+  std::pmr::vector<int> values(&resource);
+
+  std::vector<std::thread> threads;
+  for (unsigned int iThread = 0; iThread < NThreads; ++iThread) {
+    threads.emplace_back([&lists, iThread](){
+      for (unsigned int i = 0; i < NElements; ++i)
+        lists[iThread].push_back(iThread + i * 0.5);
+    });
+  } // for
+  for (unsigned int i = 0; i < NElements; ++i) values.push_back(i);
+  for (std::thread& thread: threads) thread.join();
+
+  for (unsigned int iThread = 0; iThread < NThreads; ++iThread) {
+    std::pmr::list<double> const& list = lists[iThread];
+    BOOST_CHECK_EQUAL(list.size(), NElements);
+    BOOST_CHECK_EQUAL(list.front(), iThread);
+    BOOST_CHECK_EQUAL(list.back(), iThread + (NElements - 1) * 0.5);
+  } // for
+  BOOST_CHECK_EQUAL(values.size(), NElements);
+  BOOST_CHECK_EQUAL(values.back(), (int) NElements - 1);
+
+  BOOST_CHECK_GT(resource.NChunks(), 0U);
+  auto const counts = resource.GetCounts();
+  BOOST_CHECK_GE(counts[0], NThreads * NElements * sizeof(double));
+
+  // over-aligned requests are served (and released) by the global allocator
+  void* p = resource.allocate(100U, 256U);
+  BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(p) % 256U, 0U);
+  resource.deallocate(p, 100U, 256U);
+  BOOST_CHECK_EQUAL(resource.GetCounts()[0], counts[0]);
+
+  // let the containers go before the memory
+  lists.clear();
+  values = std::pmr::vector<int>();
+  resource.release();
+  BOOST_CHECK_EQUAL(resource.NChunks(), 0U);
+
+} // MemoryResourceTest()
+#endif // __has_include(<memory_resource>)
+
+
+//------------------------------------------------------------------------------
+/**
+ * @brief Adds and removes users of the same pool from many threads at once
+ *
+ * The pool is released each time its last user goes away, while other threads
+ * are adding users and drawing memory from it: memory must never be released
+ * while a user is still holding it.
+ */
+void UserChurnTest() {
+
+  struct ChurnTestType_t { unsigned long value; };
+
+  constexpr unsigned int NThreads = 8;
+  constexpr unsigned int NLoops = 2000;
+  constexpr unsigned int NElements = 16;
+
+  std::vector<unsigned int> nErrors(NThreads, 0U);
+  std::vector<std::thread> threads;
+  for (unsigned int iThread = 0; iThread < NThreads; ++iThread) {
+    threads.emplace_back([&nErrors, iThread](){
+      for (unsigned int iLoop = 0; iLoop < NLoops; ++iLoop) {
+        lar::BulkAllocator<ChurnTestType_t> allocator(64U);
+        ChurnTestType_t* data = allocator.allocate(NElements);
+        unsigned long const base = (iThread * NLoops + iLoop) * NElements;
+        for (unsigned int i = 0; i < NElements; ++i) data[i].value = base + i;
+        std::this_thread::yield();
+        for (unsigned int i = 0; i < NElements; ++i)
+          if (data[i].value != base + i) ++nErrors[iThread];
+      } // for
+    });
+  } // for
+  for (std::thread& thread: threads) thread.join();
+
+  for (unsigned int iThread = 0; iThread < NThreads; ++iThread)
+    BOOST_CHECK_EQUAL(nErrors[iThread], 0U);
+
+  // the last user is gone, and so is the pool
+  BOOST_CHECK_EQUAL(lar::BulkAllocator<ChurnTestType_t>::NChunks(), 0U);
+
+} // UserChurnTest()
+
+
 //------------------------------------------------------------------------------
 //--- registration of tests
 //
@@ -141,3 +359,21 @@ BOOST_AUTO_TEST_CASE(RunHoughTransformTree) {
   RunHoughTransformTreeTest();
   std::cout << "Done." << std::endl;
 }
+
+BOOST_AUTO_TEST_CASE(Statistics) {
+  StatisticsTest();
+}
+
+BOOST_AUTO_TEST_CASE(MultithreadStress) {
+  MultithreadStressTest();
+}
+
+#if __has_include(<memory_resource>)
+BOOST_AUTO_TEST_CASE(MemoryResource) {
+  MemoryResourceTest();
+}
+#endif // __has_include(<memory_resource>)
+
+BOOST_AUTO_TEST_CASE(UserChurn) {
+  UserChurnTest();
+}
@@ -21,9 +21,11 @@
 
 // LArSoft libraries
 #include "lardata/Utilities/ChiSquareAccumulator.h"
+#include "lardata/Utilities/CompensatedSum.h"
 
 // C/C++ standard libraries
 #include <type_traits> // std::is_same<>
+#include <vector>
 
 
 //------------------------------------------------------------------------------
@@ -147,6 +149,59 @@ void testMakeChiSquareAccumulator_documentation2() {
 } // testMakeChiSquareAccumulator_documentation2()
 
 
+//------------------------------------------------------------------------------
+void testChiSquareAccumulatorRemoveMerge() {
+
+  auto one = [](float){ return 1.0F; };
+
+  // sliding window of 4 points over data with a very large outlier;
+  // a plain `float` sum would keep the rounding error of the outlier
+  std::vector<float> const data
+    = { 1.5F, 0.5F, 2.0F, 1.0F, 3.0e4F, 0.0F, 1.5F, 1.25F, 0.75F, 2.0F };
+  std::size_t const window = 4U;
+
+  auto chiSquare = lar::util::makeChiSquareAccumulator
+    <float, lar::util::CompensatedSum<float>>(one);
+  for (std::size_t i = 0; i < data.size(); ++i) {
+    chiSquare.add(float(i), data[i]);
+    if (i < window) continue;
+    chiSquare.remove(float(i - window), data[i - window]);
+
+    // compare with the sum from scratch on the same window
+    auto expected = lar::util::makeChiSquareAccumulator<float>(one);
+    for (std::size_t j = i + 1 - window; j <= i; ++j)
+      expected.add(float(j), data[j]);
+    BOOST_CHECK_EQUAL(chiSquare.N(), expected.N());
+    BOOST_CHECK_CLOSE(chiSquare(), expected(), 1e-3); // at 10^-5
+  } // for
+
+  // the last window does not include the outlier any more
+  BOOST_CHECK_EQUAL(chiSquare.N(), window);
+  BOOST_CHECK_CLOSE(chiSquare(), 1.375F, 1e-3); // at 10^-5
+
+  // merge and split
+  auto first = lar::util::makeChiSquareAccumulator<float>(one);
+  auto second = lar::util::makeChiSquareAccumulator<float>(one);
+  first.add(0.0F, 2.0F);
+  first.add(1.0F, 0.0F, 0.5F);
+  second.add(2.0F, 3.0F);
+
+  auto merged = first;
+  merged.merge(second);
+  BOOST_CHECK_EQUAL(merged.N(), 3U);
+  BOOST_CHECK_CLOSE(merged(), 9.0F, 1e-3); // at 10^-5
+
+  merged.remove(first);
+  BOOST_CHECK_EQUAL(merged.N(), second.N());
+  BOOST_CHECK_CLOSE(merged(), second(), 1e-3); // at 10^-5
+
+  merged.remove(2.0F, 3.0F);
+  BOOST_CHECK_EQUAL(merged.N(), 0U);
+  BOOST_CHECK_SMALL(merged(), 1e-6F);
+
+} // testChiSquareAccumulatorRemoveMerge()
+
+
 //------------------------------------------------------------------------------
 BOOST_AUTO_TEST_CASE(ChiSquareAccumulatorTestCase) {
 
@@ -154,6 +209,7 @@ BOOST_AUTO_TEST_CASE(ChiSquareAccumulatorTestCase) {
   testChiSquareAccumulator_documentation();
   testMakeChiSquareAccumulator_documentation1();
   testMakeChiSquareAccumulator_documentation2();
+  testChiSquareAccumulatorRemoveMerge();
 
 } // ChiSquareAccumulatorTestCase
 
@@ -0,0 +1,101 @@
+/**
+ * @file    CompensatedSum_test.cc
+ * @brief   Tests the classes in `CompensatedSum.h`
+ * @version 1.0
+ * @see     `lardata/Utilities/CompensatedSum.h`
+ *
+ * See http://www.boost.org/libs/test for the Boost test library home page.
+ *
+ * Timing:
+ * not given yet
+ */
+
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( CompensatedSum_test )
+#include <cetlib/quiet_unit_test.hpp> // BOOST_AUTO_TEST_CASE()
+#include <boost/test/test_tools.hpp> // BOOST_CHECK(), BOOST_CHECK_EQUAL()
+#include <boost/test/tools/floating_point_comparison.hpp> // BOOST_CHECK_CLOSE()
+
+// LArSoft libraries
+#include "lardata/Utilities/CompensatedSum.h"
+
+// C/C++ standard libraries
+#include <cmath> // std::abs()
+
+
+//------------------------------------------------------------------------------
+void testCompensatedSum_documentation() {
+  /*
+   * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~{.cpp}
+   * lar::util::CompensatedSum<double> sum;
+   * sum += 1.0;
+   * sum += 1e100;
+   * sum += 1.0;
+   * sum -= 1e100;
+   * double const total = sum; // 2.0
+   * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+   * A plain `double` sum would yield `0.0` instead.
+   */
+  lar::util::CompensatedSum<double> sum;
+  sum += 1.0;
+  sum += 1e100;
+  sum += 1.0;
+  sum -= 1e100;
+  double const total = sum; // 2.0
+
+  BOOST_CHECK_EQUAL(total, 2.0);
+
+} // testCompensatedSum_documentation()
+
+
+//------------------------------------------------------------------------------
+void testCompensatedSum() {
+
+  lar::util::CompensatedSum<float> sum;
+  BOOST_CHECK_EQUAL(sum.value(), 0.0F);
+  BOOST_CHECK_EQUAL(sum.sum(), 0.0F);
+  BOOST_CHECK_EQUAL(sum.compensation(), 0.0F);
+
+  // 10^5 times 0.1: a plain float sum is off by about 10^-4
+  float plain = 0.0F;
+  for (int i = 0; i < 100000; ++i) {
+    sum += 0.1F;
+    plain += 0.1F;
+  }
+  BOOST_CHECK_CLOSE(float(sum), 10000.0F, 1e-4); // at 10^-6
+  BOOST_CHECK(std::abs(plain - 10000.0F) > 1.0F);
+
+  // removing the same values brings back to zero
+  for (int i = 0; i < 100000; ++i) sum -= 0.1F;
+  BOOST_CHECK_SMALL(sum.value(), 1e-5F);
+
+  // merge and split
+  lar::util::CompensatedSum<float> a { 1.0F }, b;
+  for (int i = 0; i < 1000; ++i) b.add(1e-8F);
+  BOOST_CHECK_EQUAL(b.sum() + b.compensation(), b.value());
+
+  lar::util::CompensatedSum<float> merged = a;
+  merged += b;
+  BOOST_CHECK_CLOSE(merged.value(), 1.0F + 1e-5F, 1e-5);
+
+  merged -= a;
+  BOOST_CHECK_CLOSE(merged.value(), b.value(), 1e-3);
+
+  merged.clear();
+  BOOST_CHECK_EQUAL(merged.value(), 0.0F);
+  BOOST_CHECK_EQUAL(merged.compensation(), 0.0F);
+
+} // testCompensatedSum()
+
+
+//------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(CompensatedSumTestCase) {
+
+  testCompensatedSum_documentation();
+  testCompensatedSum();
+
+} // CompensatedSumTestCase
+
+
+//------------------------------------------------------------------------------
@@ -15,6 +15,7 @@
 #include <map>
 #include <random>
 #include <iostream>
+#include <stdexcept> // std::out_of_range
 
 // Boost libraries
 /*
@@ -176,6 +177,127 @@ void RunHoughTransformTreeTest() {
 } // RunHoughTransformTreeTest()
 
 
+//------------------------------------------------------------------------------
+/**
+ * @brief Compares a counters map with a STL map after random operations
+ * @tparam CountersMap_t type of counters map to be tested
+ * @param modulo counts are compared modulo this value (`0`: no modulo)
+ *
+ * The same random sequence of increments, decrements and settings is applied
+ * to a counters map and to a STL map, and then the two maps are compared.
+ */
+template <typename CountersMap_t>
+void CompareWithSTLMapTest(int modulo = 0) {
+
+  constexpr unsigned int NOperations = 200000;
+  constexpr int NKeys = 5000;
+
+  std::map<int, int> stl_map;
+  CountersMap_t cm_map;
+  BOOST_CHECK(cm_map.empty());
+
+  auto const normalize = [modulo](int value)
+    { return modulo? (value % modulo + modulo) % modulo: value; };
+
+  std::default_random_engine random_engine(RandomSeed);
+  std::uniform_int_distribution<int> key_dist(0, NKeys - 1);
+  std::uniform_int_distribution<int> op_dist(0, 9);
+  for (unsigned int i = 0; i < NOperations; ++i) {
+    int const key = key_dist(random_engine);
+    int const op = op_dist(random_engine);
+    if (op < 6) { // increment
+      int& count = stl_map[key];
+      count = normalize(count + 1);
+      BOOST_CHECK_EQUAL((int) cm_map.increment(key), count);
+    }
+    else if (op < 9) { // decrement
+      int& count = stl_map[key];
+      count = normalize(count - 1);
+      BOOST_CHECK_EQUAL((int) cm_map.decrement(key), count);
+    }
+    else { // set
+      int& count = stl_map[key];
+      count = normalize(key);
+      BOOST_CHECK_EQUAL((int) cm_map.set(key, key), count);
+    }
+  } // for
+
+  BOOST_CHECK(!cm_map.empty());
+  BOOST_CHECK_GE(cm_map.n_counters(), stl_map.size());
+
+  // the STL map has zero counters too, which do not matter
+  std::map<int, typename CountersMap_t::SubCounter_t> expected;
+  for (auto const& p: stl_map) expected[p.first] = p.second;
+  BOOST_CHECK(cm_map.is_equal(expected));
+
+  for (int key = -10; key < NKeys + 100; ++key) {
+    auto const iExpected = expected.find(key);
+    int const count = (iExpected == expected.end())? 0: iExpected->second;
+    BOOST_CHECK_EQUAL((int) cm_map[key], count);
+  } // for
+
+  // the first difference is reported
+  int first_difference = -1;
+  expected[NKeys + 20] = 1;
+  expected[NKeys + 10] = 1;
+  BOOST_CHECK(!cm_map.is_equal(expected, first_difference));
+  BOOST_CHECK_EQUAL(first_difference, NKeys + 10);
+
+  // all counters are visited
+  std::size_t nCounters = 0;
+  for (auto const& p: cm_map) {
+    if (p.second == 0) continue;
+    BOOST_CHECK_EQUAL((int) p.second, expected[p.first]);
+    ++nCounters;
+  }
+  std::size_t nExpected = 0;
+  for (auto const& p: stl_map) if (p.second != 0) ++nExpected;
+  BOOST_CHECK_EQUAL(nCounters, nExpected);
+
+} // CompareWithSTLMapTest()
+
+
+/**
+ * @brief Tests subcounters packed in the counters
+ *
+ * Four 2-bit subcounters are packed in each 8-bit counter.
+ */
+void SubcountersTest() {
+
+  using CountersMap_t = lar::CountersMap<
+    int, unsigned char, 4, std::allocator<unsigned char>, 4
+    >;
+  static_assert(CountersMap_t::NSubcounters == 16, "wrong subcounter number");
+
+  CountersMap_t cm_map;
+  BOOST_CHECK_EQUAL(cm_map.increment(5), 1U);
+  BOOST_CHECK_EQUAL(cm_map.n_counters(), 16U);
+  BOOST_CHECK_EQUAL(cm_map.increment(5), 2U);
+  BOOST_CHECK_EQUAL(cm_map.increment(5), 3U);
+  BOOST_CHECK_EQUAL(cm_map.increment(5), 0U); // wraps around...
+  BOOST_CHECK_EQUAL(cm_map.increment(5), 1U);
+  BOOST_CHECK_EQUAL(cm_map[4], 0U); // ... without affecting the others
+  BOOST_CHECK_EQUAL(cm_map[6], 0U);
+
+  BOOST_CHECK_EQUAL(cm_map.decrement(4), 3U);
+  BOOST_CHECK_EQUAL(cm_map[5], 1U);
+  BOOST_CHECK_EQUAL(cm_map.set(6, 6), 2U); // truncated
+  BOOST_CHECK_EQUAL(cm_map[4], 3U);
+  BOOST_CHECK_EQUAL(cm_map[5], 1U);
+  BOOST_CHECK_EQUAL(cm_map[6], 2U);
+  BOOST_CHECK_EQUAL(cm_map[7], 0U);
+  BOOST_CHECK_EQUAL(cm_map.n_counters(), 16U);
+
+  cm_map.increment(16); // next block
+  BOOST_CHECK_EQUAL(cm_map.n_counters(), 32U);
+
+  unsigned int total = 0;
+  for (auto const& p: cm_map) total += p.second;
+  BOOST_CHECK_EQUAL(total, 7U);
+
+} // SubcountersTest()
+
+
 //------------------------------------------------------------------------------
 //--- registration of tests
 //
@@ -189,3 +311,26 @@ BOOST_AUTO_TEST_CASE(RunHoughTransformTree) {
   RunHoughTransformTreeTest();
   std::cout << "Done." << std::endl;
 }
+
+BOOST_AUTO_TEST_CASE(TreeStorage) {
+  CompareWithSTLMapTest<lar::CountersMap<int, int, 8>>();
+}
+
+BOOST_AUTO_TEST_CASE(HashStorage) {
+  CompareWithSTLMapTest<lar::HashCountersMap<int, int, 8>>();
+  CompareWithSTLMapTest<lar::HashCountersMap<int, unsigned int, 8, 4>>(256);
+}
+
+BOOST_AUTO_TEST_CASE(PagedStorage) {
+  CompareWithSTLMapTest<lar::PagedCountersMap<int, int, 8>>();
+  CompareWithSTLMapTest
+    <lar::PagedCountersMap<int, unsigned short, 16, 2, 8>>(256);
+
+  lar::PagedCountersMap<int, int, 8> cm_map;
+  BOOST_CHECK_THROW(cm_map.increment(-1), std::out_of_range);
+  BOOST_CHECK_EQUAL(cm_map[-1], 0);
+}
+
+BOOST_AUTO_TEST_CASE(Subcounters) {
+  SubcountersTest();
+}
@@ -0,0 +1,225 @@
+/**
+ * @file   FindManyInChainP_benchmark.cc
+ * @brief  Times `lar::FindManyInChainP` on a long association chain.
+ * @date   October 18, 2026
+ * @see    lardata/Utilities/FindManyInChainP.h
+ *
+ * A synthetic chain of associations A -> B -> C -> D is created in memory,
+ * with the same structure as the one in `testAssnsChainUtils` (showers,
+ * particle flow objects, clusters and hits): each A is associated to one B,
+ * each B to three Cs and each C to 50 Ds.
+ * All the As are then associated to their Ds in two ways:
+ * 1. with `lar::FindManyInChainP`
+ * 2. with a reference implementation of the algorithm `FindManyInChainP` used
+ *    before the constant time hops: each hop sorts the source pointers and
+ *    looks up each associated pair with a binary search, and the join between
+ *    tiers looks up each intermediate pointer in a sorted list
+ *
+ * The two results are required to be identical, and the time spent by each
+ * is printed. No framework job is involved, so that the timing is not affected
+ * by data product creation or by message output.
+ * The program returns non-zero if the two methods disagree.
+ *
+ * Usage: `FindManyInChainP_benchmark [Ds] [repetitions]`
+ * (default: 500000 Ds, 5 repetitions).
+ */
+
+// LArSoft libraries
+#include "lardata/Utilities/FindManyInChainP.h"
+
+// framework libraries
+#include "canvas/Persistency/Common/Assns.h"
+#include "canvas/Persistency/Common/Ptr.h"
+#include "canvas/Persistency/Provenance/ProductID.h"
+#include "canvas/Utilities/InputTag.h"
+
+// C/C++ standard libraries
+#include <iostream>
+#include <vector>
+#include <map>
+#include <string>
+#include <chrono>
+#include <algorithm> // std::sort(), std::equal_range()
+#include <utility> // std::pair
+#include <cstddef> // std::size_t
+
+
+//------------------------------------------------------------------------------
+struct A {};
+struct B {};
+struct C {};
+struct D {};
+
+constexpr std::size_t CsPerB = 3U;
+constexpr std::size_t DsPerC = 50U;
+
+
+/// Event emulation: serves the associations by their label.
+class BenchmarkEvent {
+  std::map<std::string, void const*> fProducts;
+
+    public:
+  template <typename T>
+  void put(std::string const& label, T const& product)
+    { fProducts[label] = &product; }
+
+  /// Returns a pointer to the product (as good as a handle for the query).
+  template <typename T>
+  T const* getValidHandle(art::InputTag const& tag) const
+    { return static_cast<T const*>(fProducts.at(tag.label())); }
+
+}; // class BenchmarkEvent
+
+
+/// The chain of associations.
+struct Chain {
+  std::vector<art::Ptr<A>> As;
+  art::Assns<A, B> AB;
+  art::Assns<B, C> BC;
+  art::Assns<C, D> CD;
+}; // struct Chain
+
+
+template <typename T>
+art::Ptr<T> makePtr(unsigned int id, std::size_t key)
+  { return { art::ProductID{ id }, key, nullptr }; }
+
+
+Chain makeChain(std::size_t nD) {
+  std::size_t const nC = nD / DsPerC;
+  std::size_t const nB = (nC + CsPerB - 1) / CsPerB;
+  std::size_t const nA = nB;
+
+  Chain chain;
+  for (std::size_t iA = 0; iA < nA; ++iA) {
+    chain.As.push_back(makePtr<A>(1U, iA));
+    chain.AB.addSingle(chain.As.back(), makePtr<B>(2U, iA));
+  }
+  for (std::size_t iC = 0; iC < nC; ++iC)
+    chain.BC.addSingle(makePtr<B>(2U, iC / CsPerB), makePtr<C>(3U, iC));
+  for (std::size_t iD = 0; iD < nC * DsPerC; ++iD)
+    chain.CD.addSingle(makePtr<C>(3U, iD / DsPerC), makePtr<D>(4U, iD));
+  return chain;
+} // makeChain()
+
+
+//------------------------------------------------------------------------------
+/// One hop with the former algorithm: sorted sources and binary search.
+template <typename L, typename R>
+std::vector<std::vector<art::Ptr<R>>> referenceHop
+  (std::vector<art::Ptr<L>> const& sources, art::Assns<L, R> const& assns)
+{
+  using Entry_t = std::pair<art::Ptr<L>, std::size_t>; // pointer, position
+  std::vector<Entry_t> sorted;
+  sorted.reserve(sources.size());
+  for (std::size_t i = 0; i < sources.size(); ++i)
+    sorted.emplace_back(sources[i], i);
+  auto const byPtr = [](Entry_t const& a, Entry_t const& b)
+    { return a.first < b.first; };
+  std::sort(sorted.begin(), sorted.end(), byPtr);
+
+  std::vector<std::vector<art::Ptr<R>>> result(sources.size());
+  for (auto const& assn: assns) {
+    auto const range = std::equal_range
+      (sorted.begin(), sorted.end(), Entry_t{ assn.first, 0U }, byPtr);
+    for (auto it = range.first; it != range.second; ++it)
+      result[it->second].push_back(assn.second);
+  } // for
+  return result;
+} // referenceHop()
+
+
+/// Joins A -> B and B -> C with the former algorithm (sorted B lookup).
+template <typename B_t, typename C_t>
+std::vector<std::vector<art::Ptr<C_t>>> referenceJoin(
+  std::vector<std::vector<art::Ptr<B_t>>> const& BsOfA,
+  std::vector<art::Ptr<B_t>> const& Bs,
+  std::vector<std::vector<art::Ptr<C_t>>> const& CsOfB
+) {
+  using Entry_t = std::pair<art::Ptr<B_t>, std::size_t>;
+  std::vector<Entry_t> sorted;
+  sorted.reserve(Bs.size());
+  for (std::size_t i = 0; i < Bs.size(); ++i) sorted.emplace_back(Bs[i], i);
+  auto const byPtr = [](Entry_t const& a, Entry_t const& b)
+    { return a.first < b.first; };
+  std::sort(sorted.begin(), sorted.end(), byPtr);
+
+  std::vector<std::vector<art::Ptr<C_t>>> result(BsOfA.size());
+  for (std::size_t iA = 0; iA < BsOfA.size(); ++iA) {
+    for (art::Ptr<B_t> const& B: BsOfA[iA]) {
+      auto const it = std::lower_bound
+        (sorted.begin(), sorted.end(), Entry_t{ B, 0U }, byPtr);
+      if ((it == sorted.end()) || (it->first != B)) continue;
+      auto const& Cs = CsOfB[it->second];
+      result[iA].insert(result[iA].end(), Cs.begin(), Cs.end());
+    } // for B
+  } // for A
+  return result;
+} // referenceJoin()
+
+
+template <typename T>
+std::vector<T> flatten(std::vector<std::vector<T>> const& lists) {
+  std::vector<T> flat;
+  for (auto const& list: lists) flat.insert(flat.end(), list.begin(), list.end());
+  return flat;
+} // flatten()
+
+
+std::vector<std::vector<art::Ptr<D>>> referenceChain(Chain const& chain) {
+  auto const BsOfA = referenceHop(chain.As, chain.AB);
+  auto const Bs = flatten(BsOfA);
+  auto const CsOfB = referenceHop(Bs, chain.BC);
+  auto const Cs = flatten(CsOfB);
+  auto const DsOfC = referenceHop(Cs, chain.CD);
+  auto const DsOfB = referenceJoin(CsOfB, Cs, DsOfC);
+  return referenceJoin(BsOfA, Bs, DsOfB);
+} // referenceChain()
+
+
+//------------------------------------------------------------------------------
+int main(int argc, char** argv) {
+
+  std::size_t const nD = (argc > 1)? std::stoul(argv[1]): 500000U;
+  unsigned int const nRepetitions = (argc > 2)? std::stoul(argv[2]): 5U;
+
+  Chain const chain = makeChain(nD);
+  BenchmarkEvent event;
+  event.put("AB", chain.AB);
+  event.put("BC", chain.BC);
+  event.put("CD", chain.CD);
+  std::cout << "Chain: " << chain.AB.size() << " A->B, " << chain.BC.size()
+    << " B->C, " << chain.CD.size() << " C->D associations" << std::endl;
+
+  using clock_t = std::chrono::steady_clock;
+  std::chrono::duration<double> tChain{ 0 }, tReference{ 0 };
+  unsigned int nErrors = 0U;
+  for (unsigned int iRep = 0; iRep < nRepetitions; ++iRep) {
+
+    auto const start = clock_t::now();
+    auto const result = lar::FindManyInChainP<D, C, B>::find
+      (chain.As, event, art::InputTag{ "AB" }, art::InputTag{ "BC" }, art::InputTag{ "CD" });
+    auto const middle = clock_t::now();
+    auto const reference = referenceChain(chain);
+    auto const end = clock_t::now();
+
+    tChain += middle - start;
+    tReference += end - middle;
+    if (result != reference) ++nErrors;
+
+  } // for repetitions
+
+  std::cout << "FindManyInChainP: " << (tChain.count() / nRepetitions * 1e3)
+    << " ms/query\nreference (sorted lookup): "
+    << (tReference.count() / nRepetitions * 1e3) << " ms/query" << std::endl;
+
+  if (nErrors > 0U) {
+    std::cerr << "FindManyInChainP result differs from the reference in "
+      << nErrors << "/" << nRepetitions << " queries!" << std::endl;
+    return 1;
+  }
+  return 0;
+} // main()
+
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,136 @@
+/**
+ * @file   FindManyInChainP_test.cc
+ * @brief  Unit test for the join of association tiers of `lar::FindManyInChainP`.
+ * @date   October 18, 2026
+ * @see    lardata/Utilities/FindManyInChainP.h
+ *
+ * The join of two association tiers (A -> B and B -> C into A -> C) is tested
+ * directly on connection lists made of pointers with no data product behind,
+ * so that no event is needed.
+ * The full chain query is tested with a _art_ job in
+ * `testAssnsChainUtils/assnschainutils_test.fcl`.
+ */
+
+// LArSoft libraries
+#include "lardata/Utilities/FindManyInChainP.h"
+
+// framework libraries
+#include "canvas/Persistency/Common/Ptr.h"
+#include "canvas/Persistency/Provenance/ProductID.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( FindManyInChainP_test )
+#include <cetlib/quiet_unit_test.hpp> // BOOST_AUTO_TEST_CASE()
+#include <boost/test/test_tools.hpp> // BOOST_CHECK(), BOOST_CHECK_EQUAL()
+
+// C/C++ standard libraries
+#include <vector>
+#include <cstddef> // std::size_t
+
+
+//------------------------------------------------------------------------------
+struct A {};
+struct B {};
+struct C {};
+
+using APtr = art::Ptr<A>;
+using BPtr = art::Ptr<B>;
+using CPtr = art::Ptr<C>;
+
+template <typename T>
+art::Ptr<T> makePtr(unsigned int id, std::size_t key)
+  { return { art::ProductID{ id }, key, nullptr }; }
+
+namespace AFB = lar::details::AssociationFinderBase;
+
+
+/// Creates a A -> B list from the B keys of each A.
+AFB::ConnectionList<APtr, BPtr> makeAB
+  (std::vector<std::vector<std::size_t>> const& BsOfA)
+{
+  AFB::ConnectionList<APtr, BPtr> AB(
+    AFB::KeysFromIndex, BsOfA.size(),
+    [](std::size_t i){ return makePtr<A>(1U, i); }
+    );
+  for (std::size_t iA = 0; iA < BsOfA.size(); ++iA)
+    for (std::size_t key: BsOfA[iA]) AB.addConnectionAt(iA, makePtr<B>(2U, key));
+  return AB;
+} // makeAB()
+
+
+/// Creates a B -> C list, with the C keys of each B in the specified order.
+AFB::ConnectionList<BPtr, CPtr> makeBC(
+  std::vector<std::size_t> const& BKeys,
+  std::vector<std::vector<std::size_t>> const& CsOfB
+) {
+  AFB::ConnectionList<BPtr, CPtr> BC(
+    AFB::KeysFromIndex, BKeys.size(),
+    [&BKeys](std::size_t i){ return makePtr<B>(2U, BKeys[i]); }
+    );
+  for (std::size_t iB = 0; iB < BKeys.size(); ++iB)
+    for (std::size_t key: CsOfB[iB]) BC.addConnectionAt(iB, makePtr<C>(3U, key));
+  return BC;
+} // makeBC()
+
+
+/// Checks that the Cs of each A in `AC` have the expected keys.
+template <typename AC_t>
+void checkAC
+  (AC_t const& AC, std::vector<std::vector<std::size_t>> const& expected)
+{
+  BOOST_TEST_REQUIRE(AC.size() == expected.size());
+  for (std::size_t iA = 0; iA < expected.size(); ++iA) {
+    BOOST_TEST_MESSAGE("A #" << iA);
+    BOOST_CHECK_EQUAL(AC[iA].key(), makePtr<A>(1U, iA));
+    auto const& Cs = AC[iA].connectedTo();
+    BOOST_TEST_REQUIRE(Cs.size() == expected[iA].size());
+    for (std::size_t i = 0; i < Cs.size(); ++i)
+      BOOST_CHECK_EQUAL(Cs[i], makePtr<C>(3U, expected[iA][i]));
+  } // for
+} // checkAC()
+
+
+//------------------------------------------------------------------------------
+void inPlaceJoinTest() {
+  /*
+   * B -> C list in the same order as the connected Bs: all matched in place
+   */
+  auto const AB = AFB::makeConnectionManager(makeAB({ { 0, 1 }, {}, { 2 } }));
+  auto AC = AB.join(makeBC({ 0, 1, 2 }, { { 10, 11 }, { 12 }, {} }));
+  checkAC(AC, { { 10, 11, 12 }, {}, {} });
+} // inPlaceJoinTest()
+
+
+void lookupJoinTest() {
+  /*
+   * B -> C list shorter than the connected Bs: B #0 is matched in place (and
+   * its Cs moved to A #0) for A #0, then looked up for A #1 and, again, for
+   * A #0; both need to find the Cs that were moved away.
+   */
+  auto const AB
+    = AFB::makeConnectionManager(makeAB({ { 0, 1, 0 }, { 0 }, { 1 } }));
+  auto AC = AB.join(makeBC({ 0, 1 }, { { 10, 11 }, { 12 } }));
+  checkAC(AC, { { 10, 11, 12, 10, 11 }, { 10, 11 }, { 12 } });
+} // lookupJoinTest()
+
+
+void unmatchedJoinTest() {
+  /*
+   * B -> C list not in the order of the connected Bs, and missing B #3
+   */
+  auto const AB
+    = AFB::makeConnectionManager(makeAB({ { 2 }, { 0, 3 }, { 1, 2 } }));
+  auto AC = AB.join(makeBC({ 0, 1, 2 }, { { 10 }, { 11, 12 }, { 13 } }));
+  checkAC(AC, { { 13 }, { 10 }, { 11, 12, 13 } });
+} // unmatchedJoinTest()
+
+
+//------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(JoinTestCase) {
+  inPlaceJoinTest();
+  lookupJoinTest();
+  unmatchedJoinTest();
+} // BOOST_AUTO_TEST_CASE(JoinTestCase)
+
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,471 @@
+/**
+ * @file   GeometryUtilitiesTest_module.cc
+ * @brief  Tests the hit selections and projections of
+ *         `util::GeometryUtilities`.
+ * @date   October 18, 2026
+ * @see    lardata/Utilities/GeometryUtilities.h
+ *
+ */
+
+
+// LArSoft libraries
+#include "lardata/Utilities/GeometryUtilities.h"
+#include "lardata/Utilities/PxHitIndex.h"
+#include "lardata/Utilities/PxUtils.h"
+#include "lardata/Utilities/UtilException.h"
+#include "lardata/DetectorInfoServices/DetectorClocksService.h"
+#include "lardata/DetectorInfoServices/DetectorPropertiesService.h"
+#include "larcore/Geometry/Geometry.h"
+#include "larcore/CoreUtils/ServiceUtil.h" // lar::providerFrom<>()
+#include "larcorealg/Geometry/GeometryCore.h"
+
+// framework libraries
+#include "art/Framework/Core/EDAnalyzer.h"
+#include "art/Framework/Core/ModuleMacros.h"
+#include "art/Framework/Principal/Event.h"
+#include "art/Framework/Services/Registry/ServiceHandle.h"
+#include "messagefacility/MessageLogger/MessageLogger.h"
+#include "fhiclcpp/types/Atom.h"
+#include "fhiclcpp/types/Name.h"
+#include "fhiclcpp/types/Comment.h"
+
+// ROOT libraries
+#include "TVector3.h"
+
+// Boost libraries
+#include <boost/test/test_tools.hpp> // BOOST_CHECK(), BOOST_CHECK_THROW()
+
+// C/C++ libraries
+#include <vector>
+#include <map>
+#include <random>
+#include <algorithm> // std::find(), std::max()
+#include <limits> // std::numeric_limits<>
+#include <cmath> // std::round(), std::sqrt()
+#include <cstddef> // std::size_t
+
+
+//------------------------------------------------------------------------------
+/**
+ * @brief Compares the hit selections and the batch projections of
+ *        `util::GeometryUtilities` with their reference implementations.
+ *
+ * Pseudo-random hit lists are used to compare:
+ * * the charge selection of `SelectPolygonHitList()`
+ *   (`SelectHighChargeHits()`) with its previous implementation, based on a
+ *   `std::map` keyed by charge;
+ * * the local hit selections using a `util::PxHitIndex` with the ones scanning
+ *   the whole hit list, also with hits right at the limits of the selection;
+ * * the closest hit search using a `util::PxHitIndex` with the one scanning
+ *   the whole hit list, with many hits at the same distance.
+ *
+ * The batch projections of points, angles and pitches on all the planes are
+ * also compared with the single plane calls, element by element.
+ *
+ * This module uses Boost unit test library, and as such it must be run with
+ * `lar_ut` instead of `lar`.
+ */
+class GeometryUtilitiesTest : public art::EDAnalyzer {
+    public:
+
+  struct Config {
+    using Name = fhicl::Name;
+    using Comment = fhicl::Comment;
+
+    fhicl::Atom<unsigned int> nHitLists{
+      Name("nHitLists"),
+      Comment("number of pseudo-random hit lists to test"),
+      20U
+      };
+
+    fhicl::Atom<unsigned int> nQueries{
+      Name("nQueries"),
+      Comment("number of selections tested on each hit list"),
+      200U
+      };
+
+  }; // struct Config
+
+  using Parameters = art::EDAnalyzer::Table<Config>;
+
+  explicit GeometryUtilitiesTest(Parameters const& config)
+    : art::EDAnalyzer(config)
+    , fNHitLists(config().nHitLists())
+    , fNQueries(config().nQueries())
+    {}
+
+  virtual void analyze(art::Event const& event) override;
+
+    private:
+  using HitList_t = std::vector<util::PxHit>;
+
+  unsigned int fNHitLists; ///< Number of hit lists to test.
+  unsigned int fNQueries; ///< Number of selections on each hit list.
+
+  /// Returns `n` hits; if `onGrid`, coordinates and charge are rounded.
+  static HitList_t makeHits(std::mt19937& gen, std::size_t n, bool onGrid);
+
+  /// Tests the charge selection of the polygon against a `std::map` ordering.
+  void testHighChargeHits(util::GeometryUtilities const& gser) const;
+
+  /// Tests the indexed local hit selections against the full scans.
+  void testLocalHitlist(util::GeometryUtilities const& gser) const;
+
+  /// Tests hits at the corners of the local selection region.
+  void testLocalHitlistBounds(util::GeometryUtilities const& gser) const;
+
+  /// Tests the indexed closest hit search against the full scan.
+  void testClosestHit(util::GeometryUtilities const& gser) const;
+
+  /// Tests the batch projections on all planes against the single ones.
+  void testBatchProjections
+    (util::GeometryUtilities const& gser, geo::GeometryCore const& geom) const;
+
+}; // class GeometryUtilitiesTest
+
+
+//------------------------------------------------------------------------------
+namespace {
+
+  /// The previous charge selection of `SelectPolygonHitList()`.
+  std::vector<util::PxHit const*> mapOrderedHits
+    (std::vector<util::PxHit> const& hitlist, double fraction)
+  {
+    std::map<double, util::PxHit const*> hitmap;
+    double qtotal = 0;
+    for (auto const& h : hitlist) {
+      hitmap.try_emplace(h.charge, &h);
+      qtotal += h.charge;
+    }
+    double qintegral = 0;
+    std::vector<util::PxHit const*> ordered_hits;
+    for (auto hiter = hitmap.rbegin();
+      qintegral < qtotal * fraction && hiter != hitmap.rend(); ++hiter
+    ) {
+      qintegral += (*hiter).first;
+      ordered_hits.push_back((*hiter).second);
+    }
+    return ordered_hits;
+  } // mapOrderedHits()
+
+} // local namespace
+
+
+//------------------------------------------------------------------------------
+auto GeometryUtilitiesTest::makeHits
+  (std::mt19937& gen, std::size_t n, bool onGrid) -> HitList_t
+{
+  std::uniform_real_distribution<double> W(1.0, 300.0), T(1.0, 200.0);
+  std::uniform_real_distribution<double> Q(0.0, 50.0);
+  HitList_t hits;
+  for (std::size_t i = 0; i < n; ++i) {
+    double w = W(gen), t = T(gen), q = Q(gen);
+    if (onGrid) {
+      w = std::round(w / 3.0) * 3.0;
+      t = std::round(t / 2.0) * 2.0;
+      q = std::round(q);
+    }
+    hits.emplace_back(0U, w, t, q, q, q);
+  } // for
+  return hits;
+} // GeometryUtilitiesTest::makeHits()
+
+
+//------------------------------------------------------------------------------
+void GeometryUtilitiesTest::testHighChargeHits
+  (util::GeometryUtilities const& gser) const
+{
+  std::mt19937 gen(42U);
+  for (unsigned int iList = 0; iList < fNHitLists; ++iList) {
+    // half of the lists have charges rounded, that is many repeated charges
+    HitList_t const hits = makeHits(gen, 10U + 50U * iList, iList % 2U);
+    BOOST_TEST_MESSAGE("Charge selection on " << hits.size() << " hits");
+
+    for (double fraction: { 0.5, 0.95, 1.0 }) {
+      std::vector<util::PxHit const*> const selected
+        = util::GeometryUtilities::SelectHighChargeHits(hits, fraction);
+      std::vector<util::PxHit const*> const expected
+        = mapOrderedHits(hits, fraction);
+      BOOST_CHECK(selected == expected);
+    } // for
+
+    // the polygon is made of hits from the selection
+    std::vector<util::PxHit const*> const selected
+      = util::GeometryUtilities::SelectHighChargeHits(hits, 0.95);
+    std::vector<util::PxHit const*> polygon;
+    gser.SelectPolygonHitList(hits, polygon);
+    BOOST_CHECK(!polygon.empty());
+    for (util::PxHit const* hit: polygon) {
+      BOOST_CHECK
+        (std::find(selected.begin(), selected.end(), hit) != selected.end());
+    }
+  } // for lists
+
+  // all hits with the same charge: only the first is used
+  HitList_t const sameCharge(5U, util::PxHit(0U, 10.0, 10.0, 3.0, 3.0, 3.0));
+  std::vector<util::PxHit const*> const selected
+    = util::GeometryUtilities::SelectHighChargeHits(sameCharge, 0.95);
+  BOOST_TEST_REQUIRE(selected.size() == 1U);
+  BOOST_CHECK_EQUAL(selected.front(), &(sameCharge.front()));
+
+} // GeometryUtilitiesTest::testHighChargeHits()
+
+
+//------------------------------------------------------------------------------
+void GeometryUtilitiesTest::testLocalHitlist
+  (util::GeometryUtilities const& gser) const
+{
+  std::mt19937 gen(1234U);
+  std::uniform_real_distribution<double> U(-20.0, 320.0), S(-3.0, 3.0);
+  std::uniform_real_distribution<double> L(0.0, 30.0);
+
+  for (unsigned int iList = 0; iList < fNHitLists; ++iList) {
+    HitList_t const hits = makeHits(gen, 50U + 200U * iList, iList % 2U);
+    BOOST_TEST_MESSAGE("Local selections on " << hits.size() << " hits");
+
+    // automatic cells, elongated cells and cells much smaller than the limits
+    std::vector<util::PxHitIndex> indices;
+    indices.emplace_back(hits);
+    indices.emplace_back(hits, 0.7, 5.0);
+    indices.emplace_back(hits, 0.25, 0.25);
+
+    unsigned int nErrors = 0U;
+    for (unsigned int iQuery = 0; iQuery < fNQueries; ++iQuery) {
+      util::PxPoint start(0U, U(gen), U(gen) * 0.66);
+      double linearlimit = L(gen), ortlimit = L(gen) / 3.0;
+      double slope = (iQuery % 10U == 0U)? 0.0: S(gen);
+      // no limit along the line: the whole list is scanned
+      if (iQuery % 50U == 0U)
+        linearlimit = std::numeric_limits<double>::infinity();
+
+      std::vector<unsigned int> expected;
+      gser.SelectLocalHitlistIndex
+        (hits, expected, start, linearlimit, ortlimit, slope);
+      std::vector<util::PxHit const*> expectedHits;
+      util::PxHit expectedAverage;
+      gser.SelectLocalHitlist
+        (hits, expectedHits, start, linearlimit, ortlimit, slope, expectedAverage);
+
+      for (util::PxHitIndex const& index: indices) {
+        std::vector<unsigned int> selected;
+        gser.SelectLocalHitlistIndex
+          (index, selected, start, linearlimit, ortlimit, slope);
+        if (selected != expected) ++nErrors;
+
+        std::vector<util::PxHit const*> selectedHits;
+        util::PxHit average;
+        gser.SelectLocalHitlist
+          (index, selectedHits, start, linearlimit, ortlimit, slope, average);
+        if (selectedHits != expectedHits) ++nErrors;
+        if ((average.w != expectedAverage.w) || (average.t != expectedAverage.t))
+          ++nErrors;
+      } // for indices
+    } // for queries
+    BOOST_CHECK_EQUAL(nErrors, 0U);
+  } // for lists
+
+} // GeometryUtilitiesTest::testLocalHitlist()
+
+
+//------------------------------------------------------------------------------
+void GeometryUtilitiesTest::testLocalHitlistBounds
+  (util::GeometryUtilities const& gser) const
+{
+  /*
+   * Hits just inside and just outside the four corners of the selection
+   * region: the ones inside are farther from the start point than both the
+   * limits (almost `hypot(linearlimit, ortlimit)`), and must still be found
+   * by the indexed selection, which only visits the cells in a box around the
+   * start point. A background of hits makes the cells small.
+   */
+  std::mt19937 gen(5678U);
+
+  for (double slope: { 0.0, 0.4, -2.5, 30.0 }) {
+    BOOST_TEST_MESSAGE("Selection region corners with slope " << slope);
+
+    util::PxPoint start(0U, 150.0, 100.0);
+    double linearlimit = 12.0, ortlimit = 4.0;
+
+    // directions along and across the line
+    double const norm = std::sqrt(1.0 + slope * slope);
+    double const alongW = 1.0 / norm, alongT = slope / norm;
+    double const acrossW = -slope / norm, acrossT = 1.0 / norm;
+
+    HitList_t hits = makeHits(gen, 2000U, false);
+    std::size_t const nBackground = hits.size();
+    for (double scale: { 0.999, 1.001 }) {
+      for (double sLin: { -1.0, 1.0 }) {
+        for (double sOrt: { -1.0, 1.0 }) {
+          double const lin = scale * sLin * linearlimit;
+          double const ort = scale * sOrt * ortlimit;
+          hits.emplace_back(0U,
+            start.w + lin * alongW + ort * acrossW,
+            start.t + lin * alongT + ort * acrossT,
+            1.0, 1.0, 1.0
+            );
+        } // for sOrt
+      } // for sLin
+    } // for scale
+
+    std::vector<unsigned int> expected;
+    gser.SelectLocalHitlistIndex
+      (hits, expected, start, linearlimit, ortlimit, slope);
+
+    // the four corners inside are selected, the four outside are not
+    for (std::size_t i = nBackground; i < hits.size(); ++i) {
+      bool const isSelected
+        = std::find(expected.begin(), expected.end(), i) != expected.end();
+      BOOST_CHECK_EQUAL(isSelected, i < nBackground + 4U);
+    } // for
+
+    for (double cellSize: { 0.1, 1.0, 8.0 }) {
+      util::PxHitIndex const index(hits, cellSize, cellSize);
+      std::vector<unsigned int> selected;
+      gser.SelectLocalHitlistIndex
+        (index, selected, start, linearlimit, ortlimit, slope);
+      BOOST_CHECK(selected == expected);
+    } // for cell sizes
+  } // for slopes
+
+} // GeometryUtilitiesTest::testLocalHitlistBounds()
+
+
+//------------------------------------------------------------------------------
+void GeometryUtilitiesTest::testClosestHit
+  (util::GeometryUtilities const& gser) const
+{
+  std::mt19937 gen(91011U);
+  std::uniform_real_distribution<double> U(-20.0, 320.0);
+
+  for (unsigned int iList = 0; iList < fNHitLists; ++iList) {
+    // hits on a grid are often at the same distance from the point
+    HitList_t const hits = makeHits(gen, 10U + 100U * iList, true);
+    BOOST_TEST_MESSAGE("Closest hit on " << hits.size() << " hits");
+
+    std::vector<util::PxHitIndex> indices;
+    indices.emplace_back(hits);
+    indices.emplace_back(hits, 0.7, 5.0);
+
+    unsigned int nErrors = 0U;
+    for (unsigned int iQuery = 0; iQuery < fNQueries; ++iQuery) {
+      unsigned int wire = (unsigned int) std::max(0.0, U(gen));
+      double time = std::round(U(gen) * 0.66);
+      if (iQuery % 7U == 0U) { // right on a hit
+        util::PxHit const& hit = hits[iQuery % hits.size()];
+        wire = (unsigned int) hit.w;
+        time = hit.t;
+      }
+      unsigned int const expected = gser.FindClosestHitIndex(hits, wire, time);
+      for (util::PxHitIndex const& index: indices) {
+        if (gser.FindClosestHitIndex(index, wire, time) != expected) ++nErrors;
+      }
+    } // for queries
+    BOOST_CHECK_EQUAL(nErrors, 0U);
+  } // for lists
+
+} // GeometryUtilitiesTest::testClosestHit()
+
+
+//------------------------------------------------------------------------------
+void GeometryUtilitiesTest::testBatchProjections
+  (util::GeometryUtilities const& gser, geo::GeometryCore const& geom) const
+{
+  /*
+   * Points and directions are projected on all the planes at once, and each
+   * result, at index (plane * n + i), must be the same as the one from the
+   * call on that single plane. Points are within the first TPC, whose wires
+   * cover them in all the planes.
+   */
+  unsigned int const nPlanes = gser.Nplanes();
+  BOOST_TEST_REQUIRE(nPlanes > 0U);
+  std::size_t const n = fNQueries;
+
+  std::mt19937 gen(121314U);
+  std::uniform_real_distribution<double> X(0.0, 2.0 * geom.DetHalfWidth());
+  std::uniform_real_distribution<double> Y
+    (-0.9 * geom.DetHalfHeight(), 0.9 * geom.DetHalfHeight());
+  std::uniform_real_distribution<double> Z
+    (0.05 * geom.DetLength(), 0.95 * geom.DetLength());
+  std::uniform_real_distribution<double> D(-1.0, 1.0);
+  std::uniform_real_distribution<double> Phi(-180.0, 180.0);
+  std::uniform_real_distribution<double> Theta(-90.0, 90.0);
+
+  std::vector<double> xyz(3U * n), phi(n), theta(n);
+  std::vector<TVector3> dirs(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    xyz[3U * i] = X(gen);
+    xyz[3U * i + 1U] = Y(gen);
+    xyz[3U * i + 2U] = Z(gen);
+    dirs[i].SetXYZ(D(gen), D(gen), D(gen));
+    phi[i] = Phi(gen);
+    theta[i] = Theta(gen);
+  } // for
+  dirs.front().SetXYZ(0.0, 0.0, 1.0); // along the beam
+  dirs.back().SetXYZ(1.0, 0.0, 0.0); // along the drift
+
+  std::vector<util::PxPoint> points(nPlanes * n);
+  std::vector<double> angles(nPlanes * n), pitches(nPlanes * n);
+  gser.Get2DPointProjections(n, xyz.data(), points.data());
+  gser.Get2DanglesFrom3D(n, dirs.data(), angles.data());
+  gser.PitchesInView(n, phi.data(), theta.data(), pitches.data());
+
+  for (unsigned int plane = 0; plane < nPlanes; ++plane) {
+    BOOST_TEST_MESSAGE("Batch projections on plane #" << plane);
+    unsigned int nErrors = 0U;
+    for (std::size_t i = 0; i < n; ++i) {
+      std::size_t const index = plane * n + i;
+
+      util::PxPoint const expected
+        = gser.Get2DPointProjection(&(xyz[3U * i]), plane);
+      util::PxPoint const& point = points[index];
+      if ((point.plane != expected.plane)
+        || (point.w != expected.w) || (point.t != expected.t)
+      ) {
+        ++nErrors;
+      }
+
+      if (angles[index] != gser.Get2DangleFrom3D(plane, dirs[i])) ++nErrors;
+
+      if (pitches[index] != gser.PitchInView(plane, phi[i], theta[i]))
+        ++nErrors;
+    } // for
+    BOOST_CHECK_EQUAL(nErrors, 0U);
+  } // for planes
+
+  // planes out of range are reported by the library, not by the geometry
+  BOOST_CHECK_THROW(
+    gser.Get2DPointProjection(xyz.data(), nPlanes), util::UtilException);
+  BOOST_CHECK_THROW
+    (gser.Get2DangleFrom3D(nPlanes, dirs.front()), util::UtilException);
+  BOOST_CHECK_THROW
+    (gser.PitchInView(nPlanes, phi.front(), theta.front()), util::UtilException);
+
+} // GeometryUtilitiesTest::testBatchProjections()
+
+
+//------------------------------------------------------------------------------
+void GeometryUtilitiesTest::analyze(art::Event const& event) {
+
+  auto const clockData
+    = art::ServiceHandle<detinfo::DetectorClocksService const>()->DataFor(event);
+  auto const detProp
+    = art::ServiceHandle<detinfo::DetectorPropertiesService const>()
+      ->DataFor(event, clockData);
+  geo::GeometryCore const& geom = *(lar::providerFrom<geo::Geometry>());
+  util::GeometryUtilities const gser { geom, clockData, detProp };
+
+  mf::LogVerbatim("GeometryUtilitiesTest")
+    << "Testing " << fNHitLists << " hit lists with " << fNQueries
+    << " selections each";
+
+  testHighChargeHits(gser);
+  testLocalHitlist(gser);
+  testLocalHitlistBounds(gser);
+  testClosestHit(gser);
+  testBatchProjections(gser, geom);
+
+} // GeometryUtilitiesTest::analyze()
+
+
+//------------------------------------------------------------------------------
+DEFINE_ART_MODULE(GeometryUtilitiesTest)
@@ -13,8 +13,13 @@
  *
  * * `GridContainer2DTest`: two-dimension container test
  * * `GridContainer3DTest`: three-dimension container test
+ * * `FlatGridContainer2DTest`: two-dimension flat container test
+ * * `FlatGridContainer3DTest`: three-dimension flat container test
+ * * `GridNeighbourhoodTest`: neighbourhood iteration and searches
+ * * `GridShellTest`: iteration on the cells of shells around a cell
+ * * `FlatGridParallelBuildTest`: multithread filling of a flat container
  *
- * See the documentation of the three functions for more information.
+ * See the documentation of the functions for more information.
  *
  */
 
@@ -26,6 +31,14 @@
 #include <cetlib/quiet_unit_test.hpp> // BOOST_AUTO_TEST_CASE()
 #include <boost/test/test_tools.hpp> // BOOST_CHECK(), BOOST_CHECK_EQUAL()
 
+// C/C++ standard libraries
+#include <vector>
+#include <set>
+#include <algorithm> // std::sort(), std::max()
+#include <utility> // std::pair
+#include <cmath> // std::floor()
+#include <cstdlib> // std::abs()
+
 //------------------------------------------------------------------------------
 //--- tests
 //
@@ -213,6 +226,447 @@ void GridContainer3DTest() {
 } // GridContainer3DTest()
 
 
+//------------------------------------------------------------------------------
+/**
+ * @brief Test for a FlatGridContainer2D of integers
+ *
+ * The test fills a `FlatGridContainer2D<int>` container with the same content
+ * as `GridContainer2DTest()`, from a list of (cell, value) pairs in which the
+ * cells are not in order, and verifies its content.
+ *
+ */
+void FlatGridContainer2DTest() {
+
+  //
+  // initialise
+  //
+  using Container_t = util::FlatGridContainer2D<int>;
+  using CellID_t = Container_t::CellID_t;
+  // BUG the double brace syntax is required to work around clang bug 21629
+  // (https://bugs.llvm.org/show_bug.cgi?id=21629)
+  Container_t grid({{{ 2U, 3U }}});
+
+  BOOST_CHECK_EQUAL(grid.dims(), 2U);
+  BOOST_CHECK_EQUAL(grid.size(),  6U);
+  BOOST_CHECK_EQUAL(grid.sizeX(), 2U);
+  BOOST_CHECK_EQUAL(grid.sizeY(), 3U);
+  BOOST_CHECK_EQUAL(grid.nData(), 0U);
+  BOOST_CHECK((grid[{{ 1, 2 }}].empty()));
+
+  //
+  // fill the container
+  //
+  std::vector<std::pair<CellID_t, int>> input;
+  for (int count = 3; count-- > 0; ) { // values in each cell are decreasing
+    CellID_t cellID;
+    for (cellID[1] = grid.sizeY(); cellID[1]-- > 0; ) { // cells shuffled
+      for (cellID[0] = 0; (size_t) cellID[0] < grid.sizeX(); ++cellID[0]) {
+        if (count < cellID[0] + cellID[1]) input.emplace_back(cellID, count);
+      } // for ix
+    } // for iy
+  } // for count
+
+  grid.build(input,
+    [](std::pair<CellID_t, int> const& elem){ return elem.first; },
+    [](std::pair<CellID_t, int> const& elem){ return elem.second; }
+    );
+  BOOST_CHECK_EQUAL(grid.nData(), input.size());
+
+  //
+  // read the container
+  //
+  CellID_t cellID;
+  for (cellID[0] = 0; (size_t) cellID[0] < grid.sizeX(); ++cellID[0]) {
+    for (cellID[1] = 0; (size_t) cellID[1] < grid.sizeY(); ++cellID[1]) {
+
+      int count = cellID[0] + cellID[1];
+
+      auto cellIndex = grid.index(cellID);
+      auto const cell =  (count & 1)? grid[cellIndex]: grid[cellID];
+
+      BOOST_TEST_CHECKPOINT
+        ("[" << cellID[0] << "][" << cellID[1] << "]");
+      BOOST_CHECK_EQUAL(cell.size(), (size_t) count);
+
+      for (int val: cell) BOOST_CHECK_EQUAL(val, --count);
+
+    } // for iy
+  } // for ix
+
+  //
+  // rebuild from cell indices
+  //
+  std::vector<Container_t::CellIndex_t> indices { 5U, 0U, 5U, 2U };
+  grid.build(indices, [](auto index){ return index; });
+  BOOST_CHECK_EQUAL(grid.nData(), indices.size());
+  BOOST_CHECK_EQUAL(grid[0U].size(), 1U);
+  BOOST_CHECK_EQUAL(grid[1U].size(), 0U);
+  BOOST_CHECK_EQUAL(grid[2U].size(), 1U);
+  BOOST_CHECK_EQUAL(grid[5U].size(), 2U);
+
+  grid.clear();
+  BOOST_CHECK_EQUAL(grid.nData(), 0U);
+  BOOST_CHECK(grid[5U].empty());
+
+} // FlatGridContainer2DTest()
+
+
+//------------------------------------------------------------------------------
+/**
+ * @brief Test for a FlatGridContainer3D of integers
+ *
+ * The test fills a `FlatGridContainer3D<int>` container with the same content
+ * as `GridContainer3DTest()`, at construction, and verifies its content.
+ *
+ */
+void FlatGridContainer3DTest() {
+
+  using Container_t = util::FlatGridContainer3D<int>;
+  using CellID_t = Container_t::CellID_t;
+
+  std::vector<std::pair<CellID_t, int>> input;
+  CellID_t cellID;
+  for (cellID[2] = 4; cellID[2]-- > 0; ) {
+    for (cellID[0] = 0; cellID[0] < 2; ++cellID[0]) {
+      for (cellID[1] = 0; cellID[1] < 3; ++cellID[1]) {
+        int count = cellID[0] + cellID[1] + cellID[2];
+        while (count-- > 0) input.emplace_back(cellID, count);
+      } // for iy
+    } // for ix
+  } // for iz
+
+  // BUG the double brace syntax is required to work around clang bug 21629
+  // (https://bugs.llvm.org/show_bug.cgi?id=21629)
+  Container_t const grid({{ 2U, 3U, 4U }}, input,
+    [](std::pair<CellID_t, int> const& elem){ return elem.first; },
+    [](std::pair<CellID_t, int> const& elem){ return elem.second; }
+    );
+
+  BOOST_CHECK_EQUAL(grid.dims(), 3U);
+  BOOST_CHECK_EQUAL(grid.size(), 24U);
+  BOOST_CHECK_EQUAL(grid.sizeZ(), 4U);
+  BOOST_CHECK_EQUAL(grid.index({{ 1, 2, 3 }}), 23U);
+  BOOST_CHECK_EQUAL(grid.nData(), input.size());
+
+  for (cellID[0] = 0; (size_t) cellID[0] < grid.sizeX(); ++cellID[0]) {
+    for (cellID[1] = 0; (size_t) cellID[1] < grid.sizeY(); ++cellID[1]) {
+      for (cellID[2] = 0; (size_t) cellID[2] < grid.sizeZ(); ++cellID[2]) {
+
+        int count = cellID[0] + cellID[1] + cellID[2];
+
+        auto const cell = grid[cellID];
+
+        BOOST_TEST_CHECKPOINT
+          ("[" << cellID[0] << "][" << cellID[1] << "][" << cellID[2] << "]");
+        BOOST_CHECK_EQUAL(cell.size(), (size_t) count);
+
+        for (size_t k = 0; k < cell.size(); ++k) {
+          int val = cell[k];
+          BOOST_TEST_CHECKPOINT("  [" << k << "]");
+          BOOST_CHECK_EQUAL(val, --count);
+        } // for
+
+      } // for iz
+    } // for iy
+  } // for ix
+
+} // FlatGridContainer3DTest()
+
+
+//------------------------------------------------------------------------------
+/// A point in a 3D grid of unit cells.
+struct TestPoint_t {
+  double x, y, z;
+  int id;
+
+  /// Returns the cell the point belongs to
+  std::array<std::ptrdiff_t, 3U> cell() const
+    {
+      return {{
+        (std::ptrdiff_t) std::floor(x), (std::ptrdiff_t) std::floor(y),
+        (std::ptrdiff_t) std::floor(z)
+      }};
+    }
+
+  /// Returns the square of the distance from another point
+  double distance2(TestPoint_t const& other) const
+    {
+      return (x - other.x) * (x - other.x) + (y - other.y) * (y - other.y)
+        + (z - other.z) * (z - other.z);
+    }
+}; // TestPoint_t
+
+
+/// Returns a list of `n` points in the volume [ 0 ; sizes [ in each dimension
+std::vector<TestPoint_t> makeTestPoints(std::size_t n, std::array<int, 3> sizes)
+{
+  // a simple linear congruential generator, to have a reproducible sequence
+  unsigned long long seed = 12345U;
+  auto const random = [&seed](int max){
+    seed = (seed * 6364136223846793005ULL + 1442695040888963407ULL);
+    return (double) (seed >> 11) / (double) (1ULL << 53) * max;
+  };
+
+  std::vector<TestPoint_t> points;
+  for (std::size_t i = 0; i < n; ++i) {
+    points.push_back
+      ({ random(sizes[0]), random(sizes[1]), random(sizes[2]), (int) i });
+  }
+  return points;
+} // makeTestPoints()
+
+
+/**
+ * @brief Test for neighbourhood iteration and searches in a grid
+ *
+ * The test fills a `GridContainer3D` and a `FlatGridContainer3D` with the
+ * same random points, and compares the result of the neighbourhood and search
+ * methods with a brute force computation.
+ *
+ */
+void GridNeighbourhoodTest() {
+
+  using Grid_t = util::GridContainer3D<TestPoint_t>;
+  using FlatGrid_t = util::FlatGridContainer3D<TestPoint_t>;
+  using CellID_t = Grid_t::CellID_t;
+
+  std::vector<TestPoint_t> const points = makeTestPoints(500U, {{ 5, 4, 6 }});
+
+  // BUG the double brace syntax is required to work around clang bug 21629
+  // (https://bugs.llvm.org/show_bug.cgi?id=21629)
+  Grid_t grid({{{ 5U, 4U, 6U }}});
+  for (TestPoint_t const& point: points) grid.insert(point.cell(), point);
+
+  FlatGrid_t const flatGrid({{ 5U, 4U, 6U }}, points,
+    [](TestPoint_t const& point){ return point.cell(); });
+
+  //
+  // stencil
+  //
+  auto const stencil = grid.makeStencil(1);
+  BOOST_CHECK_EQUAL(stencil.cellOffsets.size(), 27U);
+  BOOST_CHECK_EQUAL(grid.makeStencil(0).cellOffsets.size(), 1U);
+  BOOST_CHECK_EQUAL(grid.makeStencil(2).cellOffsets.size(), 125U);
+
+  BOOST_CHECK( grid.hasCell({{ 4, 3, 5 }}));
+  BOOST_CHECK(!grid.hasCell({{ 4, 4, 5 }}));
+  BOOST_CHECK(!grid.hasCell({{ -1, 0, 0 }}));
+
+  //
+  // neighbourhood: count the neighbour cells and the points in them
+  //
+  CellID_t center;
+  for (center[0] = 0; (size_t) center[0] < grid.sizeX(); ++center[0]) {
+    for (center[1] = 0; (size_t) center[1] < grid.sizeY(); ++center[1]) {
+      for (center[2] = 0; (size_t) center[2] < grid.sizeZ(); ++center[2]) {
+
+        BOOST_TEST_CHECKPOINT
+          ("[" << center[0] << "][" << center[1] << "][" << center[2] << "]");
+
+        std::size_t expectedCells = 0U, expectedPoints = 0U;
+        CellID_t cellID;
+        for (cellID[0] = 0; (size_t) cellID[0] < grid.sizeX(); ++cellID[0]) {
+          for (cellID[1] = 0; (size_t) cellID[1] < grid.sizeY(); ++cellID[1])
+          {
+            for (cellID[2] = 0; (size_t) cellID[2] < grid.sizeZ(); ++cellID[2])
+            {
+              if (std::abs(cellID[0] - center[0]) > 1) continue;
+              if (std::abs(cellID[1] - center[1]) > 1) continue;
+              if (std::abs(cellID[2] - center[2]) > 1) continue;
+              ++expectedCells;
+              expectedPoints += grid[cellID].size();
+            } // for z
+          } // for y
+        } // for x
+
+        std::size_t nCells = 0U, nPoints = 0U, nFlatPoints = 0U;
+        grid.forEachNeighbourCell(center, stencil,
+          [&](auto const& cell){ ++nCells; nPoints += cell.size(); });
+        flatGrid.forEachNeighbourCell(center, stencil,
+          [&](auto const& cell){ nFlatPoints += cell.size(); });
+        BOOST_CHECK_EQUAL(nCells, expectedCells);
+        BOOST_CHECK_EQUAL(nPoints, expectedPoints);
+        BOOST_CHECK_EQUAL(nFlatPoints, expectedPoints);
+
+      } // for z
+    } // for y
+  } // for x
+
+  //
+  // searches
+  //
+  for (std::size_t iQuery = 0; iQuery < points.size(); iQuery += 17) {
+    TestPoint_t const& query = points[iQuery];
+    BOOST_TEST_CHECKPOINT("Query #" << iQuery);
+    auto const dist2
+      = [&query](TestPoint_t const& point){ return query.distance2(point); };
+
+    // brute force
+    std::vector<std::pair<double, int>> expected;
+    for (TestPoint_t const& point: points)
+      expected.emplace_back(dist2(point), point.id);
+    std::sort(expected.begin(), expected.end());
+
+    // within distance 0.8: a neighbourhood of radius 1 is enough
+    std::set<int> expectedWithin;
+    for (auto const& match: expected)
+      if (match.first <= 0.64) expectedWithin.insert(match.second);
+
+    for (auto const& matches: {
+      grid.findWithin(query.cell(), stencil, dist2, 0.64),
+      flatGrid.findWithin(query.cell(), stencil, dist2, 0.64)
+    }) {
+      std::set<int> within;
+      for (auto const& match: matches) {
+        within.insert(match.datum->id);
+        BOOST_CHECK_EQUAL(match.distance2, dist2(*match.datum));
+      }
+      BOOST_CHECK_EQUAL(matches.size(), expectedWithin.size());
+      BOOST_CHECK(within == expectedWithin);
+    } // for
+
+    // nearest neighbours
+    for (std::size_t k: { 0U, 1U, 5U, 30U }) {
+      for (auto const& matches: {
+        grid.findNearest(query.cell(), k, dist2, 1.0),
+        flatGrid.findNearest(query.cell(), k, dist2, 1.0)
+      }) {
+        BOOST_CHECK_EQUAL(matches.size(), k);
+        for (std::size_t i = 0; i < matches.size(); ++i)
+          BOOST_CHECK_EQUAL(matches[i].distance2, expected[i].first);
+      } // for
+    } // for k
+
+  } // for queries
+
+  // asking for more than there are
+  auto const all = flatGrid.findNearest({{ 0, 0, 0 }}, 1000U,
+    [](TestPoint_t const& point){ return point.x; }, 1.0);
+  BOOST_CHECK_EQUAL(all.size(), points.size());
+
+} // GridNeighbourhoodTest()
+
+
+//------------------------------------------------------------------------------
+/**
+ * @brief Checks all shells around many cells of the specified grid
+ *
+ * Each shell must include each cell at its (Chebyshev) distance from the
+ * center exactly once, and no other cell. Centers are also out of the grid.
+ */
+template <typename Indices>
+void checkShells(Indices const& indices, typename Indices::CellID_t sizes) {
+
+  using CellID_t = typename Indices::CellID_t;
+  using CellDimIndex_t = typename Indices::CellDimIndex_t;
+  constexpr unsigned int dims = Indices::dims();
+
+  // "odometer" loop on all cells from `first` to `last`
+  auto const forEachCell = [](CellID_t const& first, CellID_t const& last,
+    auto op)
+    {
+      CellID_t cellID = first;
+      unsigned int dim = 0;
+      do {
+        op(cellID);
+        for (dim = dims; dim-- > 0; ) {
+          if (++cellID[dim] <= last[dim]) break;
+          cellID[dim] = first[dim];
+        } // for
+      } while (dim < dims);
+    };
+
+  CellID_t firstCenter, lastCenter, firstCell, lastCell;
+  for (unsigned int d = 0; d < dims; ++d) {
+    firstCenter[d] = -2;
+    lastCenter[d] = sizes[d] + 1;
+    firstCell[d] = 0;
+    lastCell[d] = sizes[d] - 1;
+  } // for
+
+  forEachCell(firstCenter, lastCenter, [&](CellID_t const& center){
+
+    CellDimIndex_t const maxRadius = indices.maxShellRadius(center);
+    for (CellDimIndex_t radius = 0; radius <= maxRadius + 1; ++radius) {
+
+      std::vector<std::size_t> expected;
+      forEachCell(firstCell, lastCell, [&](CellID_t const& cellID){
+        CellDimIndex_t dist = 0;
+        for (unsigned int d = 0; d < dims; ++d)
+          dist = std::max(dist, std::abs(cellID[d] - center[d]));
+        if (dist == radius) expected.push_back(indices[cellID]);
+      });
+
+      std::vector<std::size_t> visited;
+      indices.forEachInShell
+        (center, radius, [&visited](auto i){ visited.push_back(i); });
+      std::sort(visited.begin(), visited.end());
+
+      // both sorted, so duplicate visits are found too
+      BOOST_CHECK(visited == expected);
+    } // for radius
+
+  });
+
+} // checkShells()
+
+
+/**
+ * @brief Test for the iteration on shells of cells
+ *
+ * The cells of each shell are compared with a brute force selection, in grids
+ * of different shapes in two and three dimensions.
+ */
+void GridShellTest() {
+
+  // BUG the double brace syntax is required to work around clang bug 21629
+  // (https://bugs.llvm.org/show_bug.cgi?id=21629)
+  checkShells(util::GridContainer2DIndices({{{ 6U, 3U }}}), {{ 6, 3 }});
+  checkShells(util::GridContainer2DIndices({{{ 1U, 5U }}}), {{ 1, 5 }});
+  checkShells(util::GridContainer3DIndices({{{ 5U, 4U, 6U }}}), {{ 5, 4, 6 }});
+  checkShells(util::GridContainer3DIndices({{{ 2U, 1U, 7U }}}), {{ 2, 1, 7 }});
+
+} // GridShellTest()
+
+
+//------------------------------------------------------------------------------
+/**
+ * @brief Test for the filling of a flat container with many threads
+ *
+ * The content of the container must be the same as from the serial filling.
+ */
+void FlatGridParallelBuildTest() {
+
+  using FlatGrid_t = util::FlatGridContainer3D<int>;
+
+  std::vector<TestPoint_t> const points = makeTestPoints(5000U, {{ 7, 3, 5 }});
+  auto const cellOf = [](TestPoint_t const& point){ return point.cell(); };
+  auto const idOf = [](TestPoint_t const& point){ return point.id; };
+
+  FlatGrid_t const expected({{ 7U, 3U, 5U }}, points, cellOf, idOf);
+  BOOST_REQUIRE_EQUAL(expected.nData(), points.size());
+
+  for (unsigned int nThreads: { 0U, 1U, 3U, 8U }) {
+    BOOST_TEST_CHECKPOINT("Threads: " << nThreads);
+    FlatGrid_t grid({{{ 7U, 3U, 5U }}});
+    grid.buildParallel(nThreads, points, cellOf, idOf);
+    BOOST_CHECK_EQUAL(grid.nData(), expected.nData());
+    for (std::size_t index = 0; index < grid.size(); ++index) {
+      auto const cell = grid[index];
+      auto const expectedCell = expected[index];
+      BOOST_CHECK_EQUAL_COLLECTIONS
+        (cell.begin(), cell.end(), expectedCell.begin(), expectedCell.end());
+    } // for
+  } // for
+
+  // an empty range
+  FlatGrid_t grid({{{ 7U, 3U, 5U }}});
+  grid.buildParallel(4U, std::vector<TestPoint_t>{}, cellOf, idOf);
+  BOOST_CHECK_EQUAL(grid.nData(), 0U);
+
+} // FlatGridParallelBuildTest()
+
+
 //------------------------------------------------------------------------------
 //--- test cases
 //
@@ -224,3 +678,23 @@ BOOST_AUTO_TEST_CASE(GridContainer3DTestCase) {
   GridContainer3DTest();
 } // GridContainer3DTestCase
 
+
+BOOST_AUTO_TEST_CASE(FlatGridContainer2DTestCase) {
+  FlatGridContainer2DTest();
+} // FlatGridContainer2DTestCase
+
+BOOST_AUTO_TEST_CASE(FlatGridContainer3DTestCase) {
+  FlatGridContainer3DTest();
+} // FlatGridContainer3DTestCase
+
+BOOST_AUTO_TEST_CASE(GridNeighbourhoodTestCase) {
+  GridNeighbourhoodTest();
+} // GridNeighbourhoodTestCase
+
+BOOST_AUTO_TEST_CASE(GridShellTestCase) {
+  GridShellTest();
+} // GridShellTestCase
+
+BOOST_AUTO_TEST_CASE(FlatGridParallelBuildTestCase) {
+  FlatGridParallelBuildTest();
+} // FlatGridParallelBuildTestCase
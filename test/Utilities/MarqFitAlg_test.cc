@@ -0,0 +1,317 @@
+/**
+ * @file   MarqFitAlg_test.cc
+ * @brief  Unit test for `gshf::MarqFitAlg`.
+ * @date   October 18, 2026
+ * @see    lardata/Utilities/MarqFitAlg.h
+ *
+ * Sums of one to three Gaussian functions with a fixed pseudo-random noise
+ * are fitted to convergence, and the result is compared with reference fits.
+ * The reference values were obtained with the previous implementation of the
+ * algorithm (Gauss-Jordan solution in single precision); they are matched
+ * within a relative tolerance of 1e-5.
+ *
+ * The batch fit steps are required to give exactly the same result as the
+ * single candidate ones, and so are the fits with an explicit workspace and
+ * the fits with one fitter shared by several threads.
+ */
+
+// LArSoft libraries
+#include "lardata/Utilities/MarqFitAlg.h"
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( MarqFitAlg_test )
+#include <cetlib/quiet_unit_test.hpp> // BOOST_AUTO_TEST_CASE()
+#include <boost/test/test_tools.hpp> // BOOST_CHECK(), BOOST_CHECK_EQUAL()
+
+// C/C++ standard libraries
+#include <vector>
+#include <thread>
+#include <limits> // std::numeric_limits<>
+#include <cmath> // std::exp(), std::abs()
+#include <functional> // std::ref()
+#include <utility> // std::move()
+#include <cstddef> // std::size_t
+
+
+//------------------------------------------------------------------------------
+/// Relative tolerance on the fit results, in percent.
+constexpr double Tolerance = 1e-3;
+
+
+/// A fit with its data and reference results.
+struct FitCase_t {
+  int nData; ///< Number of ticks.
+  std::vector<float> truth; ///< Parameters the data is generated with.
+  std::vector<float> start; ///< Starting values of the fit parameters.
+  float chiSqr; ///< Reference chi square at convergence.
+  std::vector<float> params; ///< Reference parameters at convergence.
+  std::vector<float> errors; ///< Reference parameter errors at convergence.
+}; // FitCase_t
+
+
+/// Returns a reproducible noise in [ -2, 2 [ for the specified tick.
+float noise(int tick) {
+  unsigned int s = 2654435761U * (unsigned int)(tick + 1);
+  s ^= s >> 13;
+  s *= 0x5bd1e995U;
+  s ^= s >> 15;
+  return 4.0f * float(s % 10000U) / 10000.0f - 2.0f;
+} // noise()
+
+
+/// Returns the data of the specified fit: sum of Gaussians plus noise.
+std::vector<float> makeData(int nData, std::vector<float> const& truth) {
+  std::vector<float> data(nData);
+  for (int i = 0; i < nData; ++i) {
+    float value = noise(i);
+    for (std::size_t g = 0; g < truth.size(); g += 3) {
+      float const x = (float(i) - truth[g + 1]) / truth[g + 2];
+      value += truth[g] * std::exp(-0.5f * x * x);
+    }
+    data[i] = value;
+  } // for
+  return data;
+} // makeData()
+
+
+/// Iterates fit steps until the change in chi square is small enough.
+int fitToConvergence(
+  gshf::MarqFitAlg& fitter, std::vector<float>& params,
+  std::vector<float>& data, float& chiSqr
+) {
+  float lambda = -1.0; // let the algorithm choose
+  float dchiSqr = 0.0;
+  int iStep = 0;
+  for (; iStep < 100; ++iStep) {
+    int const res = fitter.mrqdtfit(lambda, params.data(), data.data(),
+      params.size(), data.size(), chiSqr, dchiSqr);
+    if (res != 0) return -1;
+    if (std::abs(dchiSqr) < 1e-6 * chiSqr) break;
+  } // for
+  return iStep;
+} // fitToConvergence()
+
+
+//------------------------------------------------------------------------------
+std::vector<FitCase_t> const FitCases {
+  { // single Gaussian
+    40, { 50.0, 18.3, 3.2 }, { 40.0, 17.5, 4.0 },
+    53.49779,
+    { 49.85797, 18.33999, 3.181181 },
+    { 0.5157794, 0.03800031, 0.0380003 }
+  },
+  { // two separate Gaussians
+    60,
+    { 60.0, 18.2, 2.8, 35.0, 40.6, 3.5 },
+    { 50.0, 17.6, 3.3, 40.0, 41.2, 3.0 },
+    79.02326,
+    { 59.90424, 18.22736, 2.781314, 34.79374, 40.62829, 3.533311 },
+    { 0.5516115, 0.02957297, 0.02957299, 0.4894037, 0.05738752, 0.05738755 }
+  },
+  { // two overlapping Gaussians
+    50,
+    { 45.0, 20.4, 3.0, 30.0, 27.1, 2.6 },
+    { 40.0, 19.8, 3.4, 35.0, 27.8, 2.9 },
+    64.73462,
+    { 44.29821, 20.29773, 2.902334, 30.79779, 26.95167, 2.749941 },
+    { 1.016473, 0.1598418, 0.1058492, 1.178394, 0.2165751, 0.1394591 }
+  },
+  { // three Gaussians
+    70,
+    { 40.0, 15.2, 2.5, 55.0, 30.8, 3.1, 25.0, 48.4, 4.0 },
+    { 35.0, 15.8, 2.9, 60.0, 30.2, 2.8, 30.0, 47.6, 3.6 },
+    86.71406,
+    { 39.37669, 15.22698, 2.499561, 55.5191, 30.79421, 3.079496,
+      25.66743, 48.26311, 3.812777 },
+    { 0.5819744, 0.04265771, 0.04268668, 0.5248467, 0.03362828, 0.03378718,
+      0.4717439, 0.0808982, 0.08128171 }
+  },
+}; // FitCases
+
+
+//------------------------------------------------------------------------------
+void referenceFitTest() {
+
+  // the same fitter is used for all the fits, reusing its workspace
+  gshf::MarqFitAlg fitter;
+
+  for (std::size_t iCase = 0; iCase < FitCases.size(); ++iCase) {
+    FitCase_t const& fitCase = FitCases[iCase];
+    BOOST_TEST_MESSAGE("Fit case #" << iCase << " ("
+      << (fitCase.truth.size() / 3) << " Gaussians)");
+
+    std::vector<float> data = makeData(fitCase.nData, fitCase.truth);
+    std::vector<float> params = fitCase.start;
+    float chiSqr = 0.0;
+    int const nSteps = fitToConvergence(fitter, params, data, chiSqr);
+    BOOST_TEST_MESSAGE("  converged after " << nSteps << " steps");
+    BOOST_TEST_REQUIRE(nSteps >= 0);
+    BOOST_CHECK_LT(nSteps, 100);
+
+    BOOST_CHECK_CLOSE(chiSqr, fitCase.chiSqr, Tolerance);
+    BOOST_TEST_REQUIRE(params.size() == fitCase.params.size());
+    for (std::size_t i = 0; i < params.size(); ++i)
+      BOOST_CHECK_CLOSE(params[i], fitCase.params[i], Tolerance);
+
+    std::vector<float> errors(params.size());
+    int const res = fitter.cal_perr(params.data(), data.data(),
+      params.size(), data.size(), errors.data());
+    BOOST_CHECK_EQUAL(res, 0);
+    for (std::size_t i = 0; i < errors.size(); ++i)
+      BOOST_CHECK_CLOSE(errors[i], fitCase.errors[i], Tolerance);
+
+  } // for cases
+
+} // referenceFitTest()
+
+
+//------------------------------------------------------------------------------
+void batchFitTest(bool withLimits) {
+  /*
+   * Several candidates with the same number of Gaussians and ticks, fitted
+   * a step at a time both in batch and one by one with a separate fitter;
+   * the results must be identical.
+   */
+  BOOST_TEST_MESSAGE("Batch fit test " << (withLimits? "with": "without")
+    << " parameter limits");
+
+  FitCase_t const& fitCase = FitCases[2]; // two overlapping Gaussians
+  int const nParam = fitCase.start.size();
+  int const nData = fitCase.nData;
+  int const nFits = 5;
+
+  // candidates differ by their data (shifted) and starting parameters
+  std::vector<float> batchParams, data;
+  for (int f = 0; f < nFits; ++f) {
+    std::vector<float> truth = fitCase.truth;
+    std::vector<float> start = fitCase.start;
+    for (int g = 0; g < nParam; g += 3) {
+      truth[g + 1] += 0.7f * f;
+      start[g] *= 1.0f + 0.05f * f;
+      start[g + 1] += 0.9f * f - 0.2f * g;
+    }
+    std::vector<float> const candidateData = makeData(nData, truth);
+    data.insert(data.end(), candidateData.begin(), candidateData.end());
+    batchParams.insert(batchParams.end(), start.begin(), start.end());
+  } // for
+
+  // limits tight enough for the penalty to be triggered by some candidate
+  std::vector<float> minLimits(nParam, std::numeric_limits<float>::lowest());
+  std::vector<float> maxLimits(nParam, std::numeric_limits<float>::max());
+  if (withLimits) {
+    for (int g = 0; g < nParam; g += 3) {
+      minLimits[g] = 0.0;
+      maxLimits[g] = 46.0;
+      minLimits[g + 2] = 1.0;
+      maxLimits[g + 2] = 10.0;
+    }
+  }
+
+  std::vector<float> singleParams = batchParams;
+  std::vector<float> batchLambda(nFits, -1.0), singleLambda(nFits, -1.0);
+  std::vector<float> batchChiSqr(nFits), batchDChiSqr(nFits);
+
+  // the batch steps use their own workspace, the single ones the thread's
+  gshf::MarqFitAlg batchFitter, singleFitter;
+  gshf::MarqFitAlg::Workspace workspace;
+  for (int iStep = 0; iStep < 6; ++iStep) {
+    BOOST_TEST_MESSAGE("  step #" << iStep);
+
+    int const nFailed = withLimits
+      ? batchFitter.mrqdtfit(workspace, nFits, batchLambda.data(),
+        batchParams.data(), minLimits.data(), maxLimits.data(), data.data(),
+        nParam, nData, batchChiSqr.data(), batchDChiSqr.data())
+      : batchFitter.mrqdtfit(workspace, nFits, batchLambda.data(),
+        batchParams.data(), data.data(), nParam, nData,
+        batchChiSqr.data(), batchDChiSqr.data())
+      ;
+    BOOST_CHECK_EQUAL(nFailed, 0);
+
+    for (int f = 0; f < nFits; ++f) {
+      float chiSqr, dchiSqr;
+      int const res = withLimits
+        ? singleFitter.mrqdtfit(singleLambda[f], singleParams.data() + f * nParam,
+          minLimits.data(), maxLimits.data(), data.data() + f * nData,
+          nParam, nData, chiSqr, dchiSqr)
+        : singleFitter.mrqdtfit(singleLambda[f], singleParams.data() + f * nParam,
+          data.data() + f * nData, nParam, nData, chiSqr, dchiSqr)
+        ;
+      BOOST_CHECK_EQUAL(res, 0);
+      BOOST_CHECK_EQUAL(batchLambda[f], singleLambda[f]);
+      BOOST_CHECK_EQUAL(batchChiSqr[f], chiSqr);
+      BOOST_CHECK_EQUAL(batchDChiSqr[f], dchiSqr);
+      for (int i = 0; i < nParam; ++i) {
+        BOOST_CHECK_EQUAL
+          (batchParams[f * nParam + i], singleParams[f * nParam + i]);
+      }
+    } // for candidates
+  } // for steps
+
+} // batchFitTest()
+
+
+//------------------------------------------------------------------------------
+void sharedFitterTest(unsigned int nThreads) {
+  /*
+   * A single fitter is used at the same time by several threads, each fitting
+   * all the cases many times; all results must be the same as the ones of
+   * a fit in this thread.
+   */
+  BOOST_TEST_MESSAGE("Fitter shared by " << nThreads << " threads");
+
+  gshf::MarqFitAlg fitter;
+
+  std::vector<std::vector<float>> expected;
+  for (FitCase_t const& fitCase: FitCases) {
+    std::vector<float> data = makeData(fitCase.nData, fitCase.truth);
+    std::vector<float> params = fitCase.start;
+    float chiSqr = 0.0;
+    fitToConvergence(fitter, params, data, chiSqr);
+    params.push_back(chiSqr);
+    expected.push_back(std::move(params));
+  } // for
+
+  std::vector<unsigned int> nErrors(nThreads, 0U);
+  auto const fitAll = [&fitter,&expected](unsigned int& errors){
+    for (int iRepeat = 0; iRepeat < 50; ++iRepeat) {
+      for (std::size_t iCase = 0; iCase < FitCases.size(); ++iCase) {
+        FitCase_t const& fitCase = FitCases[iCase];
+        std::vector<float> data = makeData(fitCase.nData, fitCase.truth);
+        std::vector<float> params = fitCase.start;
+        float chiSqr = 0.0;
+        fitToConvergence(fitter, params, data, chiSqr);
+        params.push_back(chiSqr);
+        if (params != expected[iCase]) ++errors;
+      } // for cases
+    } // for repetitions
+  }; // fitAll()
+
+  std::vector<std::thread> threads;
+  for (unsigned int iThread = 0; iThread < nThreads; ++iThread)
+    threads.emplace_back(fitAll, std::ref(nErrors[iThread]));
+  for (std::thread& thread: threads) thread.join();
+
+  for (unsigned int iThread = 0; iThread < nThreads; ++iThread)
+    BOOST_CHECK_EQUAL(nErrors[iThread], 0U);
+
+} // sharedFitterTest()
+
+
+//------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(ReferenceFitTestCase) {
+  referenceFitTest();
+} // BOOST_AUTO_TEST_CASE(ReferenceFitTestCase)
+
+
+BOOST_AUTO_TEST_CASE(BatchFitTestCase) {
+  batchFitTest(false);
+  batchFitTest(true);
+} // BOOST_AUTO_TEST_CASE(BatchFitTestCase)
+
+
+BOOST_AUTO_TEST_CASE(SharedFitterTestCase) {
+  sharedFitterTest(4U);
+} // BOOST_AUTO_TEST_CASE(SharedFitterTestCase)
+
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,231 @@
+/**
+ * @file    PxHitIndex_test.cc
+ * @brief   Tests the spatial index of hits in `PxHitIndex.h`
+ * @see     `lardata/Utilities/PxHitIndex.h`
+ *
+ * See http://www.boost.org/libs/test for the Boost test library home page.
+ */
+
+// Boost libraries
+#define BOOST_TEST_MODULE ( PxHitIndex_test )
+#include <cetlib/quiet_unit_test.hpp> // BOOST_AUTO_TEST_CASE()
+#include <boost/test/test_tools.hpp> // BOOST_CHECK(), BOOST_CHECK_EQUAL()
+
+// LArSoft libraries
+#include "lardata/Utilities/PxHitIndex.h"
+
+// C/C++ standard libraries
+#include <algorithm> // std::sort()
+#include <cmath> // std::floor(), std::hypot()
+#include <limits> // std::numeric_limits<>
+#include <random>
+#include <utility> // std::pair
+#include <vector>
+
+
+//------------------------------------------------------------------------------
+std::vector<util::PxHit> makeHits(std::size_t n, unsigned int seed) {
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<double> w(10.0, 110.0), t(-20.0, 30.0);
+  std::vector<util::PxHit> hits;
+  for (std::size_t i = 0; i < n; ++i)
+    hits.emplace_back(0U, w(gen), t(gen), 1.0, 1.0, 1.0);
+  return hits;
+} // makeHits()
+
+
+//------------------------------------------------------------------------------
+void testBoxQueries(util::PxHitIndex const& index) {
+
+  auto const& hits = index.hits();
+
+  // each hit is in exactly one cell, the one of its coordinates
+  std::vector<unsigned int> all;
+  index.forEachInBox(-1e9, 1e9, -1e9, 1e9, [&all](unsigned int i){ all.push_back(i); });
+  std::sort(all.begin(), all.end());
+  BOOST_CHECK_EQUAL(all.size(), hits.size());
+  for (std::size_t i = 0; i < all.size(); ++i) BOOST_CHECK_EQUAL(all[i], i);
+
+  for (std::size_t i = 0; i < hits.size(); ++i) {
+    auto const cellID = index.cellOf(hits[i].w, hits[i].t);
+    auto const cell = index.grid()[cellID];
+    BOOST_CHECK(std::find(cell.begin(), cell.end(), i) != cell.end());
+  } // for
+
+  // all the hits in a box are found (and maybe a few more)
+  double const wmin = 30.0, wmax = 45.5, tmin = -3.0, tmax = 4.0;
+  std::vector<unsigned int> found;
+  index.forEachInBox(wmin, wmax, tmin, tmax, [&found](unsigned int i){ found.push_back(i); });
+  for (std::size_t i = 0; i < hits.size(); ++i) {
+    util::PxHit const& hit = hits[i];
+    if (hit.w < wmin || hit.w > wmax || hit.t < tmin || hit.t > tmax) continue;
+    BOOST_CHECK(std::find(found.begin(), found.end(), i) != found.end());
+  } // for
+
+  // a box out of the hit range has nothing
+  std::size_t nOut = 0;
+  index.forEachInBox(200.0, 300.0, -1e9, 1e9, [&nOut](unsigned int){ ++nOut; });
+  BOOST_CHECK_EQUAL(nOut, 0U);
+
+  // shells cover all the hits, each once
+  auto const center = index.cellOf(60.0, 5.0);
+  std::vector<unsigned int> shelled;
+  for (util::PxHitIndex::CellDimIndex_t r = 0; r <= index.maxShellRadius(center); ++r)
+    index.forEachInShell(center, r, [&shelled](unsigned int i){ shelled.push_back(i); });
+  std::sort(shelled.begin(), shelled.end());
+  BOOST_CHECK(shelled == all);
+
+} // testBoxQueries()
+
+
+//------------------------------------------------------------------------------
+void testPxHitIndex() {
+
+  auto const hits = makeHits(500U, 1234U);
+
+  util::PxHitIndex const index{hits};
+  BOOST_CHECK_EQUAL(index.size(), hits.size());
+  BOOST_CHECK_EQUAL(&index.hits(), &hits);
+  BOOST_CHECK(index.cellSizeW() > 0.0);
+  BOOST_CHECK_EQUAL(index.cellSizeW(), index.cellSizeT());
+  BOOST_CHECK_EQUAL(index.grid().nData(), hits.size());
+  testBoxQueries(index);
+
+  util::PxHitIndex const customIndex{hits, 2.0, 0.5};
+  BOOST_CHECK_EQUAL(customIndex.cellSizeW(), 2.0);
+  BOOST_CHECK_EQUAL(customIndex.cellSizeT(), 0.5);
+  testBoxQueries(customIndex);
+
+  // points outside the hit range are moved to the border cells
+  auto const lowCell = customIndex.cellOf(-1e3, -1e3);
+  BOOST_CHECK_EQUAL(lowCell[0], 0);
+  BOOST_CHECK_EQUAL(lowCell[1], 0);
+  auto const highCell = customIndex.cellOf(1e3, 1e3);
+  BOOST_CHECK_EQUAL(highCell[0], (int) customIndex.grid().sizeX() - 1);
+  BOOST_CHECK_EQUAL(highCell[1], (int) customIndex.grid().sizeY() - 1);
+
+} // testPxHitIndex()
+
+
+//------------------------------------------------------------------------------
+void testDegenerateLists() {
+
+  std::vector<util::PxHit> const noHits;
+  util::PxHitIndex const emptyIndex{noHits};
+  BOOST_CHECK_EQUAL(emptyIndex.size(), 0U);
+  std::size_t n = 0;
+  emptyIndex.forEachInBox(-1e9, 1e9, -1e9, 1e9, [&n](unsigned int){ ++n; });
+  BOOST_CHECK_EQUAL(n, 0U);
+
+  // all hits at the same point
+  std::vector<util::PxHit> const samePoint(10U, util::PxHit(1U, 3.0, 4.0, 1.0, 1.0, 1.0));
+  util::PxHitIndex const pointIndex{samePoint};
+  BOOST_CHECK_EQUAL(pointIndex.grid().size(), 1U);
+  testBoxQueries(pointIndex);
+
+  // all hits on the same wire
+  std::vector<util::PxHit> sameWire;
+  for (unsigned int i = 0; i < 20U; ++i)
+    sameWire.emplace_back(1U, 3.0, 0.5 * i, 1.0, 1.0, 1.0);
+  util::PxHitIndex const wireIndex{sameWire};
+  BOOST_CHECK_EQUAL(wireIndex.grid().sizeX(), 1U);
+  BOOST_CHECK(wireIndex.grid().sizeY() > 1U);
+  testBoxQueries(wireIndex);
+
+} // testDegenerateLists()
+
+
+//------------------------------------------------------------------------------
+/// Returns the first of the closest hits, scanning the whole list.
+std::size_t bruteForceClosestHit(
+  std::vector<util::PxHit> const& hits, double w, double t,
+  double scaleW, double scaleT, double maxDist
+) {
+  double minDist = maxDist;
+  std::size_t closest = hits.size();
+  for (std::size_t i = 0; i < hits.size(); ++i) {
+    double const dist
+      = std::hypot((w - hits[i].w) * scaleW, (t - hits[i].t) * scaleT);
+    if (dist < minDist) {
+      minDist = dist;
+      closest = i;
+    }
+  } // for
+  return closest;
+} // bruteForceClosestHit()
+
+
+void testClosestHit() {
+  /*
+   * Hits on a lattice of integer coordinates, many of them on the same point,
+   * so that many hits are at the same distance from the query points, which
+   * are on the lattice, halfway between its nodes, and out of the hit range.
+   */
+  std::mt19937 gen(4321U);
+  std::uniform_int_distribution<int> hitW(0, 40), hitT(-10, 10);
+  double const noLimit = std::numeric_limits<double>::max();
+
+  for (std::size_t nHits: { 1U, 7U, 100U, 1000U }) {
+    std::vector<util::PxHit> hits;
+    for (std::size_t i = 0; i < nHits; ++i)
+      hits.emplace_back(0U, double(hitW(gen)), double(hitT(gen)), 1.0, 1.0, 1.0);
+
+    std::vector<util::PxHitIndex> indices;
+    indices.emplace_back(hits);
+    indices.emplace_back(hits, 1.0, 1.0);
+    indices.emplace_back(hits, 5.0, 0.5);
+
+    std::vector<std::pair<double, double>> const scales
+      { { 1.0, 1.0 }, { 0.3, 0.05 }, { 0.05, 0.3 } };
+    for (auto const& scale: scales) {
+      BOOST_TEST_MESSAGE(nHits << " hits, scale factors "
+        << scale.first << " and " << scale.second);
+      for (util::PxHitIndex const& index: indices) {
+        unsigned int nErrors = 0U, nLimitErrors = 0U;
+        for (double w = -5.0; w <= 45.0; w += 1.5) {
+          for (double t = -15.0; t <= 15.0; t += 1.5) {
+            auto const [ sW, sT ] = scale;
+            if (index.closestHit(w, t, sW, sT)
+              != bruteForceClosestHit(hits, w, t, sW, sT, noLimit))
+              ++nErrors;
+            if (index.closestHit(w, t, sW, sT, 0.4)
+              != bruteForceClosestHit(hits, w, t, sW, sT, 0.4))
+              ++nLimitErrors;
+          } // for t
+        } // for w
+        BOOST_CHECK_EQUAL(nErrors, 0U);
+        BOOST_CHECK_EQUAL(nLimitErrors, 0U);
+      } // for indices
+    } // for scale factors
+  } // for number of hits
+
+  // a hit exactly at the maximum distance is not closer than it
+  std::vector<util::PxHit> const oneHit{ util::PxHit(0U, 3.0, 4.0, 1.0, 1.0, 1.0) };
+  util::PxHitIndex const oneIndex{oneHit};
+  BOOST_CHECK_EQUAL(oneIndex.closestHit(0.0, 0.0), 0U);
+  BOOST_CHECK_EQUAL(oneIndex.closestHit(0.0, 0.0, 1.0, 1.0, 5.0), 1U);
+  BOOST_CHECK_EQUAL(oneIndex.closestHit(0.0, 0.0, 1.0, 1.0, 5.5), 0U);
+
+  std::vector<util::PxHit> const noHits;
+  BOOST_CHECK_EQUAL(util::PxHitIndex{noHits}.closestHit(0.0, 0.0), 0U);
+
+} // testClosestHit()
+
+
+//------------------------------------------------------------------------------
+BOOST_AUTO_TEST_CASE(PxHitIndexTestCase) {
+
+  testPxHitIndex();
+  testDegenerateLists();
+
+} // PxHitIndexTestCase
+
+
+BOOST_AUTO_TEST_CASE(ClosestHitTestCase) {
+
+  testClosestHit();
+
+} // ClosestHitTestCase
+
+
+//------------------------------------------------------------------------------
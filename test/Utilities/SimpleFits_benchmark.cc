@@ -0,0 +1,118 @@
+/**
+ * @file   SimpleFits_benchmark.cc
+ * @brief  Times the batch quadratic fits against the point by point ones.
+ * @date   October 18, 2026
+ * @see    lardata/Utilities/SimpleFits.h
+ *
+ * Many datasets of the same size are fitted with a parabola in two ways:
+ * 1. point by point, with a `lar::util::QuadraticFit` per dataset
+ * 2. all at once, with `lar::util::QuadraticFitBatch`
+ *
+ * This is done both in double and in single precision, and the time taken by
+ * each way is printed. The equality of the results of the two ways is tested
+ * in `SimpleFits_test`; here only the sums of the fitted curvatures are
+ * compared, and the program returns non-zero if they disagree.
+ *
+ * Usage: `SimpleFits_benchmark [datasets] [repetitions]`
+ * (default: 20000 datasets, 5 repetitions).
+ */
+
+// LArSoft libraries
+#include "lardata/Utilities/SimpleFits.h"
+
+// C/C++ standard libraries
+#include <iostream>
+#include <vector>
+#include <random> // std::mt19937, std::normal_distribution<>
+#include <chrono>
+#include <string> // std::stoul()
+#include <algorithm> // std::max()
+#include <cmath> // std::abs()
+#include <cstddef> // std::size_t
+
+
+//------------------------------------------------------------------------------
+/// Times point by point and batch fits; returns whether they agree.
+template <typename T>
+bool PolyFitBatchBenchmark
+  (char const* typeName, std::size_t NSets, unsigned int NRepeat)
+{
+  using Data_t = T;
+  using Clock_t = std::chrono::steady_clock;
+
+  constexpr std::size_t NPoints = 32;
+
+  // all datasets have the same size and abscissae, but different noise
+  std::mt19937 gen(1);
+  std::normal_distribution<Data_t> smear(Data_t(0), Data_t(1));
+  std::vector<std::size_t> offsets { 0U };
+  std::vector<Data_t> x, y, sy;
+  for (std::size_t iSet = 0; iSet < NSets; ++iSet) {
+    for (std::size_t i = 0; i < NPoints; ++i) {
+      Data_t const xv = Data_t(0.5) * Data_t(i) - Data_t(NPoints) / Data_t(4);
+      Data_t const s = Data_t(0.5) + Data_t(0.25) * Data_t(i % 3);
+      x.push_back(xv);
+      y.push_back(Data_t(1) + Data_t(0.5) * xv - Data_t(0.1) * xv * xv
+        + s * smear(gen));
+      sy.push_back(s);
+    } // for points
+    offsets.push_back(x.size());
+  } // for sets
+
+  using Params_t = typename lar::util::QuadraticFit<Data_t>::FitParameters_t;
+  std::vector<Params_t> params(NSets), errors(NSets);
+
+  Data_t check1 = Data_t(0);
+  auto const start1 = Clock_t::now();
+  for (unsigned int iRepeat = 0; iRepeat < NRepeat; ++iRepeat) {
+    for (std::size_t iSet = 0; iSet < NSets; ++iSet) {
+      lar::util::QuadraticFit<Data_t> fitter;
+      for (std::size_t i = offsets[iSet]; i < offsets[iSet + 1]; ++i)
+        fitter.add(x[i], y[i], sy[i]);
+      fitter.FillResults(params[iSet], errors[iSet]);
+      check1 += params[iSet][2];
+    } // for
+  } // for
+  std::chrono::duration<double> const perPoint = Clock_t::now() - start1;
+
+  Data_t check2 = Data_t(0);
+  lar::util::QuadraticFitBatch<Data_t> batch;
+  auto const start2 = Clock_t::now();
+  for (unsigned int iRepeat = 0; iRepeat < NRepeat; ++iRepeat) {
+    batch.clear();
+    batch.add(NSets, offsets.data(), x.data(), y.data(), sy.data());
+    batch.FitAll(params.data(), errors.data());
+    for (Params_t const& p: params) check2 += p[2];
+  } // for
+  std::chrono::duration<double> const batched = Clock_t::now() - start2;
+
+  std::cout << "Quadratic fit (" << typeName << ") of " << NSets
+    << " datasets of " << NPoints << " points (x" << NRepeat << "):"
+    << "\n  point by point: " << perPoint.count() << " s"
+    << "\n  batch:          " << batched.count() << " s"
+    << std::endl;
+
+  Data_t const scale
+    = std::max({ Data_t(1), std::abs(check1), std::abs(check2) });
+  if (std::abs(check1 - check2) / scale <= Data_t(1e-6)) return true;
+  std::cerr << "Batch and point by point fits disagree: "
+    << check2 << " vs. " << check1 << std::endl;
+  return false;
+} // PolyFitBatchBenchmark()
+
+
+//------------------------------------------------------------------------------
+int main(int argc, char** argv) {
+
+  std::size_t const NSets = (argc > 1)? std::stoul(argv[1]): 20000U;
+  unsigned int const NRepeat = (argc > 2)? std::stoul(argv[2]): 5U;
+
+  unsigned int nErrors = 0U;
+  if (!PolyFitBatchBenchmark<double>("double", NSets, NRepeat)) ++nErrors;
+  if (!PolyFitBatchBenchmark<float>("float", NSets, NRepeat)) ++nErrors;
+
+  return (nErrors > 0U)? 1: 0;
+} // main()
+
+
+//------------------------------------------------------------------------------
@@ -22,6 +22,10 @@
 #include <stdexcept> // std::range_error
 #include <iterator> // std::ostream_iterator
 #include <iostream>
+#include <vector>
+#include <random> // std::mt19937, std::normal_distribution<>
+#include <memory> // std::unique_ptr<>
+#include <algorithm> // std::max()
 
 // Boost libraries
 /*
@@ -40,6 +44,7 @@
 
 // LArSoft libraries
 #include "lardata/Utilities/SimpleFits.h"
+#include "lardata/Utilities/CompensatedSum.h"
 
 
 //==============================================================================
@@ -664,6 +669,376 @@ void GaussianFitTest() {
 } // QuadraticFitTest()
 
 
+/** ****************************************************************************
+ * @brief Pseudo-random datasets, stored one after the other
+ */
+template <typename T>
+struct BatchTestData {
+  std::vector<std::size_t> offsets{ 0U }; ///< start of each dataset, and end
+  std::vector<T> x, y, sy; ///< points of all datasets
+
+  std::size_t nSets() const { return offsets.size() - 1; }
+  std::size_t first(std::size_t i) const { return offsets[i]; }
+  std::size_t size(std::size_t i) const { return offsets[i+1] - offsets[i]; }
+
+  /// Adds a dataset; `f` describes the expectation
+  template <typename F, typename Gen>
+  void addSet(std::size_t n, F f, Gen& gen, T noise) {
+    std::normal_distribution<T> smear(T(0), noise);
+    for (std::size_t i = 0; i < n; ++i) {
+      T const xv = T(0.5) * T(i) - T(n) / T(4);
+      T const s = T(0.5) + T(0.25) * T(i % 3);
+      x.push_back(xv);
+      y.push_back(f(xv) + s * smear(gen));
+      // every 7th point has no valid uncertainty and must be ignored
+      sy.push_back((i % 7 == 6)? T(0): s);
+    } // for
+    offsets.push_back(x.size());
+  } // addSet()
+
+}; // BatchTestData
+
+
+/// Checks that two values are close, also when they are close to 0
+template <typename T>
+void CheckNear(T a, T b, T tol) {
+  T const scale = std::max({ T(1), std::abs(a), std::abs(b) });
+  BOOST_CHECK_SMALL(double((a - b) / scale), double(tol));
+} // CheckNear()
+
+
+/** ****************************************************************************
+ * @brief Compares the batch fits with the single dataset ones
+ */
+template <typename T>
+void PolyFitBatchTest() {
+
+  using Data_t = T;
+
+  std::mt19937 gen(12345);
+  BatchTestData<Data_t> data;
+  for (std::size_t n = 2; n < 40; ++n) {
+    Data_t const a0 = Data_t(0.1) * Data_t(n), a1 = Data_t(1.5) - Data_t(n%5);
+    Data_t const a2 = Data_t(0.02) * Data_t(n % 4);
+    data.addSet
+      (n, [=](Data_t x){ return a0 + a1 * x + a2 * x * x; }, gen, Data_t(1));
+  } // for
+
+  //
+  // linear fits
+  //
+  lar::util::LinearFitBatch<Data_t> lines;
+  lines.add(data.nSets(), data.offsets.data(),
+    data.x.data(), data.y.data(), data.sy.data());
+  BOOST_CHECK_EQUAL(lines.size(), data.nSets());
+
+  using LineParams_t = typename lar::util::LinearFitBatch<Data_t>::FitParameters_t;
+  std::vector<LineParams_t> lineParams(lines.size()), lineErrors(lines.size());
+  std::vector<Data_t> lineChi2(lines.size());
+  std::unique_ptr<bool[]> lineValid(new bool[lines.size()]);
+  std::size_t nValid = lines.FitAll
+    (lineParams.data(), lineErrors.data(), lineChi2.data(), lineValid.get());
+
+  std::size_t nExpectedValid = 0;
+  for (std::size_t iSet = 0; iSet < data.nSets(); ++iSet) {
+    std::size_t const first = data.first(iSet);
+    lar::util::LinearFit<Data_t> fitter;
+    Data_t chi2 = Data_t(0);
+    for (std::size_t i = first; i < first + data.size(iSet); ++i)
+      fitter.add(data.x[i], data.y[i], data.sy[i]);
+
+    BOOST_CHECK_EQUAL(lines.N(iSet), fitter.N());
+    BOOST_CHECK_EQUAL(lines.NDF(iSet), fitter.NDF());
+    BOOST_CHECK_EQUAL(lines.isValid(iSet), fitter.isValid());
+    BOOST_CHECK_EQUAL(lineValid[iSet], fitter.isValid());
+    if (!fitter.isValid()) continue;
+    ++nExpectedValid;
+
+    LineParams_t params, errors;
+    BOOST_CHECK(fitter.FillResults(params, errors));
+    for (unsigned int iParam = 0; iParam < 2; ++iParam) {
+      CheckNear(lineParams[iSet][iParam], params[iParam], Data_t(1e-8));
+      CheckNear(lineErrors[iSet][iParam], errors[iParam], Data_t(1e-8));
+    } // for
+
+    // chi^2 computed directly
+    for (std::size_t i = first; i < first + data.size(iSet); ++i) {
+      if (data.sy[i] == Data_t(0)) continue;
+      Data_t const z = (data.y[i] - lines.Evaluate(data.x[i], params))
+        / data.sy[i];
+      chi2 += z * z;
+    } // for
+    CheckNear(lineChi2[iSet], chi2, Data_t(1e-8));
+  } // for
+  BOOST_CHECK_EQUAL(nValid, nExpectedValid);
+
+  //
+  // quadratic fits
+  //
+  lar::util::QuadraticFitBatch<Data_t> parabolae;
+  for (std::size_t iSet = 0; iSet < data.nSets(); ++iSet) {
+    std::size_t const first = data.first(iSet);
+    BOOST_CHECK_EQUAL(
+      parabolae.add(&data.x[first], &data.y[first], &data.sy[first],
+        data.size(iSet)),
+      iSet
+      );
+  } // for
+
+  for (std::size_t iSet = 0; iSet < data.nSets(); ++iSet) {
+    std::size_t const first = data.first(iSet);
+    lar::util::QuadraticFit<Data_t> fitter, arrayFitter;
+    for (std::size_t i = first; i < first + data.size(iSet); ++i)
+      fitter.add(data.x[i], data.y[i], data.sy[i]);
+    BOOST_CHECK_EQUAL(
+      arrayFitter.add_arrays
+        (&data.x[first], &data.y[first], &data.sy[first], data.size(iSet)),
+      (unsigned int) fitter.N()
+      );
+
+    BOOST_CHECK_EQUAL(parabolae.N(iSet), fitter.N());
+    BOOST_CHECK_EQUAL(arrayFitter.N(), fitter.N());
+    BOOST_CHECK_EQUAL(parabolae.isValid(iSet), fitter.isValid());
+    if (!fitter.isValid()) {
+      BOOST_CHECK_THROW(parabolae.FitParameters(iSet), std::range_error);
+      continue;
+    }
+
+    auto const params = fitter.FitParameters();
+    auto const errors = fitter.FitParameterErrors();
+    auto const batchParams = parabolae.FitParameters(iSet);
+    auto const arrayParams = arrayFitter.FitParameters();
+    typename lar::util::QuadraticFitBatch<Data_t>::FitParameters_t
+      batchParams2, batchErrors;
+    BOOST_CHECK(parabolae.FillResults(iSet, batchParams2, batchErrors));
+    for (unsigned int iParam = 0; iParam < 3; ++iParam) {
+      CheckNear(batchParams[iParam], params[iParam], Data_t(1e-7));
+      CheckNear(batchParams2[iParam], params[iParam], Data_t(1e-7));
+      CheckNear(arrayParams[iParam], params[iParam], Data_t(1e-7));
+      CheckNear(batchErrors[iParam], errors[iParam], Data_t(1e-7));
+    } // for
+    CheckNear(parabolae.ChiSquare(iSet), fitter.ChiSquare(), Data_t(1e-7));
+  } // for
+
+  //
+  // no uncertainty
+  //
+  lar::util::QuadraticFitBatch<Data_t> unweighted;
+  unweighted.add(data.nSets(), data.offsets.data(),
+    data.x.data(), data.y.data());
+  for (std::size_t iSet = 0; iSet < data.nSets(); ++iSet) {
+    std::size_t const first = data.first(iSet);
+    lar::util::QuadraticFit<Data_t> fitter;
+    for (std::size_t i = first; i < first + data.size(iSet); ++i)
+      fitter.add(data.x[i], data.y[i]);
+    BOOST_CHECK_EQUAL(unweighted.N(iSet), fitter.N());
+    if (!fitter.isValid()) continue;
+    auto const params = fitter.FitParameters();
+    auto const batchParams = unweighted.FitParameters(iSet);
+    for (unsigned int iParam = 0; iParam < 3; ++iParam)
+      CheckNear(batchParams[iParam], params[iParam], Data_t(1e-7));
+  } // for
+
+  unweighted.clear();
+  BOOST_CHECK(unweighted.empty());
+
+} // PolyFitBatchTest()
+
+
+/** ****************************************************************************
+ * @brief Compares the batch Gaussian fits with the single dataset ones
+ */
+template <typename T>
+void GaussianFitBatchTest() {
+
+  using Data_t = T;
+
+  std::mt19937 gen(54321);
+  BatchTestData<Data_t> data;
+  for (std::size_t n = 4; n < 40; ++n) {
+    Data_t const A = Data_t(10) + Data_t(n), mu = Data_t(0.1) * Data_t(n % 5);
+    Data_t const sigma = Data_t(1) + Data_t(0.1) * Data_t(n);
+    data.addSet(n,
+      [=](Data_t x){ return A * std::exp(-0.5 * std::pow((x - mu) / sigma, 2)); },
+      gen, Data_t(0.05)
+      );
+  } // for
+
+  for (bool withUncertainty: { true, false }) {
+    lar::util::GaussianFitBatch<Data_t> gaussians;
+    gaussians.add(data.nSets(), data.offsets.data(), data.x.data(),
+      data.y.data(), withUncertainty? data.sy.data(): nullptr);
+
+    using Params_t = typename lar::util::GaussianFitBatch<Data_t>::FitParameters_t;
+    std::vector<Params_t> batchParams(gaussians.size());
+    std::vector<Params_t> batchErrors(gaussians.size());
+    std::unique_ptr<bool[]> batchValid(new bool[gaussians.size()]);
+    gaussians.FitAll
+      (batchParams.data(), batchErrors.data(), batchValid.get());
+
+    for (std::size_t iSet = 0; iSet < data.nSets(); ++iSet) {
+      std::size_t const first = data.first(iSet);
+      lar::util::GaussianFit<Data_t> fitter;
+      fitter.add_arrays(&data.x[first], &data.y[first],
+        withUncertainty? &data.sy[first]: nullptr, data.size(iSet));
+
+      BOOST_CHECK_EQUAL(gaussians.N(iSet), fitter.N());
+      Params_t params, errors;
+      bool const valid = fitter.FillResults(params, errors);
+      BOOST_CHECK_EQUAL(batchValid[iSet], valid);
+      if (!valid) continue;
+      for (unsigned int iParam = 0; iParam < 3; ++iParam) {
+        CheckNear(batchParams[iSet][iParam], params[iParam], Data_t(1e-7));
+        CheckNear(batchErrors[iSet][iParam], errors[iParam], Data_t(1e-7));
+      } // for
+      CheckNear(gaussians.ChiSquare(iSet), fitter.ChiSquare(), Data_t(1e-7));
+    } // for
+  } // for
+
+} // GaussianFitBatchTest()
+
+
+/** ****************************************************************************
+ * @brief Tests fits on a sliding window, and merging and splitting of fitters
+ */
+template <typename T>
+void SlidingWindowFitTest() {
+
+  using Data_t = T;
+
+  std::mt19937 gen(54321);
+  BatchTestData<Data_t> data;
+  data.addSet(300U,
+    [](Data_t x){ return Data_t(20) - Data_t(0.3) * x + Data_t(0.01) * x * x; },
+    gen, Data_t(0.5)
+    );
+  std::size_t const nPoints = data.size(0);
+  std::size_t const window = 12U;
+
+  //
+  // sliding window: one point added and one removed at each step
+  //
+  using Fitter_t
+    = lar::util::QuadraticFit<Data_t, lar::util::CompensatedSum<Data_t>>;
+  Fitter_t sliding;
+  for (std::size_t i = 0; i < nPoints; ++i) {
+    sliding.add(data.x[i], data.y[i], data.sy[i]);
+    if (i < window) continue;
+    sliding.remove(data.x[i - window], data.y[i - window], data.sy[i - window]);
+
+    Fitter_t expected;
+    for (std::size_t j = i + 1 - window; j <= i; ++j)
+      expected.add(data.x[j], data.y[j], data.sy[j]);
+
+    BOOST_CHECK_EQUAL(sliding.N(), expected.N());
+    BOOST_CHECK_EQUAL(sliding.isValid(), expected.isValid());
+    if (!expected.isValid()) continue;
+    auto const params = sliding.FitParameters();
+    auto const expectedParams = expected.FitParameters();
+    for (unsigned int iParam = 0; iParam < 3; ++iParam)
+      CheckNear(params[iParam], expectedParams[iParam], Data_t(1e-6));
+    CheckNear(sliding.ChiSquare(), expected.ChiSquare(), Data_t(1e-6));
+  } // for
+
+  //
+  // merge and split
+  //
+  std::size_t const half = nPoints / 2;
+  lar::util::LinearFit<Data_t> first, second, all;
+  lar::util::GaussianFit<Data_t> gaussFirst, gaussSecond, gaussAll;
+  for (std::size_t i = 0; i < nPoints; ++i) {
+    Data_t const gaussY = std::exp(-data.x[i] * data.x[i] / Data_t(800));
+    ((i < half)? first: second).add(data.x[i], data.y[i], data.sy[i]);
+    ((i < half)? gaussFirst: gaussSecond).add(data.x[i], gaussY);
+    all.add(data.x[i], data.y[i], data.sy[i]);
+    gaussAll.add(data.x[i], gaussY);
+  } // for
+
+  lar::util::LinearFit<Data_t> merged = first;
+  merged.merge(second);
+  BOOST_CHECK_EQUAL(merged.N(), all.N());
+  BOOST_CHECK(merged.isValid());
+  for (unsigned int iParam = 0; iParam < 2; ++iParam) {
+    CheckNear(merged.FitParameters()[iParam], all.FitParameters()[iParam],
+      Data_t(1e-8));
+  }
+
+  merged.remove(second);
+  BOOST_CHECK_EQUAL(merged.N(), first.N());
+  for (unsigned int iParam = 0; iParam < 2; ++iParam) {
+    CheckNear(merged.FitParameters()[iParam], first.FitParameters()[iParam],
+      Data_t(1e-8));
+  }
+
+  lar::util::GaussianFit<Data_t> gaussMerged = gaussFirst;
+  gaussMerged.merge(gaussSecond);
+  BOOST_CHECK_EQUAL(gaussMerged.N(), gaussAll.N());
+  BOOST_CHECK(gaussMerged.isValid());
+  for (unsigned int iParam = 0; iParam < 3; ++iParam) {
+    CheckNear(gaussMerged.FitParameters()[iParam],
+      gaussAll.FitParameters()[iParam], Data_t(1e-8));
+  }
+
+  // points with non-positive values are never added, nor removed
+  BOOST_CHECK(!gaussMerged.remove(Data_t(0), Data_t(-1)));
+  gaussMerged.remove(gaussSecond);
+  BOOST_CHECK_EQUAL(gaussMerged.N(), gaussFirst.N());
+  for (unsigned int iParam = 0; iParam < 3; ++iParam) {
+    CheckNear(gaussMerged.FitParameters()[iParam],
+      gaussFirst.FitParameters()[iParam], Data_t(1e-8));
+  }
+
+} // SlidingWindowFitTest()
+
+
+/** ****************************************************************************
+ * @brief Tests a single precision sliding window fit across a large outlier
+ *
+ * The outlier dominates the sums while it is in the window; after it is
+ * removed, plain `float` sums would keep its rounding error, which is much
+ * larger than the contribution of the other points.
+ */
+void FloatSlidingWindowFitTest() {
+
+  using Data_t = float;
+
+  std::mt19937 gen(13579);
+  std::normal_distribution<Data_t> smear(Data_t(0), Data_t(0.5));
+  std::size_t const nPoints = 300U;
+  std::size_t const outlier = 100U;
+  std::size_t const window = 12U;
+  std::vector<Data_t> x(nPoints), y(nPoints);
+  for (std::size_t i = 0; i < nPoints; ++i) {
+    x[i] = Data_t(0.1) * Data_t(i);
+    y[i] = (i == outlier)
+      ? Data_t(2e4): Data_t(5) + Data_t(0.2) * x[i] + smear(gen);
+  } // for
+
+  using Fitter_t
+    = lar::util::LinearFit<Data_t, lar::util::CompensatedSum<Data_t>>;
+  Fitter_t sliding;
+  for (std::size_t i = 0; i < nPoints; ++i) {
+    sliding.add(x[i], y[i], Data_t(0.5));
+    if (i < window) continue;
+    sliding.remove(x[i - window], y[i - window], Data_t(0.5));
+    if (i < outlier + window) continue; // outlier still in the window
+
+    Fitter_t expected;
+    for (std::size_t j = i + 1 - window; j <= i; ++j)
+      expected.add(x[j], y[j], Data_t(0.5));
+
+    BOOST_CHECK_EQUAL(sliding.N(), expected.N());
+    BOOST_TEST_REQUIRE(sliding.isValid());
+    auto const params = sliding.FitParameters();
+    auto const expectedParams = expected.FitParameters();
+    for (unsigned int iParam = 0; iParam < 2; ++iParam)
+      CheckNear(params[iParam], expectedParams[iParam], Data_t(1e-4));
+    CheckNear(sliding.ChiSquare(), expected.ChiSquare(), Data_t(1e-3));
+  } // for
+
+} // FloatSlidingWindowFitTest()
+
+
 //------------------------------------------------------------------------------
 //--- registration of tests
 //
@@ -694,3 +1069,24 @@ BOOST_AUTO_TEST_CASE(GaussianFitRealTest) {
   GaussianFitTest<double>();
 }
 
+//
+// batch fit tests
+//
+BOOST_AUTO_TEST_CASE(PolyFitBatchRealTest) {
+  PolyFitBatchTest<double>();
+}
+
+BOOST_AUTO_TEST_CASE(GaussianFitBatchRealTest) {
+  GaussianFitBatchTest<double>();
+}
+
+//
+// incremental fit tests
+//
+BOOST_AUTO_TEST_CASE(SlidingWindowFitRealTest) {
+  SlidingWindowFitTest<double>();
+}
+
+BOOST_AUTO_TEST_CASE(SlidingWindowFitFloatTest) {
+  FloatSlidingWindowFitTest();
+}